@@ -0,0 +1,42 @@
+/// @file
+/// @brief Class @ref cubos::core::BinaryLogSink.
+/// @ingroup core
+
+#pragma once
+
+#include <cstdio>
+#include <mutex>
+
+#include <spdlog/sinks/base_sink.h>
+
+namespace cubos::core
+{
+    /// @brief Log sink which writes messages to a file without formatting them, in the format
+    /// described in @ref LoggerOptions::binaryPath.
+    /// @ingroup core
+    class BinaryLogSink final : public spdlog::sinks::base_sink<std::mutex>
+    {
+    public:
+        ~BinaryLogSink() override;
+
+        /// @brief Constructs.
+        /// @param file File to write to.
+        /// @param close Whether the file should be closed when the sink is destructed.
+        BinaryLogSink(FILE* file, bool close = true);
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override;
+        void flush_() override;
+
+    private:
+        /// @brief Appends a little endian value to the record being written.
+        /// @tparam T Value type.
+        /// @param value Value.
+        template <typename T>
+        void append(T value);
+
+        FILE* mFile;                  ///< File being written to.
+        bool mClose;                  ///< Whether the file is closed on destruction.
+        spdlog::memory_buf_t mRecord; ///< Record being written, reused between messages.
+    };
+} // namespace cubos::core
@@ -7,7 +7,10 @@ namespace cubos::core::data
 {
     /// Implementation of the abstract Serializer class for serializing to binary data.
     /// This class allows data to be serialized in both little and big endian formats.
-    class BinarySerializer : public Serializer
+    ///
+    /// The class is final so that calls through a `BinarySerializer&`, such as the ones made by
+    /// @ref writeFields, aren't virtual.
+    class BinarySerializer final : public Serializer
     {
     public:
         /// @param stream The stream to serialize to.
@@ -15,6 +18,13 @@ namespace cubos::core::data
         BinarySerializer(memory::Stream& stream, bool writeLittleEndian = true);
         ~BinarySerializer() override = default;
 
+        /// Writes the memory of a value as is, if the byte order of the platform is the one being
+        /// written. Used by @ref writeFields for types whose memory matches their serialized form.
+        /// @param data The data to write.
+        /// @param size The size of the data.
+        /// @return Whether the data was written.
+        bool writePacked(const void* data, std::size_t size);
+
         // Implement interface methods.
 
         void writeI8(int8_t value, const char* name) override;
@@ -133,10 +133,9 @@ struct fmt::formatter<cubos::core::data::Debug<T>> : formatter<string_view>
         auto stream = cubos::core::memory::BufferStream(32);
         cubos::core::data::DebugSerializer serializer(stream, this->pretty, this->types);
         serializer.write(dbg.value, nullptr);
-        stream.put('\0');
         // Skip the '?: ' prefix.
-        auto result = std::string(static_cast<const char*>(stream.getBuffer()) + 3);
-        return formatter<string_view>::format(string_view(result), ctx);
+        auto result = string_view(static_cast<const char*>(stream.getBuffer()) + 3, stream.size() - 3);
+        return formatter<string_view>::format(result, ctx);
     }
 };
 /// @endcond
@@ -0,0 +1,405 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+
+#include <cubos/core/data/deserializer.hpp>
+#include <cubos/core/data/serializer.hpp>
+
+namespace cubos::core::data
+{
+    /// Computes the identifier of a field from its name, with a 16 bit FNV-1a hash. Used by
+    /// @ref TaggedSerializer to tag values, and by @ref TaggedDeserializer to match them.
+    /// @param name The name of the field (optional).
+    /// @return The identifier, or 0 if there's no name.
+    constexpr uint32_t fieldId(const char* name)
+    {
+        if (name == nullptr)
+        {
+            return 0;
+        }
+
+        uint32_t hash = 2166136261U;
+        for (; *name != '\0'; ++name)
+        {
+            hash = (hash ^ static_cast<uint8_t>(*name)) * 16777619U;
+        }
+
+        // Fold the hash so that keys take at most 3 bytes. 0 is reserved for unnamed values.
+        auto id = (hash >> 16) ^ (hash & 0xFFFF);
+        return id == 0 ? 1 : id;
+    }
+
+    /// Compile-time descriptor of a field of a type.
+    /// @tparam T The type which contains the field.
+    /// @tparam F The type of the field.
+    template <typename T, typename F>
+    struct Field
+    {
+        using Type = F;
+
+        const char* name; ///< The name of the field.
+        uint32_t id;      ///< The identifier of the name, see @ref fieldId.
+        F T::*member;     ///< Pointer to the field.
+    };
+
+    /// Creates a field descriptor.
+    /// @tparam T The type which contains the field.
+    /// @tparam F The type of the field.
+    /// @param name The name of the field.
+    /// @param member Pointer to the field.
+    /// @return The field descriptor.
+    template <typename T, typename F>
+    constexpr Field<T, F> makeField(const char* name, F T::*member)
+    {
+        return {name, fieldId(name), member};
+    }
+
+    /// Holds the field descriptors of a type, in declaration order, which allow it to be
+    /// serialized without going through a `serialize` specialization per field.
+    ///
+    /// @details Specializations are generated by `quadrados generate` for every component, and
+    /// must define a `value` tuple of field descriptors:
+    ///
+    ///     template <>
+    ///     struct cubos::core::data::Fields<MyType>
+    ///     {
+    ///         static constexpr auto value = std::make_tuple(makeField("a", &MyType::a));
+    ///     };
+    ///
+    /// The specialization must be visible before any use of @ref HasFields on the type.
+    ///
+    /// @tparam T The type described.
+    template <typename T>
+    struct Fields;
+
+    template <typename T>
+    concept HasFields = requires
+    {
+        Fields<T>::value;
+    };
+
+    /// Checks if a type is one of the types which serializers write with a single primitive call.
+    /// @tparam T The type to check.
+    template <typename T>
+    inline constexpr bool IsPrimitive = std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+                                        std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+                                        std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t> ||
+                                        std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t> ||
+                                        std::is_same_v<T, float> || std::is_same_v<T, double> ||
+                                        std::is_same_v<T, bool>;
+
+    /// Checks if the memory of a type holds exactly its primitive fields, in order and without
+    /// padding, which means that binary serializers can write it with a single copy.
+    /// @tparam T The type to check.
+    /// @return Whether the type is packed.
+    template <typename T>
+    requires HasFields<T>
+    constexpr bool isPacked()
+    {
+        if constexpr (!std::is_trivially_copyable_v<T> || !std::is_standard_layout_v<T>)
+        {
+            return false;
+        }
+        else
+        {
+            return std::apply(
+                [](const auto&... fields) {
+                    return (IsPrimitive<typename std::remove_cvref_t<decltype(fields)>::Type> && ...) &&
+                           (sizeof(typename std::remove_cvref_t<decltype(fields)>::Type) + ... + 0) == sizeof(T);
+                },
+                Fields<T>::value);
+        }
+    }
+
+    /// Checks if the identifiers of the fields of a type are all distinct. Fields are matched by
+    /// their identifiers when deserializing, so two names with the same hash would be mixed up.
+    /// @tparam T The type to check.
+    /// @return Whether the identifiers are distinct.
+    template <typename T>
+    requires HasFields<T>
+    constexpr bool hasDistinctFieldIds()
+    {
+        return std::apply(
+            [](const auto&... fields) {
+                const uint32_t ids[] = {fields.id..., 0};
+                for (std::size_t i = 0; i < sizeof...(fields); ++i)
+                {
+                    for (std::size_t j = i + 1; j < sizeof...(fields); ++j)
+                    {
+                        if (ids[i] == ids[j])
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            },
+            Fields<T>::value);
+    }
+
+    template <typename S, typename T>
+    requires HasFields<T>
+    void writeFields(S& ser, const T& obj, const char* name);
+
+    /// Serializes a single field through the static type of the serializer.
+    /// Primitives and types with field descriptors are written without virtual calls if @p S is a
+    /// final class; other types fall back to their `serialize` function.
+    /// @tparam S The serializer type.
+    /// @tparam F The type of the field.
+    /// @param ser The serializer.
+    /// @param value The value of the field.
+    /// @param name The name of the field.
+    template <typename S, typename F>
+    inline void writeField(S& ser, const F& value, const char* name)
+    {
+        if constexpr (std::is_same_v<F, int8_t>)
+        {
+            ser.writeI8(value, name);
+        }
+        else if constexpr (std::is_same_v<F, int16_t>)
+        {
+            ser.writeI16(value, name);
+        }
+        else if constexpr (std::is_same_v<F, int32_t>)
+        {
+            ser.writeI32(value, name);
+        }
+        else if constexpr (std::is_same_v<F, int64_t>)
+        {
+            ser.writeI64(value, name);
+        }
+        else if constexpr (std::is_same_v<F, uint8_t>)
+        {
+            ser.writeU8(value, name);
+        }
+        else if constexpr (std::is_same_v<F, uint16_t>)
+        {
+            ser.writeU16(value, name);
+        }
+        else if constexpr (std::is_same_v<F, uint32_t>)
+        {
+            ser.writeU32(value, name);
+        }
+        else if constexpr (std::is_same_v<F, uint64_t>)
+        {
+            ser.writeU64(value, name);
+        }
+        else if constexpr (std::is_same_v<F, float>)
+        {
+            ser.writeF32(value, name);
+        }
+        else if constexpr (std::is_same_v<F, double>)
+        {
+            ser.writeF64(value, name);
+        }
+        else if constexpr (std::is_same_v<F, bool>)
+        {
+            ser.writeBool(value, name);
+        }
+        else if constexpr (HasFields<F>)
+        {
+            writeFields(ser, value, name);
+        }
+        else
+        {
+            ser.write(value, name);
+        }
+    }
+
+    /// Serializes an object from its field descriptors, through the static type of the
+    /// serializer. Produces the same output as the `serialize` functions generated by
+    /// `quadrados generate`: types with a single field are written as that field, and other
+    /// types are written as objects.
+    ///
+    /// If the serializer has a `writePacked(const void*, std::size_t)` method and the type is
+    /// packed, the whole object may be written at once.
+    ///
+    /// @tparam S The serializer type.
+    /// @tparam T The type of the object.
+    /// @param ser The serializer.
+    /// @param obj The object to serialize.
+    /// @param name The name of the object.
+    template <typename S, typename T>
+    requires HasFields<T>
+    inline void writeFields(S& ser, const T& obj, const char* name)
+    {
+        static_assert(hasDistinctFieldIds<T>(), "Two fields have the same identifier, one must be renamed");
+
+        if constexpr (isPacked<T>() && requires { ser.writePacked(&obj, sizeof(T)); })
+        {
+            if (ser.writePacked(&obj, sizeof(T)))
+            {
+                return;
+            }
+        }
+
+        constexpr auto& fields = Fields<T>::value;
+        if constexpr (std::tuple_size_v<std::remove_cvref_t<decltype(fields)>> == 1)
+        {
+            writeField(ser, obj.*std::get<0>(fields).member, name);
+        }
+        else
+        {
+            ser.beginObject(name);
+            std::apply([&](const auto&... field) { (writeField(ser, obj.*field.member, field.name), ...); }, fields);
+            ser.endObject();
+        }
+    }
+
+    /// Serializes an object from its field descriptors. If the dynamic type of the serializer is
+    /// one of @p Fast, the object is serialized through that type, which avoids virtual calls
+    /// per field. Otherwise, the virtual interface is used.
+    /// @tparam Fast Serializer types which get a specialized path.
+    /// @tparam T The type of the object.
+    /// @param ser The serializer.
+    /// @param obj The object to serialize.
+    /// @param name The name of the object.
+    template <typename... Fast, typename T>
+    requires HasFields<T>
+    inline void serializeFields(Serializer& ser, const T& obj, const char* name)
+    {
+        bool done = ((typeid(ser) == typeid(Fast) && (writeFields(static_cast<Fast&>(ser), obj, name), true)) || ...);
+        if (!done)
+        {
+            writeFields(ser, obj, name);
+        }
+    }
+
+    template <typename D, typename T>
+    requires HasFields<T>
+    void readFields(D& des, T& obj);
+
+    /// Deserializes a single field through the static type of the deserializer.
+    /// Counterpart of @ref writeField.
+    /// @tparam D The deserializer type.
+    /// @tparam F The type of the field.
+    /// @param des The deserializer.
+    /// @param value The value of the field.
+    template <typename D, typename F>
+    inline void readField(D& des, F& value)
+    {
+        if constexpr (std::is_same_v<F, int8_t>)
+        {
+            des.readI8(value);
+        }
+        else if constexpr (std::is_same_v<F, int16_t>)
+        {
+            des.readI16(value);
+        }
+        else if constexpr (std::is_same_v<F, int32_t>)
+        {
+            des.readI32(value);
+        }
+        else if constexpr (std::is_same_v<F, int64_t>)
+        {
+            des.readI64(value);
+        }
+        else if constexpr (std::is_same_v<F, uint8_t>)
+        {
+            des.readU8(value);
+        }
+        else if constexpr (std::is_same_v<F, uint16_t>)
+        {
+            des.readU16(value);
+        }
+        else if constexpr (std::is_same_v<F, uint32_t>)
+        {
+            des.readU32(value);
+        }
+        else if constexpr (std::is_same_v<F, uint64_t>)
+        {
+            des.readU64(value);
+        }
+        else if constexpr (std::is_same_v<F, float>)
+        {
+            des.readF32(value);
+        }
+        else if constexpr (std::is_same_v<F, double>)
+        {
+            des.readF64(value);
+        }
+        else if constexpr (std::is_same_v<F, bool>)
+        {
+            des.readBool(value);
+        }
+        else if constexpr (HasFields<F>)
+        {
+            readFields(des, value);
+        }
+        else
+        {
+            des.read(value);
+        }
+    }
+
+    /// Deserializes an object from its field descriptors, through the static type of the
+    /// deserializer. Counterpart of @ref writeFields.
+    ///
+    /// If the deserializer has `nextField(uint32_t&)` and `skipField()` methods, fields are
+    /// matched by their identifiers instead of their order: unknown fields are skipped, and
+    /// fields which aren't found keep their current values.
+    ///
+    /// @tparam D The deserializer type.
+    /// @tparam T The type of the object.
+    /// @param des The deserializer.
+    /// @param obj The object to deserialize into.
+    template <typename D, typename T>
+    requires HasFields<T>
+    inline void readFields(D& des, T& obj)
+    {
+        static_assert(hasDistinctFieldIds<T>(), "Two fields have the same identifier, one must be renamed");
+
+        constexpr auto& fields = Fields<T>::value;
+        if constexpr (std::tuple_size_v<std::remove_cvref_t<decltype(fields)>> == 1)
+        {
+            readField(des, obj.*std::get<0>(fields).member);
+        }
+        else if constexpr (requires(uint32_t id) {
+                               des.nextField(id);
+                               des.skipField();
+                           })
+        {
+            des.beginObject();
+            uint32_t id;
+            while (des.nextField(id))
+            {
+                bool found = std::apply(
+                    [&](const auto&... field) {
+                        return ((field.id == id && (readField(des, obj.*field.member), true)) || ...);
+                    },
+                    fields);
+                if (!found)
+                {
+                    des.skipField();
+                }
+            }
+            des.endObject();
+        }
+        else
+        {
+            des.beginObject();
+            std::apply([&](const auto&... field) { (readField(des, obj.*field.member), ...); }, fields);
+            des.endObject();
+        }
+    }
+
+    /// Deserializes an object from its field descriptors. If the dynamic type of the deserializer
+    /// is one of @p Fast, the object is deserialized through that type. Otherwise, the virtual
+    /// interface is used. Counterpart of @ref serializeFields.
+    /// @tparam Fast Deserializer types which get a specialized path.
+    /// @tparam T The type of the object.
+    /// @param des The deserializer.
+    /// @param obj The object to deserialize into.
+    template <typename... Fast, typename T>
+    requires HasFields<T>
+    inline void deserializeFields(Deserializer& des, T& obj)
+    {
+        bool done = ((typeid(des) == typeid(Fast) && (readFields(static_cast<Fast&>(des), obj), true)) || ...);
+        if (!done)
+        {
+            readFields(des, obj);
+        }
+    }
+} // namespace cubos::core::data
@@ -115,6 +115,9 @@ namespace cubos::core::data
         /// - `FileSystem::find(path)` fails.
         /// - `file->open(mode)` fails.
         ///
+        /// The returned stream is buffered - written data may only reach the file when the stream is
+        /// destroyed.
+        ///
         /// @param path Absolute path of the file.
         /// @param mode Mode to open the file in.
         /// @return File stream, or nullptr if an error occurred.
@@ -1,20 +1,27 @@
 #pragma once
 
-#include <stack>
-
-#include <nlohmann/json.hpp>
+#include <deque>
+#include <vector>
 
 #include <cubos/core/data/deserializer.hpp>
+#include <cubos/core/memory/stream.hpp>
 
 namespace cubos::core::data
 {
     /// Implementation of the abstract Deserializer class for deserializing from JSON.
+    ///
+    /// Values are parsed directly from the source as they are read, without building a DOM.
+    /// The length of arrays and dictionaries is found by scanning ahead, which counts the elements
+    /// of every nested container at once, so each byte is scanned at most twice.
     class JSONDeserializer : public Deserializer
     {
     public:
         /// @param src The string to deserialize from. Must correspond to a JSON literal/object/array.
         JSONDeserializer(const std::string& src);
 
+        /// @param stream The stream to deserialize from. Must outlive the deserializer.
+        JSONDeserializer(memory::Stream& stream);
+
         // Implement interface methods.
 
         void readI8(int8_t& value) override;
@@ -45,15 +52,107 @@ namespace cubos::core::data
             Dictionary
         };
 
+        /// What the next item of a frame turned out to be.
+        enum class Item
+        {
+            Key,   ///< A dictionary key, already read into @ref mKey.
+            Value, ///< A value, which starts at the current position.
+            Error  ///< The source is malformed, and the fail bit has been set.
+        };
+
         /// The current frame of deserialization.
         struct Frame
         {
-            Mode mode;                             ///< The current mode of deserialization.
-            nlohmann::ordered_json::iterator iter; ///< The current node.
-            bool key;                              ///< Whether the current node is a key.
+            Mode mode;  ///< The current mode of deserialization.
+            char close; ///< Character which closes the frame.
+            bool first; ///< Whether no item has been read yet.
+            bool key;   ///< Whether the next item is a key.
+            bool named; ///< Whether the values are preceded by names which must be skipped.
         };
 
-        std::stack<Frame> mFrame;     ///< The current frame of the deserializer.
-        nlohmann::ordered_json mJson; ///< The current JSON value being read.
+        /// Checks whether the fail bit is set, warning if it is.
+        /// @return Whether the fail bit is set.
+        bool failedBefore();
+
+        /// Sets the fail bit and logs where the source is malformed.
+        /// @param message Description of the error.
+        void error(const char* message);
+
+        /// Reads more of the source into the buffer, if the buffer has been consumed.
+        /// @return Whether there's anything left to read.
+        bool refill();
+
+        /// Peeks the next character, without skipping whitespace.
+        /// @return Next character, or `\0` at the end of the source.
+        char peek();
+
+        /// Skips whitespace and peeks the next character.
+        /// @return Next character, or `\0` at the end of the source.
+        char peekToken();
+
+        /// Skips whitespace and consumes the next character if it is the expected one.
+        /// @param expected Expected character.
+        /// @param message Error message if it isn't.
+        /// @return Whether the character was found.
+        bool expect(char expected, const char* message);
+
+        /// Positions the source at the next item of the current frame.
+        /// @return What the next item is.
+        Item nextItem();
+
+        /// Positions the source at the next value, which can't be a key.
+        /// @param message Error message if the next item is a key.
+        /// @return Whether the value can be read.
+        bool nextValue(const char* message);
+
+        /// Reads a string, which starts at the current position.
+        /// @param str String to read into.
+        /// @return Whether the string was read.
+        bool parseString(std::string& str);
+
+        /// Reads a number or literal token into @ref mToken.
+        /// @return Whether a token was read.
+        bool parseToken();
+
+        /// Skips a value, which starts at the current position.
+        void skipValue();
+
+        /// Skips the rest of the current frame, and pops it.
+        void endFrame();
+
+        /// Scans ahead until the end of the container which starts at the current position,
+        /// counting its elements and the elements of every container nested in it.
+        /// @return Whether the container is well formed.
+        bool scanCounts();
+
+        /// Gets the number of elements of the container which starts at the current position.
+        /// Scans ahead if the count isn't known yet.
+        /// @return Number of elements.
+        std::size_t takeCount();
+
+        /// Parses an integer value or key.
+        /// @tparam T Integer type.
+        /// @param value Value to read into.
+        template <typename T>
+        void readInteger(T& value);
+
+        /// Parses a floating point value or key.
+        /// @tparam T Floating point type.
+        /// @param value Value to read into.
+        template <typename T>
+        void readFloat(T& value);
+
+        memory::Stream* mStream;         ///< Stream being read, or null if the whole source is buffered.
+        bool mSeekable;                  ///< Whether the stream can seek back after scanning ahead.
+        std::vector<char> mBuffer;       ///< Buffered part of the source.
+        std::size_t mBase;               ///< Position in the source of the start of the buffer.
+        std::size_t mPos;                ///< Position in the buffer of the next character.
+        std::size_t mEnd;                ///< Size of the buffered data.
+        bool mScanning;                  ///< Whether the buffer must be kept, as it will be read again.
+        bool mDropped;                   ///< Whether the buffer was dropped while scanning.
+        std::deque<std::size_t> mCounts; ///< Element counts of the next containers, in the source order.
+        std::vector<Frame> mFrames;      ///< The frames of the deserializer.
+        std::string mKey;                ///< Last key read.
+        std::string mToken;              ///< Last number or literal token read.
     };
 } // namespace cubos::core::data
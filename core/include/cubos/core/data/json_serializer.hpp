@@ -1,8 +1,7 @@
 #pragma once
 
-#include <stack>
-
-#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
 
 #include <cubos/core/data/serializer.hpp>
 #include <cubos/core/memory/stream.hpp>
@@ -10,17 +9,20 @@
 namespace cubos::core::data
 {
     /// Implementation of the abstract Serializer class for serializing to JSON.
-    /// Each time a top-level primitive/object/array/dictionary is written, its JSON output is written to the underlying
-    /// stream.
+    /// The JSON output is formatted as values are written, and buffered before being written to the
+    /// underlying stream. Each time a top-level primitive/object/array/dictionary is written, the
+    /// buffer is flushed.
     class JSONSerializer : public Serializer
     {
     public:
         /// @param stream The stream to serialize to.
         /// @param indent The JSON output indentantion (-1 means no indentation).
         JSONSerializer(memory::Stream& stream, int indent = -1);
+        ~JSONSerializer() override;
 
         // Implement interface methods.
 
+        void flush() override;
         void writeI8(int8_t value, const char* name) override;
         void writeI16(int16_t value, const char* name) override;
         void writeI32(int32_t value, const char* name) override;
@@ -41,8 +43,6 @@ namespace cubos::core::data
         void endDictionary() override;
 
     private:
-        void writeJSON(nlohmann::ordered_json&& json, const char* name);
-
         /// The possible state modes of serialization.
         enum class Mode
         {
@@ -51,17 +51,59 @@ namespace cubos::core::data
             Dictionary
         };
 
-        /// Holds the whole state of serialization.
+        /// Holds the state of a container being serialized.
         struct Frame
         {
-            Mode mode;                   ///< The mode of the frame.
-            nlohmann::ordered_json json; ///< The JSON object to serialize to.
-            nlohmann::ordered_json key;  ///< The JSON key value.
-            std::string name;            ///< The name of the value being serialized.
+            Mode mode;         ///< The mode of the frame.
+            bool first;        ///< Whether no element has been written yet.
+            bool key;          ///< Whether the next value is a dictionary key.
+            bool isKey;        ///< Whether the container itself is a dictionary key.
+            std::size_t start; ///< Position in the buffer where the container starts, if it is a key.
         };
 
-        memory::Stream& mStream;   ///< The stream to serialize to.
-        std::stack<Frame> mFrames; ///< The stack of frames.
-        int mIndent;               ///< The indentation of the JSON output.
+        /// Writes whatever must come before a value: separators, indentation and its name.
+        /// @param name The name of the value.
+        /// @return Whether the value is a dictionary key, and thus must be written as a string.
+        bool beginValue(const char* name);
+
+        /// Finishes writing a value, flushing the buffer if needed.
+        void endValue();
+
+        /// Writes a primitive value, quoting it if it is a key.
+        /// @param text The value's JSON representation.
+        /// @param size The size of the representation.
+        /// @param name The name of the value.
+        void writePrimitive(const char* text, std::size_t size, const char* name);
+
+        /// Writes a string literal, escaping any special characters.
+        /// @param str The string.
+        /// @param size The size of the string.
+        void writeQuoted(const char* str, std::size_t size);
+
+        /// Writes the separator between a key and its value.
+        void writeKeySeparator();
+
+        /// Writes the separator before an element of the current container, and indents it.
+        void writeElementSeparator();
+
+        /// Writes a new line and indents it to the given depth, if the output is indented.
+        /// @param depth The depth.
+        void writeNewLine(std::size_t depth);
+
+        /// Starts a container.
+        /// @param mode The mode of the container.
+        /// @param open The character which opens the container.
+        /// @param name The name of the container.
+        void beginContainer(Mode mode, char open, const char* name);
+
+        /// Ends the current container.
+        /// @param close The character which closes the container.
+        void endContainer(char close);
+
+        memory::Stream& mStream;    ///< The stream to serialize to.
+        std::vector<Frame> mFrames; ///< The stack of frames.
+        int mIndent;                ///< The indentation of the JSON output.
+        std::size_t mKeyDepth;      ///< Number of open containers which are dictionary keys.
+        std::string mBuffer;        ///< Output which hasn't been written to the stream yet.
     };
 } // namespace cubos::core::data
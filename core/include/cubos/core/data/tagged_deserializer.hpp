@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+
+#include <cubos/core/data/deserializer.hpp>
+#include <cubos/core/data/tagged_serializer.hpp>
+#include <cubos/core/memory/stream.hpp>
+
+namespace cubos::core::data
+{
+    /// Implementation of the abstract Deserializer class for deserializing data written by
+    /// @ref TaggedSerializer.
+    ///
+    /// @details Values are read in order, like with the other deserializers, but objects are
+    /// tolerant to changes in their layout:
+    /// - fields missing from the end of an object are left untouched, so they keep their defaults;
+    /// - fields which were not read when an object ends are skipped without being parsed;
+    /// - integers can be read into wider types than the ones they were written with.
+    ///
+    /// Types with field descriptors (see @ref Fields) are matched by field identifier instead, with
+    /// @ref nextField and @ref skipField, which also tolerates fields being removed and reordered.
+    class TaggedDeserializer final : public Deserializer
+    {
+    public:
+        /// @param stream The stream to deserialize from.
+        TaggedDeserializer(memory::Stream& stream);
+
+        /// Reads the key of the next field of the current object, which must then be read
+        /// normally or skipped with @ref skipField.
+        /// @param[out] id The identifier of the field's name.
+        /// @return Whether there was another field.
+        bool nextField(uint32_t& id);
+
+        /// Skips the value of the field whose key was read by @ref nextField.
+        void skipField();
+
+        // Implement interface methods.
+
+        void readI8(int8_t& value) override;
+        void readI16(int16_t& value) override;
+        void readI32(int32_t& value) override;
+        void readI64(int64_t& value) override;
+        void readU8(uint8_t& value) override;
+        void readU16(uint16_t& value) override;
+        void readU32(uint32_t& value) override;
+        void readU64(uint64_t& value) override;
+        void readF32(float& value) override;
+        void readF64(double& value) override;
+        void readBool(bool& value) override;
+        void readString(std::string& value) override;
+        void beginObject() override;
+        void endObject() override;
+        std::size_t beginArray() override;
+        void endArray() override;
+        std::size_t beginDictionary() override;
+        void endDictionary() override;
+
+    private:
+        /// Reads the key of the next value, if it wasn't read by @ref nextField, and checks its
+        /// wire type.
+        /// @param type The expected wire type.
+        /// @return Whether the value is present and has the expected type.
+        bool readKey(TaggedType type);
+
+        /// Reads a variable-length integer.
+        /// @param[out] value The value read.
+        /// @return Whether the value was read successfully.
+        bool readVarint(uint64_t& value);
+
+        /// Reads raw bytes.
+        /// @param data Buffer to read into.
+        /// @param size Number of bytes to read.
+        /// @return Whether the bytes were read successfully.
+        bool readRaw(void* data, std::size_t size);
+
+        /// Checks if a size read from the stream fits in the rest of the current container, so
+        /// that corrupt data sets the fail bit instead of causing huge allocations.
+        /// @param size The size to check, in bytes.
+        /// @return Whether the size fits.
+        bool checkSize(uint64_t size);
+
+        /// Reads a signed integer value, checking if it fits in the given range.
+        /// @param[out] value The value read, untouched if it's missing.
+        /// @param min The minimum value allowed.
+        /// @param max The maximum value allowed.
+        /// @return Whether a value was read.
+        bool readSigned(int64_t& value, int64_t min, int64_t max);
+
+        /// Reads an unsigned integer value, checking if it fits in the given range.
+        /// @param[out] value The value read, untouched if it's missing.
+        /// @param max The maximum value allowed.
+        /// @return Whether a value was read.
+        bool readUnsigned(uint64_t& value, uint64_t max);
+
+        /// Starts reading a container.
+        /// @param length Whether the container stores its length.
+        /// @return The length of the container, or 0 if it's missing.
+        std::size_t beginContainer(bool length);
+
+        /// Skips the rest of the current container.
+        void endContainer();
+
+        memory::Stream& mStream;        ///< The stream to deserialize from.
+        std::size_t mOffset;            ///< Number of bytes consumed from the stream.
+        std::vector<std::size_t> mEnds; ///< Offsets where the open containers end.
+        bool mHasKey;                   ///< Whether the key of the next value was already read.
+        TaggedType mKeyType;            ///< The wire type of the key already read.
+    };
+} // namespace cubos::core::data
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <cubos/core/data/serializer.hpp>
+#include <cubos/core/memory/stream.hpp>
+
+namespace cubos::core::data
+{
+    /// Wire types of the values written by @ref TaggedSerializer, stored in the lower 3 bits of
+    /// each key.
+    enum class TaggedType : uint8_t
+    {
+        Varint = 0,  ///< Integers and booleans, as variable-length integers.
+        Fixed64 = 1, ///< Doubles, as 8 little endian bytes.
+        Bytes = 2,   ///< Strings, objects, arrays and dictionaries, prefixed by their size in bytes.
+        Fixed32 = 5, ///< Floats, as 4 little endian bytes.
+    };
+
+    /// Implementation of the abstract Serializer class for serializing to a compact tagged binary
+    /// format, which can be read back even after fields are added, removed or reordered.
+    ///
+    /// @details Each value is preceded by a variable-length key, which holds the identifier of its
+    /// name (see @ref fieldId) and its @ref TaggedType. Signed integers are zig-zag encoded.
+    /// Strings and containers are prefixed by their size in bytes, so that readers can skip them
+    /// without parsing them; arrays and dictionaries also store their length.
+    ///
+    /// Containers are formatted in a buffer, which is written to the stream each time a top-level
+    /// value ends.
+    class TaggedSerializer final : public Serializer
+    {
+    public:
+        /// @param stream The stream to serialize to.
+        TaggedSerializer(memory::Stream& stream);
+        ~TaggedSerializer() override;
+
+        // Implement interface methods.
+
+        void flush() override;
+        void writeI8(int8_t value, const char* name) override;
+        void writeI16(int16_t value, const char* name) override;
+        void writeI32(int32_t value, const char* name) override;
+        void writeI64(int64_t value, const char* name) override;
+        void writeU8(uint8_t value, const char* name) override;
+        void writeU16(uint16_t value, const char* name) override;
+        void writeU32(uint32_t value, const char* name) override;
+        void writeU64(uint64_t value, const char* name) override;
+        void writeF32(float value, const char* name) override;
+        void writeF64(double value, const char* name) override;
+        void writeBool(bool value, const char* name) override;
+        void writeString(const char* value, const char* name) override;
+        void beginObject(const char* name) override;
+        void endObject() override;
+        void beginArray(std::size_t length, const char* name) override;
+        void endArray() override;
+        void beginDictionary(std::size_t length, const char* name) override;
+        void endDictionary() override;
+
+    private:
+        /// Writes the key of a value.
+        /// @param name The name of the value.
+        /// @param type The wire type of the value.
+        void writeKey(const char* name, TaggedType type);
+
+        /// Writes a variable-length integer.
+        /// @param value The value to write.
+        void writeVarint(uint64_t value);
+
+        /// Writes a signed integer value.
+        /// @param value The value to write.
+        /// @param name The name of the value.
+        void writeSigned(int64_t value, const char* name);
+
+        /// Writes an unsigned integer value.
+        /// @param value The value to write.
+        /// @param name The name of the value.
+        void writeUnsigned(uint64_t value, const char* name);
+
+        /// Starts a container, whose size is written when it ends.
+        /// @param name The name of the container.
+        void beginContainer(const char* name);
+
+        /// Ends the current container, inserting its size before its contents.
+        void endContainer();
+
+        /// Called after each value is written, flushes the buffer if the value is at the top level.
+        void endValue();
+
+        memory::Stream& mStream;          ///< The stream to serialize to.
+        std::string mBuffer;              ///< Formatted data which hasn't been written yet.
+        std::vector<std::size_t> mStarts; ///< Offsets in the buffer where the open containers start.
+    };
+} // namespace cubos::core::data
@@ -71,7 +71,6 @@ namespace cubos::core::ecs
             /// @brief Names of the entities of the components present in the stream, in the same order.
             std::vector<std::string> names;
             memory::BufferStream stream; ///< Self growing buffer stream where the component data is stored.
-            std::mutex mutex;            ///< Protect the stream.
 
             virtual ~IBuffer() = default;
 
@@ -101,10 +100,9 @@ namespace cubos::core::ecs
 
             inline void addAll(CommandBuffer& commands, data::Context& context) override
             {
-                this->mutex.lock();
-                auto pos = this->stream.tell();
-                this->stream.seek(0, memory::SeekOrigin::Begin);
-                auto des = data::BinaryDeserializer(this->stream);
+                // Read through a view, so that the buffer can be spawned from concurrently and isn't copied.
+                auto stream = this->stream.view();
+                auto des = data::BinaryDeserializer(stream);
                 des.context().pushSubContext(context);
 
                 auto& map = des.context().get<data::SerializationMap<Entity, std::string>>();
@@ -114,8 +112,6 @@ namespace cubos::core::ecs
                     des.read(type);
                     commands.add(map.getRef(name), std::move(type));
                 }
-                this->stream.seek(static_cast<ptrdiff_t>(pos), memory::SeekOrigin::Begin);
-                this->mutex.unlock();
 
                 if (des.failed())
                 {
@@ -129,11 +125,13 @@ namespace cubos::core::ecs
             {
                 auto buffer = static_cast<Buffer<ComponentType>*>(other);
 
-                buffer->mutex.lock();
-                auto pos = buffer->stream.tell();
-                buffer->stream.seek(0, memory::SeekOrigin::Begin);
+                // The merged data should take about as much space as it did in the other buffer.
+                this->stream.reserve(this->stream.size() + buffer->stream.size());
+                this->names.reserve(this->names.size() + buffer->names.size());
+
+                auto stream = buffer->stream.view();
                 auto ser = data::BinarySerializer(this->stream);
-                auto des = data::BinaryDeserializer(buffer->stream);
+                auto des = data::BinaryDeserializer(stream);
                 ser.context().pushSubContext(dst);
                 des.context().pushSubContext(src);
                 for (const auto& name : buffer->names)
@@ -146,8 +144,6 @@ namespace cubos::core::ecs
                     des.read(type);
                     ser.write(type, "data");
                 }
-                buffer->stream.seek(static_cast<ptrdiff_t>(pos), memory::SeekOrigin::Begin);
-                buffer->mutex.unlock();
             }
 
             inline IBuffer* create() override
@@ -143,6 +143,7 @@ namespace cubos::core::ecs
             std::shared_ptr<SystemSettings> settings;
             std::shared_ptr<AnySystemWrapper<void>> system;
             std::unordered_set<std::string> tags;
+            const char* name = nullptr;
         };
 
         /// @brief Internal class used to implement a DFS algorithm for call chain compilation
@@ -182,6 +183,7 @@ namespace cubos::core::ecs
         std::vector<System*> mPendingSystems;                                ///< All systems.
         std::map<std::string, std::shared_ptr<SystemSettings>> mTagSettings; ///< All tags.
         std::vector<std::shared_ptr<AnySystemWrapper<bool>>> mConditions;    ///< All conditions.
+        std::vector<const char*> mConditionNames;                            ///< Zone names of the conditions.
         std::bitset<CUBOS_CORE_DISPATCHER_MAX_CONDITIONS>
             mRunConditions; ///< Bitset of conditions that run in this iteration.
         std::bitset<CUBOS_CORE_DISPATCHER_MAX_CONDITIONS> mRetConditions; ///< Bitset of conditions return values.
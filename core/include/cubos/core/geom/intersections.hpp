@@ -0,0 +1,108 @@
+/// @file
+/// @brief Narrow phase intersection tests between convex shapes.
+/// @ingroup core-geom
+
+#pragma once
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include <cubos/core/geom/box.hpp>
+#include <cubos/core/geom/capsule.hpp>
+#include <cubos/core/geom/plane.hpp>
+#include <cubos/core/geom/simplex.hpp>
+
+namespace cubos::core::geom
+{
+    /// @brief Describes the contact between two intersecting shapes.
+    /// @ingroup core-geom
+    struct ContactManifold
+    {
+        /// @brief Maximum number of contact points in a manifold.
+        static constexpr std::size_t MaxPoints = 4;
+
+        glm::vec3 normal{0.0F};        ///< Contact normal, pointing from the first shape towards the second.
+        float depth{0.0F};             ///< Penetration depth along the normal.
+        std::size_t pointCount{0};     ///< Number of contact points.
+        glm::vec3 points[MaxPoints]{}; ///< Contact points, in world space.
+    };
+
+    /// @brief Convex shape placed in world space, used as input to the intersection tests.
+    ///
+    /// @details Every shape is represented by a core - either an oriented box or the convex hull
+    /// of up to four points - inflated by a radius. Capsules are segments along their local Y axis
+    /// inflated by their radius, while box and simplex margins are used as the inflation radius.
+    /// @ingroup core-geom
+    struct Convex
+    {
+        /// @brief Maximum number of points in a point hull core.
+        static constexpr std::size_t MaxPoints = 4;
+
+        bool isBox{false};             ///< Whether the core is an oriented box.
+        glm::vec3 center{0.0F};        ///< Center of the box core.
+        glm::vec3 axes[3]{};           ///< Axes of the box core, scaled by its half size.
+        std::size_t pointCount{0};     ///< Number of points in the point hull core.
+        glm::vec3 points[MaxPoints]{}; ///< Points of the point hull core.
+        float radius{0.0F};            ///< Inflation radius.
+
+        /// @brief Creates a convex shape from a transformed box.
+        /// @param box Box shape.
+        /// @param transform Local to world transform of the box.
+        /// @param radius Inflation radius.
+        /// @return Convex shape.
+        static Convex box(const Box& box, const glm::mat4& transform, float radius = 0.0F);
+
+        /// @brief Creates a convex shape from a transformed capsule.
+        /// @param capsule Capsule shape.
+        /// @param transform Local to world transform of the capsule.
+        /// @return Convex shape.
+        static Convex capsule(const Capsule& capsule, const glm::mat4& transform);
+
+        /// @brief Creates a convex shape from a transformed simplex.
+        /// @param simplex Simplex shape.
+        /// @param transform Local to world transform of the simplex.
+        /// @param radius Inflation radius.
+        /// @return Convex shape.
+        static Convex simplex(const Simplex& simplex, const glm::mat4& transform, float radius = 0.0F);
+
+        /// @brief Checks whether the shape has no core, which only happens for empty simplices.
+        /// @return Whether the shape is empty.
+        bool empty() const;
+
+        /// @brief Gets the point of the core which is furthest along the given direction.
+        /// @param direction Search direction, which doesn't need to be normalized.
+        /// @return Support point of the core.
+        glm::vec3 support(const glm::vec3& direction) const;
+    };
+
+    /// @brief Computes the distance between the cores of two convex shapes, using GJK.
+    /// @param a First shape.
+    /// @param b Second shape.
+    /// @param[out] pointA Closest point on the core of the first shape.
+    /// @param[out] pointB Closest point on the core of the second shape.
+    /// @return Distance between the cores, or zero if they intersect.
+    float coreDistance(const Convex& a, const Convex& b, glm::vec3& pointA, glm::vec3& pointB);
+
+    /// @brief Checks whether two convex shapes intersect, and if so, computes their contact manifold.
+    ///
+    /// @details Pairs of boxes are tested with the separating axis theorem, which produces up to
+    /// four contact points. Every other pair is tested with GJK, falling back to EPA when the
+    /// cores overlap, and produces a single contact point.
+    ///
+    /// @param a First shape.
+    /// @param b Second shape.
+    /// @param[out] manifold Contact manifold, only written when the shapes intersect.
+    /// @return Whether the shapes intersect.
+    bool intersects(const Convex& a, const Convex& b, ContactManifold& manifold);
+
+    /// @brief Checks whether a convex shape intersects a plane, and if so, computes their contact manifold.
+    /// @param a Convex shape.
+    /// @param plane Plane shape, with its normal in world space.
+    /// @param origin Point on the plane, in world space.
+    /// @param radius Inflation radius of the plane.
+    /// @param[out] manifold Contact manifold, with the normal pointing from the shape towards the plane.
+    /// @return Whether the shape intersects the plane.
+    bool intersects(const Convex& a, const Plane& plane, const glm::vec3& origin, float radius,
+                    ContactManifold& manifold);
+} // namespace cubos::core::geom
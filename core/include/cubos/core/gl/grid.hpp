@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -31,6 +32,23 @@ namespace cubos::core::gl
     class Grid final
     {
     public:
+        /// @brief Ray to be cast against a grid, in grid space, where the voxel at position
+        /// `(x, y, z)` occupies the unit cube from `(x, y, z)` to `(x + 1, y + 1, z + 1)`.
+        struct Ray
+        {
+            glm::vec3 origin;    ///< Origin of the ray.
+            glm::vec3 direction; ///< Direction of the ray. Doesn't need to be normalized.
+            float maxDistance;   ///< Maximum distance along the ray to search for voxels.
+        };
+
+        /// @brief Describes where a ray hit a grid.
+        struct RaycastHit
+        {
+            glm::ivec3 voxel;  ///< Coordinates of the voxel hit.
+            glm::ivec3 normal; ///< Normal of the voxel face hit, or zero if the ray started inside the voxel.
+            float distance;    ///< Distance along the ray to the hit point.
+        };
+
         ~Grid() = default;
 
         /// @brief Constructs an empty single-voxel grid.
@@ -88,6 +106,29 @@ namespace cubos::core::gl
         /// @return Whether the conversion was successful.
         bool convert(const Palette& src, const Palette& dst, float minSimilarity);
 
+        /// @brief Finds the first non-empty voxel intersected by a ray.
+        ///
+        /// The grid is traversed voxel by voxel, using the Amanatides-Woo algorithm.
+        ///
+        /// @param origin Origin of the ray, in grid space.
+        /// @param direction Direction of the ray. Doesn't need to be normalized.
+        /// @param maxDistance Maximum distance along the ray to search for voxels.
+        /// @return Hit information, or nothing if no voxel was hit.
+        std::optional<RaycastHit> raycast(const glm::vec3& origin, const glm::vec3& direction,
+                                          float maxDistance) const;
+
+        /// @brief Casts multiple rays against the grid.
+        ///
+        /// When @p useMip is true, a coarse occupancy grid is built once for the whole batch,
+        /// which lets rays skip over large empty regions of the grid. This pays off for big,
+        /// sparse grids and large batches.
+        ///
+        /// @param rays Rays to cast.
+        /// @param[out] hits Hit information for each ray, or nothing for rays which hit no voxel.
+        /// @param useMip Whether to accelerate traversal with a coarse occupancy grid.
+        void raycast(const std::vector<Ray>& rays, std::vector<std::optional<RaycastHit>>& hits,
+                     bool useMip = true) const;
+
     private:
         friend void data::serialize(data::Serializer& /*serializer*/, const Grid& /*grid*/, const char* /*name*/);
         friend void data::deserialize(data::Deserializer& /*deserializer*/, Grid& /*grid*/);
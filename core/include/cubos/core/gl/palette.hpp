@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <set>
 #include <vector>
 
 #include <cubos/core/gl/material.hpp>
@@ -31,6 +32,9 @@ namespace cubos::core::gl
     /// of storing the whole material per each voxel, we just store a 16-bit
     /// integer.
     ///
+    /// Non-empty materials are indexed by color, and empty slots are tracked separately, so that
+    /// @ref find and @ref add don't need to scan the whole palette.
+    ///
     /// @ingroup core-gl
     class Palette final
     {
@@ -87,6 +91,19 @@ namespace cubos::core::gl
         friend void data::serialize(data::Serializer& /*serializer*/, const Palette& /*palette*/, const char* /*name*/);
         friend void data::deserialize(data::Deserializer& /*deserializer*/, Palette& /*palette*/);
 
-        std::vector<Material> mMaterials; ///< Materials in the palette.
+        /// @brief Adds the material at the given index to the material index or to the free slots.
+        /// @param index Index of the material (1-based).
+        void indexMaterial(uint16_t index);
+
+        /// @brief Removes the material at the given index from the material index or from the free slots.
+        /// @param index Index of the material (1-based).
+        void unindexMaterial(uint16_t index);
+
+        /// @brief Rebuilds the material index and free slots from scratch.
+        void rebuildIndex();
+
+        std::vector<Material> mMaterials;            ///< Materials in the palette.
+        std::vector<std::vector<uint16_t>> mBuckets; ///< Indices of non-empty materials, bucketed by color.
+        std::set<uint16_t> mFree;                    ///< Indices of empty materials, which may be reused.
     };
 } // namespace cubos::core::gl
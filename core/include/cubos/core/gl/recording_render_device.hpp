@@ -0,0 +1,154 @@
+/// @file
+/// @brief Class @ref cubos::core::gl::RecordingRenderDevice.
+/// @ingroup core-gl
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <cubos/core/gl/render_device.hpp>
+
+namespace cubos::core::gl
+{
+    /// @brief Frame being recorded by a @ref RecordingRenderDevice, shared with the objects it
+    /// creates.
+    struct RecordingState;
+
+    /// @brief Render device which doesn't render anything, but records the commands it receives.
+    ///
+    /// Every request succeeds. Resources are allocated on the CPU, so that buffers can still be
+    /// mapped and written to, and shader pipelines provide a binding point for any name. This
+    /// allows measuring and testing the rendering code without a GPU.
+    ///
+    /// Commands are grouped in frames, which are ended by @ref endFrame().
+    ///
+    /// @see @ref io::openHeadlessWindow() creates a window with this device.
+    /// @ingroup core-gl
+    class RecordingRenderDevice : public RenderDevice
+    {
+    public:
+        /// @brief Recorded command.
+        ///
+        /// Objects are referred to by identifiers, unique in the device, or by 0 when null.
+        struct Command
+        {
+            /// @brief Type of a command, and the meaning of its arguments.
+            enum class Type : std::uint8_t
+            {
+                SetFramebuffer,       ///< Framebuffer.
+                SetRasterState,       ///< Raster state.
+                SetDepthStencilState, ///< Depth stencil state.
+                SetBlendState,        ///< Blend state.
+                SetIndexBuffer,       ///< Index buffer.
+                SetVertexArray,       ///< Vertex array.
+                SetShaderPipeline,    ///< Shader pipeline.
+                SetViewport,          ///< X, Y, width and height.
+                SetScissor,           ///< X, Y, width and height.
+                Bind,                 ///< Binding point, and bound object.
+                SetConstant,          ///< Binding point, and size of the value.
+                MapBuffer,            ///< Buffer, and its size.
+                UpdateTexture,        ///< Texture, and number of updated texels.
+                GenerateMipmaps,      ///< Texture.
+                ClearColor,           ///< No arguments.
+                ClearTargetColor,     ///< Target.
+                ClearDepth,           ///< No arguments.
+                ClearStencil,         ///< No arguments.
+                Draw,                 ///< Offset, vertex count, instance count, and whether it's indexed.
+                DispatchCompute,      ///< Number of groups along each axis.
+                Barrier,              ///< Barriers.
+            };
+
+            Type type;               ///< Type of the command.
+            std::uint32_t args[4]{}; ///< Arguments, whose meaning depends on the type.
+        };
+
+        /// @brief Counts of the commands of a frame.
+        struct Counts
+        {
+            std::size_t draws = 0;        ///< Draw calls.
+            std::size_t instances = 0;    ///< Instances drawn, one per call for non-instanced draws.
+            std::size_t triangles = 0;    ///< Triangles drawn, over all instances.
+            std::size_t stateChanges = 0; ///< Changes of the pipeline, states, bound objects, viewport and scissor.
+            std::size_t binds = 0;        ///< Objects bound to binding points.
+            std::size_t constants = 0;    ///< Constants set.
+            std::size_t bytesMapped = 0;  ///< Bytes of the buffers mapped.
+            std::size_t uploads = 0;      ///< Texture updates.
+            std::size_t clears = 0;       ///< Clears of the framebuffer or of its targets.
+            std::size_t dispatches = 0;   ///< Compute dispatches.
+        };
+
+        /// @brief Commands received during a frame.
+        struct Frame
+        {
+            std::vector<Command> commands; ///< Commands, in the order they were received.
+            Counts counts;                 ///< Counts of the commands.
+        };
+
+        RecordingRenderDevice();
+        ~RecordingRenderDevice() override;
+
+        /// @brief Ends the frame being recorded, which becomes the last frame, and starts a new one.
+        void endFrame();
+
+        /// @brief Gets the frame being recorded.
+        /// @return Frame being recorded.
+        const Frame& frame() const;
+
+        /// @brief Gets the last frame ended by @ref endFrame().
+        /// @return Last frame, or an empty frame if none has ended yet.
+        const Frame& lastFrame() const;
+
+        // Interface implementation.
+
+        Framebuffer createFramebuffer(const FramebufferDesc& desc) override;
+        void setFramebuffer(Framebuffer fb) override;
+        RasterState createRasterState(const RasterStateDesc& desc) override;
+        void setRasterState(RasterState rs) override;
+        DepthStencilState createDepthStencilState(const DepthStencilStateDesc& desc) override;
+        void setDepthStencilState(DepthStencilState dss) override;
+        BlendState createBlendState(const BlendStateDesc& desc) override;
+        void setBlendState(BlendState bs) override;
+        Sampler createSampler(const SamplerDesc& desc) override;
+        Texture1D createTexture1D(const Texture1DDesc& desc) override;
+        Texture2D createTexture2D(const Texture2DDesc& desc) override;
+        Texture2DArray createTexture2DArray(const Texture2DArrayDesc& desc) override;
+        Texture3D createTexture3D(const Texture3DDesc& desc) override;
+        CubeMap createCubeMap(const CubeMapDesc& desc) override;
+        CubeMapArray createCubeMapArray(const CubeMapArrayDesc& desc) override;
+        ConstantBuffer createConstantBuffer(std::size_t size, const void* data, Usage usage) override;
+        IndexBuffer createIndexBuffer(std::size_t size, const void* data, IndexFormat format, Usage usage) override;
+        void setIndexBuffer(IndexBuffer ib) override;
+        VertexBuffer createVertexBuffer(std::size_t size, const void* data, Usage usage) override;
+        VertexArray createVertexArray(const VertexArrayDesc& desc) override;
+        void setVertexArray(VertexArray va) override;
+        ShaderStage createShaderStage(Stage stage, const char* src) override;
+        ShaderPipeline createShaderPipeline(ShaderStage vs, ShaderStage ps) override;
+        ShaderPipeline createShaderPipeline(ShaderStage vs, ShaderStage gs, ShaderStage ps) override;
+        ShaderPipeline createShaderPipeline(ShaderStage cs) override;
+        void setShaderPipeline(ShaderPipeline pipeline) override;
+        void clearColor(float r, float g, float b, float a) override;
+        void clearTargetColor(std::size_t target, float r, float g, float b, float a) override;
+        void clearDepth(float depth) override;
+        void clearStencil(int stencil) override;
+        void drawTriangles(std::size_t offset, std::size_t count) override;
+        void drawTrianglesIndexed(std::size_t offset, std::size_t count) override;
+        void drawTrianglesInstanced(std::size_t offset, std::size_t count, std::size_t instanceCount) override;
+        void drawTrianglesIndexedInstanced(std::size_t offset, std::size_t count, std::size_t instanceCount) override;
+        void dispatchCompute(std::size_t x, std::size_t y, std::size_t z) override;
+        void memoryBarrier(MemoryBarriers barriers) override;
+        void setViewport(int x, int y, int w, int h) override;
+        void setScissor(int x, int y, int w, int h) override;
+        int getProperty(Property prop) override;
+        RenderDeviceStats stats() const override;
+        void resetStats() override;
+
+    private:
+        /// @brief Records a draw call.
+        void draw(std::size_t offset, std::size_t count, std::size_t instanceCount, bool indexed);
+
+        std::shared_ptr<RecordingState> mState;
+        Frame mLastFrame;
+    };
+} // namespace cubos::core::gl
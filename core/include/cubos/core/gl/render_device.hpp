@@ -240,6 +240,8 @@ namespace cubos::core::gl
         RG16UInt,    ///< 2 channel 16 bits unsigned integer.
         RGBA8UInt,   ///< 4 channel 8 bits unsigned integer.
         RGBA16UInt,  ///< 4 channel 16 bits unsigned integer.
+        R32UInt,     ///< 1 channel 32 bits unsigned integer.
+        RG32UInt,    ///< 2 channel 32 bits unsigned integer.
         R16Float,    ///< 1 channel 16 bits floating point.
         R32Float,    ///< 1 channel 32 bits floating point.
         RG16Float,   ///< 2 channel 16 bits floating point.
@@ -705,6 +707,19 @@ namespace cubos::core::gl
         ShaderPipeline shaderPipeline; ///< Shader pipeline used with the vertex array.
     };
 
+    /// @brief Counts the state changes requested from a render device.
+    ///
+    /// Requests which wouldn't change the state of the underlying API, such as binding an already
+    /// bound texture, are skipped.
+    ///
+    /// @see @ref RenderDevice::stats().
+    /// @ingroup core-gl
+    struct RenderDeviceStats
+    {
+        std::size_t issued = 0;  ///< Number of requests which reached the underlying API.
+        std::size_t skipped = 0; ///< Number of requests which were skipped.
+    };
+
     /// @brief Interface used to wrap low-level rendering APIs such as OpenGL.
     ///
     /// Using this interface, the engine never directly interacts with *OpenGL* or any other
@@ -939,6 +954,14 @@ namespace cubos::core::gl
         /// @brief Gets a runtime property of the render device.
         /// @param prop Property name.
         virtual int getProperty(Property prop) = 0;
+
+        /// @brief Gets the number of state changes issued and skipped since the last call to
+        /// @ref resetStats().
+        /// @return State change statistics.
+        virtual RenderDeviceStats stats() const = 0;
+
+        /// @brief Resets the statistics returned by @ref stats().
+        virtual void resetStats() = 0;
     };
 
     namespace impl
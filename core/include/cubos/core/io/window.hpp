@@ -130,6 +130,16 @@ namespace cubos::core::io
     /// @ingroup core-io
     Window openWindow(const std::string& title = "CUBOS.", const glm::ivec2& size = {800, 600});
 
+    /// @brief Opens a new headless window, which isn't shown and renders nothing.
+    ///
+    /// Its render device is a @ref gl::RecordingRenderDevice, whose frames are ended by
+    /// @ref BaseWindow::swapBuffers(). Useful for benchmarking and testing without a GPU.
+    ///
+    /// @param size Window size.
+    /// @return New window.
+    /// @ingroup core-io
+    Window openHeadlessWindow(const glm::ivec2& size = {800, 600});
+
     /// @brief Interface used to wrap low-level window API implementations.
     ///
     /// Allows polling of input events and creates a @ref gl::RenderDevice for rendering to the
@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <string>
 
 /// @addtogroup core
 /// @{
@@ -70,6 +74,18 @@
 /// @sa CUBOS_LOG_LEVEL
 #define CUBOS_LOG_LEVEL_OFF SPDLOG_LEVEL_OFF
 
+/// @cond
+#define CUBOS_LOG_LIMITED(level, macro, ...)                                                                           \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        static ::cubos::core::LogSite cubosLogSite;                                                                    \
+        if (cubosLogSite.allow(level, ::spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}))                      \
+        {                                                                                                              \
+            macro(__VA_ARGS__);                                                                                        \
+        }                                                                                                              \
+    } while (false)
+/// @endcond
+
 /// @brief Used for logging very verbose information.
 /// @param ... Format string and arguments.
 /// @see CUBOS_LOG_LEVEL_TRACE
@@ -86,17 +102,22 @@
 /// @see CUBOS_LOG_LEVEL_INFO
 #define CUBOS_INFO(...) SPDLOG_INFO(__VA_ARGS__)
 
-/// @brief Used for logging unexpected events.
+/// @brief Used for logging unexpected events. Rate limited per call site, as set by
+/// @ref cubos::core::LoggerOptions::rateLimit.
 /// @param ... Format string and arguments.
 /// @see CUBOS_LOG_LEVEL_WARN
-#define CUBOS_WARN(...) SPDLOG_WARN(__VA_ARGS__)
+#if CUBOS_LOG_LEVEL <= CUBOS_LOG_LEVEL_WARN
+#define CUBOS_WARN(...) CUBOS_LOG_LIMITED(::spdlog::level::warn, SPDLOG_WARN, __VA_ARGS__)
+#else
+#define CUBOS_WARN(...) (void)0
+#endif
 
-/// @brief Used for logging recoverable errors.
+/// @brief Used for logging recoverable errors. Never rate limited.
 /// @param ... Format string and arguments.
 /// @see CUBOS_LOG_LEVEL_ERROR
 #define CUBOS_ERROR(...) SPDLOG_ERROR(__VA_ARGS__)
 
-/// @brief Used for logging unrecoverable errors.
+/// @brief Used for logging unrecoverable errors. Never rate limited.
 /// @param ... Format string and arguments.
 /// @see CUBOS_LOG_LEVEL_CRITICAL
 #define CUBOS_CRITICAL(...) SPDLOG_CRITICAL(__VA_ARGS__)
@@ -110,6 +131,7 @@
         {                                                                                                              \
             CUBOS_CRITICAL("" __VA_ARGS__);                                                                            \
         }                                                                                                              \
+        ::cubos::core::shutdownLogger();                                                                               \
         std::abort();                                                                                                  \
     } while (false)
 
@@ -145,11 +167,105 @@
 
 namespace cubos::core
 {
+    /// @brief Options for @ref initializeLogger().
+    /// @ingroup core
+    struct LoggerOptions
+    {
+        /// @brief Whether messages are written to the sinks by a background thread, so that
+        /// logging only has to format the message and push it to a queue.
+        bool async = false;
+
+        /// @brief Maximum number of messages queued in async mode. When the queue is full, logging
+        /// waits for the background thread to make room, so that queued messages are never lost.
+        std::size_t queueSize = 8192;
+
+        /// @brief Maximum number of warnings logged per second from each @ref CUBOS_WARN call site,
+        /// or 0 for no limit. Other levels are never limited.
+        ///
+        /// Warnings over the limit are dropped before being formatted or queued, so that a call
+        /// site warning in a loop can't flood the queue. Dropped warnings are counted, and the
+        /// count is logged once the call site's one second window ends - when it warns again, or
+        /// otherwise by a background thread every second and by @ref shutdownLogger().
+        std::size_t rateLimit = 0;
+
+        /// @brief Path of a file where all messages are also written to in a compact binary
+        /// format, or empty for none.
+        ///
+        /// Each record holds the timestamp in nanoseconds since the epoch (u64), the level (u8),
+        /// the source line (u32), the source file (u16 size followed by the characters) and the
+        /// message (u32 size followed by the characters), all little endian.
+        std::string binaryPath;
+    };
+
     /// @brief Must be called before any logging is done.
+    /// @param options Logger options.
+    /// @ingroup core
+    void initializeLogger(const LoggerOptions& options = {});
+
+    /// @brief Writes any messages still queued and stops the background threads of the logger,
+    /// if any. Called automatically on exit and by @ref CUBOS_FAIL.
     /// @ingroup core
-    void initializeLogger();
+    void shutdownLogger();
 
     /// @brief Disables all logging except for critical errors.
     /// @ingroup core
     void disableLogging();
+
+    /// @brief Limits the number of messages logged from a single call site per second, as set by
+    /// @ref LoggerOptions::rateLimit. @ref CUBOS_WARN keeps one for each call site.
+    ///
+    /// Can be used from several threads at once, in which case the limit is approximate. Sites
+    /// with dropped messages are registered until the count is reported, so that it's reported
+    /// even if they never log again.
+    ///
+    /// @ingroup core
+    class LogSite final
+    {
+    public:
+        /// @brief Reports the messages dropped by the site, if any.
+        ~LogSite();
+
+        /// @brief Constructs.
+        LogSite() = default;
+
+        /// @brief Forbid copy construction.
+        LogSite(const LogSite&) = delete;
+
+        /// @brief Logs how many messages were dropped by each registered site whose window ended.
+        /// Called every second by a background thread, while there's a rate limit.
+        /// @param now Current time. Reports all sites if it's the maximum time point.
+        static void reportDropped(std::chrono::steady_clock::time_point now);
+
+        /// @brief Checks whether a message should be logged from this call site, counting it.
+        ///
+        /// Uses the rate limit of the current logger, and the current time. Messages whose level
+        /// would be discarded by the logger aren't counted.
+        ///
+        /// @param level Level of the message.
+        /// @param source Location of the call site.
+        /// @return Whether the message should be logged.
+        bool allow(spdlog::level::level_enum level, const spdlog::source_loc& source);
+
+        /// @brief Checks whether a message should be logged from this call site, counting it.
+        ///
+        /// If this is the first message of a new one second window, and messages were dropped in
+        /// the previous window, logs a warning with their count first.
+        ///
+        /// @param source Location of the call site.
+        /// @param limit Maximum number of messages per second, or 0 for no limit.
+        /// @param now Current time.
+        /// @return Whether the message should be logged.
+        bool allow(const spdlog::source_loc& source, std::size_t limit, std::chrono::steady_clock::time_point now);
+
+    private:
+        /// @brief Logs how many messages were dropped, if any, and resets the count.
+        /// @param source Location of the call site.
+        void report(const spdlog::source_loc& source);
+
+        std::atomic<int64_t> mStart{0};       ///< Time at which the current window started, in nanoseconds, or 0.
+        std::atomic<std::size_t> mCount{0};   ///< Number of messages counted in the current window.
+        std::atomic<std::size_t> mDropped{0}; ///< Number of messages dropped and not yet reported.
+        bool mRegistered{false};              ///< Whether the site is registered. Guarded by the registry lock.
+        spdlog::source_loc mSource;           ///< Location of the call site, set when registered.
+    };
 } // namespace cubos::core
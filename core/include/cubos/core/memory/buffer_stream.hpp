@@ -4,11 +4,18 @@
 
 #pragma once
 
+#include <vector>
+
 #include <cubos/core/memory/stream.hpp>
 
 namespace cubos::core::memory
 {
     /// @brief Stream implementation which writes to/reads from a buffer.
+    ///
+    /// The buffer is either borrowed, in which case the stream can't grow past it, or owned by the
+    /// stream, in which case it grows geometrically as data is written to it. Reads never go past
+    /// the data which has been written to an owned buffer.
+    ///
     /// @ingroup core-memory
     class BufferStream : public Stream
     {
@@ -27,9 +34,16 @@ namespace cubos::core::memory
         BufferStream(const void* buffer, std::size_t size);
 
         /// @brief Constructs using a new buffer, managed internally and which grows as needed.
-        /// @param size Initial size of the buffer.
+        /// @param size Initial capacity of the buffer.
         BufferStream(std::size_t size = 16);
 
+        /// @brief Constructs by taking ownership of the given data, without copying it.
+        ///
+        /// The stream starts at the beginning of the data, and grows as needed when written to.
+        ///
+        /// @param data Data to take.
+        BufferStream(std::vector<char>&& data);
+
         /// @brief Constructs a copy of another buffer stream. If the given buffer stream owns its
         /// buffer, the copy will also create its own buffer. Otherwise, it will share the buffer
         /// with the original.
@@ -44,6 +58,47 @@ namespace cubos::core::memory
         /// @return Buffer.
         const void* getBuffer() const;
 
+        /// @brief Gets the size of the data in the buffer. For owned buffers, this is the furthest
+        /// position ever written to, and otherwise it's the size of the buffer.
+        /// @return Size in bytes.
+        std::size_t size() const;
+
+        /// @brief Gets the number of bytes which can be stored without growing the buffer.
+        /// @return Capacity in bytes.
+        std::size_t capacity() const;
+
+        /// @brief Grows the buffer so that it can store at least the given number of bytes.
+        ///
+        /// Does nothing if the buffer isn't owned by this stream.
+        ///
+        /// @param capacity Minimum capacity in bytes.
+        void reserve(std::size_t capacity);
+
+        /// @brief Creates a read-only stream which borrows the data of this stream, without
+        /// copying it.
+        ///
+        /// The view is invalidated when this stream is destroyed or its buffer grows.
+        ///
+        /// @return Stream positioned at the beginning of the data.
+        BufferStream view() const;
+
+        /// @brief Creates a read-only stream which borrows part of the data of this stream,
+        /// without copying it.
+        ///
+        /// The slice is invalidated when this stream is destroyed or its buffer grows.
+        ///
+        /// @param offset Offset of the slice, clamped to the size of the data.
+        /// @param size Size of the slice, clamped to the size of the data after the offset.
+        /// @return Stream positioned at the beginning of the slice.
+        BufferStream slice(std::size_t offset, std::size_t size) const;
+
+        /// @brief Gives away the data of this stream, without copying it, leaving the stream empty.
+        ///
+        /// If the buffer isn't owned by this stream, the data is copied instead.
+        ///
+        /// @return Data of the stream, with @ref size() bytes.
+        std::vector<char> release();
+
         // Method implementations.
 
         std::size_t read(void* data, std::size_t size) override;
@@ -54,11 +109,13 @@ namespace cubos::core::memory
         char peek() const override;
 
     private:
-        void* mBuffer;         ///< Pointer to the buffer being written to/read from.
-        std::size_t mSize;     ///< Size of the buffer.
-        std::size_t mPosition; ///< Current position in the buffer.
-        bool mReadOnly;        ///< Whether the buffer is read-only.
-        bool mReachedEof;      ///< Whether the end of the buffer has been reached.
-        bool mOwned;           ///< Whether the buffer is owned by this stream.
+        std::vector<char> mStorage; ///< Storage of the buffer, if it's owned.
+        void* mBuffer;              ///< Pointer to the buffer being written to/read from.
+        std::size_t mSize;          ///< Size of the data in the buffer.
+        std::size_t mCapacity;      ///< Size of the buffer.
+        std::size_t mPosition;      ///< Current position in the buffer.
+        bool mReadOnly;             ///< Whether the buffer is read-only.
+        bool mReachedEof;           ///< Whether the end of the buffer has been reached.
+        bool mOwned;                ///< Whether the buffer is owned by this stream.
     };
 } // namespace cubos::core::memory
@@ -0,0 +1,77 @@
+/// @file
+/// @brief Class @ref cubos::core::memory::BufferedStream.
+/// @ingroup core-memory
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <cubos/core/memory/stream.hpp>
+
+namespace cubos::core::memory
+{
+    /// @brief Stream decorator which reads and writes another stream in large blocks.
+    ///
+    /// Useful when the underlying stream has a high cost per call, such as a @ref StandardStream,
+    /// whose methods are called once per character by the text methods of @ref Stream.
+    ///
+    /// Written data is kept in the buffer until it fills up, the stream is seeked, or the stream
+    /// is destroyed.
+    ///
+    /// @ingroup core-memory
+    class BufferedStream : public Stream
+    {
+    public:
+        ~BufferedStream() override;
+
+        /// @brief Constructs.
+        /// @param stream Underlying stream.
+        /// @param bufferSize Size of the buffer.
+        BufferedStream(std::unique_ptr<Stream> stream, std::size_t bufferSize = 4096);
+
+        /// @brief Writes any buffered data to the underlying stream.
+        void flush();
+
+        /// @brief Gets the buffered data which hasn't been read yet, reading more from the
+        /// underlying stream if there is none.
+        ///
+        /// Allows parsers to scan the data directly, followed by a call to @ref consume().
+        ///
+        /// @param[out] size Number of buffered bytes, 0 if the end of the stream was reached.
+        /// @return Buffered data.
+        const char* buffered(std::size_t& size);
+
+        /// @brief Consumes data returned by @ref buffered().
+        /// @param size Number of bytes to consume, at most the size returned by @ref buffered().
+        void consume(std::size_t size);
+
+        // Method implementations.
+
+        using Stream::readUntil;
+
+        std::size_t read(void* data, std::size_t size) override;
+        std::size_t write(const void* data, std::size_t size) override;
+        std::size_t tell() const override;
+        void seek(ptrdiff_t offset, SeekOrigin origin) override;
+        bool eof() const override;
+        char peek() const override;
+        void readUntil(std::string& str, const char* terminator) override;
+        void ignore(std::size_t size) override;
+
+    private:
+        /// @brief Writes any buffered data to the underlying stream.
+        void writeBuffered() const;
+
+        /// @brief Reads more data from the underlying stream, if the buffer has been consumed.
+        /// @return Whether there's buffered data to read.
+        bool fill() const;
+
+        std::unique_ptr<Stream> mStream;   ///< Underlying stream.
+        mutable std::vector<char> mBuffer; ///< Buffered data.
+        mutable std::size_t mPosition;     ///< Position of the next byte to read from the buffer.
+        mutable std::size_t mSize;         ///< Number of bytes read into, or written to, the buffer.
+        mutable bool mReachedEof;          ///< Whether a read has reached the end of the stream.
+        mutable bool mWriting;             ///< Whether the buffer holds data to be written.
+    };
+} // namespace cubos::core::memory
@@ -203,9 +203,12 @@ namespace cubos::core::memory
         void parse(double& value);
 
         /// @brief Reads a string from the stream until the @p terminator (or `\0`) is found.
+        ///
+        /// Implementations may override this to avoid reading one byte at a time.
+        ///
         /// @param[out] str Read string.
         /// @param terminator Optional terminator to use.
-        void readUntil(std::string& str, const char* terminator);
+        virtual void readUntil(std::string& str, const char* terminator);
 
         /// @brief Reads a string from the stream until the @p terminator (or `\0`) is found.
         /// @param buffer Buffer to read into.
@@ -215,8 +218,11 @@ namespace cubos::core::memory
         std::size_t readUntil(char* buffer, std::size_t size, const char* terminator);
 
         /// @brief Ignores a number of bytes from the stream.
+        ///
+        /// Implementations may override this to avoid reading one byte at a time.
+        ///
         /// @param size Number of bytes to ignore.
-        void ignore(std::size_t size);
+        virtual void ignore(std::size_t size);
     };
 
     // Implementation
@@ -0,0 +1,100 @@
+/// @file
+/// @brief Class @ref cubos::core::profiling::Zone, profiler functions and zone macros.
+/// @ingroup core-profiling
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <cubos/core/memory/stream.hpp>
+
+/// @addtogroup core-profiling
+/// @{
+
+/// @cond
+#define CUBOS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CUBOS_PROFILE_CONCAT(a, b) CUBOS_PROFILE_CONCAT_IMPL(a, b)
+/// @endcond
+
+/// @brief Records a zone from this point until the end of the current scope.
+/// @param name Name of the zone. Must live until the profile is exported, such as a literal or a
+/// string returned by @ref cubos::core::profiling::intern().
+#define CUBOS_PROFILE_ZONE(name) ::cubos::core::profiling::Zone CUBOS_PROFILE_CONCAT(cubosProfileZone, __LINE__)(name)
+
+/// @brief Records a zone named after the current function until the end of the current scope.
+#define CUBOS_PROFILE_FUNCTION() CUBOS_PROFILE_ZONE(static_cast<const char*>(__func__))
+
+/// @}
+
+namespace cubos::core::profiling
+{
+    /// @brief Enables or disables the recording of zones. Disabled by default.
+    ///
+    /// Zones which were already open when profiling is enabled aren't recorded.
+    ///
+    /// @param enabled Whether zones should be recorded.
+    /// @ingroup core-profiling
+    void setEnabled(bool enabled);
+
+    /// @brief Checks whether zones are being recorded.
+    /// @return Whether profiling is enabled.
+    /// @ingroup core-profiling
+    bool isEnabled();
+
+    /// @brief Discards all recorded zones.
+    ///
+    /// Zones may still be recorded by other threads while this is called.
+    ///
+    /// @ingroup core-profiling
+    void clear();
+
+    /// @brief Writes the recorded zones to a stream, in the Chrome trace event JSON format, which
+    /// can be opened in `chrome://tracing` or in Perfetto.
+    ///
+    /// Zones may still be recorded by other threads while this is called, in which case they may
+    /// or may not be included. The number of zones which were overwritten before being exported
+    /// is written to `otherData.droppedZones`, and logged as a warning if there were any.
+    ///
+    /// @param stream Stream to write to.
+    /// @ingroup core-profiling
+    void exportChromeTrace(memory::Stream& stream);
+
+    /// @brief Gets a copy of the given string which lives until the program exits, so that it
+    /// can be used as a zone name. Equal strings share the same copy.
+    ///
+    /// Takes a lock, and thus should be called once per name, not when recording zones.
+    ///
+    /// @param name Name.
+    /// @return Pointer to the copy.
+    /// @ingroup core-profiling
+    const char* intern(const std::string& name);
+
+    /// @brief Records the time between its construction and destruction, if profiling is
+    /// enabled when it's constructed. Should be created with @ref CUBOS_PROFILE_ZONE.
+    ///
+    /// Each thread records zones to its own buffer, without taking locks. Each buffer holds a
+    /// limited number of zones, after which new zones overwrite the oldest ones.
+    ///
+    /// @ingroup core-profiling
+    class Zone final
+    {
+    public:
+        /// @brief Records the zone, if profiling is enabled.
+        ~Zone();
+
+        /// @brief Starts the zone, if profiling is enabled.
+        /// @param name Name of the zone.
+        Zone(const char* name);
+
+        /// @brief Forbid copy construction.
+        Zone(const Zone&) = delete;
+
+        /// @brief Forbid move construction.
+        Zone(Zone&&) = delete;
+
+    private:
+        const char* mName; ///< Name of the zone, or null if it isn't being recorded.
+        uint64_t mStart;   ///< Time at which the zone started, in nanoseconds.
+    };
+} // namespace cubos::core::profiling
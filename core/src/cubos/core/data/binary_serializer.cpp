@@ -22,68 +22,79 @@ BinarySerializer::BinarySerializer(memory::Stream& stream, bool writeLittleEndia
     mWriteLittleEndian = writeLittleEndian;
 }
 
+bool BinarySerializer::writePacked(const void* data, std::size_t size)
+{
+    if (memory::isLittleEndian() != mWriteLittleEndian)
+    {
+        return false;
+    }
+
+    mFailBit |= mStream.write(data, size) != size;
+    return true;
+}
+
 void BinarySerializer::writeI8(int8_t value, const char* /*name*/)
 {
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeI16(int16_t value, const char* /*name*/)
 {
     value = toEndianness(value, mWriteLittleEndian);
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeI32(int32_t value, const char* /*name*/)
 {
     value = toEndianness(value, mWriteLittleEndian);
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeI64(int64_t value, const char* /*name*/)
 {
     value = toEndianness(value, mWriteLittleEndian);
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeU8(uint8_t value, const char* /*name*/)
 {
     value = toEndianness(value, mWriteLittleEndian);
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeU16(uint16_t value, const char* /*name*/)
 {
     value = toEndianness(value, mWriteLittleEndian);
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeU32(uint32_t value, const char* /*name*/)
 {
     value = toEndianness(value, mWriteLittleEndian);
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeU64(uint64_t value, const char* /*name*/)
 {
     value = toEndianness(value, mWriteLittleEndian);
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeF32(float value, const char* /*name*/)
 {
     value = toEndianness(value, mWriteLittleEndian);
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeF64(double value, const char* /*name*/)
 {
     value = toEndianness(value, mWriteLittleEndian);
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeBool(bool value, const char* /*name*/)
 {
-    mFailBit |= mStream.write(&value, sizeof(value)) == sizeof(value);
+    mFailBit |= mStream.write(&value, sizeof(value)) != sizeof(value);
 }
 
 void BinarySerializer::writeString(const char* value, const char* /*name*/)
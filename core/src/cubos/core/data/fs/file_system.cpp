@@ -3,10 +3,22 @@
 #include <cubos/core/data/fs/archive.hpp>
 #include <cubos/core/data/fs/file_system.hpp>
 #include <cubos/core/log.hpp>
+#include <cubos/core/memory/buffered_stream.hpp>
 
 using namespace cubos::core;
 using namespace cubos::core::data;
 
+/// Wraps a file stream in a buffered stream, so that reading or writing it one character at a time is cheap.
+static std::unique_ptr<memory::Stream> buffered(std::unique_ptr<memory::Stream> stream)
+{
+    if (stream == nullptr)
+    {
+        return nullptr;
+    }
+
+    return std::make_unique<memory::BufferedStream>(std::move(stream));
+}
+
 File::Handle FileSystem::root()
 {
     static auto root = std::shared_ptr<File>(new File(nullptr, ""));
@@ -93,7 +105,7 @@ std::unique_ptr<memory::Stream> FileSystem::open(std::string_view path, File::Op
     {
         if (auto file = FileSystem::root()->find(path))
         {
-            return file->open(mode);
+            return buffered(file->open(mode));
         }
 
         CUBOS_ERROR("Could not open file for reading at path '{}': the file does not exist", path);
@@ -103,7 +115,7 @@ std::unique_ptr<memory::Stream> FileSystem::open(std::string_view path, File::Op
     {
         if (auto file = FileSystem::root()->create(path))
         {
-            return file->open(mode);
+            return buffered(file->open(mode));
         }
 
         CUBOS_ERROR("Could not open file for writing at path '{}': the file could not be created", path);
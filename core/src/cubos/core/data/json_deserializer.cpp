@@ -1,200 +1,875 @@
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <type_traits>
+
 #include <cubos/core/data/json_deserializer.hpp>
 #include <cubos/core/log.hpp>
 
 using namespace cubos::core;
 using namespace cubos::core::data;
 
-#define CHECK_ERROR(exp)                                                                                               \
-    do                                                                                                                 \
-    {                                                                                                                  \
-        if (mFailBit)                                                                                                  \
-        {                                                                                                              \
-            CUBOS_WARN("Deserializer fail bit is set");                                                                \
-        }                                                                                                              \
-        else                                                                                                           \
-        {                                                                                                              \
-            try                                                                                                        \
-            {                                                                                                          \
-                exp                                                                                                    \
-            }                                                                                                          \
-            catch (nlohmann::json::exception & e)                                                                      \
-            {                                                                                                          \
-                CUBOS_ERROR("Caught JSON exception '{}'", e.what());                                                   \
-                mFailBit = true;                                                                                       \
-            }                                                                                                          \
-        }                                                                                                              \
-    } while (false)
-
-// NOLINTBEGIN(bugprone-macro-parentheses)
-#define READ_GENERIC(out, type, fromStr)                                                                               \
-    CHECK_ERROR(do {                                                                                                   \
-        if (mFrame.top().mode == Mode::Dictionary)                                                                     \
-        {                                                                                                              \
-            if (mFrame.top().key)                                                                                      \
-            {                                                                                                          \
-                out = static_cast<type>(fromStr(mFrame.top().iter.key()));                                             \
-                mFrame.top().key = false;                                                                              \
-            }                                                                                                          \
-            else                                                                                                       \
-            {                                                                                                          \
-                out = mFrame.top().iter.value();                                                                       \
-                mFrame.top().iter++;                                                                                   \
-                mFrame.top().key = true;                                                                               \
-            }                                                                                                          \
-        }                                                                                                              \
-        else                                                                                                           \
-        {                                                                                                              \
-            out = mFrame.top().iter.value();                                                                           \
-            mFrame.top().iter++;                                                                                       \
-        }                                                                                                              \
-    } while (false);)
-// NOLINTEND(bugprone-macro-parentheses)
+/// Number of bytes read from the stream at once.
+static const std::size_t ChunkSize = 16384;
+
+/// Size above which the buffer is dropped while scanning ahead on a seekable stream, which is
+/// then seeked back to where the scan started.
+static const std::size_t ScanWindow = 1 << 20;
+
+/// Parses a whole token as a double, independently of the current locale.
+/// @return Whether the token is a valid number.
+static bool parseDouble(const std::string& token, double& value)
+{
+    const auto* last = token.data() + token.size();
+    auto result = std::from_chars(token.data(), last, value);
+    if (result.ptr != last || token.empty())
+    {
+        return false;
+    }
+
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        // Saturate like strtod, to infinity on overflow and to zero on underflow, which only
+        // happens with negative exponents.
+        auto exponent = token.find_first_of("eE");
+        bool underflow = exponent != std::string::npos && token[exponent + 1] == '-';
+        value = underflow ? 0.0 : std::copysign(HUGE_VAL, token[0] == '-' ? -1.0 : 1.0);
+        return true;
+    }
+
+    return result.ec == std::errc{};
+}
+
+/// Appends a code point to a string, encoded in UTF-8.
+static void appendUtf8(std::string& str, std::uint32_t codepoint)
+{
+    if (codepoint < 0x80)
+    {
+        str += static_cast<char>(codepoint);
+    }
+    else if (codepoint < 0x800)
+    {
+        str += static_cast<char>(0xC0 | (codepoint >> 6));
+        str += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+    else if (codepoint < 0x10000)
+    {
+        str += static_cast<char>(0xE0 | (codepoint >> 12));
+        str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+    else
+    {
+        str += static_cast<char>(0xF0 | (codepoint >> 18));
+        str += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        str += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
 
 JSONDeserializer::JSONDeserializer(const std::string& src)
+    : mStream(nullptr)
+    , mSeekable(false)
+    , mBuffer(src.begin(), src.end())
+    , mBase(0)
+    , mPos(0)
+    , mEnd(src.size())
+    , mScanning(false)
+    , mDropped(false)
+{
+}
+
+JSONDeserializer::JSONDeserializer(memory::Stream& stream)
+    : mStream(&stream)
+    , mSeekable(stream.tell() != SIZE_MAX)
+    , mBase(mSeekable ? stream.tell() : 0)
+    , mPos(0)
+    , mEnd(0)
+    , mScanning(false)
+    , mDropped(false)
 {
-    CHECK_ERROR(do {
-        mJson = nlohmann::ordered_json::array();
-        mJson.push_back(nlohmann::ordered_json::parse(src));
-        mFrame.push({Mode::Array, mJson.begin(), false});
-    } while (false););
 }
 
 void JSONDeserializer::readI8(int8_t& value)
 {
-    READ_GENERIC(value, int8_t, std::stoi);
+    this->readInteger(value);
 }
 
 void JSONDeserializer::readI16(int16_t& value)
 {
-    READ_GENERIC(value, int16_t, std::stoi);
+    this->readInteger(value);
 }
 
 void JSONDeserializer::readI32(int32_t& value)
 {
-    READ_GENERIC(value, int32_t, std::stol);
+    this->readInteger(value);
 }
 
 void JSONDeserializer::readI64(int64_t& value)
 {
-    READ_GENERIC(value, int64_t, std::stoll);
+    this->readInteger(value);
 }
 
 void JSONDeserializer::readU8(uint8_t& value)
 {
-    READ_GENERIC(value, uint8_t, std::stoul);
+    this->readInteger(value);
 }
 
 void JSONDeserializer::readU16(uint16_t& value)
 {
-    READ_GENERIC(value, uint16_t, std::stoul);
+    this->readInteger(value);
 }
 
 void JSONDeserializer::readU32(uint32_t& value)
 {
-    READ_GENERIC(value, uint32_t, std::stoul);
+    this->readInteger(value);
 }
 
 void JSONDeserializer::readU64(uint64_t& value)
 {
-    READ_GENERIC(value, uint64_t, std::stoull);
+    this->readInteger(value);
 }
 
 void JSONDeserializer::readF32(float& value)
 {
-    READ_GENERIC(value, float, std::stof);
+    this->readFloat(value);
 }
 
 void JSONDeserializer::readF64(double& value)
 {
-    READ_GENERIC(value, double, std::stod);
+    this->readFloat(value);
 }
 
 void JSONDeserializer::readBool(bool& value)
 {
-    READ_GENERIC(value, bool, [](const std::string& s) { return s == "true"; });
+    if (this->failedBefore())
+    {
+        return;
+    }
+
+    auto item = this->nextItem();
+    if (item == Item::Key)
+    {
+        value = mKey == "true";
+    }
+    else if (item == Item::Value && this->parseToken())
+    {
+        if (mToken == "true" || mToken == "false")
+        {
+            value = mToken == "true";
+        }
+        else
+        {
+            this->error("expected a boolean");
+        }
+    }
 }
 
 void JSONDeserializer::readString(std::string& value)
 {
-    READ_GENERIC(value, std::string, [](const std::string& s) { return s; });
+    if (this->failedBefore())
+    {
+        return;
+    }
+
+    auto item = this->nextItem();
+    if (item == Item::Key)
+    {
+        value = mKey;
+    }
+    else if (item == Item::Value)
+    {
+        if (this->peek() != '"')
+        {
+            this->error("expected a string");
+            return;
+        }
+
+        this->parseString(value);
+    }
 }
 
 void JSONDeserializer::beginObject()
 {
-    assert(!mFrame.top().key); // Objects can't be used as keys.
+    if (this->failedBefore() || !this->nextValue("objects can't be used as keys"))
+    {
+        return;
+    }
+
+    // Arrays are also accepted, in which case the fields are read in order without names.
+    auto open = this->peek();
+    if (open != '{' && open != '[')
+    {
+        this->error("expected an object");
+        return;
+    }
 
-    CHECK_ERROR(do {
-        auto iter = mFrame.top().iter.value().begin();
-        mFrame.push({Mode::Object, std::move(iter), false});
-    } while (false););
+    // Objects don't need their count, but may have been counted by a previous scan.
+    if (!mCounts.empty())
+    {
+        mCounts.pop_front();
+    }
+
+    mPos += 1;
+    mFrames.push_back({Mode::Object, open == '{' ? '}' : ']', true, false, open == '{'});
 }
 
 void JSONDeserializer::endObject()
 {
-    assert(mFrame.size() > 1);
+    assert(!mFrames.empty());
 
-    CHECK_ERROR(do {
-        mFrame.pop();
-        mFrame.top().iter++;
-        if (mFrame.top().mode == Mode::Dictionary)
-        {
-            mFrame.top().key = true;
-        }
-    } while (false););
+    if (!this->failedBefore())
+    {
+        this->endFrame();
+    }
 }
 
 std::size_t JSONDeserializer::beginArray()
 {
-    assert(!mFrame.top().key); // Arrays can't be used as keys.
+    if (this->failedBefore() || !this->nextValue("arrays can't be used as keys"))
+    {
+        return 0;
+    }
 
-    CHECK_ERROR(do {
-        auto iter = mFrame.top().iter.value().begin();
-        auto len = mFrame.top().iter.value().size();
-        mFrame.push({Mode::Array, std::move(iter), false});
-        return len;
-    } while (false););
+    if (this->peek() != '[')
+    {
+        this->error("expected an array");
+        return 0;
+    }
 
-    return 0;
+    auto count = this->takeCount();
+    if (mFailBit)
+    {
+        return 0;
+    }
+
+    mPos += 1;
+    mFrames.push_back({Mode::Array, ']', true, false, false});
+    return count;
 }
 
 void JSONDeserializer::endArray()
 {
-    assert(mFrame.size() > 1);
+    assert(!mFrames.empty());
 
-    CHECK_ERROR(do {
-        mFrame.pop();
-        mFrame.top().iter++;
-        if (mFrame.top().mode == Mode::Dictionary)
-        {
-            mFrame.top().key = true;
-        }
-    } while (false););
+    if (!this->failedBefore())
+    {
+        this->endFrame();
+    }
 }
 
 std::size_t JSONDeserializer::beginDictionary()
 {
-    assert(!mFrame.top().key); // Dictionaries can't be used as keys.
+    if (this->failedBefore() || !this->nextValue("dictionaries can't be used as keys"))
+    {
+        return 0;
+    }
 
-    CHECK_ERROR(do {
-        auto iter = mFrame.top().iter.value().begin();
-        auto len = mFrame.top().iter.value().size();
-        mFrame.push({Mode::Dictionary, std::move(iter), true});
-        return len;
-    } while (false););
+    if (this->peek() != '{')
+    {
+        this->error("expected a dictionary");
+        return 0;
+    }
 
-    return 0;
+    auto count = this->takeCount();
+    if (mFailBit)
+    {
+        return 0;
+    }
+
+    mPos += 1;
+    mFrames.push_back({Mode::Dictionary, '}', true, true, false});
+    return count;
 }
 
 void JSONDeserializer::endDictionary()
 {
-    assert(mFrame.size() > 1);
+    assert(!mFrames.empty());
+
+    if (!this->failedBefore())
+    {
+        this->endFrame();
+    }
+}
+
+bool JSONDeserializer::failedBefore()
+{
+    if (mFailBit)
+    {
+        CUBOS_WARN("Deserializer fail bit is set");
+        return true;
+    }
+
+    return false;
+}
+
+void JSONDeserializer::error(const char* message)
+{
+    CUBOS_ERROR("Could not deserialize JSON at byte {}: {}", mBase + mPos, message);
+    mFailBit = true;
+}
+
+bool JSONDeserializer::refill()
+{
+    if (mPos < mEnd)
+    {
+        return true;
+    }
+
+    if (mStream == nullptr)
+    {
+        return false;
+    }
+
+    // The consumed data can be discarded, unless it is going to be read again.
+    if (!mScanning || (mSeekable && mEnd >= ScanWindow))
+    {
+        mDropped = mDropped || mScanning;
+        mBase += mEnd;
+        mPos = 0;
+        mEnd = 0;
+    }
+
+    if (mBuffer.size() < mEnd + ChunkSize)
+    {
+        mBuffer.resize(mEnd + ChunkSize);
+    }
+
+    auto read = mStream->read(mBuffer.data() + mEnd, ChunkSize);
+    mEnd += read;
+    return read > 0;
+}
+
+char JSONDeserializer::peek()
+{
+    return this->refill() ? mBuffer[mPos] : '\0';
+}
+
+char JSONDeserializer::peekToken()
+{
+    while (this->refill())
+    {
+        auto c = mBuffer[mPos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+        {
+            return c;
+        }
+        mPos += 1;
+    }
+
+    return '\0';
+}
+
+bool JSONDeserializer::expect(char expected, const char* message)
+{
+    if (this->peekToken() != expected)
+    {
+        this->error(message);
+        return false;
+    }
+
+    mPos += 1;
+    return true;
+}
+
+JSONDeserializer::Item JSONDeserializer::nextItem()
+{
+    if (mFrames.empty())
+    {
+        if (this->peekToken() == '\0')
+        {
+            this->error("unexpected end of source");
+            return Item::Error;
+        }
+
+        return Item::Value;
+    }
+
+    auto& frame = mFrames.back();
+    if (frame.mode == Mode::Dictionary && !frame.key)
+    {
+        // The key has already been read, along with the colon after it.
+        frame.key = true;
+        this->peekToken();
+        return Item::Value;
+    }
+
+    if (!frame.first && !this->expect(',', "expected ',', there are fewer elements than were read"))
+    {
+        return Item::Error;
+    }
+    frame.first = false;
+
+    if (frame.mode == Mode::Dictionary || frame.named)
+    {
+        if (this->peekToken() != '"')
+        {
+            this->error("expected a key");
+            return Item::Error;
+        }
+
+        if (!this->parseString(mKey) || !this->expect(':', "expected ':'"))
+        {
+            return Item::Error;
+        }
+
+        if (frame.mode == Mode::Dictionary)
+        {
+            frame.key = false;
+            return Item::Key;
+        }
+    }
+
+    this->peekToken();
+    return Item::Value;
+}
+
+bool JSONDeserializer::nextValue(const char* message)
+{
+    auto item = this->nextItem();
+    if (item == Item::Key)
+    {
+        this->error(message);
+    }
+    return item == Item::Value;
+}
 
-    CHECK_ERROR(do {
-        mFrame.pop();
-        mFrame.top().iter++;
-        if (mFrame.top().mode == Mode::Dictionary)
+bool JSONDeserializer::parseString(std::string& str)
+{
+    // Reads the four hexadecimal digits of an escaped code unit.
+    auto parseHex = [this](std::uint32_t& unit) {
+        unit = 0;
+        for (int i = 0; i < 4; ++i)
         {
-            mFrame.top().key = true;
+            auto c = this->peek();
+            std::uint32_t digit;
+            if (c >= '0' && c <= '9')
+            {
+                digit = static_cast<std::uint32_t>(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                digit = static_cast<std::uint32_t>(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                digit = static_cast<std::uint32_t>(c - 'A' + 10);
+            }
+            else
+            {
+                this->error("invalid unicode escape sequence");
+                return false;
+            }
+
+            unit = (unit << 4) | digit;
+            mPos += 1;
+        }
+        return true;
+    };
+
+    str.clear();
+    mPos += 1; // Skip the opening quote.
+    while (true)
+    {
+        if (!this->refill())
+        {
+            this->error("unterminated string");
+            return false;
         }
-    } while (false););
+
+        // Copy every character until the next quote or escape sequence at once.
+        auto start = mPos;
+        while (mPos < mEnd && mBuffer[mPos] != '"' && mBuffer[mPos] != '\\')
+        {
+            mPos += 1;
+        }
+        str.append(mBuffer.data() + start, mPos - start);
+        if (mPos == mEnd)
+        {
+            continue;
+        }
+
+        if (mBuffer[mPos++] == '"')
+        {
+            return true;
+        }
+
+        if (!this->refill())
+        {
+            this->error("unterminated string");
+            return false;
+        }
+
+        auto escaped = mBuffer[mPos++];
+        switch (escaped)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            str += escaped;
+            break;
+        case 'b':
+            str += '\b';
+            break;
+        case 'f':
+            str += '\f';
+            break;
+        case 'n':
+            str += '\n';
+            break;
+        case 'r':
+            str += '\r';
+            break;
+        case 't':
+            str += '\t';
+            break;
+        case 'u': {
+            std::uint32_t codepoint;
+            if (!parseHex(codepoint))
+            {
+                return false;
+            }
+
+            // Code points outside of the BMP are escaped as surrogate pairs.
+            if (codepoint >= 0xD800 && codepoint < 0xDC00)
+            {
+                if (this->peek() != '\\')
+                {
+                    this->error("invalid surrogate pair");
+                    return false;
+                }
+                mPos += 1;
+
+                std::uint32_t low;
+                if (this->peek() != 'u')
+                {
+                    this->error("invalid surrogate pair");
+                    return false;
+                }
+                mPos += 1;
+
+                if (!parseHex(low))
+                {
+                    return false;
+                }
+
+                if (low < 0xDC00 || low >= 0xE000)
+                {
+                    this->error("invalid surrogate pair");
+                    return false;
+                }
+
+                codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+
+            appendUtf8(str, codepoint);
+            break;
+        }
+        default:
+            this->error("invalid escape sequence");
+            return false;
+        }
+    }
+}
+
+bool JSONDeserializer::parseToken()
+{
+    mToken.clear();
+    while (true)
+    {
+        auto c = this->peek();
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' || c == '+' ||
+            c == '.')
+        {
+            mToken += c;
+            mPos += 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (mToken.empty())
+    {
+        this->error("expected a value");
+        return false;
+    }
+
+    return true;
+}
+
+void JSONDeserializer::skipValue()
+{
+    auto c = this->peek();
+    if (c == '"')
+    {
+        this->parseString(mToken);
+        return;
+    }
+
+    if (c != '[' && c != '{')
+    {
+        this->parseToken();
+        return;
+    }
+
+    // Skip the whole container, along with the counts of every container nested in it.
+    std::size_t depth = 0;
+    do
+    {
+        c = this->peek();
+        if (c == '\0')
+        {
+            this->error("unexpected end of source");
+            return;
+        }
+
+        if (c == '"')
+        {
+            if (!this->parseString(mToken))
+            {
+                return;
+            }
+            continue;
+        }
+
+        mPos += 1;
+        if (c == '[' || c == '{')
+        {
+            depth += 1;
+            if (!mCounts.empty())
+            {
+                mCounts.pop_front();
+            }
+        }
+        else if (c == ']' || c == '}')
+        {
+            depth -= 1;
+        }
+    } while (depth > 0);
+}
+
+void JSONDeserializer::endFrame()
+{
+    // Skip any elements which weren't read.
+    while (true)
+    {
+        const auto& frame = mFrames.back();
+        if (frame.mode != Mode::Dictionary || frame.key)
+        {
+            auto c = this->peekToken();
+            if (c == frame.close)
+            {
+                break;
+            }
+
+            if (c == '\0')
+            {
+                this->error("unexpected end of source");
+                return;
+            }
+        }
+
+        auto item = this->nextItem();
+        if (item == Item::Value)
+        {
+            this->skipValue();
+        }
+
+        if (mFailBit)
+        {
+            return;
+        }
+    }
+
+    mPos += 1;
+    mFrames.pop_back();
+}
+
+bool JSONDeserializer::scanCounts()
+{
+    /// Container which is still open during the scan.
+    struct Open
+    {
+        std::size_t index;  ///< Index of its count in mCounts.
+        std::size_t commas; ///< Number of commas found directly inside it.
+        bool empty;         ///< Whether nothing has been found inside it yet.
+    };
+
+    std::vector<Open> open;
+    do
+    {
+        if (!this->refill())
+        {
+            this->error("unexpected end of source");
+            return false;
+        }
+
+        auto c = mBuffer[mPos++];
+        switch (c)
+        {
+        case '"':
+            // Skip the string, as it may contain brackets and commas.
+            for (bool escaped = false;;)
+            {
+                if (!this->refill())
+                {
+                    this->error("unterminated string");
+                    return false;
+                }
+
+                auto s = mBuffer[mPos++];
+                if (escaped)
+                {
+                    escaped = false;
+                }
+                else if (s == '\\')
+                {
+                    escaped = true;
+                }
+                else if (s == '"')
+                {
+                    break;
+                }
+            }
+            open.back().empty = false;
+            break;
+        case '[':
+        case '{':
+            if (!open.empty())
+            {
+                open.back().empty = false;
+            }
+            mCounts.push_back(0);
+            open.push_back({mCounts.size() - 1, 0, true});
+            break;
+        case ']':
+        case '}':
+            mCounts[open.back().index] = open.back().empty ? 0 : open.back().commas + 1;
+            open.pop_back();
+            break;
+        case ',':
+            open.back().commas += 1;
+            break;
+        case ' ':
+        case '\n':
+        case '\r':
+        case '\t':
+        case ':':
+            break;
+        default:
+            open.back().empty = false;
+            break;
+        }
+    } while (!open.empty());
+
+    return true;
+}
+
+std::size_t JSONDeserializer::takeCount()
+{
+    if (mCounts.empty())
+    {
+        // Keep the buffer while scanning, so that the container can be read afterwards. If it
+        // grows too large, it is dropped instead, and the stream is seeked back.
+        auto start = mBase + mPos;
+        mScanning = true;
+        mDropped = false;
+        auto scanned = this->scanCounts();
+        mScanning = false;
+
+        if (!scanned)
+        {
+            mCounts.clear();
+            return 0;
+        }
+
+        if (mDropped)
+        {
+            mStream->seek(static_cast<ptrdiff_t>(start), memory::SeekOrigin::Begin);
+            mBase = start;
+            mPos = 0;
+            mEnd = 0;
+            this->refill(); // The caller expects the opening bracket to be buffered.
+        }
+        else
+        {
+            mPos = start - mBase;
+        }
+    }
+
+    auto count = mCounts.front();
+    mCounts.pop_front();
+    return count;
+}
+
+template <typename T>
+void JSONDeserializer::readInteger(T& value)
+{
+    if (this->failedBefore())
+    {
+        return;
+    }
+
+    auto item = this->nextItem();
+    if (item == Item::Error || (item == Item::Value && !this->parseToken()))
+    {
+        return;
+    }
+
+    const auto& token = item == Item::Key ? mKey : mToken;
+    const auto* first = token.data();
+    const auto* last = token.data() + token.size();
+
+    // Numbers with a fractional part or an exponent are truncated.
+    if (token.find_first_of(".eE") != std::string::npos)
+    {
+        double real;
+        if (!parseDouble(token, real))
+        {
+            this->error("expected an integer");
+            return;
+        }
+
+        value = static_cast<T>(real);
+        return;
+    }
+
+    // Parse through the widest integer type of the same signedness, and then narrow it.
+    std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t> integer = 0;
+    auto result = std::from_chars(first, last, integer);
+    if (result.ec != std::errc{} || result.ptr != last)
+    {
+        this->error("expected an integer");
+        return;
+    }
+
+    value = static_cast<T>(integer);
+}
+
+template <typename T>
+void JSONDeserializer::readFloat(T& value)
+{
+    if (this->failedBefore())
+    {
+        return;
+    }
+
+    auto item = this->nextItem();
+    if (item == Item::Error || (item == Item::Value && !this->parseToken()))
+    {
+        return;
+    }
+
+    const auto& token = item == Item::Key ? mKey : mToken;
+    double real;
+    if (!parseDouble(token, real))
+    {
+        this->error("expected a number");
+        return;
+    }
+
+    value = static_cast<T>(real);
 }
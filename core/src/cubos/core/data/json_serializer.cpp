@@ -1,151 +1,208 @@
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
 #include <cubos/core/data/json_serializer.hpp>
 #include <cubos/core/log.hpp>
 
 using namespace cubos::core::data;
 
+/// Size above which the buffer is written to the stream, even if no top-level value has ended.
+static const std::size_t FlushSize = 16384;
+
+/// Size of the buffers to which numbers are formatted, enough for any 64 bit integer or double.
+static const std::size_t NumberSize = 32;
+
+/// Formats an integer.
+template <typename T>
+static std::size_t formatInteger(char* buf, T value)
+{
+    return static_cast<std::size_t>(std::to_chars(buf, buf + NumberSize, value).ptr - buf);
+}
+
+/// Formats a floating point number with the shortest representation which reads back as the same
+/// value. Always includes a decimal point or an exponent, so that it isn't read as an integer.
+template <typename T>
+static std::size_t formatFloat(char* buf, T value)
+{
+    if (!std::isfinite(value))
+    {
+        // JSON has no representation for these values.
+        std::memcpy(buf, "null", 4);
+        return 4;
+    }
+
+    auto* end = std::to_chars(buf, buf + NumberSize - 2, value).ptr;
+    if (std::find_if(buf, end, [](char c) { return c == '.' || c == 'e'; }) == end)
+    {
+        *end++ = '.';
+        *end++ = '0';
+    }
+    return static_cast<std::size_t>(end - buf);
+}
+
 JSONSerializer::JSONSerializer(memory::Stream& stream, int indent)
     : mStream(stream)
     , mIndent(indent)
+    , mKeyDepth(0)
 {
     // Do nothing.
 }
 
+JSONSerializer::~JSONSerializer()
+{
+    this->flush();
+}
+
+void JSONSerializer::flush()
+{
+    if (!mBuffer.empty())
+    {
+        mStream.write(mBuffer.data(), mBuffer.size());
+        mBuffer.clear();
+    }
+}
+
 void JSONSerializer::writeI8(int8_t value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatInteger(buf, value), name);
 }
 
 void JSONSerializer::writeI16(int16_t value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatInteger(buf, value), name);
 }
 
 void JSONSerializer::writeI32(int32_t value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatInteger(buf, value), name);
 }
 
 void JSONSerializer::writeI64(int64_t value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatInteger(buf, value), name);
 }
 
 void JSONSerializer::writeU8(uint8_t value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatInteger(buf, value), name);
 }
 
 void JSONSerializer::writeU16(uint16_t value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatInteger(buf, value), name);
 }
 
 void JSONSerializer::writeU32(uint32_t value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatInteger(buf, value), name);
 }
 
 void JSONSerializer::writeU64(uint64_t value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatInteger(buf, value), name);
 }
 
 void JSONSerializer::writeF32(float value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatFloat(buf, value), name);
 }
 
 void JSONSerializer::writeF64(double value, const char* name)
 {
-    this->writeJSON(value, name);
+    char buf[NumberSize];
+    this->writePrimitive(buf, formatFloat(buf, value), name);
 }
 
 void JSONSerializer::writeBool(bool value, const char* name)
 {
-    this->writeJSON(value, name);
+    this->writePrimitive(value ? "true" : "false", value ? 4 : 5, name);
 }
 
 void JSONSerializer::writeString(const char* value, const char* name)
 {
     assert(value != nullptr);
-    this->writeJSON(value, name);
+    auto key = this->beginValue(name);
+    this->writeQuoted(value, std::strlen(value));
+    if (key)
+    {
+        this->writeKeySeparator();
+    }
+    else
+    {
+        this->endValue();
+    }
 }
 
-#undef WRITE_PRIMITIVE
-
 void JSONSerializer::beginObject(const char* name)
 {
-    mFrames.push({Mode::Object, nlohmann::ordered_json::object(), nullptr, name != nullptr ? name : ""});
+    this->beginContainer(Mode::Object, '{', name);
 }
 
 void JSONSerializer::endObject()
 {
-    assert(!mFrames.empty() && mFrames.top().mode == Mode::Object); // endObject without matching beginObject.
-    auto json = std::move(mFrames.top().json);
-    auto name = std::move(mFrames.top().name);
-    mFrames.pop();
-    this->writeJSON(std::move(json), name.empty() ? nullptr : name.c_str());
+    assert(!mFrames.empty() && mFrames.back().mode == Mode::Object); // endObject without matching beginObject.
+    this->endContainer('}');
 }
 
 void JSONSerializer::beginArray(std::size_t /*length*/, const char* name)
 {
-    mFrames.push({Mode::Array, nlohmann::ordered_json::array(), nullptr, name != nullptr ? name : ""});
+    this->beginContainer(Mode::Array, '[', name);
 }
 
 void JSONSerializer::endArray()
 {
-    assert(!mFrames.empty() && mFrames.top().mode == Mode::Array); // endArray without matching beginArray.
-    auto json = std::move(mFrames.top().json);
-    auto name = std::move(mFrames.top().name);
-    mFrames.pop();
-    this->writeJSON(std::move(json), name.empty() ? nullptr : name.c_str());
+    assert(!mFrames.empty() && mFrames.back().mode == Mode::Array); // endArray without matching beginArray.
+    this->endContainer(']');
 }
 
 void JSONSerializer::beginDictionary(std::size_t /*length*/, const char* name)
 {
-    mFrames.push({Mode::Dictionary, nlohmann::ordered_json::object(), nullptr, name != nullptr ? name : ""});
+    this->beginContainer(Mode::Dictionary, '{', name);
 }
 
 void JSONSerializer::endDictionary()
 {
     assert(!mFrames.empty() &&
-           mFrames.top().mode == Mode::Dictionary); // endDictionary without matching beginDictionary.
-    auto json = std::move(mFrames.top().json);
-    auto name = std::move(mFrames.top().name);
-    mFrames.pop();
-    this->writeJSON(std::move(json), name.empty() ? nullptr : name.c_str());
+           mFrames.back().mode == Mode::Dictionary); // endDictionary without matching beginDictionary.
+    this->endContainer('}');
 }
 
-void JSONSerializer::writeJSON(nlohmann::ordered_json&& json, const char* name)
+bool JSONSerializer::beginValue(const char* name)
 {
     if (mFrames.empty())
     {
-        mStream.print(json.dump(mIndent));
+        return false;
     }
-    else if (mFrames.top().mode == Mode::Dictionary)
+
+    auto& frame = mFrames.back();
+    if (frame.mode == Mode::Dictionary)
     {
-        if (mFrames.top().key.is_null())
+        // Keys and values alternate, and the separator between them is written after the key.
+        auto isKey = frame.key;
+        frame.key = !frame.key;
+        if (isKey)
         {
-            if (json.is_string())
-            {
-                mFrames.top().key = std::move(json);
-            }
-            else
-            {
-                mFrames.top().key = json.dump();
-            }
-        }
-        else
-        {
-            mFrames.top().json.emplace(std::move(mFrames.top().key), std::move(json));
-            mFrames.top().key = nullptr;
+            this->writeElementSeparator();
+            return true;
         }
     }
-    else if (mFrames.top().mode == Mode::Array)
+    else if (frame.mode == Mode::Array)
     {
-        mFrames.top().json.emplace_back(std::move(json));
+        this->writeElementSeparator();
     }
-    else if (mFrames.top().mode == Mode::Object)
+    else if (frame.mode == Mode::Object)
     {
         if (name == nullptr)
         {
@@ -153,6 +210,147 @@ void JSONSerializer::writeJSON(nlohmann::ordered_json&& json, const char* name)
             abort();
         }
 
-        mFrames.top().json.emplace(name, std::move(json));
+        this->writeElementSeparator();
+        this->writeQuoted(name, std::strlen(name));
+        this->writeKeySeparator();
+    }
+
+    return false;
+}
+
+void JSONSerializer::endValue()
+{
+    // Keys must stay in the buffer until they end, as they're converted to strings.
+    if (mKeyDepth == 0 && (mFrames.empty() || mBuffer.size() >= FlushSize))
+    {
+        this->flush();
+    }
+}
+
+void JSONSerializer::writePrimitive(const char* text, std::size_t size, const char* name)
+{
+    if (this->beginValue(name))
+    {
+        // Dictionary keys must be strings.
+        this->writeQuoted(text, size);
+        this->writeKeySeparator();
+    }
+    else
+    {
+        mBuffer.append(text, size);
+        this->endValue();
+    }
+}
+
+void JSONSerializer::writeQuoted(const char* str, std::size_t size)
+{
+    static const char* hex = "0123456789abcdef";
+
+    mBuffer += '"';
+    auto* end = str + size;
+    while (str != end)
+    {
+        // Copy every character which needs no escaping at once.
+        const auto* run = str;
+        while (str != end && *str != '"' && *str != '\\' && static_cast<unsigned char>(*str) >= 0x20)
+        {
+            ++str;
+        }
+        mBuffer.append(run, static_cast<std::size_t>(str - run));
+        if (str == end)
+        {
+            break;
+        }
+
+        auto c = *str++;
+        switch (c)
+        {
+        case '"':
+            mBuffer += "\\\"";
+            break;
+        case '\\':
+            mBuffer += "\\\\";
+            break;
+        case '\b':
+            mBuffer += "\\b";
+            break;
+        case '\f':
+            mBuffer += "\\f";
+            break;
+        case '\n':
+            mBuffer += "\\n";
+            break;
+        case '\r':
+            mBuffer += "\\r";
+            break;
+        case '\t':
+            mBuffer += "\\t";
+            break;
+        default:
+            mBuffer += "\\u00";
+            mBuffer += hex[(c >> 4) & 0xF];
+            mBuffer += hex[c & 0xF];
+            break;
+        }
+    }
+    mBuffer += '"';
+}
+
+void JSONSerializer::writeKeySeparator()
+{
+    mBuffer += mIndent >= 0 && mKeyDepth == 0 ? ": " : ":";
+}
+
+void JSONSerializer::writeElementSeparator()
+{
+    auto& frame = mFrames.back();
+    if (!frame.first)
+    {
+        mBuffer += ',';
+    }
+    frame.first = false;
+    this->writeNewLine(mFrames.size());
+}
+
+void JSONSerializer::writeNewLine(std::size_t depth)
+{
+    // Keys are always written without whitespace.
+    if (mIndent >= 0 && mKeyDepth == 0)
+    {
+        mBuffer += '\n';
+        mBuffer.append(depth * static_cast<std::size_t>(mIndent), ' ');
+    }
+}
+
+void JSONSerializer::beginContainer(Mode mode, char open, const char* name)
+{
+    auto isKey = this->beginValue(name);
+    mFrames.push_back({mode, true, mode == Mode::Dictionary, isKey, mBuffer.size()});
+    mKeyDepth += isKey ? 1 : 0;
+    mBuffer += open;
+}
+
+void JSONSerializer::endContainer(char close)
+{
+    auto frame = mFrames.back();
+    if (!frame.first)
+    {
+        this->writeNewLine(mFrames.size() - 1);
+    }
+    mBuffer += close;
+    mFrames.pop_back();
+
+    if (frame.isKey)
+    {
+        // Containers used as keys are converted to strings with their JSON representation.
+        auto json = mBuffer.substr(frame.start);
+        mBuffer.resize(frame.start);
+        mKeyDepth -= 1;
+        this->writeQuoted(json.data(), json.size());
+        this->writeKeySeparator();
+    }
+    else
+    {
+        this->endValue();
     }
 }
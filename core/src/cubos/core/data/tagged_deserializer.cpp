@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include <cubos/core/data/tagged_deserializer.hpp>
+#include <cubos/core/log.hpp>
+#include <cubos/core/memory/endianness.hpp>
+
+using namespace cubos::core;
+using namespace cubos::core::data;
+
+/// Maximum number of bytes of a variable-length 64 bit integer.
+static const std::size_t MaxVarintSize = 10;
+
+/// Number of bytes by which strings grow while being read, when their size can't be checked.
+static const std::size_t StringChunkSize = 4096;
+
+TaggedDeserializer::TaggedDeserializer(memory::Stream& stream)
+    : mStream(stream)
+    , mOffset(0)
+    , mHasKey(false)
+    , mKeyType(TaggedType::Varint)
+{
+    // Do nothing.
+}
+
+bool TaggedDeserializer::nextField(uint32_t& id)
+{
+    assert(!mHasKey); // The value of the previous field wasn't read or skipped.
+    if (mEnds.empty() || mOffset >= mEnds.back())
+    {
+        return false;
+    }
+
+    uint64_t key;
+    if (!this->readVarint(key))
+    {
+        return false;
+    }
+
+    id = static_cast<uint32_t>(key >> 3);
+    mKeyType = static_cast<TaggedType>(key & 0x7);
+    mHasKey = true;
+    return true;
+}
+
+void TaggedDeserializer::skipField()
+{
+    assert(mHasKey); // skipField without nextField.
+    mHasKey = false;
+
+    uint64_t value;
+    switch (mKeyType)
+    {
+    case TaggedType::Varint:
+        this->readVarint(value);
+        return;
+    case TaggedType::Fixed32:
+        value = 4;
+        break;
+    case TaggedType::Fixed64:
+        value = 8;
+        break;
+    case TaggedType::Bytes:
+        if (!this->readVarint(value) || !this->checkSize(value))
+        {
+            return;
+        }
+        break;
+    default:
+        CUBOS_ERROR("Could not skip field with unknown wire type {}", static_cast<int>(mKeyType));
+        mFailBit = true;
+        return;
+    }
+
+    mStream.ignore(static_cast<std::size_t>(value));
+    mOffset += static_cast<std::size_t>(value);
+}
+
+void TaggedDeserializer::readI8(int8_t& value)
+{
+    int64_t read;
+    if (this->readSigned(read, std::numeric_limits<int8_t>::min(), std::numeric_limits<int8_t>::max()))
+    {
+        value = static_cast<int8_t>(read);
+    }
+}
+
+void TaggedDeserializer::readI16(int16_t& value)
+{
+    int64_t read;
+    if (this->readSigned(read, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max()))
+    {
+        value = static_cast<int16_t>(read);
+    }
+}
+
+void TaggedDeserializer::readI32(int32_t& value)
+{
+    int64_t read;
+    if (this->readSigned(read, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()))
+    {
+        value = static_cast<int32_t>(read);
+    }
+}
+
+void TaggedDeserializer::readI64(int64_t& value)
+{
+    this->readSigned(value, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
+}
+
+void TaggedDeserializer::readU8(uint8_t& value)
+{
+    uint64_t read;
+    if (this->readUnsigned(read, std::numeric_limits<uint8_t>::max()))
+    {
+        value = static_cast<uint8_t>(read);
+    }
+}
+
+void TaggedDeserializer::readU16(uint16_t& value)
+{
+    uint64_t read;
+    if (this->readUnsigned(read, std::numeric_limits<uint16_t>::max()))
+    {
+        value = static_cast<uint16_t>(read);
+    }
+}
+
+void TaggedDeserializer::readU32(uint32_t& value)
+{
+    uint64_t read;
+    if (this->readUnsigned(read, std::numeric_limits<uint32_t>::max()))
+    {
+        value = static_cast<uint32_t>(read);
+    }
+}
+
+void TaggedDeserializer::readU64(uint64_t& value)
+{
+    this->readUnsigned(value, std::numeric_limits<uint64_t>::max());
+}
+
+void TaggedDeserializer::readF32(float& value)
+{
+    float read;
+    if (this->readKey(TaggedType::Fixed32) && this->readRaw(&read, sizeof(read)))
+    {
+        value = memory::fromLittleEndian(read);
+    }
+}
+
+void TaggedDeserializer::readF64(double& value)
+{
+    double read;
+    if (this->readKey(TaggedType::Fixed64) && this->readRaw(&read, sizeof(read)))
+    {
+        value = memory::fromLittleEndian(read);
+    }
+}
+
+void TaggedDeserializer::readBool(bool& value)
+{
+    uint64_t read;
+    if (this->readUnsigned(read, 1))
+    {
+        value = read != 0;
+    }
+}
+
+void TaggedDeserializer::readString(std::string& value)
+{
+    uint64_t size;
+    if (!this->readKey(TaggedType::Bytes) || !this->readVarint(size) || !this->checkSize(size))
+    {
+        return;
+    }
+
+    // Top-level strings have no container to check their size against, so the string only grows
+    // as its bytes are actually read.
+    std::string read;
+    while (read.size() < size)
+    {
+        auto offset = read.size();
+        auto chunk = static_cast<std::size_t>(std::min<uint64_t>(size - offset, StringChunkSize));
+        read.resize(offset + chunk);
+        if (!this->readRaw(read.data() + offset, chunk))
+        {
+            return;
+        }
+    }
+    value = std::move(read);
+}
+
+void TaggedDeserializer::beginObject()
+{
+    this->beginContainer(false);
+}
+
+void TaggedDeserializer::endObject()
+{
+    this->endContainer();
+}
+
+std::size_t TaggedDeserializer::beginArray()
+{
+    return this->beginContainer(true);
+}
+
+void TaggedDeserializer::endArray()
+{
+    this->endContainer();
+}
+
+std::size_t TaggedDeserializer::beginDictionary()
+{
+    return this->beginContainer(true);
+}
+
+void TaggedDeserializer::endDictionary()
+{
+    this->endContainer();
+}
+
+bool TaggedDeserializer::readKey(TaggedType type)
+{
+    if (!mHasKey)
+    {
+        // Fields missing from the end of an object keep their current values.
+        if (!mEnds.empty() && mOffset >= mEnds.back())
+        {
+            return false;
+        }
+
+        uint64_t key;
+        if (!this->readVarint(key))
+        {
+            return false;
+        }
+        mKeyType = static_cast<TaggedType>(key & 0x7);
+    }
+
+    mHasKey = false;
+    if (mKeyType != type)
+    {
+        CUBOS_ERROR("Could not deserialize value: expected wire type {}, found {}", static_cast<int>(type),
+                    static_cast<int>(mKeyType));
+        mFailBit = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool TaggedDeserializer::readVarint(uint64_t& value)
+{
+    value = 0;
+    for (std::size_t i = 0; i < MaxVarintSize; ++i)
+    {
+        uint8_t byte;
+        if (!this->readRaw(&byte, 1))
+        {
+            return false;
+        }
+
+        value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    CUBOS_ERROR("Could not deserialize variable-length integer: too many bytes");
+    mFailBit = true;
+    return false;
+}
+
+bool TaggedDeserializer::readRaw(void* data, std::size_t size)
+{
+    auto read = mStream.read(data, size);
+    mOffset += read;
+    if (read != size)
+    {
+        CUBOS_ERROR("Could not deserialize value: unexpected end of stream");
+        mFailBit = true;
+        return false;
+    }
+    return true;
+}
+
+bool TaggedDeserializer::checkSize(uint64_t size)
+{
+    if (!mEnds.empty() && (mOffset > mEnds.back() || size > mEnds.back() - mOffset))
+    {
+        CUBOS_ERROR("Could not deserialize value: size {} is larger than its container", size);
+        mFailBit = true;
+        return false;
+    }
+    return true;
+}
+
+bool TaggedDeserializer::readSigned(int64_t& value, int64_t min, int64_t max)
+{
+    uint64_t zigzag;
+    if (!this->readUnsigned(zigzag, std::numeric_limits<uint64_t>::max()))
+    {
+        return false;
+    }
+
+    auto read = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+    if (read < min || read > max)
+    {
+        CUBOS_ERROR("Could not deserialize integer: {} is out of range", read);
+        mFailBit = true;
+        return false;
+    }
+
+    value = read;
+    return true;
+}
+
+bool TaggedDeserializer::readUnsigned(uint64_t& value, uint64_t max)
+{
+    uint64_t read;
+    if (!this->readKey(TaggedType::Varint) || !this->readVarint(read))
+    {
+        return false;
+    }
+
+    if (read > max)
+    {
+        CUBOS_ERROR("Could not deserialize integer: {} is out of range", read);
+        mFailBit = true;
+        return false;
+    }
+
+    value = read;
+    return true;
+}
+
+std::size_t TaggedDeserializer::beginContainer(bool length)
+{
+    uint64_t size;
+    if (!this->readKey(TaggedType::Bytes) || !this->readVarint(size))
+    {
+        // Missing containers are read as empty.
+        mEnds.push_back(mOffset);
+        return 0;
+    }
+
+    if (!this->checkSize(size))
+    {
+        mEnds.push_back(mOffset);
+        return 0;
+    }
+
+    mEnds.push_back(mOffset + static_cast<std::size_t>(size));
+    uint64_t count = 0;
+    if (length && (!this->readVarint(count) || !this->checkSize(count)))
+    {
+        // Every element takes at least one byte, so larger counts are also corrupt.
+        return 0;
+    }
+    return static_cast<std::size_t>(count);
+}
+
+void TaggedDeserializer::endContainer()
+{
+    assert(!mEnds.empty()); // endObject/endArray/endDictionary without matching begin.
+    auto end = mEnds.back();
+    mEnds.pop_back();
+
+    if (mOffset > end)
+    {
+        CUBOS_ERROR("Could not deserialize container: read past its end");
+        mFailBit = true;
+    }
+    else if (mOffset < end)
+    {
+        // Skip fields which weren't read, without parsing them.
+        mStream.ignore(end - mOffset);
+        mOffset = end;
+    }
+}
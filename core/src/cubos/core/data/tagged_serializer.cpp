@@ -0,0 +1,198 @@
+#include <cassert>
+#include <cstring>
+
+#include <cubos/core/data/fields.hpp>
+#include <cubos/core/data/tagged_serializer.hpp>
+#include <cubos/core/memory/endianness.hpp>
+
+using namespace cubos::core;
+using namespace cubos::core::data;
+
+/// Maximum number of bytes of a variable-length 64 bit integer.
+static const std::size_t MaxVarintSize = 10;
+
+/// Encodes a variable-length integer: 7 bits per byte, with the high bit set on all but the last.
+static std::size_t encodeVarint(char* buf, uint64_t value)
+{
+    std::size_t size = 0;
+    while (value >= 0x80)
+    {
+        buf[size++] = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    buf[size++] = static_cast<char>(value);
+    return size;
+}
+
+TaggedSerializer::TaggedSerializer(memory::Stream& stream)
+    : mStream(stream)
+{
+    // Do nothing.
+}
+
+TaggedSerializer::~TaggedSerializer()
+{
+    this->flush();
+}
+
+void TaggedSerializer::flush()
+{
+    if (!mBuffer.empty())
+    {
+        mFailBit |= mStream.write(mBuffer.data(), mBuffer.size()) != mBuffer.size();
+        mBuffer.clear();
+    }
+}
+
+void TaggedSerializer::writeI8(int8_t value, const char* name)
+{
+    this->writeSigned(value, name);
+}
+
+void TaggedSerializer::writeI16(int16_t value, const char* name)
+{
+    this->writeSigned(value, name);
+}
+
+void TaggedSerializer::writeI32(int32_t value, const char* name)
+{
+    this->writeSigned(value, name);
+}
+
+void TaggedSerializer::writeI64(int64_t value, const char* name)
+{
+    this->writeSigned(value, name);
+}
+
+void TaggedSerializer::writeU8(uint8_t value, const char* name)
+{
+    this->writeUnsigned(value, name);
+}
+
+void TaggedSerializer::writeU16(uint16_t value, const char* name)
+{
+    this->writeUnsigned(value, name);
+}
+
+void TaggedSerializer::writeU32(uint32_t value, const char* name)
+{
+    this->writeUnsigned(value, name);
+}
+
+void TaggedSerializer::writeU64(uint64_t value, const char* name)
+{
+    this->writeUnsigned(value, name);
+}
+
+void TaggedSerializer::writeF32(float value, const char* name)
+{
+    this->writeKey(name, TaggedType::Fixed32);
+    value = memory::toLittleEndian(value);
+    mBuffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    this->endValue();
+}
+
+void TaggedSerializer::writeF64(double value, const char* name)
+{
+    this->writeKey(name, TaggedType::Fixed64);
+    value = memory::toLittleEndian(value);
+    mBuffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    this->endValue();
+}
+
+void TaggedSerializer::writeBool(bool value, const char* name)
+{
+    this->writeUnsigned(value ? 1 : 0, name);
+}
+
+void TaggedSerializer::writeString(const char* value, const char* name)
+{
+    assert(value != nullptr);
+    auto size = std::strlen(value);
+    this->writeKey(name, TaggedType::Bytes);
+    this->writeVarint(size);
+    mBuffer.append(value, size);
+    this->endValue();
+}
+
+void TaggedSerializer::beginObject(const char* name)
+{
+    this->beginContainer(name);
+}
+
+void TaggedSerializer::endObject()
+{
+    this->endContainer();
+}
+
+void TaggedSerializer::beginArray(std::size_t length, const char* name)
+{
+    this->beginContainer(name);
+    this->writeVarint(length);
+}
+
+void TaggedSerializer::endArray()
+{
+    this->endContainer();
+}
+
+void TaggedSerializer::beginDictionary(std::size_t length, const char* name)
+{
+    this->beginContainer(name);
+    this->writeVarint(length);
+}
+
+void TaggedSerializer::endDictionary()
+{
+    this->endContainer();
+}
+
+void TaggedSerializer::writeKey(const char* name, TaggedType type)
+{
+    this->writeVarint(static_cast<uint64_t>(fieldId(name)) << 3 | static_cast<uint64_t>(type));
+}
+
+void TaggedSerializer::writeVarint(uint64_t value)
+{
+    char buf[MaxVarintSize];
+    mBuffer.append(buf, encodeVarint(buf, value));
+}
+
+void TaggedSerializer::writeSigned(int64_t value, const char* name)
+{
+    // Zig-zag encoding maps small negative numbers to small unsigned numbers.
+    auto zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    this->writeUnsigned(zigzag, name);
+}
+
+void TaggedSerializer::writeUnsigned(uint64_t value, const char* name)
+{
+    this->writeKey(name, TaggedType::Varint);
+    this->writeVarint(value);
+    this->endValue();
+}
+
+void TaggedSerializer::beginContainer(const char* name)
+{
+    this->writeKey(name, TaggedType::Bytes);
+    mStarts.push_back(mBuffer.size());
+}
+
+void TaggedSerializer::endContainer()
+{
+    assert(!mStarts.empty()); // endObject/endArray/endDictionary without matching begin.
+    auto start = mStarts.back();
+    mStarts.pop_back();
+
+    char buf[MaxVarintSize];
+    mBuffer.insert(start, buf, encodeVarint(buf, mBuffer.size() - start));
+    this->endValue();
+}
+
+void TaggedSerializer::endValue()
+{
+    if (mStarts.empty())
+    {
+        this->flush();
+    }
+}
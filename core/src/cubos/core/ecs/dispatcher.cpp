@@ -1,6 +1,8 @@
 #include <algorithm>
+#include <string>
 
 #include <cubos/core/ecs/dispatcher.hpp>
+#include <cubos/core/profiling/profiler.hpp>
 
 using namespace cubos::core::ecs;
 
@@ -231,14 +233,29 @@ void Dispatcher::callSystems(World& world, CommandBuffer& cmds)
     // We can't multi-thread this as the systems require exclusive access to the world to prepare.
     if (!mPrepared)
     {
-        for (auto& system : mSystems)
+        for (std::size_t i = 0; i < mSystems.size(); ++i)
         {
-            system->system->prepare(world);
+            mSystems[i]->system->prepare(world);
+
+            // Systems have no names, so their zones are named after their position and tags.
+            std::string name = "System " + std::to_string(i);
+            const char* separator = " (";
+            for (const auto& tag : mSystems[i]->tags)
+            {
+                name += separator + tag;
+                separator = ", ";
+            }
+            if (!mSystems[i]->tags.empty())
+            {
+                name += ')';
+            }
+            mSystems[i]->name = profiling::intern(name);
         }
 
-        for (auto& condition : mConditions)
+        for (std::size_t i = 0; i < mConditions.size(); ++i)
         {
-            condition->prepare(world);
+            mConditions[i]->prepare(world);
+            mConditionNames.push_back(profiling::intern("Condition " + std::to_string(i)));
         }
 
         mPrepared = true;
@@ -264,6 +281,7 @@ void Dispatcher::callSystems(World& world, CommandBuffer& cmds)
                     // We have a condition, check if it has run already
                     if (!mRunConditions.test(i))
                     {
+                        CUBOS_PROFILE_ZONE(mConditionNames[i]);
                         mRunConditions.set(i);
                         if (mConditions[i]->call(world, cmds))
                         {
@@ -285,10 +303,12 @@ void Dispatcher::callSystems(World& world, CommandBuffer& cmds)
 
         if (canRun)
         {
+            CUBOS_PROFILE_ZONE(system->name);
             system->system->call(world, cmds);
         }
 
         // TODO: Check synchronization concerns when this gets multithreaded
+        CUBOS_PROFILE_ZONE("Commit commands");
         cmds.commit();
     }
 }
@@ -0,0 +1,936 @@
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <cubos/core/geom/intersections.hpp>
+
+using namespace cubos::core::geom;
+
+/// Maximum number of iterations of the GJK and EPA loops.
+static const int MaxIterations = 64;
+
+/// Tolerance used to detect convergence of GJK and EPA.
+static const float Tolerance = 1e-4F;
+
+/// Squared lengths below this are considered to be zero.
+static const float Epsilon = 1e-10F;
+
+namespace
+{
+    /// @brief Point of the Minkowski difference of two shapes, along with the points which generated it.
+    struct SupportPoint
+    {
+        glm::vec3 w; ///< Point of the Minkowski difference.
+        glm::vec3 a; ///< Support point on the first shape.
+        glm::vec3 b; ///< Support point on the second shape.
+    };
+
+    /// @brief Simplex used by GJK, along with the barycentric weights of its point closest to the origin.
+    struct GjkSimplex
+    {
+        SupportPoint points[4]; ///< Vertices of the simplex.
+        float weights[4];       ///< Barycentric weights of the closest point.
+        std::size_t count = 0;  ///< Number of vertices.
+    };
+
+    /// @brief Face of the polytope expanded by EPA.
+    struct EpaFace
+    {
+        std::size_t v[3]; ///< Indices of the vertices, in counter-clockwise order seen from outside.
+        glm::vec3 normal; ///< Outward unit normal.
+        float distance;   ///< Distance from the origin to the plane of the face.
+    };
+} // namespace
+
+Convex Convex::box(const Box& box, const glm::mat4& transform, float radius)
+{
+    Convex convex;
+    convex.isBox = true;
+    convex.center = glm::vec3(transform * glm::vec4(0.0F, 0.0F, 0.0F, 1.0F));
+    for (glm::length_t i = 0; i < 3; ++i)
+    {
+        convex.axes[i] = glm::vec3(transform[i]) * box.halfSize[i];
+    }
+    convex.radius = radius;
+    return convex;
+}
+
+Convex Convex::capsule(const Capsule& capsule, const glm::mat4& transform)
+{
+    Convex convex;
+    convex.pointCount = 2;
+    convex.points[0] = glm::vec3(transform * glm::vec4(0.0F, -capsule.length / 2.0F, 0.0F, 1.0F));
+    convex.points[1] = glm::vec3(transform * glm::vec4(0.0F, capsule.length / 2.0F, 0.0F, 1.0F));
+    convex.radius = capsule.radius;
+    return convex;
+}
+
+Convex Convex::simplex(const Simplex& simplex, const glm::mat4& transform, float radius)
+{
+    Convex convex;
+    convex.pointCount = std::min(simplex.points.size(), MaxPoints);
+    for (std::size_t i = 0; i < convex.pointCount; ++i)
+    {
+        convex.points[i] = glm::vec3(transform * glm::vec4(simplex.points[i], 1.0F));
+    }
+    convex.radius = radius;
+    return convex;
+}
+
+bool Convex::empty() const
+{
+    return !isBox && pointCount == 0;
+}
+
+glm::vec3 Convex::support(const glm::vec3& direction) const
+{
+    if (isBox)
+    {
+        auto point = center;
+        for (const auto& axis : axes)
+        {
+            point += glm::dot(axis, direction) >= 0.0F ? axis : -axis;
+        }
+        return point;
+    }
+
+    auto best = points[0];
+    auto bestDot = glm::dot(best, direction);
+    for (std::size_t i = 1; i < pointCount; ++i)
+    {
+        auto dot = glm::dot(points[i], direction);
+        if (dot > bestDot)
+        {
+            best = points[i];
+            bestDot = dot;
+        }
+    }
+    return best;
+}
+
+/// Gets the support point of the Minkowski difference of two shapes along the given direction.
+/// If @p inflated is true, the radii of the shapes are taken into account.
+static SupportPoint support(const Convex& a, const Convex& b, const glm::vec3& direction, bool inflated)
+{
+    SupportPoint point{{}, a.support(direction), b.support(-direction)};
+    if (inflated)
+    {
+        auto length = glm::length(direction);
+        if (length > 0.0F)
+        {
+            point.a += direction * (a.radius / length);
+            point.b -= direction * (b.radius / length);
+        }
+    }
+    point.w = point.a - point.b;
+    return point;
+}
+
+/// Computes the point of a segment closest to the origin, storing the smallest sub-simplex which
+/// contains it in @p out.
+static glm::vec3 closestOnSegment(const SupportPoint& a, const SupportPoint& b, GjkSimplex& out)
+{
+    auto ab = b.w - a.w;
+    auto denom = glm::dot(ab, ab);
+    auto t = denom > Epsilon ? -glm::dot(a.w, ab) / denom : 0.0F;
+
+    if (t <= 0.0F)
+    {
+        out.count = 1;
+        out.points[0] = a;
+        out.weights[0] = 1.0F;
+        return a.w;
+    }
+
+    if (t >= 1.0F)
+    {
+        out.count = 1;
+        out.points[0] = b;
+        out.weights[0] = 1.0F;
+        return b.w;
+    }
+
+    out.count = 2;
+    out.points[0] = a;
+    out.points[1] = b;
+    out.weights[0] = 1.0F - t;
+    out.weights[1] = t;
+    return a.w + ab * t;
+}
+
+/// Computes the point of a triangle closest to the origin, storing the smallest sub-simplex which
+/// contains it in @p out. Based on the region tests from Real-Time Collision Detection, 5.1.5.
+static glm::vec3 closestOnTriangle(const SupportPoint& a, const SupportPoint& b, const SupportPoint& c,
+                                   GjkSimplex& out)
+{
+    auto ab = b.w - a.w;
+    auto ac = c.w - a.w;
+
+    auto d1 = glm::dot(ab, -a.w);
+    auto d2 = glm::dot(ac, -a.w);
+    if (d1 <= 0.0F && d2 <= 0.0F)
+    {
+        return closestOnSegment(a, a, out);
+    }
+
+    auto d3 = glm::dot(ab, -b.w);
+    auto d4 = glm::dot(ac, -b.w);
+    if (d3 >= 0.0F && d4 <= d3)
+    {
+        return closestOnSegment(b, b, out);
+    }
+
+    auto vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0F && d1 >= 0.0F && d3 <= 0.0F)
+    {
+        return closestOnSegment(a, b, out);
+    }
+
+    auto d5 = glm::dot(ab, -c.w);
+    auto d6 = glm::dot(ac, -c.w);
+    if (d6 >= 0.0F && d5 <= d6)
+    {
+        return closestOnSegment(c, c, out);
+    }
+
+    auto vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0F && d2 >= 0.0F && d6 <= 0.0F)
+    {
+        return closestOnSegment(a, c, out);
+    }
+
+    auto va = d3 * d6 - d5 * d4;
+    if (va <= 0.0F && (d4 - d3) >= 0.0F && (d5 - d6) >= 0.0F)
+    {
+        return closestOnSegment(b, c, out);
+    }
+
+    auto denom = va + vb + vc;
+    if (denom * denom <= Epsilon)
+    {
+        // Degenerate triangle, pick the closest of its edges.
+        GjkSimplex other;
+        auto v = closestOnSegment(a, b, out);
+        auto w = closestOnSegment(b, c, other);
+        if (glm::dot(w, w) < glm::dot(v, v))
+        {
+            out = other;
+            v = w;
+        }
+        return v;
+    }
+
+    auto v = vb / denom;
+    auto w = vc / denom;
+    out.count = 3;
+    out.points[0] = a;
+    out.points[1] = b;
+    out.points[2] = c;
+    out.weights[0] = 1.0F - v - w;
+    out.weights[1] = v;
+    out.weights[2] = w;
+    return a.w + ab * v + ac * w;
+}
+
+/// Computes the point of a tetrahedron closest to the origin, storing the smallest sub-simplex
+/// which contains it in @p out. If the origin is inside the tetrahedron, it is kept whole.
+static glm::vec3 closestOnTetrahedron(const SupportPoint points[4], GjkSimplex& out)
+{
+    // Each face is given by three vertices, followed by the vertex opposite to it.
+    static const int Faces[4][4] = {{0, 1, 2, 3}, {0, 3, 1, 2}, {0, 2, 3, 1}, {1, 3, 2, 0}};
+
+    bool inside = true;
+    auto bestDistance = std::numeric_limits<float>::infinity();
+    glm::vec3 best{0.0F};
+
+    for (const auto& face : Faces)
+    {
+        const auto& a = points[face[0]];
+        const auto& b = points[face[1]];
+        const auto& c = points[face[2]];
+        const auto& d = points[face[3]];
+
+        auto normal = glm::cross(b.w - a.w, c.w - a.w);
+        auto signOrigin = glm::dot(-a.w, normal);
+        auto signOpposite = glm::dot(d.w - a.w, normal);
+        if (signOrigin * signOpposite < 0.0F || signOpposite * signOpposite <= Epsilon)
+        {
+            // The origin is on the other side of this face, so it can't be inside.
+            inside = false;
+
+            GjkSimplex candidate;
+            auto v = closestOnTriangle(a, b, c, candidate);
+            if (glm::dot(v, v) < bestDistance)
+            {
+                bestDistance = glm::dot(v, v);
+                best = v;
+                out = candidate;
+            }
+        }
+    }
+
+    if (inside)
+    {
+        out.count = 4;
+        std::copy(points, points + 4, out.points);
+        return glm::vec3{0.0F};
+    }
+
+    return best;
+}
+
+/// Runs GJK on the Minkowski difference of two shapes.
+/// @param a First shape.
+/// @param b Second shape.
+/// @param inflated Whether the radii of the shapes should be taken into account.
+/// @param[out] simplex Final simplex.
+/// @param[out] closest Point of the Minkowski difference closest to the origin.
+/// @return Whether the shapes intersect.
+static bool gjk(const Convex& a, const Convex& b, bool inflated, GjkSimplex& simplex, glm::vec3& closest)
+{
+    auto direction = b.support({0.0F, 0.0F, 0.0F}) - a.support({0.0F, 0.0F, 0.0F});
+    if (glm::dot(direction, direction) <= Epsilon)
+    {
+        direction = {1.0F, 0.0F, 0.0F};
+    }
+
+    simplex.count = 1;
+    simplex.points[0] = support(a, b, direction, inflated);
+    simplex.weights[0] = 1.0F;
+    closest = simplex.points[0].w;
+
+    for (int i = 0; i < MaxIterations; ++i)
+    {
+        auto distance = glm::dot(closest, closest);
+        if (distance <= Epsilon)
+        {
+            return true;
+        }
+
+        auto point = support(a, b, -closest, inflated);
+        if (distance - glm::dot(closest, point.w) <= Tolerance * Tolerance * std::max(1.0F, distance))
+        {
+            return false; // No progress was made, so we've found the closest point.
+        }
+
+        for (std::size_t j = 0; j < simplex.count; ++j)
+        {
+            auto delta = simplex.points[j].w - point.w;
+            if (glm::dot(delta, delta) <= Epsilon)
+            {
+                return false; // The point is already in the simplex.
+            }
+        }
+
+        simplex.points[simplex.count++] = point;
+
+        GjkSimplex reduced;
+        switch (simplex.count)
+        {
+        case 2:
+            closest = closestOnSegment(simplex.points[0], simplex.points[1], reduced);
+            break;
+        case 3:
+            closest = closestOnTriangle(simplex.points[0], simplex.points[1], simplex.points[2], reduced);
+            break;
+        default:
+            closest = closestOnTetrahedron(simplex.points, reduced);
+            break;
+        }
+        simplex = reduced;
+
+        if (simplex.count == 4)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Grows a simplex which contains the origin into a tetrahedron, so that it can be used as the
+/// initial polytope for EPA.
+/// @return Whether a non-degenerate tetrahedron was found.
+static bool blowUp(const Convex& a, const Convex& b, std::vector<SupportPoint>& vertices)
+{
+    static const glm::vec3 Directions[6] = {{1.0F, 0.0F, 0.0F},  {-1.0F, 0.0F, 0.0F}, {0.0F, 1.0F, 0.0F},
+                                            {0.0F, -1.0F, 0.0F}, {0.0F, 0.0F, 1.0F},  {0.0F, 0.0F, -1.0F}};
+
+    if (vertices.size() == 1)
+    {
+        for (const auto& direction : Directions)
+        {
+            auto point = support(a, b, direction, true);
+            auto delta = point.w - vertices[0].w;
+            if (glm::dot(delta, delta) > Epsilon)
+            {
+                vertices.push_back(point);
+                break;
+            }
+        }
+    }
+
+    if (vertices.size() == 2)
+    {
+        auto line = vertices[1].w - vertices[0].w;
+        for (const auto& axis : Directions)
+        {
+            auto direction = glm::cross(line, axis);
+            if (glm::dot(direction, direction) <= Epsilon)
+            {
+                continue;
+            }
+
+            auto point = support(a, b, direction, true);
+            auto offset = glm::cross(point.w - vertices[0].w, line);
+            if (glm::dot(offset, offset) > Epsilon)
+            {
+                vertices.push_back(point);
+                break;
+            }
+        }
+    }
+
+    if (vertices.size() == 3)
+    {
+        auto normal = glm::cross(vertices[1].w - vertices[0].w, vertices[2].w - vertices[0].w);
+        for (auto direction : {normal, -normal})
+        {
+            auto point = support(a, b, direction, true);
+            auto offset = glm::dot(point.w - vertices[0].w, normal);
+            if (offset * offset > Epsilon)
+            {
+                vertices.push_back(point);
+                break;
+            }
+        }
+    }
+
+    return vertices.size() == 4;
+}
+
+/// Adds a face to the EPA polytope.
+/// @return Whether the face is non-degenerate.
+static bool addFace(const std::vector<SupportPoint>& vertices, std::vector<EpaFace>& faces, std::size_t i,
+                    std::size_t j, std::size_t k)
+{
+    auto normal = glm::cross(vertices[j].w - vertices[i].w, vertices[k].w - vertices[i].w);
+    auto length = glm::length(normal);
+    if (length * length <= Epsilon)
+    {
+        return false;
+    }
+
+    normal /= length;
+    faces.push_back({{i, j, k}, normal, std::max(0.0F, glm::dot(normal, vertices[i].w))});
+    return true;
+}
+
+/// Runs EPA on the Minkowski difference of two inflated shapes, starting from the simplex in
+/// which GJK found the origin.
+/// @return Whether a contact was found.
+static bool epa(const Convex& a, const Convex& b, const GjkSimplex& simplex, ContactManifold& manifold)
+{
+    std::vector<SupportPoint> vertices(simplex.points, simplex.points + simplex.count);
+    if (!blowUp(a, b, vertices))
+    {
+        return false;
+    }
+
+    // Orient the initial tetrahedron so that its faces are counter-clockwise when seen from outside.
+    if (glm::dot(glm::cross(vertices[1].w - vertices[0].w, vertices[2].w - vertices[0].w),
+                 vertices[3].w - vertices[0].w) > 0.0F)
+    {
+        std::swap(vertices[1], vertices[2]);
+    }
+
+    std::vector<EpaFace> faces;
+    if (!addFace(vertices, faces, 0, 1, 2) || !addFace(vertices, faces, 0, 3, 1) ||
+        !addFace(vertices, faces, 0, 2, 3) || !addFace(vertices, faces, 1, 3, 2))
+    {
+        return false;
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> horizon;
+    EpaFace closest = faces[0];
+    for (int i = 0; i < MaxIterations && !faces.empty(); ++i)
+    {
+        closest = *std::min_element(faces.begin(), faces.end(),
+                                    [](const EpaFace& l, const EpaFace& r) { return l.distance < r.distance; });
+
+        auto point = support(a, b, closest.normal, true);
+        if (glm::dot(point.w, closest.normal) - closest.distance < Tolerance)
+        {
+            break;
+        }
+
+        // Remove every face visible from the new point, keeping track of the horizon edges.
+        horizon.clear();
+        for (auto it = faces.begin(); it != faces.end();)
+        {
+            if (glm::dot(it->normal, point.w - vertices[it->v[0]].w) <= 0.0F)
+            {
+                ++it;
+                continue;
+            }
+
+            for (int e = 0; e < 3; ++e)
+            {
+                std::pair<std::size_t, std::size_t> edge{it->v[e], it->v[(e + 1) % 3]};
+                auto twin = std::find(horizon.begin(), horizon.end(), std::make_pair(edge.second, edge.first));
+                if (twin != horizon.end())
+                {
+                    horizon.erase(twin);
+                }
+                else
+                {
+                    horizon.push_back(edge);
+                }
+            }
+
+            it = faces.erase(it);
+        }
+
+        vertices.push_back(point);
+        for (const auto& [from, to] : horizon)
+        {
+            addFace(vertices, faces, from, to, vertices.size() - 1);
+        }
+    }
+
+    // Find the barycentric coordinates of the projection of the origin on the closest face, and
+    // use them to recover the deepest point on the first shape.
+    const auto& p0 = vertices[closest.v[0]];
+    const auto& p1 = vertices[closest.v[1]];
+    const auto& p2 = vertices[closest.v[2]];
+    auto projection = closest.normal * closest.distance;
+    auto e0 = p1.w - p0.w;
+    auto e1 = p2.w - p0.w;
+    auto e2 = projection - p0.w;
+    auto d00 = glm::dot(e0, e0);
+    auto d01 = glm::dot(e0, e1);
+    auto d11 = glm::dot(e1, e1);
+    auto d20 = glm::dot(e2, e0);
+    auto d21 = glm::dot(e2, e1);
+    auto denom = d00 * d11 - d01 * d01;
+    auto v = denom > Epsilon ? (d11 * d20 - d01 * d21) / denom : 0.0F;
+    auto w = denom > Epsilon ? (d00 * d21 - d01 * d20) / denom : 0.0F;
+    auto deepest = p0.a * (1.0F - v - w) + p1.a * v + p2.a * w;
+
+    manifold.normal = closest.normal;
+    manifold.depth = closest.distance;
+    manifold.pointCount = 1;
+    manifold.points[0] = deepest - closest.normal * (closest.distance / 2.0F);
+    return true;
+}
+
+/// Computes the closest points between segments [p1, q1] and [p2, q2], as described in
+/// Real-Time Collision Detection, 5.1.9.
+static void closestOnSegments(const glm::vec3& p1, const glm::vec3& q1, const glm::vec3& p2, const glm::vec3& q2,
+                              glm::vec3& c1, glm::vec3& c2)
+{
+    auto d1 = q1 - p1;
+    auto d2 = q2 - p2;
+    auto r = p1 - p2;
+    auto a = glm::dot(d1, d1);
+    auto e = glm::dot(d2, d2);
+    auto f = glm::dot(d2, r);
+
+    float s = 0.0F;
+    float t = 0.0F;
+    if (a <= Epsilon && e <= Epsilon)
+    {
+        // Both segments are points.
+    }
+    else if (a <= Epsilon)
+    {
+        t = glm::clamp(f / e, 0.0F, 1.0F);
+    }
+    else
+    {
+        auto c = glm::dot(d1, r);
+        if (e <= Epsilon)
+        {
+            s = glm::clamp(-c / a, 0.0F, 1.0F);
+        }
+        else
+        {
+            auto b = glm::dot(d1, d2);
+            auto denom = a * e - b * b;
+            s = denom > Epsilon ? glm::clamp((b * f - c * e) / denom, 0.0F, 1.0F) : 0.0F;
+            t = (b * s + f) / e;
+            if (t < 0.0F)
+            {
+                t = 0.0F;
+                s = glm::clamp(-c / a, 0.0F, 1.0F);
+            }
+            else if (t > 1.0F)
+            {
+                t = 1.0F;
+                s = glm::clamp((b - c) / a, 0.0F, 1.0F);
+            }
+        }
+    }
+
+    c1 = p1 + d1 * s;
+    c2 = p2 + d2 * t;
+}
+
+/// Clips the face of the incident box most opposed to @p normal against the side planes of the
+/// face of the reference box most aligned with it, adding the resulting points to the manifold.
+/// @param ref Reference box.
+/// @param inc Incident box.
+/// @param normal Normal pointing from the reference box towards the incident box.
+static void clipBoxFaces(const Convex& ref, const Convex& inc, const glm::vec3& normal, ContactManifold& manifold)
+{
+    // Find the reference face and its side axes.
+    int refAxis = 0;
+    int incAxis = 0;
+    float refBest = -1.0F;
+    float incBest = -1.0F;
+    for (int i = 0; i < 3; ++i)
+    {
+        auto refLength = glm::length(ref.axes[i]);
+        auto refAlign = refLength > 0.0F ? std::abs(glm::dot(ref.axes[i], normal)) / refLength : 0.0F;
+        if (refAlign > refBest)
+        {
+            refBest = refAlign;
+            refAxis = i;
+        }
+
+        auto incLength = glm::length(inc.axes[i]);
+        auto incAlign = incLength > 0.0F ? std::abs(glm::dot(inc.axes[i], normal)) / incLength : 0.0F;
+        if (incAlign > incBest)
+        {
+            incBest = incAlign;
+            incAxis = i;
+        }
+    }
+
+    auto refSign = glm::dot(ref.axes[refAxis], normal) >= 0.0F ? 1.0F : -1.0F;
+    auto faceCenter = ref.center + ref.axes[refAxis] * refSign;
+
+    // Build the incident face polygon, with its vertices in order.
+    auto incSign = glm::dot(inc.axes[incAxis], normal) > 0.0F ? -1.0F : 1.0F;
+    auto incCenter = inc.center + inc.axes[incAxis] * incSign;
+    const auto& u = inc.axes[(incAxis + 1) % 3];
+    const auto& v = inc.axes[(incAxis + 2) % 3];
+    std::vector<glm::vec3> polygon{incCenter + u + v, incCenter - u + v, incCenter - u - v, incCenter + u - v};
+    std::vector<glm::vec3> clipped;
+
+    // Clip it against the four side planes of the reference face.
+    for (int side = 1; side <= 2 && !polygon.empty(); ++side)
+    {
+        const auto& axis = ref.axes[(refAxis + side) % 3];
+        auto extent = glm::length(axis);
+        if (extent <= 0.0F)
+        {
+            continue;
+        }
+
+        for (auto sign : {1.0F, -1.0F})
+        {
+            auto direction = axis * (sign / extent);
+            auto offset = glm::dot(faceCenter, direction) + extent;
+
+            clipped.clear();
+            for (std::size_t i = 0; i < polygon.size(); ++i)
+            {
+                const auto& from = polygon[i];
+                const auto& to = polygon[(i + 1) % polygon.size()];
+                auto fromDistance = glm::dot(from, direction) - offset;
+                auto toDistance = glm::dot(to, direction) - offset;
+
+                if (fromDistance <= 0.0F)
+                {
+                    clipped.push_back(from);
+                }
+                if ((fromDistance < 0.0F && toDistance > 0.0F) || (fromDistance > 0.0F && toDistance < 0.0F))
+                {
+                    clipped.push_back(from + (to - from) * (fromDistance / (fromDistance - toDistance)));
+                }
+            }
+            std::swap(polygon, clipped);
+        }
+    }
+
+    // Keep the points below the reference face, deepest first.
+    auto radii = ref.radius + inc.radius;
+    std::vector<std::pair<float, glm::vec3>> contacts;
+    for (const auto& point : polygon)
+    {
+        auto separation = glm::dot(point - faceCenter, normal);
+        if (separation <= radii)
+        {
+            // Midpoint between the surfaces of both shapes.
+            contacts.emplace_back(separation, point - normal * ((separation + inc.radius - ref.radius) / 2.0F));
+        }
+    }
+    std::sort(contacts.begin(), contacts.end(), [](const auto& l, const auto& r) { return l.first < r.first; });
+
+    manifold.pointCount = std::min(contacts.size(), ContactManifold::MaxPoints);
+    for (std::size_t i = 0; i < manifold.pointCount; ++i)
+    {
+        manifold.points[i] = contacts[i].second;
+    }
+
+    if (manifold.pointCount == 0)
+    {
+        // Only reachable through numerical issues, fall back to a point between the faces.
+        manifold.pointCount = 1;
+        manifold.points[0] = (faceCenter + incCenter) / 2.0F;
+    }
+}
+
+/// Tests two boxes for intersection using the separating axis theorem.
+static bool intersectBoxes(const Convex& a, const Convex& b, ContactManifold& manifold)
+{
+    auto offset = b.center - a.center;
+    auto radii = a.radius + b.radius;
+
+    // Returns how much the boxes overlap when projected on the given unit axis.
+    auto overlap = [&](const glm::vec3& axis) {
+        float projection = radii - std::abs(glm::dot(offset, axis));
+        for (int i = 0; i < 3; ++i)
+        {
+            projection += std::abs(glm::dot(a.axes[i], axis)) + std::abs(glm::dot(b.axes[i], axis));
+        }
+        return projection;
+    };
+
+    glm::vec3 unitA[3];
+    glm::vec3 unitB[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        auto lengthA = glm::length(a.axes[i]);
+        auto lengthB = glm::length(b.axes[i]);
+        unitA[i] = lengthA > 0.0F ? a.axes[i] / lengthA : glm::vec3{0.0F};
+        unitB[i] = lengthB > 0.0F ? b.axes[i] / lengthB : glm::vec3{0.0F};
+    }
+
+    // Test the face normals of both boxes first.
+    auto bestOverlap = std::numeric_limits<float>::infinity();
+    glm::vec3 bestAxis{0.0F};
+    int bestFace = -1; // 0 to 2 are faces of A, 3 to 5 are faces of B.
+    int bestEdgeA = -1;
+    int bestEdgeB = -1;
+
+    for (int i = 0; i < 6; ++i)
+    {
+        const auto& axis = i < 3 ? unitA[i] : unitB[i - 3];
+        if (glm::dot(axis, axis) <= Epsilon)
+        {
+            continue;
+        }
+
+        auto o = overlap(axis);
+        if (o < 0.0F)
+        {
+            return false;
+        }
+
+        if (o < bestOverlap)
+        {
+            bestOverlap = o;
+            bestAxis = axis;
+            bestFace = i;
+        }
+    }
+
+    // Edge axes are only preferred when they are significantly better, since face contacts are
+    // more stable.
+    auto bestFaceOverlap = bestOverlap;
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            auto axis = glm::cross(unitA[i], unitB[j]);
+            auto length = glm::length(axis);
+            if (length <= 1e-4F)
+            {
+                continue; // Parallel edges, already covered by the face axes.
+            }
+            axis /= length;
+
+            auto o = overlap(axis);
+            if (o < 0.0F)
+            {
+                return false;
+            }
+
+            if (o < bestOverlap && o < bestFaceOverlap * 0.95F - Tolerance)
+            {
+                bestOverlap = o;
+                bestAxis = axis;
+                bestEdgeA = i;
+                bestEdgeB = j;
+            }
+        }
+    }
+
+    if (bestFace == -1 && bestEdgeA == -1)
+    {
+        return false; // Both boxes are degenerate.
+    }
+
+    auto normal = glm::dot(bestAxis, offset) < 0.0F ? -bestAxis : bestAxis;
+    manifold.normal = normal;
+    manifold.depth = bestOverlap;
+
+    if (bestEdgeA != -1)
+    {
+        // Find the supporting edge of each box and compute the closest points between them.
+        auto edgeA = a.center;
+        auto edgeB = b.center;
+        for (int k = 0; k < 3; ++k)
+        {
+            if (k != bestEdgeA)
+            {
+                edgeA += glm::dot(a.axes[k], normal) >= 0.0F ? a.axes[k] : -a.axes[k];
+            }
+            if (k != bestEdgeB)
+            {
+                edgeB += glm::dot(b.axes[k], normal) <= 0.0F ? b.axes[k] : -b.axes[k];
+            }
+        }
+
+        glm::vec3 pointA;
+        glm::vec3 pointB;
+        closestOnSegments(edgeA - a.axes[bestEdgeA], edgeA + a.axes[bestEdgeA], edgeB - b.axes[bestEdgeB],
+                          edgeB + b.axes[bestEdgeB], pointA, pointB);
+        manifold.pointCount = 1;
+        manifold.points[0] = ((pointA + normal * a.radius) + (pointB - normal * b.radius)) / 2.0F;
+    }
+    else if (bestFace < 3)
+    {
+        clipBoxFaces(a, b, normal, manifold);
+    }
+    else
+    {
+        clipBoxFaces(b, a, -normal, manifold);
+    }
+
+    return true;
+}
+
+float cubos::core::geom::coreDistance(const Convex& a, const Convex& b, glm::vec3& pointA, glm::vec3& pointB)
+{
+    GjkSimplex simplex;
+    glm::vec3 closest;
+    if (gjk(a, b, false, simplex, closest))
+    {
+        pointA = pointB = simplex.points[0].a;
+        return 0.0F;
+    }
+
+    pointA = pointB = glm::vec3{0.0F};
+    for (std::size_t i = 0; i < simplex.count; ++i)
+    {
+        pointA += simplex.points[i].a * simplex.weights[i];
+        pointB += simplex.points[i].b * simplex.weights[i];
+    }
+    return glm::length(closest);
+}
+
+bool cubos::core::geom::intersects(const Convex& a, const Convex& b, ContactManifold& manifold)
+{
+    if (a.empty() || b.empty())
+    {
+        return false;
+    }
+
+    if (a.isBox && b.isBox)
+    {
+        return intersectBoxes(a, b, manifold);
+    }
+
+    glm::vec3 pointA;
+    glm::vec3 pointB;
+    auto distance = coreDistance(a, b, pointA, pointB);
+    auto radii = a.radius + b.radius;
+    if (distance > radii)
+    {
+        return false;
+    }
+
+    if (distance > Tolerance)
+    {
+        // Only the inflated parts of the shapes overlap, so the closest points of the cores are
+        // enough to build the contact.
+        manifold.normal = (pointB - pointA) / distance;
+        manifold.depth = radii - distance;
+        manifold.pointCount = 1;
+        manifold.points[0] = ((pointA + manifold.normal * a.radius) + (pointB - manifold.normal * b.radius)) / 2.0F;
+        return true;
+    }
+
+    // The cores overlap, so we need to find the penetration through EPA.
+    GjkSimplex simplex;
+    glm::vec3 closest;
+    if (!gjk(a, b, true, simplex, closest))
+    {
+        return false;
+    }
+
+    return epa(a, b, simplex, manifold);
+}
+
+bool cubos::core::geom::intersects(const Convex& a, const Plane& plane, const glm::vec3& origin, float radius,
+                                   ContactManifold& manifold)
+{
+    auto length = glm::length(plane.normal);
+    if (a.empty() || length <= 0.0F)
+    {
+        return false;
+    }
+
+    auto normal = plane.normal / length;
+    auto separation = glm::dot(a.support(-normal) - origin, normal) - a.radius - radius;
+    if (separation > 0.0F)
+    {
+        return false;
+    }
+
+    // Gather the vertices of the core which are touching the plane.
+    glm::vec3 vertices[8];
+    std::size_t vertexCount = 0;
+    if (a.isBox)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            vertices[vertexCount++] = a.center + a.axes[0] * ((i & 1) != 0 ? 1.0F : -1.0F) +
+                                      a.axes[1] * ((i & 2) != 0 ? 1.0F : -1.0F) +
+                                      a.axes[2] * ((i & 4) != 0 ? 1.0F : -1.0F);
+        }
+    }
+    else
+    {
+        std::copy(a.points, a.points + a.pointCount, vertices);
+        vertexCount = a.pointCount;
+    }
+
+    std::pair<float, glm::vec3> contacts[8];
+    std::size_t contactCount = 0;
+    for (std::size_t i = 0; i < vertexCount; ++i)
+    {
+        auto height = glm::dot(vertices[i] - origin, normal);
+        if (height - a.radius - radius <= 0.0F)
+        {
+            // Midpoint between the surface of the shape and the surface of the plane.
+            auto onShape = vertices[i] - normal * a.radius;
+            auto onPlane = vertices[i] - normal * (height - radius);
+            contacts[contactCount++] = {height, (onShape + onPlane) / 2.0F};
+        }
+    }
+    std::sort(contacts, contacts + contactCount, [](const auto& l, const auto& r) { return l.first < r.first; });
+
+    manifold.normal = -normal;
+    manifold.depth = -separation;
+    manifold.pointCount = std::min(contactCount, ContactManifold::MaxPoints);
+    for (std::size_t i = 0; i < manifold.pointCount; ++i)
+    {
+        manifold.points[i] = contacts[i].second;
+    }
+    return true;
+}
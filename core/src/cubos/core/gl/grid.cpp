@@ -1,4 +1,5 @@
-#include <unordered_map>
+#include <algorithm>
+#include <limits>
 
 #include <cubos/core/gl/grid.hpp>
 #include <cubos/core/gl/palette.hpp>
@@ -113,54 +114,537 @@ void Grid::set(const glm::ivec3& position, uint16_t mat)
 
 bool Grid::convert(const Palette& src, const Palette& dst, float minSimilarity)
 {
-    // Find the mappings for every material in the source palette.
-    std::unordered_map<uint16_t, uint16_t> mappings;
-    for (uint16_t i = 0; i <= src.size(); ++i)
+    // Find which materials are used by the grid, as only those need to be mapped.
+    std::vector<bool> used(static_cast<std::size_t>(UINT16_MAX) + 1, false);
+    for (auto index : mIndices)
     {
-        uint16_t j = dst.find(src.get(i));
-        if (src.get(i).similarity(dst.get(j)) >= minSimilarity)
-        {
-            mappings[i] = j;
-        }
+        used[index] = true;
     }
 
-    // Check if the mappings are complete for every material being used in the grid.
-    for (uint32_t i = 0; i < mSize.x * mSize.y * mSize.z; ++i)
+    // Find the mappings for every used material, failing if any of them has no match.
+    std::vector<uint16_t> mappings(used.size(), 0);
+    for (std::size_t i = 0; i < used.size(); ++i)
     {
-        if (mappings.find(mIndices[i]) == mappings.end())
+        if (!used[i])
+        {
+            continue;
+        }
+
+        const auto& material = src.get(static_cast<uint16_t>(i));
+        uint16_t j = dst.find(material);
+        if (material.similarity(dst.get(j)) < minSimilarity)
         {
             return false;
         }
+        mappings[i] = j;
     }
 
     // Apply the mappings.
-    for (uint32_t i = 0; i < mSize.x * mSize.y * mSize.z; ++i)
+    for (auto& index : mIndices)
     {
-        mIndices[i] = mappings[mIndices[i]];
+        index = mappings[index];
     }
 
     return true;
 }
 
+/// Size, in voxels, of each cell of the coarse occupancy grid used by batched raycasts.
+static const int MipCellSize = 8;
+
+/// Clips a ray against the bounds of a grid.
+/// @param origin Ray origin.
+/// @param direction Normalized ray direction.
+/// @param size Grid size.
+/// @param[in,out] tEnter Distance at which the ray enters the grid. Should be initialized to 0.
+/// @param[in,out] tExit Distance at which the ray exits the grid. Should be initialized to the maximum distance.
+/// @param[out] normal Normal of the grid face the ray enters through, or zero if it starts inside.
+/// @return Whether the ray intersects the grid.
+static bool clipRay(const glm::vec3& origin, const glm::vec3& direction, const glm::uvec3& size, float& tEnter,
+                    float& tExit, glm::ivec3& normal)
+{
+    normal = {0, 0, 0};
+    for (int a = 0; a < 3; ++a)
+    {
+        auto max = static_cast<float>(size[a]);
+        if (direction[a] == 0.0F)
+        {
+            if (origin[a] < 0.0F || origin[a] > max)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        float t0 = (0.0F - origin[a]) / direction[a];
+        float t1 = (max - origin[a]) / direction[a];
+        if (t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+
+        if (t0 > tEnter)
+        {
+            tEnter = t0;
+            normal = {0, 0, 0};
+            normal[a] = direction[a] > 0.0F ? -1 : 1;
+        }
+        tExit = std::min(tExit, t1);
+    }
+
+    return tEnter <= tExit;
+}
+
+/// Visits, in order, the cells of a regular grid intersected by a ray, using the Amanatides-Woo
+/// algorithm. Cell `i` spans from `i * cellSize` to `(i + 1) * cellSize` along each axis.
+/// @param origin Ray origin.
+/// @param direction Normalized ray direction.
+/// @param tStart Distance along the ray at which traversal starts.
+/// @param tEnd Distance along the ray at which traversal stops.
+/// @param cellSize Size of each cell.
+/// @param lo Minimum cell coordinates. Traversal stops when the ray leaves the cell range.
+/// @param hi Maximum cell coordinates. Traversal stops when the ray leaves the cell range.
+/// @param normal Normal of the face through which the ray enters the first cell.
+/// @param visit Called with the cell coordinates, entry face normal and entry distance of each
+/// cell. Traversal stops when it returns true.
+/// @return Whether traversal was stopped by @p visit.
+template <typename F>
+static bool traverse(const glm::vec3& origin, const glm::vec3& direction, float tStart, float tEnd, float cellSize,
+                     const glm::ivec3& lo, const glm::ivec3& hi, glm::ivec3 normal, F visit)
+{
+    auto cell = glm::clamp(glm::ivec3(glm::floor((origin + direction * tStart) / cellSize)), lo, hi);
+
+    glm::ivec3 step;
+    glm::vec3 next;
+    glm::vec3 delta;
+    for (int a = 0; a < 3; ++a)
+    {
+        if (direction[a] > 0.0F)
+        {
+            step[a] = 1;
+            next[a] = (static_cast<float>(cell[a] + 1) * cellSize - origin[a]) / direction[a];
+            delta[a] = cellSize / direction[a];
+        }
+        else if (direction[a] < 0.0F)
+        {
+            step[a] = -1;
+            next[a] = (static_cast<float>(cell[a]) * cellSize - origin[a]) / direction[a];
+            delta[a] = -cellSize / direction[a];
+        }
+        else
+        {
+            step[a] = 0;
+            next[a] = std::numeric_limits<float>::infinity();
+            delta[a] = std::numeric_limits<float>::infinity();
+        }
+    }
+
+    float t = tStart;
+    while (true)
+    {
+        if (visit(cell, normal, t))
+        {
+            return true;
+        }
+
+        // Step into the neighboring cell whose boundary is closest along the ray.
+        int axis = next.x < next.y ? (next.x < next.z ? 0 : 2) : (next.y < next.z ? 1 : 2);
+        t = std::max(t, next[axis]);
+        cell[axis] += step[axis];
+        if (t > tEnd || cell[axis] < lo[axis] || cell[axis] > hi[axis])
+        {
+            return false;
+        }
+
+        next[axis] += delta[axis];
+        normal = {0, 0, 0};
+        normal[axis] = -step[axis];
+    }
+}
+
+std::optional<Grid::RaycastHit> Grid::raycast(const glm::vec3& origin, const glm::vec3& direction,
+                                              float maxDistance) const
+{
+    if (direction == glm::vec3{0.0F})
+    {
+        return std::nullopt;
+    }
+
+    auto dir = glm::normalize(direction);
+    float tEnter = 0.0F;
+    float tExit = maxDistance;
+    glm::ivec3 normal;
+    if (!clipRay(origin, dir, mSize, tEnter, tExit, normal))
+    {
+        return std::nullopt;
+    }
+
+    std::optional<RaycastHit> hit;
+    traverse(origin, dir, tEnter, tExit, 1.0F, glm::ivec3{0}, glm::ivec3(mSize) - 1, normal,
+             [&](const glm::ivec3& voxel, const glm::ivec3& faceNormal, float t) {
+                 if (this->get(voxel) != 0)
+                 {
+                     hit = RaycastHit{voxel, faceNormal, t};
+                     return true;
+                 }
+                 return false;
+             });
+    return hit;
+}
+
+void Grid::raycast(const std::vector<Ray>& rays, std::vector<std::optional<RaycastHit>>& hits, bool useMip) const
+{
+    hits.clear();
+    hits.resize(rays.size());
+
+    if (!useMip)
+    {
+        for (std::size_t i = 0; i < rays.size(); ++i)
+        {
+            hits[i] = this->raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance);
+        }
+        return;
+    }
+
+    // Build a coarse occupancy grid, where each cell tells whether its block of voxels has any
+    // non-empty voxel.
+    auto mipSize = (glm::ivec3(mSize) + (MipCellSize - 1)) / MipCellSize;
+    std::vector<bool> occupied(static_cast<std::size_t>(mipSize.x * mipSize.y * mipSize.z), false);
+    for (int z = 0; z < static_cast<int>(mSize.z); ++z)
+    {
+        for (int y = 0; y < static_cast<int>(mSize.y); ++y)
+        {
+            for (int x = 0; x < static_cast<int>(mSize.x); ++x)
+            {
+                if (this->get({x, y, z}) != 0)
+                {
+                    auto cell = glm::ivec3{x, y, z} / MipCellSize;
+                    occupied[static_cast<std::size_t>(cell.x + (cell.y + cell.z * mipSize.y) * mipSize.x)] = true;
+                }
+            }
+        }
+    }
+
+    auto maxVoxel = glm::ivec3(mSize) - 1;
+    for (std::size_t i = 0; i < rays.size(); ++i)
+    {
+        const auto& ray = rays[i];
+        if (ray.direction == glm::vec3{0.0F})
+        {
+            continue;
+        }
+
+        auto dir = glm::normalize(ray.direction);
+        float tEnter = 0.0F;
+        float tExit = ray.maxDistance;
+        glm::ivec3 normal;
+        if (!clipRay(ray.origin, dir, mSize, tEnter, tExit, normal))
+        {
+            continue;
+        }
+
+        // Traverse the coarse grid, and only descend into the voxels of occupied cells.
+        traverse(ray.origin, dir, tEnter, tExit, static_cast<float>(MipCellSize), glm::ivec3{0}, mipSize - 1, normal,
+                 [&](const glm::ivec3& cell, const glm::ivec3& cellNormal, float cellT) {
+                     if (!occupied[static_cast<std::size_t>(cell.x + (cell.y + cell.z * mipSize.y) * mipSize.x)])
+                     {
+                         return false;
+                     }
+
+                     auto lo = cell * MipCellSize;
+                     auto hi = glm::min(lo + (MipCellSize - 1), maxVoxel);
+                     return traverse(ray.origin, dir, cellT, tExit, 1.0F, lo, hi, cellNormal,
+                                     [&](const glm::ivec3& voxel, const glm::ivec3& faceNormal, float t) {
+                                         if (this->get(voxel) != 0)
+                                         {
+                                             hits[i] = RaycastHit{voxel, faceNormal, t};
+                                             return true;
+                                         }
+                                         return false;
+                                     });
+                 });
+    }
+}
+
+/// Version of the encoding used to serialize grids.
+static const uint8_t EncodingVersion = 1;
+
+/// Returns the number of bits needed to represent every value in the range [0, max].
+static uint32_t bitsFor(uint32_t max)
+{
+    uint32_t bits = 0;
+    while (bits < 32 && (max >> bits) != 0)
+    {
+        ++bits;
+    }
+    return bits;
+}
+
+namespace
+{
+    /// Packs values with arbitrary bit widths into a sequence of 32-bit words.
+    class BitWriter
+    {
+    public:
+        /// Appends the lowest @p bits bits of @p value.
+        void write(uint32_t value, uint32_t bits)
+        {
+            if (bits == 0)
+            {
+                return;
+            }
+
+            mAccumulator |= static_cast<uint64_t>(value) << mCount;
+            mCount += bits;
+            if (mCount >= 32)
+            {
+                mWords.push_back(static_cast<uint32_t>(mAccumulator));
+                mAccumulator >>= 32;
+                mCount -= 32;
+            }
+        }
+
+        /// Flushes any pending bits and returns the written words.
+        std::vector<uint32_t>& finish()
+        {
+            if (mCount > 0)
+            {
+                mWords.push_back(static_cast<uint32_t>(mAccumulator));
+                mAccumulator = 0;
+                mCount = 0;
+            }
+            return mWords;
+        }
+
+    private:
+        std::vector<uint32_t> mWords;
+        uint64_t mAccumulator{0};
+        uint32_t mCount{0};
+    };
+
+    /// Unpacks values written by @ref BitWriter, pulling words from a deserializer as they are needed.
+    class BitReader
+    {
+    public:
+        BitReader(cubos::core::data::Deserializer& deserializer, std::size_t words)
+            : mDeserializer(deserializer)
+            , mRemaining(words)
+        {
+        }
+
+        /// Reads a value with the given number of bits.
+        /// @return Whether there were enough words left to read the value.
+        bool read(uint32_t& value, uint32_t bits)
+        {
+            if (bits == 0)
+            {
+                value = 0;
+                return true;
+            }
+
+            while (mCount < bits)
+            {
+                if (mRemaining == 0)
+                {
+                    return false;
+                }
+
+                uint32_t word = 0;
+                mDeserializer.read(word);
+                mAccumulator |= static_cast<uint64_t>(word) << mCount;
+                mCount += 32;
+                mRemaining -= 1;
+            }
+
+            value = static_cast<uint32_t>(mAccumulator & ((static_cast<uint64_t>(1) << bits) - 1));
+            mAccumulator >>= bits;
+            mCount -= bits;
+            return true;
+        }
+
+        /// Consumes the words which weren't needed, if any.
+        void skip()
+        {
+            uint32_t word;
+            for (; mRemaining > 0; --mRemaining)
+            {
+                mDeserializer.read(word);
+            }
+        }
+
+    private:
+        cubos::core::data::Deserializer& mDeserializer;
+        std::size_t mRemaining;
+        uint64_t mAccumulator{0};
+        uint32_t mCount{0};
+    };
+} // namespace
+
+// The grid is stored as run-length encoded rows along the X axis. Each run is packed as its length
+// minus one followed by an index into a local palette containing only the materials used by the
+// grid, both using the minimum number of bits possible for the grid's dimensions and material count.
+//
+// Grids written before this encoding existed stored every voxel in the 'data' array. To remain
+// compatible with them, the encoded format always writes an empty 'data' array, which the legacy
+// format never did, as grids always have at least one voxel.
+
 void cubos::core::data::serialize(Serializer& serializer, const gl::Grid& grid, const char* name)
 {
+    // Build a local palette with the materials used by the grid, ordered by their index.
+    std::vector<uint16_t> toLocal(static_cast<std::size_t>(UINT16_MAX) + 1, 0);
+    std::vector<bool> used(static_cast<std::size_t>(UINT16_MAX) + 1, false);
+    for (auto index : grid.mIndices)
+    {
+        used[index] = true;
+    }
+
+    std::vector<uint16_t> palette;
+    for (std::size_t i = 0; i < used.size(); ++i)
+    {
+        if (used[i])
+        {
+            toLocal[i] = static_cast<uint16_t>(palette.size());
+            palette.push_back(static_cast<uint16_t>(i));
+        }
+    }
+
+    auto lengthBits = bitsFor(grid.mSize.x - 1);
+    auto indexBits = bitsFor(static_cast<uint32_t>(palette.size()) - 1);
+
+    // Encode each row along the X axis as a sequence of runs.
+    BitWriter writer;
+    const auto* row = grid.mIndices.data();
+    for (uint32_t r = 0; r < grid.mSize.y * grid.mSize.z; ++r, row += grid.mSize.x)
+    {
+        uint32_t x = 0;
+        while (x < grid.mSize.x)
+        {
+            uint32_t start = x;
+            while (x < grid.mSize.x && row[x] == row[start])
+            {
+                ++x;
+            }
+
+            writer.write(x - start - 1, lengthBits);
+            writer.write(toLocal[row[start]], indexBits);
+        }
+    }
+
     serializer.beginObject(name);
     serializer.write(grid.mSize, "size");
-    serializer.write(grid.mIndices, "data");
+    serializer.beginArray(0, "data");
+    serializer.endArray();
+    serializer.write(EncodingVersion, "version");
+    serializer.write(palette, "palette");
+    serializer.write(writer.finish(), "runs");
     serializer.endObject();
 }
 
+/// Decodes the runs of an encoded grid straight into its index buffer.
+/// @return Whether the encoded data was valid.
+static bool decodeRuns(cubos::core::data::Deserializer& deserializer, const glm::uvec3& size,
+                       const std::vector<uint16_t>& palette, std::vector<uint16_t>& indices)
+{
+    if (palette.empty())
+    {
+        CUBOS_WARN("Encoded grid has an empty palette");
+        return false;
+    }
+
+    auto lengthBits = bitsFor(size.x - 1);
+    auto indexBits = bitsFor(static_cast<uint32_t>(palette.size()) - 1);
+
+    BitReader reader{deserializer, deserializer.beginArray()};
+    auto* row = indices.data();
+    bool valid = true;
+    for (uint32_t r = 0; valid && r < size.y * size.z; ++r, row += size.x)
+    {
+        uint32_t x = 0;
+        while (x < size.x)
+        {
+            uint32_t length;
+            uint32_t local;
+            if (!reader.read(length, lengthBits) || !reader.read(local, indexBits))
+            {
+                CUBOS_WARN("Encoded grid data ended unexpectedly");
+                valid = false;
+                break;
+            }
+
+            length += 1;
+            if (length > size.x - x || local >= palette.size())
+            {
+                CUBOS_WARN("Encoded grid contains an invalid run");
+                valid = false;
+                break;
+            }
+
+            std::fill_n(row + x, length, palette[local]);
+            x += length;
+        }
+    }
+    reader.skip();
+    deserializer.endArray();
+
+    return valid;
+}
+
 void cubos::core::data::deserialize(Deserializer& deserializer, gl::Grid& grid)
 {
     deserializer.beginObject();
     deserializer.read(grid.mSize);
-    deserializer.read(grid.mIndices);
+
+    auto voxelCount = static_cast<std::size_t>(grid.mSize.x) * static_cast<std::size_t>(grid.mSize.y) *
+                      static_cast<std::size_t>(grid.mSize.z);
+    bool valid = true;
+
+    std::size_t length = deserializer.beginArray();
+    if (length != 0)
+    {
+        // Legacy format, with every voxel stored individually.
+        grid.mIndices.resize(length);
+        for (auto& index : grid.mIndices)
+        {
+            deserializer.read(index);
+        }
+        deserializer.endArray();
+
+        if (voxelCount != length)
+        {
+            CUBOS_WARN("Grid size and indices size mismatch: was ({}, {}, {}), indices size is {}.", grid.mSize.x,
+                       grid.mSize.y, grid.mSize.z, length);
+            valid = false;
+        }
+    }
+    else
+    {
+        deserializer.endArray();
+
+        uint8_t version = 0;
+        deserializer.read(version);
+        if (version != EncodingVersion)
+        {
+            CUBOS_WARN("Unsupported grid encoding version {}, expected {}", version, EncodingVersion);
+            valid = false;
+        }
+        else if (voxelCount == 0)
+        {
+            CUBOS_WARN("Grid size must be at least 1 in each dimension: was ({}, {}, {})", grid.mSize.x, grid.mSize.y,
+                       grid.mSize.z);
+            valid = false;
+        }
+        else
+        {
+            std::vector<uint16_t> palette;
+            deserializer.read(palette);
+            grid.mIndices.resize(voxelCount);
+            valid = decodeRuns(deserializer, grid.mSize, palette, grid.mIndices);
+        }
+    }
+
     deserializer.endObject();
 
-    if (grid.mSize.x * grid.mSize.y * grid.mSize.z != static_cast<unsigned int>(grid.mIndices.size()))
+    if (!valid)
     {
-        CUBOS_WARN("Grid size and indices size mismatch: was ({}, {}, {}), indices size is {}.", grid.mSize.x,
-                   grid.mSize.y, grid.mSize.z, grid.mIndices.size());
         grid.mSize = {1, 1, 1};
         grid.mIndices.clear();
         grid.mIndices.resize(1, 0);
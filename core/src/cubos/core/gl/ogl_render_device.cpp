@@ -1,7 +1,8 @@
 #include <cassert>
 #include <cstdlib>
-#include <list>
+#include <cstring>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #include <glad/glad.h>
@@ -157,6 +158,16 @@ static bool textureFormatToGL(TextureFormat texFormat, GLenum& internalFormat, G
         format = GL_RGBA_INTEGER;
         type = GL_SHORT;
         break;
+    case TextureFormat::R32UInt:
+        internalFormat = GL_R32UI;
+        format = GL_RED_INTEGER;
+        type = GL_UNSIGNED_INT;
+        break;
+    case TextureFormat::RG32UInt:
+        internalFormat = GL_RG32UI;
+        format = GL_RG_INTEGER;
+        type = GL_UNSIGNED_INT;
+        break;
     case TextureFormat::R16Float:
         internalFormat = GL_R16F;
         format = GL_RED;
@@ -459,19 +470,216 @@ static void blendOpToGL(BlendOp blendOp, GLenum& glBlendOp)
     }
 }
 
+/// Binding whose value isn't known, and which must thus always be set.
+static const GLuint UnknownBinding = ~0U;
+
+/// Number of texture units and uniform buffer binding points whose bindings are mirrored. Bindings
+/// past these are always set.
+static const std::size_t MirroredUnits = 32;
+
+struct cubos::core::gl::OGLState
+{
+    /// Counts a request which can be skipped if it doesn't change the state.
+    /// @param changed Whether the request changes the state.
+    /// @return Whether the request must be issued.
+    bool issue(bool changed)
+    {
+        if (changed)
+        {
+            this->stats.issued += 1;
+        }
+        else
+        {
+            this->stats.skipped += 1;
+        }
+        return changed;
+    }
+
+    void bindFramebuffer(GLuint id)
+    {
+        if (this->issue(this->framebuffer != id))
+        {
+            this->framebuffer = id;
+            glBindFramebuffer(GL_FRAMEBUFFER, id);
+        }
+    }
+
+    void useProgram(GLuint id)
+    {
+        if (this->issue(this->program != id))
+        {
+            this->program = id;
+            glUseProgram(id);
+        }
+    }
+
+    void bindVertexArray(GLuint id)
+    {
+        if (this->issue(this->vertexArray != id))
+        {
+            // The index buffer binding is part of the vertex array state.
+            this->vertexArray = id;
+            this->indexBuffer = UnknownBinding;
+            glBindVertexArray(id);
+        }
+    }
+
+    void bindIndexBuffer(GLuint id)
+    {
+        if (this->issue(this->indexBuffer != id))
+        {
+            this->indexBuffer = id;
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
+        }
+    }
+
+    void bindUniformBuffer(GLuint index, GLuint id)
+    {
+        if (this->issue(index >= MirroredUnits || this->uniformBuffers[index] != id))
+        {
+            if (index < MirroredUnits)
+            {
+                this->uniformBuffers[index] = id;
+            }
+            glBindBufferBase(GL_UNIFORM_BUFFER, index, id);
+        }
+    }
+
+    /// Binds a texture to a texture unit.
+    void bindTexture(GLuint unit, GLenum target, GLuint id)
+    {
+        if (this->issue(unit >= MirroredUnits || this->textureTargets[unit] != target || this->textures[unit] != id))
+        {
+            this->setActiveTexture(unit);
+            this->bindTexture(target, id);
+        }
+    }
+
+    /// Binds a texture to the active texture unit, which is done to upload data to it.
+    void bindTexture(GLenum target, GLuint id)
+    {
+        if (this->activeUnit < MirroredUnits)
+        {
+            this->textureTargets[this->activeUnit] = target;
+            this->textures[this->activeUnit] = id;
+        }
+        glBindTexture(target, id);
+    }
+
+    void setActiveTexture(GLuint unit)
+    {
+        if (this->activeUnit != unit)
+        {
+            this->activeUnit = unit;
+            glActiveTexture(GL_TEXTURE0 + unit);
+        }
+    }
+
+    void bindSampler(GLuint unit, GLuint id)
+    {
+        if (this->issue(unit >= MirroredUnits || this->samplers[unit] != id))
+        {
+            if (unit < MirroredUnits)
+            {
+                this->samplers[unit] = id;
+            }
+            glBindSampler(unit, id);
+        }
+    }
+
+    // OpenGL resets the bindings of deleted objects to zero.
+
+    void forgetFramebuffer(GLuint id)
+    {
+        if (this->framebuffer == id)
+        {
+            this->framebuffer = 0;
+        }
+    }
+
+    void forgetVertexArray(GLuint id)
+    {
+        if (this->vertexArray == id)
+        {
+            this->vertexArray = 0;
+            this->indexBuffer = UnknownBinding;
+        }
+    }
+
+    void forgetBuffer(GLuint id)
+    {
+        if (this->indexBuffer == id)
+        {
+            this->indexBuffer = UnknownBinding;
+        }
+        for (auto& buffer : this->uniformBuffers)
+        {
+            if (buffer == id)
+            {
+                buffer = 0;
+            }
+        }
+    }
+
+    void forgetTexture(GLuint id)
+    {
+        for (auto& texture : this->textures)
+        {
+            if (texture == id)
+            {
+                texture = 0;
+            }
+        }
+    }
+
+    void forgetSampler(GLuint id)
+    {
+        for (auto& sampler : this->samplers)
+        {
+            if (sampler == id)
+            {
+                sampler = 0;
+            }
+        }
+    }
+
+    RenderDeviceStats stats;
+
+    GLuint framebuffer{0};
+    GLuint program{0};
+    GLuint vertexArray{0};
+    GLuint indexBuffer{UnknownBinding};
+    GLuint activeUnit{0};
+    GLenum textureTargets[MirroredUnits]{};
+    GLuint textures[MirroredUnits]{};
+    GLuint samplers[MirroredUnits]{};
+    GLuint uniformBuffers[MirroredUnits]{};
+    GLint viewport[4]{-1, -1, -1, -1};
+    GLint scissor[4]{-1, -1, -1, -1};
+
+    // State objects are immutable, so the same object always sets the same state. Keeping them
+    // alive also keeps their addresses from being reused.
+    RasterState rasterState;
+    DepthStencilState depthStencilState;
+    BlendState blendState;
+};
+
 class OGLFramebuffer : public impl::Framebuffer
 {
 public:
-    OGLFramebuffer(GLuint id)
-        : id(id)
+    OGLFramebuffer(std::shared_ptr<OGLState> state, GLuint id)
+        : state(std::move(state))
+        , id(id)
     {
     }
 
     ~OGLFramebuffer() override
     {
+        this->state->forgetFramebuffer(this->id);
         glDeleteFramebuffers(1, &this->id);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
 };
 
@@ -534,24 +742,28 @@ public:
 class OGLSampler : public impl::Sampler
 {
 public:
-    OGLSampler(GLuint id)
-        : id(id)
+    OGLSampler(std::shared_ptr<OGLState> state, GLuint id)
+        : state(std::move(state))
+        , id(id)
     {
     }
 
     ~OGLSampler() override
     {
+        this->state->forgetSampler(this->id);
         glDeleteSamplers(1, &this->id);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
 };
 
 class OGLTexture1D : public impl::Texture1D
 {
 public:
-    OGLTexture1D(GLuint id, GLenum internalFormat, GLenum format, GLenum type)
-        : id(id)
+    OGLTexture1D(std::shared_ptr<OGLState> state, GLuint id, GLenum internalFormat, GLenum format, GLenum type)
+        : state(std::move(state))
+        , id(id)
         , internalFormat(internalFormat)
         , format(format)
         , type(type)
@@ -560,22 +772,24 @@ public:
 
     ~OGLTexture1D() override
     {
+        this->state->forgetTexture(this->id);
         glDeleteTextures(1, &this->id);
     }
 
     void update(std::size_t x, std::size_t width, const void* data, std::size_t level) override
     {
-        glBindTexture(GL_TEXTURE_1D, this->id);
+        this->state->bindTexture(GL_TEXTURE_1D, this->id);
         glTexSubImage1D(GL_TEXTURE_1D, static_cast<GLint>(level), static_cast<GLint>(x), static_cast<GLsizei>(width),
                         this->format, this->type, data);
     }
 
     void generateMipmaps() override
     {
-        glBindTexture(GL_TEXTURE_1D, this->id);
+        this->state->bindTexture(GL_TEXTURE_1D, this->id);
         glGenerateMipmap(GL_TEXTURE_1D);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
     GLenum internalFormat;
     GLenum format;
@@ -585,8 +799,9 @@ public:
 class OGLTexture2D : public impl::Texture2D
 {
 public:
-    OGLTexture2D(GLuint id, GLenum internalFormat, GLenum format, GLenum type)
-        : id(id)
+    OGLTexture2D(std::shared_ptr<OGLState> state, GLuint id, GLenum internalFormat, GLenum format, GLenum type)
+        : state(std::move(state))
+        , id(id)
         , internalFormat(internalFormat)
         , format(format)
         , type(type)
@@ -595,23 +810,25 @@ public:
 
     ~OGLTexture2D() override
     {
+        this->state->forgetTexture(this->id);
         glDeleteTextures(1, &this->id);
     }
 
     void update(std::size_t x, std::size_t y, std::size_t width, std::size_t height, const void* data,
                 std::size_t level) override
     {
-        glBindTexture(GL_TEXTURE_2D, this->id);
+        this->state->bindTexture(GL_TEXTURE_2D, this->id);
         glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(x), static_cast<GLint>(y),
                         static_cast<GLsizei>(width), static_cast<GLsizei>(height), this->format, this->type, data);
     }
 
     void generateMipmaps() override
     {
-        glBindTexture(GL_TEXTURE_2D, this->id);
+        this->state->bindTexture(GL_TEXTURE_2D, this->id);
         glGenerateMipmap(GL_TEXTURE_2D);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
     GLenum internalFormat;
     GLenum format;
@@ -621,8 +838,9 @@ public:
 class OGLTexture2DArray : public impl::Texture2DArray
 {
 public:
-    OGLTexture2DArray(GLuint id, GLenum internalFormat, GLenum format, GLenum type)
-        : id(id)
+    OGLTexture2DArray(std::shared_ptr<OGLState> state, GLuint id, GLenum internalFormat, GLenum format, GLenum type)
+        : state(std::move(state))
+        , id(id)
         , internalFormat(internalFormat)
         , format(format)
         , type(type)
@@ -631,13 +849,14 @@ public:
 
     ~OGLTexture2DArray() override
     {
+        this->state->forgetTexture(this->id);
         glDeleteTextures(1, &this->id);
     }
 
     void update(std::size_t x, std::size_t y, std::size_t i, std::size_t width, std::size_t height, const void* data,
                 std::size_t level) override
     {
-        glBindTexture(GL_TEXTURE_2D_ARRAY, this->id);
+        this->state->bindTexture(GL_TEXTURE_2D_ARRAY, this->id);
         glTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), static_cast<GLint>(x), static_cast<GLint>(y),
                         static_cast<GLint>(i), static_cast<GLsizei>(width), static_cast<GLsizei>(height), 1,
                         this->format, this->type, data);
@@ -645,10 +864,11 @@ public:
 
     void generateMipmaps() override
     {
-        glBindTexture(GL_TEXTURE_2D_ARRAY, this->id);
+        this->state->bindTexture(GL_TEXTURE_2D_ARRAY, this->id);
         glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
     GLenum internalFormat;
     GLenum format;
@@ -658,8 +878,9 @@ public:
 class OGLTexture3D : public impl::Texture3D
 {
 public:
-    OGLTexture3D(GLuint id, GLenum internalFormat, GLenum format, GLenum type)
-        : id(id)
+    OGLTexture3D(std::shared_ptr<OGLState> state, GLuint id, GLenum internalFormat, GLenum format, GLenum type)
+        : state(std::move(state))
+        , id(id)
         , internalFormat(internalFormat)
         , format(format)
         , type(type)
@@ -668,13 +889,14 @@ public:
 
     ~OGLTexture3D() override
     {
+        this->state->forgetTexture(this->id);
         glDeleteTextures(1, &this->id);
     }
 
     void update(std::size_t x, std::size_t y, std::size_t z, std::size_t width, std::size_t height, std::size_t depth,
                 const void* data, std::size_t level) override
     {
-        glBindTexture(GL_TEXTURE_3D, this->id);
+        this->state->bindTexture(GL_TEXTURE_3D, this->id);
         glTexSubImage3D(GL_TEXTURE_3D, static_cast<GLint>(level), static_cast<GLint>(x), static_cast<GLint>(y),
                         static_cast<GLint>(z), static_cast<GLsizei>(width), static_cast<GLsizei>(height),
                         static_cast<GLsizei>(depth), this->format, this->type, data);
@@ -682,10 +904,11 @@ public:
 
     void generateMipmaps() override
     {
-        glBindTexture(GL_TEXTURE_3D, this->id);
+        this->state->bindTexture(GL_TEXTURE_3D, this->id);
         glGenerateMipmap(GL_TEXTURE_3D);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
     GLenum internalFormat;
     GLenum format;
@@ -695,8 +918,9 @@ public:
 class OGLCubeMap : public impl::CubeMap
 {
 public:
-    OGLCubeMap(GLuint id, GLenum internalFormat, GLenum format, GLenum type)
-        : id(id)
+    OGLCubeMap(std::shared_ptr<OGLState> state, GLuint id, GLenum internalFormat, GLenum format, GLenum type)
+        : state(std::move(state))
+        , id(id)
         , internalFormat(internalFormat)
         , format(format)
         , type(type)
@@ -705,6 +929,7 @@ public:
 
     ~OGLCubeMap() override
     {
+        this->state->forgetTexture(this->id);
         glDeleteTextures(1, &this->id);
     }
 
@@ -714,17 +939,18 @@ public:
         GLenum glFace;
         cubeFaceToGL(face, glFace);
 
-        glBindTexture(GL_TEXTURE_CUBE_MAP, this->id);
+        this->state->bindTexture(GL_TEXTURE_CUBE_MAP, this->id);
         glTexSubImage2D(glFace, static_cast<GLint>(level), static_cast<GLint>(x), static_cast<GLint>(y),
                         static_cast<GLsizei>(width), static_cast<GLsizei>(height), this->format, this->type, data);
     }
 
     void generateMipmaps() override
     {
-        glBindTexture(GL_TEXTURE_CUBE_MAP, this->id);
+        this->state->bindTexture(GL_TEXTURE_CUBE_MAP, this->id);
         glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
     GLenum internalFormat;
     GLenum format;
@@ -734,8 +960,9 @@ public:
 class OGLCubeMapArray : public impl::CubeMapArray
 {
 public:
-    OGLCubeMapArray(GLuint id, GLenum internalFormat, GLenum format, GLenum type)
-        : id(id)
+    OGLCubeMapArray(std::shared_ptr<OGLState> state, GLuint id, GLenum internalFormat, GLenum format, GLenum type)
+        : state(std::move(state))
+        , id(id)
         , internalFormat(internalFormat)
         , format(format)
         , type(type)
@@ -744,13 +971,14 @@ public:
 
     ~OGLCubeMapArray() override
     {
+        this->state->forgetTexture(this->id);
         glDeleteTextures(1, &this->id);
     }
 
     void update(std::size_t x, std::size_t y, std::size_t i, std::size_t width, std::size_t height, const void* data,
                 CubeFace face, std::size_t level = 0) override
     {
-        glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, this->id);
+        this->state->bindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, this->id);
         glTexSubImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, static_cast<GLint>(level), static_cast<GLint>(x),
                         static_cast<GLint>(y), static_cast<GLint>(i) * 6 + static_cast<GLint>(face),
                         static_cast<GLsizei>(width), static_cast<GLsizei>(height), 1, this->format, this->type, data);
@@ -758,10 +986,11 @@ public:
 
     void generateMipmaps() override
     {
-        glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, this->id);
+        this->state->bindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, this->id);
         glGenerateMipmap(GL_TEXTURE_CUBE_MAP_ARRAY);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
     GLenum internalFormat;
     GLenum format;
@@ -771,13 +1000,15 @@ public:
 class OGLConstantBuffer : public impl::ConstantBuffer
 {
 public:
-    OGLConstantBuffer(GLuint id)
-        : id(id)
+    OGLConstantBuffer(std::shared_ptr<OGLState> state, GLuint id)
+        : state(std::move(state))
+        , id(id)
     {
     }
 
     ~OGLConstantBuffer() override
     {
+        this->state->forgetBuffer(this->id);
         glDeleteBuffers(1, &this->id);
     }
 
@@ -792,14 +1023,16 @@ public:
         glUnmapBuffer(GL_UNIFORM_BUFFER);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
 };
 
 class OGLIndexBuffer : public impl::IndexBuffer
 {
 public:
-    OGLIndexBuffer(GLuint id, GLenum format, std::size_t indexSz)
-        : id(id)
+    OGLIndexBuffer(std::shared_ptr<OGLState> state, GLuint id, GLenum format, std::size_t indexSz)
+        : state(std::move(state))
+        , id(id)
         , format(format)
         , indexSz(indexSz)
     {
@@ -807,12 +1040,13 @@ public:
 
     ~OGLIndexBuffer() override
     {
+        this->state->forgetBuffer(this->id);
         glDeleteBuffers(1, &this->id);
     }
 
     void* map() override
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->id);
+        this->state->bindIndexBuffer(this->id);
         return glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY);
     }
 
@@ -821,6 +1055,7 @@ public:
         glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
     GLenum format;
     std::size_t indexSz;
@@ -829,13 +1064,15 @@ public:
 class OGLVertexBuffer : public impl::VertexBuffer
 {
 public:
-    OGLVertexBuffer(GLuint id)
-        : id(id)
+    OGLVertexBuffer(std::shared_ptr<OGLState> state, GLuint id)
+        : state(std::move(state))
+        , id(id)
     {
     }
 
     ~OGLVertexBuffer() override
     {
+        this->state->forgetBuffer(this->id);
         glDeleteBuffers(1, &this->id);
     }
 
@@ -850,14 +1087,16 @@ public:
         glUnmapBuffer(GL_ARRAY_BUFFER);
     }
 
+    std::shared_ptr<OGLState> state;
     GLuint id;
 };
 
 class OGLVertexArray : public impl::VertexArray
 {
 public:
-    OGLVertexArray(GLuint id, const VertexBuffer* buffers)
-        : id(id)
+    OGLVertexArray(std::shared_ptr<OGLState> state, GLuint id, const VertexBuffer* buffers)
+        : state(std::move(state))
+        , id(id)
     {
         for (std::size_t i = 0; i < CUBOS_CORE_GL_MAX_VERTEX_ARRAY_BUFFER_COUNT; ++i)
         {
@@ -867,9 +1106,11 @@ public:
 
     ~OGLVertexArray() override
     {
+        this->state->forgetVertexArray(this->id);
         glDeleteVertexArrays(1, &this->id);
     }
 
+    std::shared_ptr<OGLState> state;
     VertexBuffer buffers[CUBOS_CORE_GL_MAX_VERTEX_ARRAY_BUFFER_COUNT];
     GLuint id;
 };
@@ -900,8 +1141,8 @@ public:
 class OGLShaderBindingPoint : public impl::ShaderBindingPoint
 {
 public:
-    OGLShaderBindingPoint(const char* name, int loc, int tex = 0)
-        : name(name)
+    OGLShaderBindingPoint(std::shared_ptr<OGLState> state, int loc, int tex = 0)
+        : state(std::move(state))
         , loc(loc)
         , tex(tex)
     {
@@ -909,111 +1150,45 @@ public:
 
     void bind(Sampler sampler) override
     {
-        if (sampler)
-        {
-            glBindSampler(static_cast<GLuint>(this->tex), std::static_pointer_cast<OGLSampler>(sampler)->id);
-        }
-        else
-        {
-            glBindSampler(static_cast<GLuint>(this->tex), 0);
-        }
+        auto id = sampler ? std::static_pointer_cast<OGLSampler>(sampler)->id : 0;
+        this->state->bindSampler(static_cast<GLuint>(this->tex), id);
     }
 
     void bind(Texture1D tex) override
     {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(this->tex));
-        if (tex)
-        {
-            glBindTexture(GL_TEXTURE_1D, std::static_pointer_cast<OGLTexture1D>(tex)->id);
-        }
-        else
-        {
-            glBindTexture(GL_TEXTURE_1D, 0);
-        }
-        glUniform1i(this->loc, this->tex);
+        this->bindTexture(GL_TEXTURE_1D, tex ? std::static_pointer_cast<OGLTexture1D>(tex)->id : 0);
     }
 
     void bind(Texture2D tex) override
     {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(this->tex));
-        if (tex)
-        {
-            glBindTexture(GL_TEXTURE_2D, std::static_pointer_cast<OGLTexture2D>(tex)->id);
-        }
-        else
-        {
-            glBindTexture(GL_TEXTURE_2D, 0);
-        }
-        glUniform1i(this->loc, this->tex);
+        this->bindTexture(GL_TEXTURE_2D, tex ? std::static_pointer_cast<OGLTexture2D>(tex)->id : 0);
     }
 
     void bind(Texture2DArray tex) override
     {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(this->tex));
-        if (tex)
-        {
-            glBindTexture(GL_TEXTURE_2D_ARRAY, std::static_pointer_cast<OGLTexture2DArray>(tex)->id);
-        }
-        else
-        {
-            glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
-        }
-        glUniform1i(this->loc, this->tex);
+        this->bindTexture(GL_TEXTURE_2D_ARRAY, tex ? std::static_pointer_cast<OGLTexture2DArray>(tex)->id : 0);
     }
 
     void bind(Texture3D tex) override
     {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(this->tex));
-        if (tex)
-        {
-            glBindTexture(GL_TEXTURE_3D, std::static_pointer_cast<OGLTexture3D>(tex)->id);
-        }
-        else
-        {
-            glBindTexture(GL_TEXTURE_3D, 0);
-        }
-        glUniform1i(this->loc, this->tex);
+        this->bindTexture(GL_TEXTURE_3D, tex ? std::static_pointer_cast<OGLTexture3D>(tex)->id : 0);
     }
 
     void bind(CubeMap cubeMap) override
     {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(this->tex));
-        if (cubeMap)
-        {
-            glBindTexture(GL_TEXTURE_CUBE_MAP, std::static_pointer_cast<OGLCubeMap>(cubeMap)->id);
-        }
-        else
-        {
-            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-        }
-        glUniform1i(this->loc, this->tex);
+        this->bindTexture(GL_TEXTURE_CUBE_MAP, cubeMap ? std::static_pointer_cast<OGLCubeMap>(cubeMap)->id : 0);
     }
 
     void bind(CubeMapArray cubeMap) override
     {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(this->tex));
-        if (cubeMap)
-        {
-            glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, std::static_pointer_cast<OGLCubeMapArray>(cubeMap)->id);
-        }
-        else
-        {
-            glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, 0);
-        }
-        glUniform1i(this->loc, this->tex);
+        this->bindTexture(GL_TEXTURE_CUBE_MAP_ARRAY,
+                          cubeMap ? std::static_pointer_cast<OGLCubeMapArray>(cubeMap)->id : 0);
     }
 
     void bind(ConstantBuffer cb) override
     {
-        if (cb)
-        {
-            glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(this->loc),
-                             std::static_pointer_cast<OGLConstantBuffer>(cb)->id);
-        }
-        else
-        {
-            glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(this->loc), 0);
-        }
+        auto id = cb ? std::static_pointer_cast<OGLConstantBuffer>(cb)->id : 0;
+        this->state->bindUniformBuffer(static_cast<GLuint>(this->loc), id);
     }
 
     void bind(gl::Texture2D tex, int level, Access access) override
@@ -1035,74 +1210,117 @@ public:
             abort();
         }
 
-        glUniform1i(this->loc, this->tex);
+        if (this->changed(this->tex))
+        {
+            glUniform1i(this->loc, this->tex);
+        }
+        this->state->stats.issued += 1;
         glBindImageTexture(static_cast<GLuint>(this->tex), texImpl->id, level, GL_TRUE, 0, glAccess,
                            texImpl->internalFormat);
     }
 
     void setConstant(glm::vec2 val) override
     {
-        glUniform2fv(loc, 1, &val[0]);
+        if (this->changed(val))
+        {
+            glUniform2fv(loc, 1, &val[0]);
+        }
     }
 
     void setConstant(glm::vec3 val) override
     {
-        glUniform3fv(loc, 1, &val[0]);
+        if (this->changed(val))
+        {
+            glUniform3fv(loc, 1, &val[0]);
+        }
     }
 
     void setConstant(glm::vec4 val) override
     {
-        glUniform4fv(loc, 1, &val[0]);
+        if (this->changed(val))
+        {
+            glUniform4fv(loc, 1, &val[0]);
+        }
     }
 
     void setConstant(glm::ivec2 val) override
     {
-        glUniform2iv(loc, 1, &val[0]);
+        if (this->changed(val))
+        {
+            glUniform2iv(loc, 1, &val[0]);
+        }
     }
 
     void setConstant(glm::ivec3 val) override
     {
-        glUniform3iv(loc, 1, &val[0]);
+        if (this->changed(val))
+        {
+            glUniform3iv(loc, 1, &val[0]);
+        }
     }
 
     void setConstant(glm::ivec4 val) override
     {
-        glUniform4iv(loc, 1, &val[0]);
+        if (this->changed(val))
+        {
+            glUniform4iv(loc, 1, &val[0]);
+        }
     }
 
     void setConstant(glm::uvec2 val) override
     {
-        glUniform2uiv(loc, 1, &val[0]);
+        if (this->changed(val))
+        {
+            glUniform2uiv(loc, 1, &val[0]);
+        }
     }
 
     void setConstant(glm::uvec3 val) override
     {
-        glUniform3uiv(loc, 1, &val[0]);
+        if (this->changed(val))
+        {
+            glUniform3uiv(loc, 1, &val[0]);
+        }
     }
 
     void setConstant(glm::uvec4 val) override
     {
-        glUniform4uiv(loc, 1, &val[0]);
+        if (this->changed(val))
+        {
+            glUniform4uiv(loc, 1, &val[0]);
+        }
     }
 
     void setConstant(glm::mat4 val) override
     {
-        glUniformMatrix4fv(loc, 1, GL_FALSE, &val[0][0]);
+        if (this->changed(val))
+        {
+            glUniformMatrix4fv(loc, 1, GL_FALSE, &val[0][0]);
+        }
     }
 
     void setConstant(float val) override
     {
-        glUniform1f(loc, val);
+        if (this->changed(val))
+        {
+            glUniform1f(loc, val);
+        }
     }
 
     void setConstant(int val) override
     {
-        glUniform1i(loc, val);
+        if (this->changed(val))
+        {
+            glUniform1i(loc, val);
+        }
     }
 
     void setConstant(unsigned int val) override
     {
-        glUniform1ui(loc, val);
+        if (this->changed(val))
+        {
+            glUniform1ui(loc, val);
+        }
     }
 
     bool queryConstantBufferStructure(ConstantBufferStructure* /*structure*/) override
@@ -1110,15 +1328,45 @@ public:
         return false; // TODO
     }
 
-    std::string name;
+    std::shared_ptr<OGLState> state;
     int loc, tex;
+
+private:
+    /// Checks whether a value differs from the one last set to the uniform, and stores it if so.
+    /// Uniforms belong to their program, so the value is only lost if the program is relinked.
+    template <typename T>
+    bool changed(const T& val)
+    {
+        static_assert(sizeof(T) <= sizeof(mValue), "Value doesn't fit the uniform cache");
+        if (!this->state->issue(mValueSize != sizeof(T) || std::memcmp(mValue, &val, sizeof(T)) != 0))
+        {
+            return false;
+        }
+
+        std::memcpy(mValue, &val, sizeof(T));
+        mValueSize = sizeof(T);
+        return true;
+    }
+
+    void bindTexture(GLenum target, GLuint id)
+    {
+        this->state->bindTexture(static_cast<GLuint>(this->tex), target, id);
+        if (this->changed(this->tex))
+        {
+            glUniform1i(this->loc, this->tex);
+        }
+    }
+
+    unsigned char mValue[sizeof(glm::mat4)];
+    std::size_t mValueSize{0};
 };
 
 class OGLShaderPipeline : public impl::ShaderPipeline
 {
 public:
-    OGLShaderPipeline(ShaderStage vs, ShaderStage ps, GLuint program)
-        : vs(std::move(vs))
+    OGLShaderPipeline(std::shared_ptr<OGLState> state, ShaderStage vs, ShaderStage ps, GLuint program)
+        : state(std::move(state))
+        , vs(std::move(vs))
         , ps(std::move(ps))
         , program(program)
     {
@@ -1127,14 +1375,16 @@ public:
         mSsboCount = 0;
     }
 
-    OGLShaderPipeline(ShaderStage vs, ShaderStage gs, ShaderStage ps, GLuint program)
-        : OGLShaderPipeline(std::move(vs), std::move(ps), program)
+    OGLShaderPipeline(std::shared_ptr<OGLState> state, ShaderStage vs, ShaderStage gs, ShaderStage ps,
+                      GLuint program)
+        : OGLShaderPipeline(std::move(state), std::move(vs), std::move(ps), program)
     {
         this->gs = std::move(gs);
     }
 
-    OGLShaderPipeline(ShaderStage cs, GLuint program)
-        : cs(std::move(cs))
+    OGLShaderPipeline(std::shared_ptr<OGLState> state, ShaderStage cs, GLuint program)
+        : state(std::move(state))
+        , cs(std::move(cs))
         , program(program)
     {
         mTexCount = 0;
@@ -1144,27 +1394,38 @@ public:
 
     ~OGLShaderPipeline() override
     {
+        // Forget the program, so that a new program which reuses its name is always used.
+        if (this->state->program == this->program)
+        {
+            this->state->program = UnknownBinding;
+        }
         glDeleteProgram(this->program);
     }
 
     ShaderBindingPoint getBindingPoint(const char* name) override
     {
-        // Search for already existing binding point
-        for (auto& bp : this->bps)
+        // Search for an already existing binding point. Names which aren't found are also stored,
+        // so that looking them up again doesn't query OpenGL.
+        auto [it, inserted] = this->bps.try_emplace(name);
+        if (inserted)
         {
-            if (bp.name == name)
-            {
-                return &bp;
-            }
+            it->second = this->createBindingPoint(name);
         }
+        return it->second.get();
+    }
 
-        // No existing binding point was found, it must be created first
+    std::shared_ptr<OGLState> state;
+    ShaderStage vs, gs, ps, cs;
+    GLuint program;
+    std::unordered_map<std::string, std::unique_ptr<OGLShaderBindingPoint>> bps;
 
+private:
+    std::unique_ptr<OGLShaderBindingPoint> createBindingPoint(const char* name)
+    {
         auto loc = glGetUniformLocation(this->program, name);
         if (loc != -1)
         {
-            bps.emplace_back(name, loc, mTexCount++);
-            return &bps.back();
+            return std::make_unique<OGLShaderBindingPoint>(this->state, loc, mTexCount++);
         }
 
         // Search for uniform block binding
@@ -1182,8 +1443,7 @@ public:
             }
 
             mUboCount += 1;
-            bps.emplace_back(name, loc);
-            return &bps.back();
+            return std::make_unique<OGLShaderBindingPoint>(this->state, loc);
         }
 
         // Search for shader storage block binding
@@ -1201,24 +1461,19 @@ public:
             }
 
             mSsboCount += 1;
-            bps.emplace_back(name, loc);
-            return &bps.back();
+            return std::make_unique<OGLShaderBindingPoint>(this->state, loc);
         }
 
         return nullptr;
     }
 
-    ShaderStage vs, gs, ps, cs;
-    GLuint program;
-    std::list<OGLShaderBindingPoint> bps;
-
-private:
     int mTexCount;
     int mUboCount;
     int mSsboCount;
 };
 
 OGLRenderDevice::OGLRenderDevice()
+    : mState(std::make_shared<OGLState>())
 {
     // Set the debug message callback
     // TODO: disable this on release for performance reasons (?)
@@ -1284,7 +1539,7 @@ Framebuffer OGLRenderDevice::createFramebuffer(const FramebufferDesc& desc)
     // Initialize framebuffer
     GLuint id;
     glGenFramebuffers(1, &id);
-    glBindFramebuffer(GL_FRAMEBUFFER, id);
+    mState->bindFramebuffer(id);
 
     // Attach targets
     std::vector<GLenum> drawBuffers;
@@ -1407,6 +1662,7 @@ Framebuffer OGLRenderDevice::createFramebuffer(const FramebufferDesc& desc)
 
         if (formatError)
         {
+            mState->forgetFramebuffer(id);
             glDeleteFramebuffers(1, &id);
             CUBOS_ERROR("Invalid depth stencil target format");
             return nullptr;
@@ -1420,6 +1676,7 @@ Framebuffer OGLRenderDevice::createFramebuffer(const FramebufferDesc& desc)
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetFramebuffer(id);
         glDeleteFramebuffers(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
@@ -1428,24 +1685,18 @@ Framebuffer OGLRenderDevice::createFramebuffer(const FramebufferDesc& desc)
     // Check if the framebuffer is complete
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
     {
+        mState->forgetFramebuffer(id);
         glDeleteFramebuffers(1, &id);
         CUBOS_ERROR("glCheckFramebufferStatus didn't return GL_FRAMEBUFFER_COMPLETE");
         return nullptr;
     }
 
-    return std::make_shared<OGLFramebuffer>(id);
+    return std::make_shared<OGLFramebuffer>(mState, id);
 }
 
 void OGLRenderDevice::setFramebuffer(Framebuffer fb)
 {
-    if (fb)
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, std::static_pointer_cast<OGLFramebuffer>(fb)->id);
-    }
-    else
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    }
+    mState->bindFramebuffer(fb ? std::static_pointer_cast<OGLFramebuffer>(fb)->id : 0);
 }
 
 RasterState OGLRenderDevice::createRasterState(const RasterStateDesc& desc)
@@ -1461,7 +1712,18 @@ RasterState OGLRenderDevice::createRasterState(const RasterStateDesc& desc)
 
 void OGLRenderDevice::setRasterState(RasterState rs)
 {
-    auto rsImpl = std::static_pointer_cast<OGLRasterState>(rs ? rs : mDefaultRS);
+    if (!rs)
+    {
+        rs = mDefaultRS;
+    }
+
+    if (!mState->issue(mState->rasterState != rs))
+    {
+        return;
+    }
+    mState->rasterState = rs;
+
+    auto rsImpl = std::static_pointer_cast<OGLRasterState>(rs);
 
     if (rsImpl->cullEnabled == 0U)
     {
@@ -1516,7 +1778,18 @@ DepthStencilState OGLRenderDevice::createDepthStencilState(const DepthStencilSta
 
 void OGLRenderDevice::setDepthStencilState(DepthStencilState dss)
 {
-    auto dssImpl = std::static_pointer_cast<OGLDepthStencilState>(dss ? dss : mDefaultDSS);
+    if (!dss)
+    {
+        dss = mDefaultDSS;
+    }
+
+    if (!mState->issue(mState->depthStencilState != dss))
+    {
+        return;
+    }
+    mState->depthStencilState = dss;
+
+    auto dssImpl = std::static_pointer_cast<OGLDepthStencilState>(dss);
 
     if (dssImpl->depthEnabled == 0U)
     {
@@ -1568,7 +1841,18 @@ BlendState OGLRenderDevice::createBlendState(const BlendStateDesc& desc)
 
 void OGLRenderDevice::setBlendState(BlendState bs)
 {
-    auto bsImpl = std::static_pointer_cast<OGLBlendState>(bs ? bs : mDefaultBS);
+    if (!bs)
+    {
+        bs = mDefaultBS;
+    }
+
+    if (!mState->issue(mState->blendState != bs))
+    {
+        return;
+    }
+    mState->blendState = bs;
+
+    auto bsImpl = std::static_pointer_cast<OGLBlendState>(bs);
 
     if (bsImpl->blendEnabled == 0U)
     {
@@ -1672,7 +1956,7 @@ Sampler OGLRenderDevice::createSampler(const SamplerDesc& desc)
         return nullptr;
     }
 
-    return std::make_shared<OGLSampler>(id);
+    return std::make_shared<OGLSampler>(mState, id);
 }
 
 Texture1D OGLRenderDevice::createTexture1D(const Texture1DDesc& desc)
@@ -1697,7 +1981,7 @@ Texture1D OGLRenderDevice::createTexture1D(const Texture1DDesc& desc)
     // Initialize texture
     GLuint id;
     glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_1D, id);
+    mState->bindTexture(GL_TEXTURE_1D, id);
     for (std::size_t i = 0, div = 1; i < desc.mipLevelCount; ++i, div *= 2)
     {
         glTexImage1D(GL_TEXTURE_1D, static_cast<GLint>(i), static_cast<GLint>(internalFormat),
@@ -1715,12 +1999,13 @@ Texture1D OGLRenderDevice::createTexture1D(const Texture1DDesc& desc)
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetTexture(id);
         glDeleteTextures(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLTexture1D>(id, internalFormat, format, type);
+    return std::make_shared<OGLTexture1D>(mState, id, internalFormat, format, type);
 }
 
 Texture2D OGLRenderDevice::createTexture2D(const Texture2DDesc& desc)
@@ -1738,7 +2023,7 @@ Texture2D OGLRenderDevice::createTexture2D(const Texture2DDesc& desc)
     // Initialize texture
     GLuint id;
     glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_2D, id);
+    mState->bindTexture(GL_TEXTURE_2D, id);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     for (std::size_t i = 0, div = 1; i < desc.mipLevelCount; ++i, div *= 2)
     {
@@ -1759,12 +2044,13 @@ Texture2D OGLRenderDevice::createTexture2D(const Texture2DDesc& desc)
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetTexture(id);
         glDeleteTextures(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLTexture2D>(id, internalFormat, format, type);
+    return std::make_shared<OGLTexture2D>(mState, id, internalFormat, format, type);
 }
 
 Texture2DArray OGLRenderDevice::createTexture2DArray(const Texture2DArrayDesc& desc)
@@ -1782,7 +2068,7 @@ Texture2DArray OGLRenderDevice::createTexture2DArray(const Texture2DArrayDesc& d
     // Initialize texture
     GLuint id;
     glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+    mState->bindTexture(GL_TEXTURE_2D_ARRAY, id);
     glTexStorage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLsizei>(desc.mipLevelCount), internalFormat,
                    static_cast<GLsizei>(desc.width), static_cast<GLsizei>(desc.height),
                    static_cast<GLsizei>(desc.size));
@@ -1811,12 +2097,13 @@ Texture2DArray OGLRenderDevice::createTexture2DArray(const Texture2DArrayDesc& d
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetTexture(id);
         glDeleteTextures(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLTexture2DArray>(id, internalFormat, format, type);
+    return std::make_shared<OGLTexture2DArray>(mState, id, internalFormat, format, type);
 }
 
 Texture3D OGLRenderDevice::createTexture3D(const Texture3DDesc& desc)
@@ -1841,7 +2128,7 @@ Texture3D OGLRenderDevice::createTexture3D(const Texture3DDesc& desc)
     // Initialize texture
     GLuint id;
     glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_3D, id);
+    mState->bindTexture(GL_TEXTURE_3D, id);
     for (std::size_t i = 0, div = 1; i < desc.mipLevelCount; ++i, div *= 2)
     {
         glTexImage3D(GL_TEXTURE_3D, static_cast<GLint>(i), static_cast<GLint>(internalFormat),
@@ -1862,12 +2149,13 @@ Texture3D OGLRenderDevice::createTexture3D(const Texture3DDesc& desc)
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetTexture(id);
         glDeleteTextures(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLTexture3D>(id, internalFormat, format, type);
+    return std::make_shared<OGLTexture3D>(mState, id, internalFormat, format, type);
 }
 
 CubeMap OGLRenderDevice::createCubeMap(const CubeMapDesc& desc)
@@ -1885,7 +2173,7 @@ CubeMap OGLRenderDevice::createCubeMap(const CubeMapDesc& desc)
     // Initialize texture
     GLuint id;
     glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+    mState->bindTexture(GL_TEXTURE_CUBE_MAP, id);
     for (std::size_t i = 0, div = 1; i < desc.mipLevelCount; ++i, div *= 2)
     {
         glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X, static_cast<GLint>(i), static_cast<GLint>(internalFormat),
@@ -1920,12 +2208,13 @@ CubeMap OGLRenderDevice::createCubeMap(const CubeMapDesc& desc)
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetTexture(id);
         glDeleteTextures(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLCubeMap>(id, internalFormat, format, type);
+    return std::make_shared<OGLCubeMap>(mState, id, internalFormat, format, type);
 }
 
 CubeMapArray OGLRenderDevice::createCubeMapArray(const CubeMapArrayDesc& desc)
@@ -1943,7 +2232,7 @@ CubeMapArray OGLRenderDevice::createCubeMapArray(const CubeMapArrayDesc& desc)
     // Initialize texture
     GLuint id;
     glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, id);
+    mState->bindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, id);
     glTexStorage3D(GL_TEXTURE_CUBE_MAP_ARRAY, static_cast<GLsizei>(desc.mipLevelCount), internalFormat,
                    static_cast<GLsizei>(desc.width), static_cast<GLsizei>(desc.height),
                    static_cast<GLsizei>(desc.size * 6));
@@ -1975,12 +2264,13 @@ CubeMapArray OGLRenderDevice::createCubeMapArray(const CubeMapArrayDesc& desc)
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetTexture(id);
         glDeleteTextures(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLCubeMapArray>(id, internalFormat, format, type);
+    return std::make_shared<OGLCubeMapArray>(mState, id, internalFormat, format, type);
 }
 
 ConstantBuffer OGLRenderDevice::createConstantBuffer(std::size_t size, const void* data, Usage usage)
@@ -2015,12 +2305,13 @@ ConstantBuffer OGLRenderDevice::createConstantBuffer(std::size_t size, const voi
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetBuffer(id);
         glDeleteBuffers(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLConstantBuffer>(id);
+    return std::make_shared<OGLConstantBuffer>(mState, id);
 }
 
 IndexBuffer OGLRenderDevice::createIndexBuffer(std::size_t size, const void* data, IndexFormat format, Usage usage)
@@ -2065,25 +2356,26 @@ IndexBuffer OGLRenderDevice::createIndexBuffer(std::size_t size, const void* dat
     // Initialize buffer
     GLuint id;
     glGenBuffers(1, &id);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
+    mState->bindIndexBuffer(id);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), data, glUsage);
 
     // Check errors
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetBuffer(id);
         glDeleteBuffers(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLIndexBuffer>(id, glFormat, indexSz);
+    return std::make_shared<OGLIndexBuffer>(mState, id, glFormat, indexSz);
 }
 
 void OGLRenderDevice::setIndexBuffer(IndexBuffer ib)
 {
     auto ibImpl = std::static_pointer_cast<OGLIndexBuffer>(ib);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibImpl->id);
+    mState->bindIndexBuffer(ibImpl->id);
     mCurrentIndexFormat = static_cast<int>(ibImpl->format);
     mCurrentIndexSz = ibImpl->indexSz;
 }
@@ -2120,12 +2412,13 @@ VertexBuffer OGLRenderDevice::createVertexBuffer(std::size_t size, const void* d
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetBuffer(id);
         glDeleteBuffers(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLVertexBuffer>(id);
+    return std::make_shared<OGLVertexBuffer>(mState, id);
 }
 
 VertexArray OGLRenderDevice::createVertexArray(const VertexArrayDesc& desc)
@@ -2136,7 +2429,7 @@ VertexArray OGLRenderDevice::createVertexArray(const VertexArrayDesc& desc)
     // Initialize vertex array
     GLuint id;
     glGenVertexArrays(1, &id);
-    glBindVertexArray(id);
+    mState->bindVertexArray(id);
 
     // Link elements
     assert(desc.elementCount <= CUBOS_CORE_GL_MAX_VERTEX_ARRAY_ELEMENT_COUNT);
@@ -2151,6 +2444,7 @@ VertexArray OGLRenderDevice::createVertexArray(const VertexArrayDesc& desc)
         GLint loc = glGetAttribLocation(pp->program, desc.elements[i].name);
         if (loc == -1)
         {
+            mState->forgetVertexArray(id);
             glDeleteVertexArrays(1, &id);
             CUBOS_ERROR("Could not find vertex element with name '{}'", desc.elements[i].name);
             return nullptr;
@@ -2243,17 +2537,18 @@ VertexArray OGLRenderDevice::createVertexArray(const VertexArrayDesc& desc)
     GLenum glErr = glGetError();
     if (glErr != 0)
     {
+        mState->forgetVertexArray(id);
         glDeleteVertexArrays(1, &id);
         LOG_GL_ERROR(glErr);
         return nullptr;
     }
 
-    return std::make_shared<OGLVertexArray>(id, desc.buffers);
+    return std::make_shared<OGLVertexArray>(mState, id, desc.buffers);
 }
 
 void OGLRenderDevice::setVertexArray(VertexArray va)
 {
-    glBindVertexArray(std::static_pointer_cast<OGLVertexArray>(va)->id);
+    mState->bindVertexArray(std::static_pointer_cast<OGLVertexArray>(va)->id);
 }
 
 ShaderStage OGLRenderDevice::createShaderStage(Stage stage, const char* src)
@@ -2339,7 +2634,7 @@ ShaderPipeline OGLRenderDevice::createShaderPipeline(ShaderStage vs, ShaderStage
         return nullptr;
     }
 
-    return std::make_shared<OGLShaderPipeline>(vsImpl, psImpl, id);
+    return std::make_shared<OGLShaderPipeline>(mState, vsImpl, psImpl, id);
 }
 
 ShaderPipeline OGLRenderDevice::createShaderPipeline(ShaderStage vs, ShaderStage gs, ShaderStage ps)
@@ -2376,7 +2671,7 @@ ShaderPipeline OGLRenderDevice::createShaderPipeline(ShaderStage vs, ShaderStage
         return nullptr;
     }
 
-    return std::make_shared<OGLShaderPipeline>(vsImpl, gsImpl, psImpl, id);
+    return std::make_shared<OGLShaderPipeline>(mState, vsImpl, gsImpl, psImpl, id);
 }
 
 ShaderPipeline OGLRenderDevice::createShaderPipeline(ShaderStage cs)
@@ -2409,12 +2704,12 @@ ShaderPipeline OGLRenderDevice::createShaderPipeline(ShaderStage cs)
         return nullptr;
     }
 
-    return std::make_shared<OGLShaderPipeline>(csImpl, id);
+    return std::make_shared<OGLShaderPipeline>(mState, csImpl, id);
 }
 
 void OGLRenderDevice::setShaderPipeline(ShaderPipeline pipeline)
 {
-    glUseProgram(std::static_pointer_cast<OGLShaderPipeline>(pipeline)->program);
+    mState->useProgram(std::static_pointer_cast<OGLShaderPipeline>(pipeline)->program);
 }
 
 void OGLRenderDevice::clearColor(float r, float g, float b, float a)
@@ -2502,12 +2797,28 @@ void OGLRenderDevice::memoryBarrier(MemoryBarriers barriers)
 
 void OGLRenderDevice::setViewport(int x, int y, int w, int h)
 {
-    glViewport(x, y, w, h);
+    auto& viewport = mState->viewport;
+    if (mState->issue(viewport[0] != x || viewport[1] != y || viewport[2] != w || viewport[3] != h))
+    {
+        viewport[0] = x;
+        viewport[1] = y;
+        viewport[2] = w;
+        viewport[3] = h;
+        glViewport(x, y, w, h);
+    }
 }
 
 void OGLRenderDevice::setScissor(int x, int y, int w, int h)
 {
-    glScissor(x, y, w, h);
+    auto& scissor = mState->scissor;
+    if (mState->issue(scissor[0] != x || scissor[1] != y || scissor[2] != w || scissor[3] != h))
+    {
+        scissor[0] = x;
+        scissor[1] = y;
+        scissor[2] = w;
+        scissor[3] = h;
+        glScissor(x, y, w, h);
+    }
 }
 
 int OGLRenderDevice::getProperty(Property prop)
@@ -2538,3 +2849,13 @@ int OGLRenderDevice::getProperty(Property prop)
         return -1;
     }
 }
+
+RenderDeviceStats OGLRenderDevice::stats() const
+{
+    return mState->stats;
+}
+
+void OGLRenderDevice::resetStats()
+{
+    mState->stats = {};
+}
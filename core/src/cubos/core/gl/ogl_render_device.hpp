@@ -1,9 +1,15 @@
 #pragma once
 
+#include <memory>
+
 #include <cubos/core/gl/render_device.hpp>
 
 namespace cubos::core::gl
 {
+    /// Mirror of the OpenGL state set through an @ref OGLRenderDevice, used to skip calls which
+    /// wouldn't change it.
+    struct OGLState;
+
     /// Render device implementation using OpenGL.
     /// @see RenderDevice.
     class OGLRenderDevice : public RenderDevice
@@ -50,8 +56,13 @@ namespace cubos::core::gl
         void setViewport(int x, int y, int w, int h) override;
         void setScissor(int x, int y, int w, int h) override;
         int getProperty(Property prop) override;
+        RenderDeviceStats stats() const override;
+        void resetStats() override;
 
     private:
+        /// Shared with the objects created by the device, which also change the OpenGL state.
+        std::shared_ptr<OGLState> mState;
+
         int mCurrentIndexFormat;
         std::size_t mCurrentIndexSz;
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 
 #include <cubos/core/gl/palette.hpp>
@@ -5,9 +6,26 @@
 
 using namespace cubos::core::gl;
 
+/// Number of buckets along each color axis of the material index.
+static const int IndexResolution = 8;
+
+/// Gets the coordinates of the bucket of the material index which contains the given color.
+static glm::ivec3 bucketOf(const glm::vec4& color)
+{
+    auto bucket = glm::ivec3(glm::clamp(glm::vec3(color), 0.0F, 1.0F) * static_cast<float>(IndexResolution));
+    return glm::min(bucket, glm::ivec3{IndexResolution - 1});
+}
+
+/// Gets the position of a bucket in the bucket array.
+static std::size_t bucketIndex(const glm::ivec3& bucket)
+{
+    return static_cast<std::size_t>(bucket.x + (bucket.y + bucket.z * IndexResolution) * IndexResolution);
+}
+
 Palette::Palette(std::vector<Material>&& materials)
     : mMaterials(std::move(materials))
 {
+    this->rebuildIndex();
 }
 
 const Material* Palette::data() const
@@ -38,10 +56,20 @@ void Palette::set(uint16_t index, const Material& material)
     }
     if (index > static_cast<uint16_t>(mMaterials.size()))
     {
+        // The slots between the old end of the palette and the new material are empty.
+        for (auto i = static_cast<uint32_t>(mMaterials.size()) + 1; i < index; ++i)
+        {
+            mFree.insert(static_cast<uint16_t>(i));
+        }
         mMaterials.resize(index, Material::Empty);
     }
+    else
+    {
+        this->unindexMaterial(index);
+    }
 
     mMaterials[index - 1] = material;
+    this->indexMaterial(index);
 }
 
 uint16_t Palette::find(const Material& material) const
@@ -49,13 +77,52 @@ uint16_t Palette::find(const Material& material) const
     uint16_t bestI = 0;
     float bestS = material.similarity(Material::Empty);
 
-    for (uint16_t i = 0; i < this->size(); ++i)
+    if (mBuckets.empty())
     {
-        float s = material.similarity(this->get(i + 1));
-        if (s > bestS)
+        return bestI;
+    }
+
+    // Search the buckets in shells of increasing distance around the bucket of the material.
+    // Materials in buckets at distance r differ by at least r - 1 bucket widths in some color
+    // component, which bounds their similarity and lets the search stop early.
+    auto center = bucketOf(material.color);
+    for (int r = 0; r < IndexResolution; ++r)
+    {
+        if (r > 1)
         {
-            bestS = s;
-            bestI = i + 1;
+            auto bound = 1.0F - static_cast<float>(r - 1) / (static_cast<float>(IndexResolution) * 4.0F);
+            if (bound + 1e-5F < bestS)
+            {
+                break;
+            }
+        }
+
+        auto min = glm::max(center - r, glm::ivec3{0});
+        auto max = glm::min(center + r, glm::ivec3{IndexResolution - 1});
+        for (int z = min.z; z <= max.z; ++z)
+        {
+            for (int y = min.y; y <= max.y; ++y)
+            {
+                for (int x = min.x; x <= max.x; ++x)
+                {
+                    // Only visit the buckets on the surface of the shell.
+                    if (glm::abs(x - center.x) != r && glm::abs(y - center.y) != r && glm::abs(z - center.z) != r)
+                    {
+                        continue;
+                    }
+
+                    for (auto i : mBuckets[bucketIndex({x, y, z})])
+                    {
+                        // Ties are broken in favor of the lowest index, as the index order is not preserved.
+                        float s = material.similarity(mMaterials[i - 1]);
+                        if (s > bestS || (s == bestS && bestI != 0 && i < bestI))
+                        {
+                            bestS = s;
+                            bestI = i;
+                        }
+                    }
+                }
+            }
         }
     }
 
@@ -70,13 +137,11 @@ uint16_t Palette::add(const Material& material, float similarity)
         return i;
     }
 
-    for (uint16_t i = 0; i < this->size(); ++i)
+    if (!mFree.empty())
     {
-        if (this->get(i + 1).similarity(Material::Empty) >= 1.0F)
-        {
-            this->set(i + 1, material);
-            return i + 1;
-        }
+        auto slot = *mFree.begin();
+        this->set(slot, material);
+        return slot;
     }
 
     if (this->size() == UINT16_MAX)
@@ -85,7 +150,7 @@ uint16_t Palette::add(const Material& material, float similarity)
         return i;
     }
 
-    mMaterials.push_back(material);
+    this->set(static_cast<uint16_t>(this->size() + 1), material);
     return this->size();
 }
 
@@ -97,6 +162,46 @@ void Palette::merge(const Palette& palette, float similarity)
     }
 }
 
+void Palette::indexMaterial(uint16_t index)
+{
+    const auto& material = mMaterials[index - 1];
+    if (material.similarity(Material::Empty) >= 1.0F)
+    {
+        mFree.insert(index);
+        return;
+    }
+
+    if (mBuckets.empty())
+    {
+        mBuckets.resize(static_cast<std::size_t>(IndexResolution * IndexResolution * IndexResolution));
+    }
+
+    mBuckets[bucketIndex(bucketOf(material.color))].push_back(index);
+}
+
+void Palette::unindexMaterial(uint16_t index)
+{
+    const auto& material = mMaterials[index - 1];
+    if (material.similarity(Material::Empty) >= 1.0F)
+    {
+        mFree.erase(index);
+        return;
+    }
+
+    auto& indices = mBuckets[bucketIndex(bucketOf(material.color))];
+    indices.erase(std::find(indices.begin(), indices.end(), index));
+}
+
+void Palette::rebuildIndex()
+{
+    mBuckets.clear();
+    mFree.clear();
+    for (uint32_t i = 1; i <= mMaterials.size(); ++i)
+    {
+        this->indexMaterial(static_cast<uint16_t>(i));
+    }
+}
+
 void cubos::core::data::serialize(Serializer& serializer, const gl::Palette& palette, const char* name)
 {
     // Count non-empty materials.
@@ -146,4 +251,6 @@ void cubos::core::data::deserialize(Deserializer& deserializer, gl::Palette& pal
         palette.mMaterials[index - 1] = mat;
     }
     deserializer.endDictionary();
+
+    palette.rebuildIndex();
 }
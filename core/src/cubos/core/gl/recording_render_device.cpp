@@ -0,0 +1,657 @@
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <cubos/core/gl/recording_render_device.hpp>
+
+using namespace cubos::core;
+using namespace cubos::core::gl;
+
+using Command = RecordingRenderDevice::Command;
+using CommandType = RecordingRenderDevice::Command::Type;
+
+struct cubos::core::gl::RecordingState
+{
+    /// Records a command.
+    void record(CommandType type, std::size_t a = 0, std::size_t b = 0, std::size_t c = 0, std::size_t d = 0)
+    {
+        Command command{type};
+        command.args[0] = static_cast<std::uint32_t>(a);
+        command.args[1] = static_cast<std::uint32_t>(b);
+        command.args[2] = static_cast<std::uint32_t>(c);
+        command.args[3] = static_cast<std::uint32_t>(d);
+        this->frame.commands.push_back(command);
+    }
+
+    /// Records a state change.
+    void recordChange(CommandType type, std::uint32_t object)
+    {
+        this->record(type, object);
+        this->frame.counts.stateChanges += 1;
+        this->stats.issued += 1;
+    }
+
+    std::uint32_t nextId{1};
+    RecordingRenderDevice::Frame frame;
+    RenderDeviceStats stats;
+};
+
+namespace
+{
+    /// Object created by the device, identified in the recorded commands by its identifier.
+    class RecordedObject
+    {
+    public:
+        RecordedObject(std::shared_ptr<RecordingState> state)
+            : state(std::move(state))
+            , id(this->state->nextId++)
+        {
+        }
+
+        std::shared_ptr<RecordingState> state;
+        std::uint32_t id;
+    };
+
+    class RecordingFramebuffer : public impl::Framebuffer, public RecordedObject
+    {
+    public:
+        using RecordedObject::RecordedObject;
+    };
+
+    class RecordingRasterState : public impl::RasterState, public RecordedObject
+    {
+    public:
+        using RecordedObject::RecordedObject;
+    };
+
+    class RecordingDepthStencilState : public impl::DepthStencilState, public RecordedObject
+    {
+    public:
+        using RecordedObject::RecordedObject;
+    };
+
+    class RecordingBlendState : public impl::BlendState, public RecordedObject
+    {
+    public:
+        using RecordedObject::RecordedObject;
+    };
+
+    class RecordingSampler : public impl::Sampler, public RecordedObject
+    {
+    public:
+        using RecordedObject::RecordedObject;
+    };
+
+    /// Implements the methods common to every texture type.
+    template <typename Base>
+    class RecordingTexture : public Base, public RecordedObject
+    {
+    public:
+        using RecordedObject::RecordedObject;
+
+        void generateMipmaps() override
+        {
+            this->state->record(CommandType::GenerateMipmaps, this->id);
+        }
+
+    protected:
+        void recordUpdate(std::size_t texels)
+        {
+            this->state->record(CommandType::UpdateTexture, this->id, texels);
+            this->state->frame.counts.uploads += 1;
+        }
+    };
+
+    class RecordingTexture1D : public RecordingTexture<impl::Texture1D>
+    {
+    public:
+        using RecordingTexture::RecordingTexture;
+
+        void update(std::size_t /*x*/, std::size_t width, const void* /*data*/, std::size_t /*level*/) override
+        {
+            this->recordUpdate(width);
+        }
+    };
+
+    class RecordingTexture2D : public RecordingTexture<impl::Texture2D>
+    {
+    public:
+        using RecordingTexture::RecordingTexture;
+
+        void update(std::size_t /*x*/, std::size_t /*y*/, std::size_t width, std::size_t height, const void* /*data*/,
+                    std::size_t /*level*/) override
+        {
+            this->recordUpdate(width * height);
+        }
+    };
+
+    class RecordingTexture2DArray : public RecordingTexture<impl::Texture2DArray>
+    {
+    public:
+        using RecordingTexture::RecordingTexture;
+
+        void update(std::size_t /*x*/, std::size_t /*y*/, std::size_t /*i*/, std::size_t width, std::size_t height,
+                    const void* /*data*/, std::size_t /*level*/) override
+        {
+            this->recordUpdate(width * height);
+        }
+    };
+
+    class RecordingTexture3D : public RecordingTexture<impl::Texture3D>
+    {
+    public:
+        using RecordingTexture::RecordingTexture;
+
+        void update(std::size_t /*x*/, std::size_t /*y*/, std::size_t /*z*/, std::size_t width, std::size_t height,
+                    std::size_t depth, const void* /*data*/, std::size_t /*level*/) override
+        {
+            this->recordUpdate(width * height * depth);
+        }
+    };
+
+    class RecordingCubeMap : public RecordingTexture<impl::CubeMap>
+    {
+    public:
+        using RecordingTexture::RecordingTexture;
+
+        void update(std::size_t /*x*/, std::size_t /*y*/, std::size_t width, std::size_t height, const void* /*data*/,
+                    CubeFace /*face*/, std::size_t /*level*/) override
+        {
+            this->recordUpdate(width * height);
+        }
+    };
+
+    class RecordingCubeMapArray : public RecordingTexture<impl::CubeMapArray>
+    {
+    public:
+        using RecordingTexture::RecordingTexture;
+
+        void update(std::size_t /*x*/, std::size_t /*y*/, std::size_t /*i*/, std::size_t width, std::size_t height,
+                    const void* /*data*/, CubeFace /*face*/, std::size_t /*level*/) override
+        {
+            this->recordUpdate(width * height);
+        }
+    };
+
+    /// Implements the buffer types, whose contents are kept on the CPU.
+    template <typename Base>
+    class RecordingBuffer : public Base, public RecordedObject
+    {
+    public:
+        RecordingBuffer(std::shared_ptr<RecordingState> state, std::size_t size, const void* data)
+            : RecordedObject(std::move(state))
+            , data(size)
+        {
+            if (data != nullptr)
+            {
+                std::memcpy(this->data.data(), data, size);
+            }
+        }
+
+        void* map() override
+        {
+            this->state->record(CommandType::MapBuffer, this->id, this->data.size());
+            this->state->frame.counts.bytesMapped += this->data.size();
+            return this->data.data();
+        }
+
+        void unmap() override
+        {
+        }
+
+        std::vector<unsigned char> data;
+    };
+
+    using RecordingConstantBuffer = RecordingBuffer<impl::ConstantBuffer>;
+    using RecordingVertexBuffer = RecordingBuffer<impl::VertexBuffer>;
+
+    class RecordingIndexBuffer : public RecordingBuffer<impl::IndexBuffer>
+    {
+    public:
+        using RecordingBuffer::RecordingBuffer;
+    };
+
+    class RecordingVertexArray : public impl::VertexArray, public RecordedObject
+    {
+    public:
+        using RecordedObject::RecordedObject;
+    };
+
+    class RecordingShaderStage : public impl::ShaderStage
+    {
+    public:
+        RecordingShaderStage(Stage type)
+            : type(type)
+        {
+        }
+
+        Stage getType() override
+        {
+            return this->type;
+        }
+
+        Stage type;
+    };
+
+    /// Gets the identifier of an object, or 0 if it's null.
+    template <typename Recorded, typename Handle>
+    std::uint32_t idOf(const Handle& handle)
+    {
+        return handle ? std::static_pointer_cast<Recorded>(handle)->id : 0;
+    }
+
+    class RecordingShaderBindingPoint : public impl::ShaderBindingPoint, public RecordedObject
+    {
+    public:
+        using RecordedObject::RecordedObject;
+
+        void bind(Sampler sampler) override
+        {
+            this->recordBind(idOf<RecordingSampler>(sampler));
+        }
+
+        void bind(Texture1D tex) override
+        {
+            this->recordBind(idOf<RecordingTexture1D>(tex));
+        }
+
+        void bind(Texture2D tex) override
+        {
+            this->recordBind(idOf<RecordingTexture2D>(tex));
+        }
+
+        void bind(Texture2DArray tex) override
+        {
+            this->recordBind(idOf<RecordingTexture2DArray>(tex));
+        }
+
+        void bind(Texture3D tex) override
+        {
+            this->recordBind(idOf<RecordingTexture3D>(tex));
+        }
+
+        void bind(CubeMap cubeMap) override
+        {
+            this->recordBind(idOf<RecordingCubeMap>(cubeMap));
+        }
+
+        void bind(CubeMapArray cubeMap) override
+        {
+            this->recordBind(idOf<RecordingCubeMapArray>(cubeMap));
+        }
+
+        void bind(ConstantBuffer cb) override
+        {
+            this->recordBind(idOf<RecordingConstantBuffer>(cb));
+        }
+
+        void bind(Texture2D tex, int /*level*/, Access /*access*/) override
+        {
+            this->recordBind(idOf<RecordingTexture2D>(tex));
+        }
+
+        void setConstant(glm::vec2 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(glm::vec3 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(glm::vec4 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(glm::ivec2 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(glm::ivec3 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(glm::ivec4 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(glm::uvec2 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(glm::uvec3 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(glm::uvec4 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(glm::mat4 val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(float val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(int val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        void setConstant(unsigned int val) override
+        {
+            this->recordConstant(sizeof(val));
+        }
+
+        bool queryConstantBufferStructure(ConstantBufferStructure* /*structure*/) override
+        {
+            return false;
+        }
+
+    private:
+        void recordBind(std::uint32_t object)
+        {
+            this->state->record(CommandType::Bind, this->id, object);
+            this->state->frame.counts.binds += 1;
+            this->state->stats.issued += 1;
+        }
+
+        void recordConstant(std::size_t size)
+        {
+            this->state->record(CommandType::SetConstant, this->id, size);
+            this->state->frame.counts.constants += 1;
+            this->state->stats.issued += 1;
+        }
+    };
+
+    class RecordingShaderPipeline : public impl::ShaderPipeline, public RecordedObject
+    {
+    public:
+        using RecordedObject::RecordedObject;
+
+        ShaderBindingPoint getBindingPoint(const char* name) override
+        {
+            // There are no shaders to check the name against, so every name is accepted.
+            auto& bp = this->bps[name];
+            if (bp == nullptr)
+            {
+                bp = std::make_unique<RecordingShaderBindingPoint>(this->state);
+            }
+            return bp.get();
+        }
+
+        std::unordered_map<std::string, std::unique_ptr<RecordingShaderBindingPoint>> bps;
+    };
+} // namespace
+
+RecordingRenderDevice::RecordingRenderDevice()
+    : mState(std::make_shared<RecordingState>())
+{
+}
+
+RecordingRenderDevice::~RecordingRenderDevice() = default;
+
+void RecordingRenderDevice::endFrame()
+{
+    // Swap the frames, so that the memory of the commands is reused.
+    std::swap(mLastFrame, mState->frame);
+    mState->frame.commands.clear();
+    mState->frame.counts = {};
+}
+
+const RecordingRenderDevice::Frame& RecordingRenderDevice::frame() const
+{
+    return mState->frame;
+}
+
+const RecordingRenderDevice::Frame& RecordingRenderDevice::lastFrame() const
+{
+    return mLastFrame;
+}
+
+Framebuffer RecordingRenderDevice::createFramebuffer(const FramebufferDesc& /*desc*/)
+{
+    return std::make_shared<RecordingFramebuffer>(mState);
+}
+
+void RecordingRenderDevice::setFramebuffer(Framebuffer fb)
+{
+    mState->recordChange(CommandType::SetFramebuffer, idOf<RecordingFramebuffer>(fb));
+}
+
+RasterState RecordingRenderDevice::createRasterState(const RasterStateDesc& /*desc*/)
+{
+    return std::make_shared<RecordingRasterState>(mState);
+}
+
+void RecordingRenderDevice::setRasterState(RasterState rs)
+{
+    mState->recordChange(CommandType::SetRasterState, idOf<RecordingRasterState>(rs));
+}
+
+DepthStencilState RecordingRenderDevice::createDepthStencilState(const DepthStencilStateDesc& /*desc*/)
+{
+    return std::make_shared<RecordingDepthStencilState>(mState);
+}
+
+void RecordingRenderDevice::setDepthStencilState(DepthStencilState dss)
+{
+    mState->recordChange(CommandType::SetDepthStencilState, idOf<RecordingDepthStencilState>(dss));
+}
+
+BlendState RecordingRenderDevice::createBlendState(const BlendStateDesc& /*desc*/)
+{
+    return std::make_shared<RecordingBlendState>(mState);
+}
+
+void RecordingRenderDevice::setBlendState(BlendState bs)
+{
+    mState->recordChange(CommandType::SetBlendState, idOf<RecordingBlendState>(bs));
+}
+
+Sampler RecordingRenderDevice::createSampler(const SamplerDesc& /*desc*/)
+{
+    return std::make_shared<RecordingSampler>(mState);
+}
+
+Texture1D RecordingRenderDevice::createTexture1D(const Texture1DDesc& /*desc*/)
+{
+    return std::make_shared<RecordingTexture1D>(mState);
+}
+
+Texture2D RecordingRenderDevice::createTexture2D(const Texture2DDesc& /*desc*/)
+{
+    return std::make_shared<RecordingTexture2D>(mState);
+}
+
+Texture2DArray RecordingRenderDevice::createTexture2DArray(const Texture2DArrayDesc& /*desc*/)
+{
+    return std::make_shared<RecordingTexture2DArray>(mState);
+}
+
+Texture3D RecordingRenderDevice::createTexture3D(const Texture3DDesc& /*desc*/)
+{
+    return std::make_shared<RecordingTexture3D>(mState);
+}
+
+CubeMap RecordingRenderDevice::createCubeMap(const CubeMapDesc& /*desc*/)
+{
+    return std::make_shared<RecordingCubeMap>(mState);
+}
+
+CubeMapArray RecordingRenderDevice::createCubeMapArray(const CubeMapArrayDesc& /*desc*/)
+{
+    return std::make_shared<RecordingCubeMapArray>(mState);
+}
+
+ConstantBuffer RecordingRenderDevice::createConstantBuffer(std::size_t size, const void* data, Usage /*usage*/)
+{
+    return std::make_shared<RecordingConstantBuffer>(mState, size, data);
+}
+
+IndexBuffer RecordingRenderDevice::createIndexBuffer(std::size_t size, const void* data, IndexFormat /*format*/,
+                                                     Usage /*usage*/)
+{
+    return std::make_shared<RecordingIndexBuffer>(mState, size, data);
+}
+
+void RecordingRenderDevice::setIndexBuffer(IndexBuffer ib)
+{
+    mState->recordChange(CommandType::SetIndexBuffer, idOf<RecordingIndexBuffer>(ib));
+}
+
+VertexBuffer RecordingRenderDevice::createVertexBuffer(std::size_t size, const void* data, Usage /*usage*/)
+{
+    return std::make_shared<RecordingVertexBuffer>(mState, size, data);
+}
+
+VertexArray RecordingRenderDevice::createVertexArray(const VertexArrayDesc& /*desc*/)
+{
+    return std::make_shared<RecordingVertexArray>(mState);
+}
+
+void RecordingRenderDevice::setVertexArray(VertexArray va)
+{
+    mState->recordChange(CommandType::SetVertexArray, idOf<RecordingVertexArray>(va));
+}
+
+ShaderStage RecordingRenderDevice::createShaderStage(Stage stage, const char* /*src*/)
+{
+    return std::make_shared<RecordingShaderStage>(stage);
+}
+
+ShaderPipeline RecordingRenderDevice::createShaderPipeline(ShaderStage /*vs*/, ShaderStage /*ps*/)
+{
+    return std::make_shared<RecordingShaderPipeline>(mState);
+}
+
+ShaderPipeline RecordingRenderDevice::createShaderPipeline(ShaderStage /*vs*/, ShaderStage /*gs*/, ShaderStage /*ps*/)
+{
+    return std::make_shared<RecordingShaderPipeline>(mState);
+}
+
+ShaderPipeline RecordingRenderDevice::createShaderPipeline(ShaderStage /*cs*/)
+{
+    return std::make_shared<RecordingShaderPipeline>(mState);
+}
+
+void RecordingRenderDevice::setShaderPipeline(ShaderPipeline pipeline)
+{
+    mState->recordChange(CommandType::SetShaderPipeline, idOf<RecordingShaderPipeline>(pipeline));
+}
+
+void RecordingRenderDevice::clearColor(float /*r*/, float /*g*/, float /*b*/, float /*a*/)
+{
+    mState->record(CommandType::ClearColor);
+    mState->frame.counts.clears += 1;
+}
+
+void RecordingRenderDevice::clearTargetColor(std::size_t target, float /*r*/, float /*g*/, float /*b*/, float /*a*/)
+{
+    mState->record(CommandType::ClearTargetColor, target);
+    mState->frame.counts.clears += 1;
+}
+
+void RecordingRenderDevice::clearDepth(float /*depth*/)
+{
+    mState->record(CommandType::ClearDepth);
+    mState->frame.counts.clears += 1;
+}
+
+void RecordingRenderDevice::clearStencil(int /*stencil*/)
+{
+    mState->record(CommandType::ClearStencil);
+    mState->frame.counts.clears += 1;
+}
+
+void RecordingRenderDevice::drawTriangles(std::size_t offset, std::size_t count)
+{
+    this->draw(offset, count, 1, false);
+}
+
+void RecordingRenderDevice::drawTrianglesIndexed(std::size_t offset, std::size_t count)
+{
+    this->draw(offset, count, 1, true);
+}
+
+void RecordingRenderDevice::drawTrianglesInstanced(std::size_t offset, std::size_t count, std::size_t instanceCount)
+{
+    this->draw(offset, count, instanceCount, false);
+}
+
+void RecordingRenderDevice::drawTrianglesIndexedInstanced(std::size_t offset, std::size_t count,
+                                                          std::size_t instanceCount)
+{
+    this->draw(offset, count, instanceCount, true);
+}
+
+void RecordingRenderDevice::dispatchCompute(std::size_t x, std::size_t y, std::size_t z)
+{
+    mState->record(CommandType::DispatchCompute, x, y, z);
+    mState->frame.counts.dispatches += 1;
+}
+
+void RecordingRenderDevice::memoryBarrier(MemoryBarriers barriers)
+{
+    mState->record(CommandType::Barrier, static_cast<std::size_t>(barriers));
+}
+
+void RecordingRenderDevice::setViewport(int x, int y, int w, int h)
+{
+    mState->record(CommandType::SetViewport, static_cast<std::size_t>(x), static_cast<std::size_t>(y),
+                   static_cast<std::size_t>(w), static_cast<std::size_t>(h));
+    mState->frame.counts.stateChanges += 1;
+    mState->stats.issued += 1;
+}
+
+void RecordingRenderDevice::setScissor(int x, int y, int w, int h)
+{
+    mState->record(CommandType::SetScissor, static_cast<std::size_t>(x), static_cast<std::size_t>(y),
+                   static_cast<std::size_t>(w), static_cast<std::size_t>(h));
+    mState->frame.counts.stateChanges += 1;
+    mState->stats.issued += 1;
+}
+
+int RecordingRenderDevice::getProperty(Property prop)
+{
+    switch (prop)
+    {
+    case Property::MaxAnisotropy:
+        return 1;
+    case Property::ComputeSupported:
+        return 1;
+    default:
+        return -1;
+    }
+}
+
+RenderDeviceStats RecordingRenderDevice::stats() const
+{
+    return mState->stats;
+}
+
+void RecordingRenderDevice::resetStats()
+{
+    mState->stats = {};
+}
+
+void RecordingRenderDevice::draw(std::size_t offset, std::size_t count, std::size_t instanceCount, bool indexed)
+{
+    mState->record(CommandType::Draw, offset, count, instanceCount, indexed ? 1 : 0);
+    mState->frame.counts.draws += 1;
+    mState->frame.counts.instances += instanceCount;
+    mState->frame.counts.triangles += count / 3 * instanceCount;
+}
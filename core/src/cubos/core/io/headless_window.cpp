@@ -0,0 +1,85 @@
+#include <cubos/core/io/headless_window.hpp>
+
+using namespace cubos::core::io;
+
+HeadlessWindow::HeadlessWindow(const glm::ivec2& size)
+    : mSize(size)
+    , mRenderDevice(std::make_unique<gl::RecordingRenderDevice>())
+    , mStart(std::chrono::steady_clock::now())
+    , mMouseState(MouseState::Default)
+{
+}
+
+void HeadlessWindow::pollEvents()
+{
+    // There's nothing which could generate events.
+}
+
+void HeadlessWindow::swapBuffers()
+{
+    mRenderDevice->endFrame();
+}
+
+cubos::core::gl::RenderDevice& HeadlessWindow::renderDevice() const
+{
+    return *mRenderDevice;
+}
+
+glm::ivec2 HeadlessWindow::size() const
+{
+    return mSize;
+}
+
+glm::ivec2 HeadlessWindow::framebufferSize() const
+{
+    return mSize;
+}
+
+bool HeadlessWindow::shouldClose() const
+{
+    return false;
+}
+
+double HeadlessWindow::time() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+}
+
+void HeadlessWindow::mouseState(MouseState state)
+{
+    mMouseState = state;
+}
+
+MouseState HeadlessWindow::mouseState() const
+{
+    return mMouseState;
+}
+
+std::shared_ptr<Cursor> HeadlessWindow::createCursor(Cursor::Standard /*standard*/)
+{
+    return nullptr;
+}
+
+void HeadlessWindow::cursor(std::shared_ptr<Cursor> /*cursor*/)
+{
+}
+
+void HeadlessWindow::clipboard(const std::string& text)
+{
+    mClipboard = text;
+}
+
+const char* HeadlessWindow::clipboard() const
+{
+    return mClipboard.c_str();
+}
+
+Modifiers HeadlessWindow::modifiers() const
+{
+    return Modifiers::None;
+}
+
+bool HeadlessWindow::pressed(Key /*key*/, Modifiers /*modifiers*/) const
+{
+    return false;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <cubos/core/gl/recording_render_device.hpp>
+#include <cubos/core/io/window.hpp>
+
+namespace cubos::core::io
+{
+    /// Window which isn't shown and never receives events. Its render device records the commands
+    /// it receives instead of rendering them, and each swap of the buffers ends a frame.
+    class HeadlessWindow : public BaseWindow
+    {
+    public:
+        HeadlessWindow(const glm::ivec2& size);
+
+        // Interface implementation.
+
+        void pollEvents() override;
+        void swapBuffers() override;
+        gl::RenderDevice& renderDevice() const override;
+        glm::ivec2 size() const override;
+        glm::ivec2 framebufferSize() const override;
+        bool shouldClose() const override;
+        double time() const override;
+        void mouseState(MouseState state) override;
+        MouseState mouseState() const override;
+        std::shared_ptr<Cursor> createCursor(Cursor::Standard standard) override;
+        void cursor(std::shared_ptr<Cursor> cursor) override;
+        void clipboard(const std::string& text) override;
+        const char* clipboard() const override;
+        Modifiers modifiers() const override;
+        bool pressed(Key key, Modifiers modifiers = Modifiers::None) const override;
+
+    private:
+        glm::ivec2 mSize;
+        std::unique_ptr<gl::RecordingRenderDevice> mRenderDevice;
+        std::chrono::steady_clock::time_point mStart;
+        MouseState mMouseState;
+        std::string mClipboard;
+    };
+} // namespace cubos::core::io
@@ -1,4 +1,5 @@
 #include <cubos/core/io/glfw_window.hpp>
+#include <cubos/core/io/headless_window.hpp>
 #include <cubos/core/io/window.hpp>
 
 using namespace cubos::core::io;
@@ -8,6 +9,11 @@ Window cubos::core::io::openWindow(const std::string& title, const glm::ivec2& s
     return std::make_shared<GLFWWindow>(title, size);
 }
 
+Window cubos::core::io::openHeadlessWindow(const glm::ivec2& size)
+{
+    return std::make_shared<HeadlessWindow>(size);
+}
+
 BaseWindow::BaseWindow()
 {
     mPolled = false;
@@ -1,9 +1,92 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <spdlog/async.h>
+#include <spdlog/details/periodic_worker.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <cubos/core/binary_log_sink.hpp>
 #include <cubos/core/log.hpp>
+#include <cubos/core/memory/endianness.hpp>
+
+using cubos::core::LogSite;
+
+/// Length of the window over which @ref LogSite counts messages, in nanoseconds.
+static const int64_t SiteWindow = 1000000000;
+
+/// Rate limit of the current logger, used by @ref LogSite.
+static std::atomic<std::size_t> currentRateLimit{0};
+
+/// Thread which periodically reports the messages dropped by the rate limit.
+static std::unique_ptr<spdlog::details::periodic_worker> dropReporter;
+
+namespace
+{
+    /// Sites with dropped messages which weren't reported yet.
+    struct SiteRegistry
+    {
+        std::mutex mutex;            ///< Protects the sites.
+        std::vector<LogSite*> sites; ///< Registered sites.
+    };
+} // namespace
+
+static SiteRegistry& siteRegistry()
+{
+    // Never destroyed, as the sites kept by the logging macros may be destroyed after it.
+    static auto* registry = new SiteRegistry();
+    return *registry;
+}
+
+cubos::core::BinaryLogSink::~BinaryLogSink()
+{
+    if (mClose)
+    {
+        std::fclose(mFile);
+    }
+}
+
+cubos::core::BinaryLogSink::BinaryLogSink(FILE* file, bool close)
+    : mFile(file)
+    , mClose(close)
+{
+}
+
+void cubos::core::BinaryLogSink::sink_it_(const spdlog::details::log_msg& msg)
+{
+    const char* file = msg.source.filename == nullptr ? "" : msg.source.filename;
+    auto fileSize = static_cast<uint16_t>(std::min<std::size_t>(std::strlen(file), UINT16_MAX));
+    auto msgSize = static_cast<uint32_t>(msg.payload.size());
+
+    mRecord.clear();
+    this->append(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count()));
+    this->append(static_cast<uint8_t>(msg.level));
+    this->append(static_cast<uint32_t>(msg.source.line));
+    this->append(fileSize);
+    mRecord.append(file, file + fileSize);
+    this->append(msgSize);
+    mRecord.append(msg.payload.data(), msg.payload.data() + msgSize);
+    std::fwrite(mRecord.data(), 1, mRecord.size(), mFile);
+}
+
+void cubos::core::BinaryLogSink::flush_()
+{
+    std::fflush(mFile);
+}
 
-void cubos::core::initializeLogger()
+template <typename T>
+void cubos::core::BinaryLogSink::append(T value)
+{
+    value = memory::toLittleEndian(value);
+    const auto* bytes = reinterpret_cast<const char*>(&value);
+    mRecord.append(bytes, bytes + sizeof(T));
+}
+
+void cubos::core::initializeLogger(const LoggerOptions& options)
 {
     auto consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
     consoleSink->set_level(spdlog::level::trace);
@@ -14,13 +97,168 @@ void cubos::core::initializeLogger()
     fileSink->set_level(spdlog::level::warn);
     fileSink->set_pattern("[cubos] [%s:%# %!] %l: %v");
 
-    auto logger = std::make_shared<spdlog::logger>("cubos", spdlog::sinks_init_list({consoleSink, fileSink}));
+    std::vector<spdlog::sink_ptr> sinks{consoleSink, fileSink};
+    FILE* binaryFile = nullptr;
+    if (!options.binaryPath.empty())
+    {
+        binaryFile = std::fopen(options.binaryPath.c_str(), "wb");
+        if (binaryFile != nullptr)
+        {
+            sinks.push_back(std::make_shared<BinaryLogSink>(binaryFile));
+        }
+    }
+
+    std::shared_ptr<spdlog::logger> logger;
+    if (options.async)
+    {
+        // A single worker thread writes the messages, and another flushes the sinks periodically,
+        // instead of flushing after every message. Overrunning the queue could drop errors, so a
+        // full queue blocks instead - call sites flooding it are already stopped by the rate limit.
+        spdlog::init_thread_pool(options.queueSize, 1);
+        logger = std::make_shared<spdlog::async_logger>("cubos", sinks.begin(), sinks.end(), spdlog::thread_pool(),
+                                                        spdlog::async_overflow_policy::block);
+        logger->flush_on(spdlog::level::err);
+        spdlog::flush_every(std::chrono::seconds(1));
+
+        static bool registered = false;
+        if (!registered)
+        {
+            registered = true;
+            std::atexit(cubos::core::shutdownLogger);
+        }
+    }
+    else
+    {
+        logger = std::make_shared<spdlog::logger>("cubos", sinks.begin(), sinks.end());
+        logger->flush_on(spdlog::level::trace);
+    }
+
     logger->set_level(spdlog::level::trace);
-    logger->flush_on(spdlog::level::trace);
     spdlog::set_default_logger(logger);
+    currentRateLimit.store(options.rateLimit, std::memory_order_relaxed);
+
+    // Call sites which stop logging wouldn't report their dropped messages otherwise.
+    dropReporter.reset();
+    if (options.rateLimit > 0)
+    {
+        dropReporter = std::make_unique<spdlog::details::periodic_worker>(
+            [] { LogSite::reportDropped(std::chrono::steady_clock::now()); }, std::chrono::seconds(1));
+    }
+
+    if (!options.binaryPath.empty() && binaryFile == nullptr)
+    {
+        CUBOS_ERROR("Couldn't open binary log file {}", options.binaryPath);
+    }
+}
+
+void cubos::core::shutdownLogger()
+{
+    dropReporter.reset();
+    LogSite::reportDropped(std::chrono::steady_clock::time_point::max());
+    currentRateLimit.store(0, std::memory_order_relaxed);
+
+    // Dropping the loggers and the thread pool waits for the queued messages to be written.
+    spdlog::shutdown();
 }
 
 void cubos::core::disableLogging()
 {
     spdlog::set_level(spdlog::level::critical);
 }
+
+LogSite::~LogSite()
+{
+    auto& registry = siteRegistry();
+    std::lock_guard lock(registry.mutex);
+    if (mRegistered)
+    {
+        registry.sites.erase(std::find(registry.sites.begin(), registry.sites.end(), this));
+        this->report(mSource);
+    }
+}
+
+void LogSite::reportDropped(std::chrono::steady_clock::time_point now)
+{
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    auto& registry = siteRegistry();
+    std::lock_guard lock(registry.mutex);
+    for (std::size_t i = 0; i < registry.sites.size();)
+    {
+        // Sites still within their window report their drops once it ends.
+        auto* site = registry.sites[i];
+        if (time - site->mStart.load(std::memory_order_relaxed) < SiteWindow)
+        {
+            ++i;
+            continue;
+        }
+
+        site->mRegistered = false;
+        site->report(site->mSource);
+        registry.sites[i] = registry.sites.back();
+        registry.sites.pop_back();
+    }
+}
+
+bool LogSite::allow(spdlog::level::level_enum level, const spdlog::source_loc& source)
+{
+    auto limit = currentRateLimit.load(std::memory_order_relaxed);
+    if (limit == 0)
+    {
+        return true;
+    }
+
+    // Messages which the logger would discard anyway shouldn't count towards the limit.
+    if (!spdlog::default_logger_raw()->should_log(level))
+    {
+        return false;
+    }
+
+    return this->allow(source, limit, std::chrono::steady_clock::now());
+}
+
+bool LogSite::allow(const spdlog::source_loc& source, std::size_t limit, std::chrono::steady_clock::time_point now)
+{
+    if (limit == 0)
+    {
+        return true;
+    }
+
+    // Only the thread which starts a new window resets the counters and reports the drops.
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    auto start = mStart.load(std::memory_order_relaxed);
+    if ((start == 0 || time - start >= SiteWindow) &&
+        mStart.compare_exchange_strong(start, time, std::memory_order_relaxed))
+    {
+        mCount.store(0, std::memory_order_relaxed);
+        this->report(source);
+    }
+
+    if (mCount.fetch_add(1, std::memory_order_relaxed) < limit)
+    {
+        return true;
+    }
+
+    // The first drop since the last report registers the site, so that it's reported even if it
+    // never logs again.
+    if (mDropped.fetch_add(1, std::memory_order_relaxed) == 0)
+    {
+        auto& registry = siteRegistry();
+        std::lock_guard lock(registry.mutex);
+        if (!mRegistered)
+        {
+            mRegistered = true;
+            mSource = source;
+            registry.sites.push_back(this);
+        }
+    }
+    return false;
+}
+
+void LogSite::report(const spdlog::source_loc& source)
+{
+    auto* logger = spdlog::default_logger_raw();
+    if (auto dropped = mDropped.exchange(0, std::memory_order_relaxed); dropped > 0 && logger != nullptr)
+    {
+        logger->log(source, spdlog::level::warn, "Dropped {} messages logged from here over the rate limit", dropped);
+    }
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 
 #include <cubos/core/memory/buffer_stream.hpp>
@@ -8,6 +9,7 @@ BufferStream::BufferStream(void* buffer, std::size_t size, bool readOnly)
 {
     mBuffer = buffer;
     mSize = size;
+    mCapacity = size;
     mPosition = 0;
     mReadOnly = readOnly;
     mReachedEof = false;
@@ -20,6 +22,7 @@ BufferStream::BufferStream(const void* buffer, std::size_t size)
     // as read-only.
     mBuffer = const_cast<void*>(buffer);
     mSize = size;
+    mCapacity = size;
     mPosition = 0;
     mReadOnly = true;
     mReachedEof = false;
@@ -28,38 +31,45 @@ BufferStream::BufferStream(const void* buffer, std::size_t size)
 
 BufferStream::BufferStream(std::size_t size)
 {
-    if (size == 0)
-    {
-        abort();
-    }
-
-    mBuffer = new char[size];
-    mSize = size;
+    mStorage.resize(size);
+    mBuffer = mStorage.data();
+    mSize = 0;
+    mCapacity = size;
     mPosition = 0;
     mReadOnly = false;
     mReachedEof = false;
     mOwned = true;
 }
 
-BufferStream::~BufferStream()
+BufferStream::BufferStream(std::vector<char>&& data)
 {
-    if (mOwned)
-    {
-        delete[] static_cast<char*>(mBuffer);
-    }
+    mStorage = std::move(data);
+    mBuffer = mStorage.data();
+    mSize = mStorage.size();
+    mCapacity = mStorage.size();
+    mPosition = 0;
+    mReadOnly = false;
+    mReachedEof = false;
+    mOwned = true;
 }
 
+BufferStream::~BufferStream() = default;
+
 BufferStream::BufferStream(const BufferStream& other)
 {
     mSize = other.mSize;
+    mCapacity = other.mCapacity;
     mPosition = other.mPosition;
     mReadOnly = other.mReadOnly;
     mReachedEof = other.mReachedEof;
     mOwned = other.mOwned;
     if (mOwned)
     {
-        mBuffer = new char[mSize];
-        memcpy(mBuffer, other.mBuffer, mSize);
+        // Only the data is copied, the rest of the buffer is allocated but left as is.
+        mStorage.reserve(mCapacity);
+        mStorage.assign(other.mStorage.begin(), other.mStorage.begin() + static_cast<ptrdiff_t>(mSize));
+        mStorage.resize(mCapacity);
+        mBuffer = mStorage.data();
     }
     else
     {
@@ -69,14 +79,18 @@ BufferStream::BufferStream(const BufferStream& other)
 
 BufferStream::BufferStream(BufferStream&& other) noexcept
 {
+    // Moving the storage doesn't move the data it points to, so mBuffer stays valid.
+    mStorage = std::move(other.mStorage);
     mBuffer = other.mBuffer;
     mSize = other.mSize;
+    mCapacity = other.mCapacity;
     mPosition = other.mPosition;
     mReadOnly = other.mReadOnly;
     mReachedEof = other.mReachedEof;
     mOwned = other.mOwned;
     other.mBuffer = nullptr;
     other.mSize = 0;
+    other.mCapacity = 0;
     other.mPosition = 0;
     other.mReadOnly = true;
     other.mReachedEof = true;
@@ -88,6 +102,58 @@ const void* BufferStream::getBuffer() const
     return mBuffer;
 }
 
+std::size_t BufferStream::size() const
+{
+    return mSize;
+}
+
+std::size_t BufferStream::capacity() const
+{
+    return mCapacity;
+}
+
+void BufferStream::reserve(std::size_t capacity)
+{
+    if (mOwned && capacity > mCapacity)
+    {
+        mStorage.resize(capacity);
+        mBuffer = mStorage.data();
+        mCapacity = capacity;
+    }
+}
+
+BufferStream BufferStream::view() const
+{
+    return {static_cast<const void*>(mBuffer), mSize};
+}
+
+BufferStream BufferStream::slice(std::size_t offset, std::size_t size) const
+{
+    offset = std::min(offset, mSize);
+    size = std::min(size, mSize - offset);
+    return {static_cast<const void*>(static_cast<const char*>(mBuffer) + offset), size};
+}
+
+std::vector<char> BufferStream::release()
+{
+    if (!mOwned)
+    {
+        const auto* data = static_cast<const char*>(mBuffer);
+        return {data, data + mSize};
+    }
+
+    // Shrinking the vector doesn't reallocate it.
+    mStorage.resize(mSize);
+    auto data = std::move(mStorage);
+    mStorage.clear();
+    mBuffer = mStorage.data();
+    mSize = 0;
+    mCapacity = 0;
+    mPosition = 0;
+    mReachedEof = false;
+    return data;
+}
+
 std::size_t BufferStream::read(void* data, std::size_t size)
 {
     std::size_t bytesRemaining = mSize - mPosition;
@@ -108,23 +174,13 @@ std::size_t BufferStream::write(const void* data, std::size_t size)
         return 0;
     }
 
-    std::size_t bytesRemaining = mSize - mPosition;
+    std::size_t bytesRemaining = mCapacity - mPosition;
     if (size > bytesRemaining)
     {
         if (mOwned)
         {
-            // Expand the buffer.
-            std::size_t newSize = mSize * 2;
-            while (newSize < mPosition + size)
-            {
-                newSize *= 2;
-            }
-
-            char* newBuffer = new char[newSize];
-            memcpy(newBuffer, static_cast<char*>(mBuffer), mSize);
-            delete[] static_cast<char*>(mBuffer);
-            mBuffer = newBuffer;
-            mSize = newSize;
+            // Grow the buffer geometrically, so that many small writes take amortized constant time.
+            this->reserve(std::max(mCapacity * 2, mPosition + size));
         }
         else
         {
@@ -134,6 +190,10 @@ std::size_t BufferStream::write(const void* data, std::size_t size)
     }
     memcpy(static_cast<char*>(mBuffer) + mPosition, data, size);
     mPosition += size;
+    if (mOwned)
+    {
+        mSize = std::max(mSize, mPosition);
+    }
     return size;
 }
 
@@ -201,9 +261,9 @@ bool BufferStream::eof() const
 
 char BufferStream::peek() const
 {
-    if (mPosition == mSize)
+    if (mPosition >= mSize)
     {
         return '\0';
     }
-    return ((char*)mBuffer)[mPosition];
+    return static_cast<const char*>(mBuffer)[mPosition];
 }
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <cstring>
+
+#include <cubos/core/memory/buffered_stream.hpp>
+
+using namespace cubos::core::memory;
+
+BufferedStream::BufferedStream(std::unique_ptr<Stream> stream, std::size_t bufferSize)
+    : mStream(std::move(stream))
+    , mBuffer(std::max(bufferSize, std::size_t{1}))
+    , mPosition(0)
+    , mSize(0)
+    , mReachedEof(false)
+    , mWriting(false)
+{
+}
+
+BufferedStream::~BufferedStream()
+{
+    this->writeBuffered();
+}
+
+void BufferedStream::flush()
+{
+    this->writeBuffered();
+}
+
+const char* BufferedStream::buffered(std::size_t& size)
+{
+    size = this->fill() ? mSize - mPosition : 0;
+    return mBuffer.data() + mPosition;
+}
+
+void BufferedStream::consume(std::size_t size)
+{
+    mPosition += std::min(size, mSize - mPosition);
+}
+
+std::size_t BufferedStream::read(void* data, std::size_t size)
+{
+    auto* out = static_cast<char*>(data);
+    std::size_t total = 0;
+    while (total < size)
+    {
+        // Reads larger than the buffer skip it, once it is empty.
+        if (mPosition == mSize && !mWriting && size - total >= mBuffer.size())
+        {
+            total += mStream->read(out + total, size - total);
+            break;
+        }
+
+        if (!this->fill())
+        {
+            break;
+        }
+
+        auto count = std::min(size - total, mSize - mPosition);
+        std::memcpy(out + total, mBuffer.data() + mPosition, count);
+        mPosition += count;
+        total += count;
+    }
+
+    if (total < size)
+    {
+        mReachedEof = true;
+    }
+    return total;
+}
+
+std::size_t BufferedStream::write(const void* data, std::size_t size)
+{
+    if (!mWriting)
+    {
+        // Move the underlying stream back to where the data which was read ends.
+        if (mPosition < mSize)
+        {
+            mStream->seek(-static_cast<ptrdiff_t>(mSize - mPosition), SeekOrigin::Current);
+        }
+
+        mPosition = 0;
+        mSize = 0;
+        mWriting = true;
+    }
+
+    if (mSize + size > mBuffer.size())
+    {
+        this->writeBuffered();
+        mWriting = true;
+
+        // Writes larger than the buffer skip it.
+        if (size >= mBuffer.size())
+        {
+            return mStream->write(data, size);
+        }
+    }
+
+    std::memcpy(mBuffer.data() + mSize, data, size);
+    mSize += size;
+    return size;
+}
+
+std::size_t BufferedStream::tell() const
+{
+    auto position = mStream->tell();
+    if (position == SIZE_MAX)
+    {
+        return SIZE_MAX;
+    }
+
+    return mWriting ? position + mSize : position - (mSize - mPosition);
+}
+
+void BufferedStream::seek(ptrdiff_t offset, SeekOrigin origin)
+{
+    mReachedEof = false;
+    if (!mWriting && origin == SeekOrigin::Current)
+    {
+        // Seeks within the buffer don't need to touch the underlying stream.
+        if (offset >= 0 && static_cast<std::size_t>(offset) <= mSize - mPosition)
+        {
+            mPosition += static_cast<std::size_t>(offset);
+            return;
+        }
+
+        // The underlying stream is ahead by the data which hasn't been read.
+        offset -= static_cast<ptrdiff_t>(mSize - mPosition);
+    }
+
+    this->writeBuffered();
+    mPosition = 0;
+    mSize = 0;
+    mStream->seek(offset, origin);
+}
+
+bool BufferedStream::eof() const
+{
+    return mReachedEof;
+}
+
+char BufferedStream::peek() const
+{
+    return this->fill() ? mBuffer[mPosition] : '\0';
+}
+
+void BufferedStream::readUntil(std::string& str, const char* terminator)
+{
+    if (terminator == nullptr)
+    {
+        terminator = "";
+    }
+    auto length = std::strlen(terminator);
+    str.clear();
+
+    while (this->fill())
+    {
+        // Find the first null character or first character of the terminator in the buffer.
+        const auto* begin = mBuffer.data() + mPosition;
+        auto available = mSize - mPosition;
+        const auto* stop = static_cast<const char*>(std::memchr(begin, '\0', available));
+        if (length > 0)
+        {
+            auto before = stop != nullptr ? static_cast<std::size_t>(stop - begin) : available;
+            if (const auto* first = static_cast<const char*>(std::memchr(begin, terminator[0], before)))
+            {
+                stop = first;
+            }
+        }
+
+        auto count = stop != nullptr ? static_cast<std::size_t>(stop - begin) : available;
+        str.append(begin, count);
+        mPosition += count;
+        if (stop == nullptr)
+        {
+            continue;
+        }
+
+        mPosition += 1;
+        if (*stop == '\0')
+        {
+            return;
+        }
+
+        // Check if the rest of the terminator follows, which may span several buffer fills.
+        std::size_t matched = 1;
+        while (matched < length && this->fill() && mBuffer[mPosition] == terminator[matched])
+        {
+            mPosition += 1;
+            matched += 1;
+        }
+
+        if (matched == length)
+        {
+            return;
+        }
+        str.append(terminator, matched);
+    }
+
+    mReachedEof = true;
+}
+
+void BufferedStream::ignore(std::size_t size)
+{
+    if (!mWriting)
+    {
+        auto count = std::min(size, mSize - mPosition);
+        mPosition += count;
+        size -= count;
+    }
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    if (mStream->tell() != SIZE_MAX)
+    {
+        // Skip the rest without reading it.
+        this->seek(static_cast<ptrdiff_t>(size), SeekOrigin::Current);
+        return;
+    }
+
+    while (size > 0 && this->fill())
+    {
+        auto count = std::min(size, mSize - mPosition);
+        mPosition += count;
+        size -= count;
+    }
+}
+
+void BufferedStream::writeBuffered() const
+{
+    if (mWriting)
+    {
+        mStream->write(mBuffer.data(), mSize);
+        mPosition = 0;
+        mSize = 0;
+        mWriting = false;
+    }
+}
+
+bool BufferedStream::fill() const
+{
+    this->writeBuffered();
+    if (mPosition < mSize)
+    {
+        return true;
+    }
+
+    mPosition = 0;
+    mSize = mStream->read(mBuffer.data(), mBuffer.size());
+    return mSize > 0;
+}
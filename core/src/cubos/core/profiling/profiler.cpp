@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include <cubos/core/data/json_serializer.hpp>
+#include <cubos/core/log.hpp>
+#include <cubos/core/profiling/profiler.hpp>
+
+using namespace cubos::core;
+using namespace cubos::core::profiling;
+
+/// Number of zones kept for each thread. Once full, new zones overwrite the oldest ones.
+static const std::size_t BufferCapacity = 1 << 16;
+
+namespace
+{
+    /// A recorded zone.
+    struct Event
+    {
+        const char* name; ///< Name of the zone.
+        uint64_t start;   ///< Time at which the zone started, in nanoseconds.
+        uint64_t end;     ///< Time at which the zone ended, in nanoseconds.
+    };
+
+    /// Slot of a thread buffer. Its fields are atomic since they may be overwritten while
+    /// another thread exports them.
+    struct Slot
+    {
+        std::atomic<const char*> name; ///< Name of the zone.
+        std::atomic<uint64_t> start;   ///< Time at which the zone started, in nanoseconds.
+        std::atomic<uint64_t> end;     ///< Time at which the zone ended, in nanoseconds.
+    };
+
+    /// Zones recorded by a thread, in a ring. Only that thread writes to the buffer, and it
+    /// publishes new events by incrementing the count, so that they can be read by other threads
+    /// without locks.
+    struct ThreadBuffer
+    {
+        std::size_t thread;                ///< Identifier of the thread in the exported trace.
+        std::atomic<uint64_t> epoch{0};    ///< Value of the global epoch when the events were recorded.
+        std::atomic<std::size_t> count{0}; ///< Number of events recorded, including overwritten ones.
+        std::unique_ptr<Slot[]> slots;     ///< Ring of recorded events.
+    };
+
+    /// State shared by all threads.
+    struct State
+    {
+        std::atomic<bool> enabled{false}; ///< Whether zones are being recorded.
+        std::atomic<uint64_t> epoch{1};   ///< Incremented on every clear, so that threads reset their buffers.
+
+        std::mutex mutex;                                   ///< Protects the fields below.
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers; ///< Buffers of all threads which recorded zones.
+        std::unordered_set<std::string> names;              ///< Interned names.
+    };
+} // namespace
+
+static State& state()
+{
+    static State state;
+    return state;
+}
+
+/// Gets the current time, in nanoseconds since the first call.
+static uint64_t now()
+{
+    static const auto base = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - base).count());
+}
+
+/// Gets the buffer of the current thread, registering it on the first call.
+static ThreadBuffer& threadBuffer()
+{
+    // The buffer is shared with the registry, so that its zones can still be exported after the
+    // thread exits.
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (buffer == nullptr)
+    {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->slots = std::make_unique<Slot[]>(BufferCapacity);
+
+        std::lock_guard lock(state().mutex);
+        buffer->thread = state().buffers.size();
+        state().buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+/// Records a zone in the buffer of the current thread.
+static void record(const char* name, uint64_t start, uint64_t end)
+{
+    auto& buffer = threadBuffer();
+
+    // Events recorded before the last clear are discarded. Only this thread resets the buffer,
+    // and the epoch is published after the count, so readers never see a stale count.
+    auto epoch = state().epoch.load(std::memory_order_acquire);
+    if (buffer.epoch.load(std::memory_order_relaxed) != epoch)
+    {
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.epoch.store(epoch, std::memory_order_release);
+    }
+
+    // The fence makes readers which see any of the new fields also see the count published by
+    // the previous call, and thus know that the slot may be being overwritten.
+    auto count = buffer.count.load(std::memory_order_relaxed);
+    auto& slot = buffer.slots[count % BufferCapacity];
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+/// Copies the events of a thread buffer which weren't overwritten.
+/// @param buffer Buffer.
+/// @param epoch Current global epoch.
+/// @param[out] events Copied events.
+/// @return Number of events overwritten, or which were being overwritten while copied.
+static std::size_t copyEvents(const ThreadBuffer& buffer, uint64_t epoch, std::vector<Event>& events)
+{
+    events.clear();
+    if (buffer.epoch.load(std::memory_order_acquire) != epoch)
+    {
+        return 0;
+    }
+
+    auto end = buffer.count.load(std::memory_order_acquire);
+    auto begin = end > BufferCapacity ? end - BufferCapacity : 0;
+    for (auto i = begin; i < end; ++i)
+    {
+        const auto& slot = buffer.slots[i % BufferCapacity];
+        events.push_back({slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                          slot.end.load(std::memory_order_relaxed)});
+    }
+
+    // Check how far the thread got while the events were copied. The slot of the event it may be
+    // writing right now is also discarded. If the buffer was reset, all events are discarded.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto last = buffer.count.load(std::memory_order_relaxed);
+    if (last < end || buffer.epoch.load(std::memory_order_relaxed) != epoch)
+    {
+        events.clear();
+        return 0;
+    }
+
+    auto valid = std::max(begin, last + 1 > BufferCapacity ? last + 1 - BufferCapacity : 0);
+    events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(std::min(valid, end) - begin));
+    return std::min(valid, end);
+}
+
+void cubos::core::profiling::setEnabled(bool enabled)
+{
+    state().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool cubos::core::profiling::isEnabled()
+{
+    return state().enabled.load(std::memory_order_relaxed);
+}
+
+void cubos::core::profiling::clear()
+{
+    std::lock_guard lock(state().mutex);
+    state().epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void cubos::core::profiling::exportChromeTrace(memory::Stream& stream)
+{
+    std::lock_guard lock(state().mutex);
+    auto epoch = state().epoch.load(std::memory_order_acquire);
+
+    data::JSONSerializer ser{stream};
+    ser.beginObject(nullptr);
+    ser.writeString("ns", "displayTimeUnit");
+    ser.beginArray(0, "traceEvents");
+    std::size_t dropped = 0;
+    std::vector<Event> events;
+    for (const auto& buffer : state().buffers)
+    {
+        dropped += copyEvents(*buffer, epoch, events);
+        for (const auto& event : events)
+        {
+            // Timestamps are in microseconds.
+            ser.beginObject(nullptr);
+            ser.writeString(event.name, "name");
+            ser.writeString("X", "ph");
+            ser.writeF64(static_cast<double>(event.start) / 1000.0, "ts");
+            ser.writeF64(static_cast<double>(event.end - event.start) / 1000.0, "dur");
+            ser.writeU32(0, "pid");
+            ser.writeU64(buffer->thread, "tid");
+            ser.endObject();
+        }
+    }
+    ser.endArray();
+
+    // Not part of the events, but shown by trace viewers as metadata.
+    ser.beginObject("otherData");
+    ser.writeU64(dropped, "droppedZones");
+    ser.endObject();
+    ser.endObject();
+
+    if (dropped > 0)
+    {
+        CUBOS_WARN("Exported profile is missing {} zones, which were overwritten by newer ones", dropped);
+    }
+}
+
+const char* cubos::core::profiling::intern(const std::string& name)
+{
+    std::lock_guard lock(state().mutex);
+    return state().names.insert(name).first->c_str();
+}
+
+Zone::~Zone()
+{
+    if (mName != nullptr)
+    {
+        record(mName, mStart, now());
+    }
+}
+
+Zone::Zone(const char* name)
+    : mName(nullptr)
+    , mStart(0)
+{
+    if (isEnabled())
+    {
+        mName = name;
+        mStart = now();
+    }
+}
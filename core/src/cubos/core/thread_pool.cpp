@@ -30,10 +30,16 @@ ThreadPool::ThreadPool(std::size_t numThreads)
                 }
 
                 task();
-                mNumTasks -= 1; // Task has finished executing.
+
+                {
+                    // The counter must be updated while holding the lock, otherwise a thread
+                    // waiting on wait() could miss the notification.
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mNumTasks -= 1; // Task has finished executing.
+                }
 
                 // Signal that a thread has finished executing a task.
-                mTaskDone.notify_one();
+                mTaskDone.notify_all();
             }
         });
     }
@@ -41,7 +47,10 @@ ThreadPool::ThreadPool(std::size_t numThreads)
 
 ThreadPool::~ThreadPool()
 {
-    mStop = true;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mStop = true;
+    }
     mNewTask.notify_all();
     for (auto& thread : mThreads)
     {
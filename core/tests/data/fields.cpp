@@ -0,0 +1,134 @@
+#include <cstring>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/data/binary_serializer.hpp>
+#include <cubos/core/data/fields.hpp>
+#include <cubos/core/memory/buffer_stream.hpp>
+
+using cubos::core::data::BinarySerializer;
+using cubos::core::data::Fields;
+using cubos::core::data::hasDistinctFieldIds;
+using cubos::core::data::isPacked;
+using cubos::core::data::makeField;
+using cubos::core::data::Serializer;
+using cubos::core::data::serializeFields;
+using cubos::core::memory::BufferStream;
+
+/// A type whose memory matches its serialized form.
+struct Packed
+{
+    int32_t a;
+    float b;
+};
+
+/// A type with padding between its fields.
+struct Padded
+{
+    uint8_t a;
+    uint32_t b;
+};
+
+/// A type with another described type as a field.
+struct Nested
+{
+    Padded padded;
+    uint16_t c;
+};
+
+template <>
+struct cubos::core::data::Fields<Packed>
+{
+    static constexpr auto value = std::make_tuple(makeField("a", &Packed::a), makeField("b", &Packed::b));
+};
+
+template <>
+struct cubos::core::data::Fields<Padded>
+{
+    static constexpr auto value = std::make_tuple(makeField("a", &Padded::a), makeField("b", &Padded::b));
+};
+
+template <>
+struct cubos::core::data::Fields<Nested>
+{
+    static constexpr auto value = std::make_tuple(makeField("padded", &Nested::padded), makeField("c", &Nested::c));
+};
+
+/// A type with two field names whose identifiers collide.
+struct Colliding
+{
+    int32_t aapy;
+    int32_t aaym;
+};
+
+template <>
+struct cubos::core::data::Fields<Colliding>
+{
+    static constexpr auto value =
+        std::make_tuple(makeField("aapy", &Colliding::aapy), makeField("aaym", &Colliding::aaym));
+};
+
+/// Serializes a padded value field by field, as generated code did before field descriptors.
+template <>
+void cubos::core::data::serialize<Padded>(Serializer& ser, const Padded& obj, const char* name)
+{
+    ser.beginObject(name);
+    ser.write(obj.a, "a");
+    ser.write(obj.b, "b");
+    ser.endObject();
+}
+
+static_assert(isPacked<Packed>());
+static_assert(!isPacked<Padded>());
+static_assert(!isPacked<Nested>());
+
+/// Serializes a value both through the virtual interface and through the field descriptors, and
+/// checks if the outputs match.
+template <typename T>
+static void checkSame(const T& value, bool littleEndian)
+{
+    BufferStream expected{};
+    {
+        BinarySerializer ser{expected, littleEndian};
+        auto fields = Fields<T>::value;
+        std::apply([&](const auto&... field) { (ser.write(value.*field.member, field.name), ...); }, fields);
+        CHECK_FALSE(ser.failed());
+    }
+
+    BufferStream actual{};
+    {
+        BinarySerializer ser{actual, littleEndian};
+        serializeFields<BinarySerializer>(static_cast<Serializer&>(ser), value, nullptr);
+        CHECK_FALSE(ser.failed());
+    }
+
+    REQUIRE(actual.size() == expected.size());
+    CHECK(std::memcmp(actual.getBuffer(), expected.getBuffer(), actual.size()) == 0);
+}
+
+TEST_CASE("data::Fields")
+{
+    SUBCASE("packed type")
+    {
+        checkSame(Packed{-7, 1.5F}, true);
+        checkSame(Packed{-7, 1.5F}, false);
+    }
+
+    SUBCASE("padded type")
+    {
+        checkSame(Padded{3, 0xDEADBEEF}, true);
+    }
+
+    SUBCASE("nested type")
+    {
+        Nested nested{{1, 2}, 3};
+        checkSame(nested, true);
+        checkSame(nested, false);
+    }
+
+    SUBCASE("colliding identifiers are detected")
+    {
+        static_assert(hasDistinctFieldIds<Nested>());
+        static_assert(!hasDistinctFieldIds<Colliding>());
+    }
+}
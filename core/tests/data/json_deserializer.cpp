@@ -0,0 +1,125 @@
+#include <clocale>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/data/json_deserializer.hpp>
+#include <cubos/core/memory/buffer_stream.hpp>
+
+using cubos::core::data::JSONDeserializer;
+using cubos::core::memory::BufferStream;
+
+TEST_CASE("data::JSONDeserializer")
+{
+    SUBCASE("primitives")
+    {
+        JSONDeserializer des{R"([-5, 300, 1.5, true, "a\"bé😀", 2e1])"};
+        CHECK(des.beginArray() == 6);
+
+        int8_t i8 = 0;
+        uint16_t u16 = 0;
+        double f64 = 0.0;
+        bool b = false;
+        std::string str;
+        int32_t i32 = 0;
+        des.read(i8);
+        des.read(u16);
+        des.read(f64);
+        des.read(b);
+        des.read(str);
+        des.read(i32);
+        des.endArray();
+
+        CHECK_FALSE(des.failed());
+        CHECK(i8 == -5);
+        CHECK(u16 == 300);
+        CHECK(f64 == 1.5);
+        CHECK(b);
+        CHECK(str == "a\"b\xC3\xA9\xF0\x9F\x98\x80");
+        CHECK(i32 == 20);
+    }
+
+    SUBCASE("nested containers from a stream")
+    {
+        const char src[] = R"({
+            "name": "ignored",
+            "list": [[1, 2], [], [3]],
+            "map": {"1": [4, 5, 6], "2": []}
+        })";
+        BufferStream stream{src, sizeof(src) - 1};
+        JSONDeserializer des{stream};
+
+        std::string name;
+        std::vector<std::vector<int>> list;
+        std::unordered_map<int, std::vector<int>> map;
+        des.beginObject();
+        des.read(name);
+        des.read(list);
+        des.read(map);
+        des.endObject();
+
+        CHECK_FALSE(des.failed());
+        CHECK(name == "ignored");
+        CHECK(list == std::vector<std::vector<int>>{{1, 2}, {}, {3}});
+        REQUIRE(map.size() == 2);
+        CHECK(map[1] == std::vector<int>{4, 5, 6});
+        CHECK(map[2].empty());
+    }
+
+    SUBCASE("unread fields are skipped")
+    {
+        JSONDeserializer des{R"([{"a": 1, "b": [[2], {"c": "]"}]}, [7, 8]])"};
+        CHECK(des.beginArray() == 2);
+        int a = 0;
+        des.beginObject();
+        des.read(a);
+        des.endObject();
+        std::vector<int> vec;
+        des.read(vec);
+        des.endArray();
+
+        CHECK_FALSE(des.failed());
+        CHECK(a == 1);
+        CHECK(vec == std::vector<int>{7, 8});
+    }
+
+    SUBCASE("numbers are parsed independently of the locale")
+    {
+        // Under these locales, strtod expects a comma as the decimal separator.
+        std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+        for (const char* name : {"de_DE.UTF-8", "fr_FR.UTF-8", "pt_PT.UTF-8"})
+        {
+            if (std::setlocale(LC_NUMERIC, name) != nullptr)
+            {
+                break;
+            }
+        }
+
+        JSONDeserializer des{"[0.5, 2.5e-1, 1e400]"};
+        CHECK(des.beginArray() == 3);
+        double half = 0.0;
+        float quarter = 0.0F;
+        double huge = 0.0;
+        des.read(half);
+        des.read(quarter);
+        des.read(huge);
+        des.endArray();
+        std::setlocale(LC_NUMERIC, previous.c_str());
+
+        CHECK_FALSE(des.failed());
+        CHECK(half == 0.5);
+        CHECK(quarter == 0.25F);
+        CHECK(std::isinf(huge));
+    }
+
+    SUBCASE("malformed source sets the fail bit")
+    {
+        JSONDeserializer des{R"([1, "two"])"};
+        std::vector<int> vec;
+        des.read(vec);
+        CHECK(des.failed());
+    }
+}
@@ -0,0 +1,86 @@
+#include <unordered_map>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/data/json_deserializer.hpp>
+#include <cubos/core/data/json_serializer.hpp>
+#include <cubos/core/memory/buffer_stream.hpp>
+
+using cubos::core::data::JSONDeserializer;
+using cubos::core::data::JSONSerializer;
+using cubos::core::memory::BufferStream;
+using cubos::core::memory::SeekOrigin;
+
+/// Serializes a value with the given indentation, and returns the output.
+template <typename T>
+static std::string toJSON(const T& value, int indent)
+{
+    BufferStream stream{};
+    {
+        JSONSerializer ser{stream, indent};
+        ser.write(value, nullptr);
+    }
+    return {static_cast<const char*>(stream.getBuffer()), stream.tell()};
+}
+
+TEST_CASE("data::JSONSerializer")
+{
+    SUBCASE("primitives")
+    {
+        CHECK(toJSON(int32_t{-42}, -1) == "-42");
+        CHECK(toJSON(uint64_t{18446744073709551615ULL}, -1) == "18446744073709551615");
+        CHECK(toJSON(0.1F, -1) == "0.1");
+        CHECK(toJSON(2.0, -1) == "2.0");
+        CHECK(toJSON(true, -1) == "true");
+        CHECK(toJSON(std::string{"a\"b\n\x01"}, -1) == R"("a\"b\n\u0001")");
+    }
+
+    SUBCASE("compact containers")
+    {
+        std::vector<std::vector<int>> vec{{1, 2}, {}};
+        CHECK(toJSON(vec, -1) == "[[1,2],[]]");
+
+        std::unordered_map<int, bool> map{{3, false}};
+        CHECK(toJSON(map, -1) == R"({"3":false})");
+    }
+
+    SUBCASE("indented containers")
+    {
+        std::vector<std::vector<int>> vec{{1, 2}, {}};
+        CHECK(toJSON(vec, 2) == "[\n  [\n    1,\n    2\n  ],\n  []\n]");
+
+        std::unordered_map<std::string, std::vector<int>> map{{"a", {1}}};
+        CHECK(toJSON(map, 4) == "{\n    \"a\": [\n        1\n    ]\n}");
+    }
+
+    SUBCASE("containers used as keys are written as strings")
+    {
+        BufferStream stream{};
+        {
+            JSONSerializer ser{stream, 2};
+            ser.beginDictionary(1, nullptr);
+            ser.write(std::vector<int>{1, 2}, nullptr);
+            ser.write(3, nullptr);
+            ser.endDictionary();
+        }
+        CHECK(std::string{static_cast<const char*>(stream.getBuffer()), stream.tell()} == "{\n  \"[1,2]\": 3\n}");
+    }
+
+    SUBCASE("output can be read back")
+    {
+        std::unordered_map<std::string, std::vector<float>> map{{"x", {0.1F, -3.25F, 1e-20F}}};
+        BufferStream stream{};
+        {
+            JSONSerializer ser{stream, 4};
+            ser.write(map, nullptr);
+        }
+
+        stream.seek(0, SeekOrigin::Begin);
+        JSONDeserializer des{stream};
+        std::unordered_map<std::string, std::vector<float>> read;
+        des.read(read);
+        CHECK_FALSE(des.failed());
+        CHECK(read == map);
+    }
+}
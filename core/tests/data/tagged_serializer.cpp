@@ -0,0 +1,192 @@
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/data/fields.hpp>
+#include <cubos/core/data/tagged_deserializer.hpp>
+#include <cubos/core/data/tagged_serializer.hpp>
+#include <cubos/core/memory/buffer_stream.hpp>
+
+using cubos::core::data::deserializeFields;
+using cubos::core::data::makeField;
+using cubos::core::data::serializeFields;
+using cubos::core::data::TaggedDeserializer;
+using cubos::core::data::TaggedSerializer;
+using cubos::core::memory::BufferStream;
+
+/// Layout of a type as it was when some data was saved.
+struct OldLayout
+{
+    int32_t a = 0;
+    std::string b;
+    std::vector<float> c;
+};
+
+/// Layout of the same type after a patch: @p b was removed, @p c moved and @p d added.
+struct NewLayout
+{
+    std::vector<float> c;
+    int64_t a = 0;
+    bool d = true;
+};
+
+template <>
+struct cubos::core::data::Fields<OldLayout>
+{
+    static constexpr auto value =
+        std::make_tuple(makeField("a", &OldLayout::a), makeField("b", &OldLayout::b), makeField("c", &OldLayout::c));
+};
+
+template <>
+struct cubos::core::data::Fields<NewLayout>
+{
+    static constexpr auto value =
+        std::make_tuple(makeField("c", &NewLayout::c), makeField("a", &NewLayout::a), makeField("d", &NewLayout::d));
+};
+
+/// Serializes a value and returns the stream with the output.
+template <typename T>
+static BufferStream toTagged(const T& value)
+{
+    BufferStream stream{};
+    TaggedSerializer ser{stream};
+    ser.write(value, "value");
+    CHECK_FALSE(ser.failed());
+    return stream;
+}
+
+TEST_CASE("data::TaggedSerializer")
+{
+    SUBCASE("values can be read back")
+    {
+        std::unordered_map<std::string, std::vector<int16_t>> map{{"x", {-1, 300}}, {"y", {}}};
+        auto stream = toTagged(map);
+        auto view = stream.view();
+        TaggedDeserializer des{view};
+        std::unordered_map<std::string, std::vector<int16_t>> read;
+        des.read(read);
+        CHECK_FALSE(des.failed());
+        CHECK(read == map);
+    }
+
+    SUBCASE("small integers take a single byte")
+    {
+        BufferStream stream{};
+        {
+            TaggedSerializer ser{stream};
+            ser.writeI64(-3, nullptr);
+            ser.writeU32(127, nullptr);
+        }
+        CHECK(stream.size() == 4);
+    }
+
+    SUBCASE("integers can be read into wider types")
+    {
+        auto stream = toTagged(int8_t{-100});
+        auto view = stream.view();
+        TaggedDeserializer des{view};
+        int64_t value = 0;
+        des.read(value);
+        CHECK_FALSE(des.failed());
+        CHECK(value == -100);
+    }
+
+    SUBCASE("out of range integers set the fail bit")
+    {
+        auto stream = toTagged(uint32_t{1000});
+        auto view = stream.view();
+        TaggedDeserializer des{view};
+        uint8_t value = 0;
+        des.read(value);
+        CHECK(des.failed());
+    }
+
+    SUBCASE("corrupt sizes set the fail bit")
+    {
+        // An array which claims 2^40 elements, in a container of 6 bytes.
+        const unsigned char array[] = {0x02, 0x06, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20};
+        BufferStream arrayStream{array, sizeof(array)};
+        TaggedDeserializer arrayDes{arrayStream};
+        CHECK(arrayDes.beginArray() == 0);
+        arrayDes.endArray();
+        CHECK(arrayDes.failed());
+
+        // An object with a string which claims 2^32 - 1 bytes, of which only one is present.
+        const unsigned char object[] = {0x02, 0x07, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 'a'};
+        BufferStream objectStream{object, sizeof(object)};
+        TaggedDeserializer objectDes{objectStream};
+        std::string str = "default";
+        objectDes.beginObject();
+        objectDes.readString(str);
+        objectDes.endObject();
+        CHECK(objectDes.failed());
+        CHECK(str == "default");
+
+        // A top-level string has no container to be checked against, but must not be allocated
+        // before its bytes are read.
+        const unsigned char string[] = {0x02, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20, 'a'};
+        BufferStream stringStream{string, sizeof(string)};
+        TaggedDeserializer stringDes{stringStream};
+        stringDes.readString(str);
+        CHECK(stringDes.failed());
+        CHECK(str == "default");
+    }
+
+    SUBCASE("unread fields are skipped and missing fields keep their values")
+    {
+        BufferStream stream{};
+        {
+            TaggedSerializer ser{stream};
+            ser.beginArray(2, nullptr);
+            ser.beginObject(nullptr);
+            ser.writeI32(1, "a");
+            ser.writeString("skipped", "b");
+            ser.endObject();
+            ser.beginObject(nullptr);
+            ser.writeI32(2, "a");
+            ser.endObject();
+            ser.endArray();
+        }
+
+        auto view = stream.view();
+        TaggedDeserializer des{view};
+        int32_t first = 0;
+        int32_t second = 0;
+        std::string missing = "default";
+        CHECK(des.beginArray() == 2);
+        des.beginObject();
+        des.readI32(first);
+        des.endObject();
+        des.beginObject();
+        des.readI32(second);
+        des.readString(missing);
+        des.endObject();
+        des.endArray();
+
+        CHECK_FALSE(des.failed());
+        CHECK(first == 1);
+        CHECK(second == 2);
+        CHECK(missing == "default");
+    }
+
+    SUBCASE("types with field descriptors are matched by field identifier")
+    {
+        OldLayout old{-5, "removed", {1.0F, 2.5F}};
+        BufferStream stream{};
+        {
+            TaggedSerializer ser{stream};
+            serializeFields<TaggedSerializer>(ser, old, nullptr);
+        }
+
+        auto view = stream.view();
+        TaggedDeserializer des{view};
+        NewLayout read{};
+        deserializeFields<TaggedDeserializer>(des, read);
+        CHECK_FALSE(des.failed());
+        CHECK(read.a == -5);
+        CHECK(read.c == old.c);
+        CHECK(read.d);
+    }
+}
@@ -0,0 +1,165 @@
+#include <doctest/doctest.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cubos/core/geom/intersections.hpp>
+
+#include "utils.hpp"
+
+using cubos::core::geom::Box;
+using cubos::core::geom::Capsule;
+using cubos::core::geom::ContactManifold;
+using cubos::core::geom::Convex;
+using cubos::core::geom::Plane;
+using cubos::core::geom::Simplex;
+
+static glm::mat4 at(float x, float y, float z)
+{
+    return glm::translate(glm::mat4{1.0F}, glm::vec3{x, y, z});
+}
+
+TEST_CASE("geom::intersects")
+{
+    ContactManifold manifold;
+    auto box = Convex::box(Box{glm::vec3{0.5F}}, glm::mat4{1.0F});
+
+    SUBCASE("separated boxes")
+    {
+        CHECK_FALSE(intersects(box, Convex::box(Box{glm::vec3{0.5F}}, at(1.1F, 0.0F, 0.0F)), manifold));
+        CHECK_FALSE(intersects(box, Convex::box(Box{glm::vec3{0.5F}}, at(0.8F, 1.05F, 0.0F)), manifold));
+    }
+
+    SUBCASE("box face contact")
+    {
+        REQUIRE(intersects(box, Convex::box(Box{glm::vec3{0.5F}}, at(0.9F, 0.2F, 0.0F)), manifold));
+        CHECK_VEC3_EQ(manifold.normal, glm::vec3{1.0F, 0.0F, 0.0F});
+        CHECK(manifold.depth == doctest::Approx(0.1F));
+        REQUIRE(manifold.pointCount == 4);
+        for (std::size_t i = 0; i < manifold.pointCount; ++i)
+        {
+            CHECK(manifold.points[i].x == doctest::Approx(0.45F));
+            CHECK(manifold.points[i].y >= -0.3F - 1e-4F);
+            CHECK(manifold.points[i].y <= 0.5F + 1e-4F);
+            CHECK(std::abs(manifold.points[i].z) == doctest::Approx(0.5F));
+        }
+    }
+
+    SUBCASE("box face contact is symmetric")
+    {
+        auto other = Convex::box(Box{glm::vec3{0.5F}}, at(-0.9F, 0.0F, 0.0F));
+        REQUIRE(intersects(box, other, manifold));
+        CHECK_VEC3_EQ(manifold.normal, glm::vec3{-1.0F, 0.0F, 0.0F});
+        CHECK(manifold.depth == doctest::Approx(0.1F));
+    }
+
+    SUBCASE("rotated box edge on box face")
+    {
+        auto transform = glm::rotate(at(1.1F, 0.0F, 0.0F), glm::radians(45.0F), glm::vec3{0.0F, 0.0F, 1.0F});
+        REQUIRE(intersects(box, Convex::box(Box{glm::vec3{0.5F}}, transform), manifold));
+        CHECK(manifold.normal.x == doctest::Approx(1.0F));
+        CHECK(manifold.depth == doctest::Approx(0.5F - (1.1F - std::sqrt(0.5F))));
+        CHECK(manifold.pointCount == 2);
+    }
+
+    SUBCASE("box margins are taken into account")
+    {
+        auto withMargin = Convex::box(Box{glm::vec3{0.5F}}, at(1.05F, 0.0F, 0.0F), 0.1F);
+        REQUIRE(intersects(box, withMargin, manifold));
+        CHECK(manifold.depth == doctest::Approx(0.05F));
+    }
+
+    SUBCASE("spheres")
+    {
+        auto a = Convex::capsule(Capsule::sphere(1.0F), glm::mat4{1.0F});
+        auto b = Convex::capsule(Capsule::sphere(1.0F), at(0.0F, 1.5F, 0.0F));
+        REQUIRE(intersects(a, b, manifold));
+        CHECK(manifold.normal.y == doctest::Approx(1.0F));
+        CHECK(manifold.depth == doctest::Approx(0.5F));
+        REQUIRE(manifold.pointCount == 1);
+        CHECK(manifold.points[0].y == doctest::Approx(0.75F));
+
+        CHECK_FALSE(intersects(a, Convex::capsule(Capsule::sphere(1.0F), at(0.0F, 2.1F, 0.0F)), manifold));
+    }
+
+    SUBCASE("crossed capsules")
+    {
+        auto a = Convex::capsule(Capsule{0.25F, 2.0F}, glm::mat4{1.0F});
+        auto transform = glm::rotate(at(0.0F, 0.0F, 0.4F), glm::radians(90.0F), glm::vec3{0.0F, 0.0F, 1.0F});
+        auto b = Convex::capsule(Capsule{0.25F, 2.0F}, transform);
+        REQUIRE(intersects(a, b, manifold));
+        CHECK(manifold.normal.z == doctest::Approx(1.0F));
+        CHECK(manifold.depth == doctest::Approx(0.1F));
+    }
+
+    SUBCASE("sphere touching box")
+    {
+        auto sphere = Convex::capsule(Capsule::sphere(0.5F), at(0.9F, 0.0F, 0.0F));
+        REQUIRE(intersects(box, sphere, manifold));
+        CHECK(manifold.normal.x == doctest::Approx(1.0F));
+        CHECK(manifold.depth == doctest::Approx(0.1F));
+        CHECK(manifold.points[0].x == doctest::Approx(0.45F));
+    }
+
+    SUBCASE("sphere deep inside box")
+    {
+        auto sphere = Convex::capsule(Capsule::sphere(0.5F), at(0.3F, 0.0F, 0.0F));
+        REQUIRE(intersects(box, sphere, manifold));
+        CHECK(manifold.normal.x == doctest::Approx(1.0F).epsilon(0.01));
+        CHECK(manifold.depth == doctest::Approx(0.7F).epsilon(0.01));
+    }
+
+    SUBCASE("simplex overlapping box")
+    {
+        auto simplex = Convex::simplex(
+            Simplex::tetrahedron({0.0F, 0.0F, 0.0F}, {1.0F, 0.0F, 0.0F}, {0.0F, 1.0F, 0.0F}, {0.0F, 0.0F, 1.0F}),
+            at(0.0F, 0.4F, 0.0F));
+        auto other = Convex::box(Box{glm::vec3{2.0F, 0.5F, 2.0F}}, glm::mat4{1.0F});
+        REQUIRE(intersects(other, simplex, manifold));
+        CHECK(manifold.normal.y == doctest::Approx(1.0F).epsilon(0.01));
+        CHECK(manifold.depth == doctest::Approx(0.1F).epsilon(0.01));
+    }
+
+    SUBCASE("empty simplex never intersects")
+    {
+        CHECK_FALSE(intersects(box, Convex::simplex(Simplex::empty(), glm::mat4{1.0F}), manifold));
+    }
+
+    SUBCASE("box resting on plane")
+    {
+        REQUIRE(intersects(Convex::box(Box{glm::vec3{0.5F}}, at(0.0F, 0.4F, 0.0F)), Plane{}, glm::vec3{0.0F}, 0.0F,
+                           manifold));
+        CHECK_VEC3_EQ(manifold.normal, glm::vec3{0.0F, -1.0F, 0.0F});
+        CHECK(manifold.depth == doctest::Approx(0.1F));
+        REQUIRE(manifold.pointCount == 4);
+        for (std::size_t i = 0; i < manifold.pointCount; ++i)
+        {
+            CHECK(manifold.points[i].y == doctest::Approx(-0.05F));
+        }
+
+        CHECK_FALSE(intersects(Convex::box(Box{glm::vec3{0.5F}}, at(0.0F, 0.6F, 0.0F)), Plane{}, glm::vec3{0.0F},
+                               0.0F, manifold));
+    }
+
+    SUBCASE("capsule lying on plane")
+    {
+        auto transform = glm::rotate(at(0.0F, 0.2F, 0.0F), glm::radians(90.0F), glm::vec3{0.0F, 0.0F, 1.0F});
+        REQUIRE(intersects(Convex::capsule(Capsule{0.25F, 1.0F}, transform), Plane{}, glm::vec3{0.0F}, 0.0F,
+                           manifold));
+        CHECK(manifold.depth == doctest::Approx(0.05F));
+        CHECK(manifold.pointCount == 2);
+    }
+}
+
+TEST_CASE("geom::coreDistance")
+{
+    glm::vec3 pointA;
+    glm::vec3 pointB;
+
+    auto box = Convex::box(Box{glm::vec3{0.5F}}, glm::mat4{1.0F});
+    auto point = Convex::simplex(Simplex::point({2.0F, 2.0F, 0.0F}), glm::mat4{1.0F});
+    CHECK(coreDistance(box, point, pointA, pointB) == doctest::Approx(std::sqrt(4.5F)));
+    CHECK_VEC3_EQ(pointA, glm::vec3{0.5F, 0.5F, 0.0F});
+    CHECK_VEC3_EQ(pointB, glm::vec3{2.0F, 2.0F, 0.0F});
+
+    auto inside = Convex::simplex(Simplex::point({0.1F, 0.0F, 0.0F}), glm::mat4{1.0F});
+    CHECK(coreDistance(box, inside, pointA, pointB) == 0.0F);
+}
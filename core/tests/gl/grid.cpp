@@ -0,0 +1,165 @@
+#include <doctest/doctest.h>
+
+#include <cubos/core/data/binary_deserializer.hpp>
+#include <cubos/core/data/binary_serializer.hpp>
+#include <cubos/core/gl/grid.hpp>
+#include <cubos/core/memory/buffer_stream.hpp>
+
+using cubos::core::data::BinaryDeserializer;
+using cubos::core::data::BinarySerializer;
+using cubos::core::gl::Grid;
+using cubos::core::memory::BufferStream;
+using cubos::core::memory::SeekOrigin;
+
+/// Serializes a grid to a binary buffer and deserializes it back.
+static Grid roundTrip(const Grid& grid, std::size_t* encodedSize = nullptr)
+{
+    BufferStream stream{};
+    {
+        BinarySerializer serializer{stream};
+        serializer.write(grid, nullptr);
+    }
+
+    if (encodedSize != nullptr)
+    {
+        *encodedSize = stream.tell();
+    }
+
+    stream.seek(0, SeekOrigin::Begin);
+    BinaryDeserializer deserializer{stream};
+    Grid result{};
+    deserializer.read(result);
+    REQUIRE_FALSE(deserializer.failed());
+    return result;
+}
+
+/// Checks if two grids have the same size and voxels.
+static void checkGridsEqual(const Grid& a, const Grid& b)
+{
+    REQUIRE(a.size() == b.size());
+    for (int z = 0; z < static_cast<int>(a.size().z); ++z)
+    {
+        for (int y = 0; y < static_cast<int>(a.size().y); ++y)
+        {
+            for (int x = 0; x < static_cast<int>(a.size().x); ++x)
+            {
+                CHECK(a.get({x, y, z}) == b.get({x, y, z}));
+            }
+        }
+    }
+}
+
+TEST_CASE("gl::Grid")
+{
+    SUBCASE("single voxel grid is preserved")
+    {
+        Grid grid{{1, 1, 1}, {7}};
+        checkGridsEqual(grid, roundTrip(grid));
+    }
+
+    SUBCASE("grid with mixed materials is preserved")
+    {
+        Grid grid{{3, 2, 2}, {1, 1, 2, 0, 0, 0, 3, 1, 1, 65535, 65535, 2}};
+        checkGridsEqual(grid, roundTrip(grid));
+    }
+
+    SUBCASE("mostly empty grid is compressed")
+    {
+        Grid grid{{64, 64, 64}};
+        grid.set({10, 20, 30}, 5);
+        grid.set({11, 20, 30}, 5);
+        grid.set({63, 63, 63}, 2);
+
+        std::size_t encodedSize = 0;
+        checkGridsEqual(grid, roundTrip(grid, &encodedSize));
+        CHECK(encodedSize < 64 * 64 * 64 * sizeof(uint16_t) / 16);
+    }
+
+    SUBCASE("legacy uncompressed grids are still read")
+    {
+        BufferStream stream{};
+        {
+            BinarySerializer serializer{stream};
+            serializer.write(glm::uvec3{2, 1, 1}, nullptr);
+            serializer.write(std::vector<uint16_t>{4, 9}, nullptr);
+        }
+
+        stream.seek(0, SeekOrigin::Begin);
+        BinaryDeserializer deserializer{stream};
+        Grid grid{};
+        deserializer.read(grid);
+        REQUIRE(grid.size() == glm::uvec3{2, 1, 1});
+        CHECK(grid.get({0, 0, 0}) == 4);
+        CHECK(grid.get({1, 0, 0}) == 9);
+    }
+
+    SUBCASE("raycast hits the first non-empty voxel")
+    {
+        Grid grid{{4, 4, 4}};
+        grid.set({2, 1, 1}, 3);
+        grid.set({3, 1, 1}, 4);
+
+        auto hit = grid.raycast({-1.0F, 1.5F, 1.5F}, {1.0F, 0.0F, 0.0F}, 100.0F);
+        REQUIRE(hit.has_value());
+        CHECK(hit->voxel == glm::ivec3{2, 1, 1});
+        CHECK(hit->normal == glm::ivec3{-1, 0, 0});
+        CHECK(hit->distance == doctest::Approx(3.0F));
+    }
+
+    SUBCASE("raycast respects the maximum distance")
+    {
+        Grid grid{{4, 4, 4}};
+        grid.set({3, 3, 3}, 1);
+        CHECK_FALSE(grid.raycast({0.5F, 0.5F, 0.5F}, {1.0F, 1.0F, 1.0F}, 2.0F).has_value());
+        CHECK(grid.raycast({0.5F, 0.5F, 0.5F}, {1.0F, 1.0F, 1.0F}, 10.0F).has_value());
+    }
+
+    SUBCASE("raycast misses rays which don't cross the grid")
+    {
+        Grid grid{{2, 2, 2}, {1, 1, 1, 1, 1, 1, 1, 1}};
+        CHECK_FALSE(grid.raycast({-1.0F, 3.0F, 0.5F}, {1.0F, 0.0F, 0.0F}, 100.0F).has_value());
+        CHECK_FALSE(grid.raycast({-1.0F, 0.5F, 0.5F}, {-1.0F, 0.0F, 0.0F}, 100.0F).has_value());
+    }
+
+    SUBCASE("raycast from inside a voxel has no normal")
+    {
+        Grid grid{{2, 2, 2}, {1, 1, 1, 1, 1, 1, 1, 1}};
+        auto hit = grid.raycast({0.5F, 0.5F, 0.5F}, {0.0F, 1.0F, 0.0F}, 100.0F);
+        REQUIRE(hit.has_value());
+        CHECK(hit->voxel == glm::ivec3{0, 0, 0});
+        CHECK(hit->normal == glm::ivec3{0, 0, 0});
+        CHECK(hit->distance == doctest::Approx(0.0F));
+    }
+
+    SUBCASE("batched raycasts match single raycasts")
+    {
+        Grid grid{{40, 20, 30}};
+        for (int i = 0; i < 200; ++i)
+        {
+            grid.set({(i * 7) % 40, (i * 11) % 20, (i * 13) % 30}, static_cast<uint16_t>(1 + i % 5));
+        }
+
+        std::vector<Grid::Ray> rays;
+        for (int i = 0; i < 300; ++i)
+        {
+            auto origin = glm::vec3{-5.0F, static_cast<float>(i % 23) - 1.5F, static_cast<float>(i % 31) - 0.5F};
+            auto direction =
+                glm::vec3{1.0F, static_cast<float>(i % 7) / 10.0F - 0.3F, static_cast<float>(i % 5) / 8.0F - 0.25F};
+            rays.push_back({origin, direction, 80.0F});
+        }
+
+        std::vector<std::optional<Grid::RaycastHit>> hits;
+        grid.raycast(rays, hits);
+        REQUIRE(hits.size() == rays.size());
+        for (std::size_t i = 0; i < rays.size(); ++i)
+        {
+            auto expected = grid.raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance);
+            REQUIRE(hits[i].has_value() == expected.has_value());
+            if (expected.has_value())
+            {
+                CHECK(hits[i]->voxel == expected->voxel);
+                CHECK(hits[i]->distance == doctest::Approx(expected->distance));
+            }
+        }
+    }
+}
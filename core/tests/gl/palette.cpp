@@ -0,0 +1,74 @@
+#include <doctest/doctest.h>
+
+#include <cubos/core/gl/palette.hpp>
+
+using cubos::core::gl::Material;
+using cubos::core::gl::Palette;
+
+/// Finds the most similar material by comparing with every material in the palette.
+static uint16_t bruteForceFind(const Palette& palette, const Material& material)
+{
+    uint16_t bestI = 0;
+    float bestS = material.similarity(Material::Empty);
+    for (uint16_t i = 1; i <= palette.size(); ++i)
+    {
+        float s = material.similarity(palette.get(i));
+        if (s > bestS)
+        {
+            bestS = s;
+            bestI = i;
+        }
+    }
+    return bestI;
+}
+
+TEST_CASE("gl::Palette")
+{
+    Palette palette{};
+
+    SUBCASE("empty palette finds the empty material")
+    {
+        CHECK(palette.find({{1.0F, 0.0F, 0.0F, 1.0F}}) == 0);
+    }
+
+    SUBCASE("find matches an exhaustive search")
+    {
+        for (int i = 0; i < 500; ++i)
+        {
+            auto r = static_cast<float>((i * 37) % 101) / 100.0F;
+            auto g = static_cast<float>((i * 53) % 89) / 88.0F;
+            auto b = static_cast<float>((i * 71) % 97) / 96.0F;
+            palette.set(static_cast<uint16_t>(i + 1), {{r, g, b, 1.0F}});
+        }
+
+        for (int i = 0; i < 200; ++i)
+        {
+            auto r = static_cast<float>((i * 13) % 67) / 66.0F;
+            auto g = static_cast<float>((i * 29) % 71) / 70.0F;
+            auto b = static_cast<float>((i * 41) % 61) / 60.0F;
+            Material material{{r, g, b, 1.0F}};
+            CHECK(palette.find(material) == bruteForceFind(palette, material));
+        }
+    }
+
+    SUBCASE("duplicate materials resolve to the lowest index")
+    {
+        palette.set(3, {{0.5F, 0.5F, 0.5F, 1.0F}});
+        palette.set(1, {{0.5F, 0.5F, 0.5F, 1.0F}});
+        CHECK(palette.find({{0.5F, 0.5F, 0.5F, 1.0F}}) == 1);
+    }
+
+    SUBCASE("add reuses empty slots")
+    {
+        palette.set(4, {{1.0F, 0.0F, 0.0F, 1.0F}});
+        CHECK(palette.add({{0.0F, 1.0F, 0.0F, 1.0F}}) == 1);
+        CHECK(palette.add({{0.0F, 0.0F, 1.0F, 1.0F}}) == 2);
+        CHECK(palette.add({{1.0F, 0.0F, 0.0F, 1.0F}}) == 4);
+
+        palette.set(1, Material::Empty);
+        CHECK(palette.add({{1.0F, 1.0F, 0.0F, 1.0F}}) == 1);
+        CHECK(palette.add({{0.0F, 1.0F, 1.0F, 1.0F}}) == 3);
+        CHECK(palette.add({{1.0F, 1.0F, 1.0F, 1.0F}}) == 5);
+        CHECK(palette.size() == 5);
+    }
+}
@@ -0,0 +1,98 @@
+#include <cstring>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/gl/recording_render_device.hpp>
+#include <cubos/core/io/window.hpp>
+
+using namespace cubos::core::gl;
+using cubos::core::io::openHeadlessWindow;
+
+using CommandType = RecordingRenderDevice::Command::Type;
+
+TEST_CASE("gl::RecordingRenderDevice")
+{
+    RecordingRenderDevice rd{};
+
+    SUBCASE("commands are recorded in order")
+    {
+        auto rs = rd.createRasterState({});
+        rd.setRasterState(rs);
+        rd.setViewport(0, 0, 16, 8);
+        rd.clearColor(0.0F, 0.0F, 0.0F, 1.0F);
+        rd.drawTrianglesIndexedInstanced(3, 6, 4);
+
+        const auto& commands = rd.frame().commands;
+        REQUIRE(commands.size() == 4);
+        CHECK(commands[0].type == CommandType::SetRasterState);
+        CHECK(commands[0].args[0] != 0);
+        CHECK(commands[1].type == CommandType::SetViewport);
+        CHECK(commands[1].args[2] == 16);
+        CHECK(commands[1].args[3] == 8);
+        CHECK(commands[2].type == CommandType::ClearColor);
+        CHECK(commands[3].type == CommandType::Draw);
+        CHECK(commands[3].args[0] == 3);
+        CHECK(commands[3].args[1] == 6);
+        CHECK(commands[3].args[2] == 4);
+        CHECK(commands[3].args[3] == 1);
+
+        const auto& counts = rd.frame().counts;
+        CHECK(counts.stateChanges == 2);
+        CHECK(counts.clears == 1);
+        CHECK(counts.draws == 1);
+        CHECK(counts.instances == 4);
+        CHECK(counts.triangles == 8);
+    }
+
+    SUBCASE("buffers keep their contents")
+    {
+        const int data[] = {1, 2, 3, 4};
+        auto vb = rd.createVertexBuffer(sizeof(data), data, Usage::Dynamic);
+        auto* mapped = static_cast<int*>(vb->map());
+        CHECK(std::memcmp(mapped, data, sizeof(data)) == 0);
+        vb->unmap();
+        CHECK(rd.frame().counts.bytesMapped == sizeof(data));
+    }
+
+    SUBCASE("pipelines accept any binding point")
+    {
+        auto vs = rd.createShaderStage(Stage::Vertex, "");
+        auto ps = rd.createShaderStage(Stage::Pixel, "");
+        auto pipeline = rd.createShaderPipeline(vs, ps);
+        auto* bp = pipeline->getBindingPoint("anything");
+        REQUIRE(bp != nullptr);
+        CHECK(pipeline->getBindingPoint("anything") == bp);
+
+        bp->setConstant(glm::vec4{1.0F});
+        bp->bind(Texture2D{nullptr});
+        CHECK(rd.frame().counts.constants == 1);
+        CHECK(rd.frame().counts.binds == 1);
+        CHECK(rd.frame().commands[0].args[1] == sizeof(glm::vec4));
+        CHECK(rd.frame().commands[1].args[1] == 0);
+    }
+
+    SUBCASE("ending a frame starts a new one")
+    {
+        rd.drawTriangles(0, 3);
+        rd.endFrame();
+        CHECK(rd.frame().commands.empty());
+        CHECK(rd.frame().counts.draws == 0);
+        CHECK(rd.lastFrame().counts.draws == 1);
+        CHECK(rd.stats().skipped == 0);
+    }
+}
+
+TEST_CASE("io::openHeadlessWindow")
+{
+    auto window = openHeadlessWindow({64, 32});
+    REQUIRE(window != nullptr);
+    CHECK(window->framebufferSize() == glm::ivec2{64, 32});
+    CHECK_FALSE(window->pollEvent().has_value());
+
+    // Swapping the buffers ends the frame recorded by the device.
+    auto& rd = dynamic_cast<RecordingRenderDevice&>(window->renderDevice());
+    rd.drawTriangles(0, 6);
+    window->swapBuffers();
+    CHECK(rd.lastFrame().counts.triangles == 2);
+    CHECK(rd.frame().commands.empty());
+}
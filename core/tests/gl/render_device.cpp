@@ -0,0 +1,115 @@
+#include <cstdlib>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/gl/render_device.hpp>
+#include <cubos/core/io/window.hpp>
+
+using namespace cubos::core::gl;
+using cubos::core::io::openWindow;
+
+/// Opening a window needs a display. No GPU is needed though, as Mesa's software rasterizer can
+/// be used instead, e.g. with `LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ctest`.
+static bool hasDisplay()
+{
+    return std::getenv("DISPLAY") != nullptr || std::getenv("WAYLAND_DISPLAY") != nullptr;
+}
+
+static const char* vertexShader = R"glsl(
+#version 330 core
+
+in vec2 position;
+uniform vec2 offset;
+
+void main()
+{
+    gl_Position = vec4(position + offset, 0.0, 1.0);
+}
+)glsl";
+
+static const char* pixelShader = R"glsl(
+#version 330 core
+
+uniform sampler2D tex;
+out vec4 color;
+
+void main()
+{
+    color = texture(tex, vec2(0.5));
+}
+)glsl";
+
+TEST_CASE("gl::RenderDevice" * doctest::skip(!hasDisplay()))
+{
+    auto window = openWindow();
+    auto& rd = window->renderDevice();
+
+    auto vs = rd.createShaderStage(Stage::Vertex, vertexShader);
+    auto ps = rd.createShaderStage(Stage::Pixel, pixelShader);
+    auto pipeline = rd.createShaderPipeline(vs, ps);
+    REQUIRE(pipeline != nullptr);
+    rd.resetStats();
+
+    SUBCASE("repeated state changes are skipped")
+    {
+        auto rs = rd.createRasterState({});
+        rd.setRasterState(rs);
+        rd.setRasterState(rs);
+        rd.setShaderPipeline(pipeline);
+        rd.setShaderPipeline(pipeline);
+        rd.setViewport(0, 0, 16, 16);
+        rd.setViewport(0, 0, 16, 16);
+        CHECK(rd.stats().issued == 3);
+        CHECK(rd.stats().skipped == 3);
+    }
+
+    SUBCASE("different state changes are issued")
+    {
+        rd.setViewport(0, 0, 16, 16);
+        rd.setViewport(0, 0, 32, 32);
+        rd.setRasterState(nullptr);
+        rd.setRasterState(rd.createRasterState({}));
+        CHECK(rd.stats().issued == 4);
+        CHECK(rd.stats().skipped == 0);
+    }
+
+    SUBCASE("binding points are only looked up once")
+    {
+        CHECK(pipeline->getBindingPoint("offset") != nullptr);
+        CHECK(pipeline->getBindingPoint("offset") == pipeline->getBindingPoint("offset"));
+        CHECK(pipeline->getBindingPoint("missing") == nullptr);
+        CHECK(pipeline->getBindingPoint("missing") == nullptr);
+    }
+
+    SUBCASE("repeated constants are skipped")
+    {
+        rd.setShaderPipeline(pipeline);
+        auto* offset = pipeline->getBindingPoint("offset");
+        offset->setConstant(glm::vec2{1.0F, 2.0F});
+        offset->setConstant(glm::vec2{1.0F, 2.0F});
+        offset->setConstant(glm::vec2{2.0F, 1.0F});
+        CHECK(rd.stats().issued == 3);
+        CHECK(rd.stats().skipped == 1);
+    }
+
+    SUBCASE("deleted textures are unbound")
+    {
+        Texture2DDesc desc;
+        desc.width = 1;
+        desc.height = 1;
+        desc.format = TextureFormat::RGBA8UNorm;
+        desc.usage = Usage::Static;
+
+        rd.setShaderPipeline(pipeline);
+        auto* tex = pipeline->getBindingPoint("tex");
+        auto texture = rd.createTexture2D(desc);
+        tex->bind(texture);
+        rd.resetStats();
+
+        // Deleting the texture unbinds it, so unbinding it again does nothing.
+        texture = nullptr;
+        tex->bind(Texture2D{nullptr});
+        CHECK(rd.stats().issued == 0);
+        CHECK(rd.stats().skipped == 2);
+    }
+}
@@ -0,0 +1,168 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/binary_log_sink.hpp>
+#include <cubos/core/log.hpp>
+#include <cubos/core/memory/endianness.hpp>
+
+using cubos::core::BinaryLogSink;
+using cubos::core::LogSite;
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    /// Sink which stores the messages it receives.
+    class CaptureSink : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+    {
+    public:
+        std::vector<std::pair<spdlog::level::level_enum, std::string>> messages;
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override
+        {
+            messages.emplace_back(msg.level, std::string(msg.payload.data(), msg.payload.size()));
+        }
+
+        void flush_() override
+        {
+        }
+    };
+} // namespace
+
+/// Reads a little endian value from a file.
+template <typename T>
+static T read(FILE* file)
+{
+    T value{};
+    REQUIRE(std::fread(&value, sizeof(T), 1, file) == 1);
+    return cubos::core::memory::fromLittleEndian(value);
+}
+
+/// Reads a string of the given size from a file.
+static std::string read(FILE* file, std::size_t size)
+{
+    std::string str(size, '\0');
+    REQUIRE(std::fread(str.data(), 1, size, file) == size);
+    return str;
+}
+
+TEST_CASE("log.site")
+{
+    auto sink = std::make_shared<CaptureSink>();
+    auto previous = spdlog::default_logger();
+    spdlog::set_default_logger(std::make_shared<spdlog::logger>("test", sink));
+
+    spdlog::source_loc source{"file.cpp", 42, "function"};
+    auto start = std::chrono::steady_clock::now();
+
+    SUBCASE("without limit")
+    {
+        LogSite site{};
+        for (int i = 0; i < 100; ++i)
+        {
+            CHECK(site.allow(source, 0, start));
+        }
+    }
+
+    SUBCASE("per call site")
+    {
+        LogSite first{};
+        LogSite second{};
+
+        // Each site gets its own three messages per second.
+        CHECK(first.allow(source, 3, start));
+        CHECK(first.allow(source, 3, start));
+        CHECK(second.allow(source, 3, start));
+        CHECK(first.allow(source, 3, start + 100ms));
+        CHECK_FALSE(first.allow(source, 3, start + 200ms));
+        CHECK_FALSE(first.allow(source, 3, start + 900ms));
+        CHECK(second.allow(source, 3, start + 900ms));
+        CHECK(second.allow(source, 3, start + 900ms));
+        CHECK_FALSE(second.allow(source, 3, start + 900ms));
+        CHECK(sink->messages.empty());
+
+        // Once a new window starts, the dropped messages are reported before the next one.
+        CHECK(first.allow(source, 3, start + 1000ms));
+        REQUIRE(sink->messages.size() == 1);
+        CHECK(sink->messages[0].first == spdlog::level::warn);
+        CHECK(sink->messages[0].second.find("Dropped 2 messages") != std::string::npos);
+
+        // Nothing is reported when no messages were dropped.
+        CHECK(first.allow(source, 3, start + 1100ms));
+        CHECK(first.allow(source, 3, start + 2500ms));
+        CHECK(sink->messages.size() == 1);
+
+        CHECK(second.allow(source, 3, start + 5000ms));
+        REQUIRE(sink->messages.size() == 2);
+        CHECK(sink->messages[1].second.find("Dropped 1 messages") != std::string::npos);
+    }
+
+    SUBCASE("quiet call sites")
+    {
+        LogSite site{};
+        for (int i = 0; i < 5; ++i)
+        {
+            site.allow(source, 2, start);
+        }
+
+        // Drops are only reported by the registry once the window ends.
+        LogSite::reportDropped(start + 500ms);
+        CHECK(sink->messages.empty());
+        LogSite::reportDropped(start + 1000ms);
+        REQUIRE(sink->messages.size() == 1);
+        CHECK(sink->messages[0].second.find("Dropped 3 messages") != std::string::npos);
+
+        // Reported drops aren't reported again, neither by the registry nor by the site.
+        LogSite::reportDropped(start + 3000ms);
+        CHECK(site.allow(source, 2, start + 3000ms));
+        CHECK(sink->messages.size() == 1);
+
+        // Sites destroyed before reporting their drops report them on destruction.
+        {
+            LogSite other{};
+            other.allow(source, 1, start);
+            other.allow(source, 1, start);
+        }
+        REQUIRE(sink->messages.size() == 2);
+        CHECK(sink->messages[1].second.find("Dropped 1 messages") != std::string::npos);
+
+        // Shutting down reports all sites, even those within their window.
+        CHECK_FALSE(site.allow(source, 1, start + 3000ms));
+        LogSite::reportDropped(std::chrono::steady_clock::time_point::max());
+        REQUIRE(sink->messages.size() == 3);
+        CHECK(sink->messages[2].second.find("Dropped 1 messages") != std::string::npos);
+    }
+
+    spdlog::set_default_logger(previous);
+}
+
+TEST_CASE("log.binary")
+{
+    FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+
+    spdlog::logger logger{"test", std::make_shared<BinaryLogSink>(file, false)};
+    auto before = std::chrono::system_clock::now();
+    logger.log(spdlog::source_loc{"some/file.cpp", 42, "function"}, spdlog::level::err, "Hello {}!", 7);
+    logger.flush();
+    auto after = std::chrono::system_clock::now();
+
+    std::rewind(file);
+    auto time = std::chrono::nanoseconds(read<uint64_t>(file));
+    CHECK(time >= std::chrono::duration_cast<std::chrono::nanoseconds>(before.time_since_epoch()));
+    CHECK(time <= std::chrono::duration_cast<std::chrono::nanoseconds>(after.time_since_epoch()));
+    CHECK(read<uint8_t>(file) == static_cast<uint8_t>(spdlog::level::err));
+    CHECK(read<uint32_t>(file) == 42);
+    auto fileSize = read<uint16_t>(file);
+    CHECK(read(file, fileSize) == "some/file.cpp");
+    auto msgSize = read<uint32_t>(file);
+    CHECK(read(file, msgSize) == "Hello 7!");
+
+    // The whole record was read.
+    CHECK(std::fgetc(file) == EOF);
+    std::fclose(file);
+}
@@ -0,0 +1,73 @@
+#include <string>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/memory/buffer_stream.hpp>
+
+using cubos::core::memory::BufferStream;
+using cubos::core::memory::SeekOrigin;
+
+TEST_CASE("memory::BufferStream")
+{
+    SUBCASE("owned buffers grow and only read written data")
+    {
+        BufferStream stream{2};
+        stream.print("hello");
+        CHECK(stream.size() == 5);
+        CHECK(stream.capacity() >= 5);
+
+        stream.seek(0, SeekOrigin::Begin);
+        char buf[8];
+        CHECK(stream.read(buf, 8) == 5);
+        CHECK(stream.eof());
+        CHECK(std::string(buf, 5) == "hello");
+
+        stream.seek(-2, SeekOrigin::End);
+        CHECK(stream.peek() == 'l');
+        stream.print("p!");
+        CHECK(stream.size() == 5);
+    }
+
+    SUBCASE("reserve doesn't change the data")
+    {
+        BufferStream stream{};
+        stream.print("abc");
+        stream.reserve(1000);
+        CHECK(stream.capacity() == 1000);
+        CHECK(stream.size() == 3);
+        CHECK(std::string(static_cast<const char*>(stream.getBuffer()), 3) == "abc");
+    }
+
+    SUBCASE("views and slices borrow the data")
+    {
+        BufferStream stream{};
+        stream.print("0123456789");
+
+        auto view = stream.view();
+        CHECK(view.getBuffer() == stream.getBuffer());
+        CHECK(view.size() == 10);
+        CHECK(view.write("x", 1) == 0);
+
+        auto slice = stream.slice(3, 4);
+        std::string str;
+        slice.readUntil(str, nullptr);
+        CHECK(str == "3456");
+        CHECK(stream.slice(8, 100).size() == 2);
+        CHECK(stream.slice(100, 1).size() == 0);
+    }
+
+    SUBCASE("data can be taken and released without copying")
+    {
+        std::vector<char> data{'a', 'b', 'c'};
+        const auto* ptr = data.data();
+        BufferStream stream{std::move(data)};
+        CHECK(stream.getBuffer() == ptr);
+        CHECK(stream.get() == 'a');
+
+        stream.seek(0, SeekOrigin::End);
+        stream.put('d');
+        auto released = stream.release();
+        CHECK(std::string(released.begin(), released.end()) == "abcd");
+        CHECK(stream.size() == 0);
+    }
+}
@@ -0,0 +1,98 @@
+#include <cstring>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/memory/buffer_stream.hpp>
+#include <cubos/core/memory/buffered_stream.hpp>
+
+using cubos::core::memory::BufferedStream;
+using cubos::core::memory::BufferStream;
+using cubos::core::memory::SeekOrigin;
+
+/// Creates a buffered stream which reads the given string through a tiny buffer, so that most
+/// operations cross buffer boundaries.
+static BufferedStream bufferedString(const char* str, std::size_t bufferSize = 3)
+{
+    return BufferedStream{std::make_unique<BufferStream>(str, std::strlen(str)), bufferSize};
+}
+
+TEST_CASE("memory::BufferedStream")
+{
+    SUBCASE("read and peek")
+    {
+        auto stream = bufferedString("hello world");
+        char buf[5];
+        REQUIRE(stream.read(buf, 5) == 5);
+        CHECK(std::string(buf, 5) == "hello");
+        CHECK(stream.tell() == 5);
+        CHECK(stream.peek() == ' ');
+        CHECK(stream.get() == ' ');
+        CHECK(stream.read(buf, 5) == 5);
+        CHECK(std::string(buf, 5) == "world");
+        CHECK_FALSE(stream.eof());
+        CHECK(stream.read(buf, 1) == 0);
+        CHECK(stream.eof());
+    }
+
+    SUBCASE("readUntil with terminators split between reads")
+    {
+        auto stream = bufferedString("ab::cd:e::f");
+        std::string str;
+        stream.readUntil(str, "::");
+        CHECK(str == "ab");
+        stream.readUntil(str, "::");
+        CHECK(str == "cd:e");
+        CHECK_FALSE(stream.eof());
+        stream.readUntil(str, "::");
+        CHECK(str == "f");
+        CHECK(stream.eof());
+    }
+
+    SUBCASE("readUntil stops at null characters")
+    {
+        const char src[] = "abc\0def";
+        BufferedStream stream{std::make_unique<BufferStream>(src, sizeof(src)), 2};
+        std::string str;
+        stream.readUntil(str, nullptr);
+        CHECK(str == "abc");
+        stream.readUntil(str, nullptr);
+        CHECK(str == "def");
+    }
+
+    SUBCASE("ignore and seek")
+    {
+        auto stream = bufferedString("0123456789");
+        stream.ignore(1);
+        CHECK(stream.get() == '1');
+        stream.ignore(5);
+        CHECK(stream.tell() == 7);
+        CHECK(stream.get() == '7');
+        stream.seek(-6, SeekOrigin::Current);
+        CHECK(stream.get() == '2');
+        stream.seek(1, SeekOrigin::Current);
+        CHECK(stream.get() == '4');
+        stream.seek(-1, SeekOrigin::End);
+        CHECK(stream.get() == '9');
+    }
+
+    SUBCASE("writes are flushed before reading")
+    {
+        auto* inner = new BufferStream();
+        BufferedStream stream{std::unique_ptr<BufferStream>(inner), 4};
+        stream.print("abc");
+        CHECK(inner->tell() == 0);
+        CHECK(stream.tell() == 3);
+        stream.print("defgh");
+        stream.seek(0, SeekOrigin::Begin);
+        CHECK(inner->tell() == 0);
+
+        std::string str;
+        stream.readUntil(str, "e");
+        CHECK(str == "abcd");
+
+        // Writing in the middle of buffered data overwrites the data which follows.
+        stream.put('E');
+        stream.flush();
+        CHECK(std::string{static_cast<const char*>(inner->getBuffer()), 8} == "abcdeEgh");
+    }
+}
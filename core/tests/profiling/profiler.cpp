@@ -0,0 +1,108 @@
+#include <string>
+#include <thread>
+
+#include <doctest/doctest.h>
+
+#include <cubos/core/data/json_deserializer.hpp>
+#include <cubos/core/memory/buffer_stream.hpp>
+#include <cubos/core/profiling/profiler.hpp>
+
+using cubos::core::data::JSONDeserializer;
+using cubos::core::memory::BufferStream;
+using cubos::core::memory::SeekOrigin;
+
+namespace profiling = cubos::core::profiling;
+
+/// Exports the recorded zones, and returns the output.
+static std::string exportTrace()
+{
+    BufferStream stream{};
+    profiling::exportChromeTrace(stream);
+    return {static_cast<const char*>(stream.getBuffer()), stream.size()};
+}
+
+/// Counts the occurrences of a string in another.
+static std::size_t count(const std::string& str, const std::string& sub)
+{
+    std::size_t n = 0;
+    for (auto pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + 1))
+    {
+        n += 1;
+    }
+    return n;
+}
+
+TEST_CASE("profiling::Zone")
+{
+    profiling::clear();
+
+    SUBCASE("zones aren't recorded while disabled")
+    {
+        {
+            CUBOS_PROFILE_ZONE("disabled");
+        }
+        CHECK(count(exportTrace(), "\"disabled\"") == 0);
+    }
+
+    SUBCASE("zones are recorded while enabled")
+    {
+        profiling::setEnabled(true);
+        {
+            CUBOS_PROFILE_ZONE("outer");
+            CUBOS_PROFILE_ZONE(profiling::intern("inner"));
+        }
+        std::thread([] { CUBOS_PROFILE_ZONE("thread"); }).join();
+        profiling::setEnabled(false);
+
+        auto trace = exportTrace();
+        CHECK(count(trace, "\"outer\"") == 1);
+        CHECK(count(trace, "\"inner\"") == 1);
+        CHECK(count(trace, "\"thread\"") == 1);
+        CHECK(count(trace, "\"ph\":\"X\"") == 3);
+
+        // The exported trace must be valid JSON.
+        BufferStream stream{};
+        profiling::exportChromeTrace(stream);
+        stream.seek(0, SeekOrigin::Begin);
+        JSONDeserializer des{stream};
+        std::string unit;
+        des.beginObject();
+        des.read(unit);
+        CHECK_FALSE(des.failed());
+        CHECK(unit == "ns");
+
+        profiling::clear();
+        CHECK(count(exportTrace(), "\"ph\"") == 0);
+    }
+
+    SUBCASE("full buffers keep the newest zones")
+    {
+        profiling::setEnabled(true);
+        for (int i = 0; i < 10; ++i)
+        {
+            CUBOS_PROFILE_ZONE("oldest");
+        }
+        for (int i = 0; i < 100000; ++i)
+        {
+            CUBOS_PROFILE_ZONE("newest");
+        }
+        profiling::setEnabled(false);
+
+        auto trace = exportTrace();
+        auto kept = count(trace, "\"newest\"");
+        CHECK(count(trace, "\"oldest\"") == 0);
+        CHECK(kept > 0);
+        CHECK(kept < 100000);
+
+        // The overwritten zones are reported.
+        auto dropped = std::to_string(100010 - kept);
+        CHECK(count(trace, "\"droppedZones\":" + dropped + "}") == 1);
+        profiling::clear();
+    }
+
+    SUBCASE("interned names are shared")
+    {
+        auto* name = profiling::intern("name");
+        CHECK(profiling::intern(std::string{"na"} + "me") == name);
+    }
+}
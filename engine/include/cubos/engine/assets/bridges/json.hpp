@@ -38,10 +38,8 @@ namespace cubos::engine
     protected:
         bool loadFromFile(Assets& assets, const AnyAsset& handle, core::memory::Stream& stream) override
         {
-            // Dump the file stream into a string and initialize a JSON deserializer with it.
-            std::string json{};
-            stream.readUntil(json, nullptr);
-            core::data::JSONDeserializer deserializer{json};
+            // Initialize a JSON deserializer which parses the file stream as it is read.
+            core::data::JSONDeserializer deserializer{stream};
 
             // Deserialize the asset and store it in the asset manager.
             T data{};
@@ -0,0 +1,71 @@
+/// @file
+/// @brief Class @ref cubos::engine::TaggedBridge.
+/// @ingroup assets-plugin
+
+#pragma once
+
+#include <cubos/core/data/tagged_deserializer.hpp>
+#include <cubos/core/data/tagged_serializer.hpp>
+#include <cubos/core/log.hpp>
+
+#include <cubos/engine/assets/bridges/file.hpp>
+
+namespace cubos::engine
+{
+    /// @brief Bridge for loading and saving assets which are serialized to and from a tagged
+    /// binary file.
+    ///
+    /// Works like @ref BinaryBridge, but files saved by it can still be loaded after fields are
+    /// added to or removed from @p T. No additional context is given to the serializer or
+    /// deserializer.
+    ///
+    /// @tparam T Type of asset to load and save. Must be default constructible.
+    /// @ingroup assets-plugin
+    template <typename T>
+    class TaggedBridge : public FileBridge
+    {
+    public:
+        /// @brief Constructs a bridge.
+        TaggedBridge()
+            : FileBridge(typeid(T))
+        {
+        }
+
+    protected:
+        bool loadFromFile(Assets& assets, const AnyAsset& handle, core::memory::Stream& stream) override
+        {
+            // Initialize a tagged deserializer with the file stream.
+            core::data::TaggedDeserializer deserializer{stream};
+
+            // Deserialize the asset and store it in the asset manager.
+            T data{};
+            deserializer.read(data);
+            if (deserializer.failed())
+            {
+                CUBOS_ERROR("Could not deserialize asset from tagged binary file");
+                return false;
+            }
+
+            assets.store(handle, std::move(data));
+            return true;
+        }
+
+        bool saveToFile(const Assets& assets, const AnyAsset& handle, core::memory::Stream& stream) override
+        {
+            // Initialize a tagged serializer with the file stream.
+            core::data::TaggedSerializer serializer{stream};
+
+            // Read the asset from the asset manager and serialize it to the file stream.
+            auto data = assets.read<T>(handle);
+            serializer.write(*data, nullptr);
+            serializer.flush();
+            if (serializer.failed())
+            {
+                CUBOS_ERROR("Could not serialize asset to tagged binary file");
+                return false;
+            }
+
+            return true;
+        }
+    };
+} // namespace cubos::engine
@@ -4,12 +4,14 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
 #include <unordered_set>
 #include <vector>
 
 #include <cubos/core/ecs/entity_manager.hpp>
 
+#include <cubos/engine/collisions/aabb.hpp>
+
 using cubos::core::ecs::Entity;
 
 namespace cubos::engine
@@ -22,14 +24,58 @@ namespace cubos::engine
         using Candidate = std::pair<Entity, Entity>;
 
         /// @brief Hash function to allow Candidates to be used as keys in an unordered_set.
+        ///
+        /// Both entity indices are packed into a single key, so that pairs which share an entity
+        /// or swap their entities don't collide, and the key's bits are mixed for bucketing.
         struct CandidateHash
         {
             std::size_t operator()(const Candidate& candidate) const
             {
-                return std::hash<Entity>()(candidate.first) ^ std::hash<Entity>()(candidate.second);
+                auto key = static_cast<std::uint64_t>(candidate.first.index) << 32 | candidate.second.index;
+                key ^= key >> 33;
+                key *= 0xFF51AFD7ED558CCDULL;
+                key ^= key >> 33;
+                return static_cast<std::size_t>(key);
             }
         };
 
+        /// @brief Shape of a collider, used to find the collision type of a pair of entities.
+        enum class Shape
+        {
+            Box = 0,
+            Capsule,
+            Plane,
+            Simplex
+        };
+
+        /// @brief AABBs of the tracked entities, mirrored into contiguous arrays - one per bound
+        /// and axis - so that they can be tested for overlap in batches.
+        struct Bounds
+        {
+            /// @brief Slot of entities which aren't tracked.
+            static constexpr std::uint32_t NoSlot = UINT32_MAX;
+
+            std::vector<Entity> entities;     ///< Entity of each slot.
+            std::vector<std::uint8_t> shapes; ///< Bit mask of the shapes of the colliders of each slot.
+            std::vector<float> min[3];        ///< Minimum bound of each slot, along each axis.
+            std::vector<float> max[3];        ///< Maximum bound of each slot, along each axis.
+            std::vector<std::uint32_t> slots; ///< Slot of each entity, indexed by the entity's index.
+
+            /// @brief Gets the slot of an entity.
+            /// @param entity Entity.
+            /// @return Slot, or @ref NoSlot if the entity isn't tracked.
+            std::uint32_t slot(Entity entity) const;
+
+            /// @brief Gets the AABB stored in a slot.
+            /// @param slot Slot.
+            /// @return AABB.
+            ColliderAABB aabb(std::uint32_t slot) const;
+
+            /// @brief Gets the number of slots.
+            /// @return Number of slots.
+            std::size_t size() const;
+        };
+
         /// @brief Collision type for each pair of colliders.
         enum class CollisionType
         {
@@ -47,45 +93,93 @@ namespace cubos::engine
             Count ///< Number of collision types.
         };
 
+        /// @brief Algorithms which can be used to find the collision candidates.
+        enum class Backend
+        {
+            SweepAndPrune, ///< Incremental sort and sweep of the AABB bounds along each axis.
+            AABBTree,      ///< Queries of the moved entities on a @ref BroadPhaseTree.
+            HashGrid       ///< Uniform grid rebuilt every frame, suited for many similarly sized colliders.
+        };
+
+        /// @brief Algorithm used to find the collision candidates. Chosen on startup from the
+        /// `collisions.broadPhase` setting.
+        Backend backend = Backend::SweepAndPrune;
+
         /// @brief Marker used for sweep and prune.
         struct SweepMarker
         {
-            Entity entity; ///< Entity referenced by the marker.
-            bool isMin;    ///< Whether the marker is a min or max marker.
+            Entity entity;  ///< Entity referenced by the marker.
+            bool isMin;     ///< Whether the marker is a min or max marker.
+            float position; ///< Position of the marker along its axis, cached from the entity's AABB.
         };
 
-        /// @brief List of ordered sweep markers for each axis. Stores the index of the marker in mMarkers.
+        /// @brief List of sweep markers for each axis. Kept sorted between frames, so that they can
+        /// be updated with an insertion sort, which is close to linear when objects move little.
         std::vector<SweepMarker> markersPerAxis[3];
 
-        /// @brief Maps of overlapping entities for each axis calculated by sweep and prune.
+        /// @brief Pairs of entities whose overlap along each axis changed in the last sweep.
+        std::vector<Candidate> deltasPerAxis[3];
+
+        /// @brief Number of entities added since the last sweep.
+        std::size_t addedEntities = 0;
+
+        /// @brief Whether the last sweep rebuilt the overlaps from scratch, instead of updating them.
+        ///
+        /// Happens when many entities were added at once, as sorting their markers into place one
+        /// by one would be quadratic. When set, the deltas of the first axis hold every pair which
+        /// overlaps on that axis, and the candidates must be rebuilt from them.
+        bool rebuilt = false;
+
+        /// @brief Pairs of entities whose enlarged AABBs overlap in the @ref BroadPhaseTree, found
+        /// by the tree backend.
         ///
-        /// For each each map, the key is an entity and the value is a list of entities that
-        /// overlap with the key. Symmetrical pairs are not stored.
-        std::unordered_map<Entity, std::vector<Entity>> sweepOverlapMaps[3];
+        /// Their actual AABBs are tested again on every frame, as they may start or stop
+        /// overlapping without leaving their enlarged AABBs.
+        std::unordered_set<Candidate, CandidateHash> treePairs;
 
-        /// @brief Set of active entities during sweep for each axis.
-        std::unordered_set<Entity> activePerAxis[3];
+        /// @brief AABBs of the tracked entities, updated by the AABB systems.
+        Bounds bounds;
 
         /// @brief Sets of collision candidates for each collision type. The index of the array is
         /// the collision type.
         std::unordered_set<Candidate, CandidateHash> candidatesPerType[static_cast<std::size_t>(CollisionType::Count)];
 
-        /// @brief Adds an entity to the list of entities tracked by sweep and prune.
+        /// @brief Adds an entity to the list of entities tracked by the broad phase.
+        ///
+        /// Entities with colliders of several shapes are added once per shape, but only tracked once.
+        ///
         /// @param entity Entity to add.
-        void addEntity(Entity entity);
+        /// @param shape Shape of the entity's collider.
+        void addEntity(Entity entity, Shape shape);
 
-        /// @brief Removes an entity from the list of entities tracked by sweep and prune.
+        /// @brief Removes an entity from the list of entities tracked by the broad phase, along
+        /// with the collision candidates which include it.
         /// @param entity Entity to remove.
         void removeEntity(Entity entity);
 
-        /// @brief Clears the list of entities tracked by sweep and prune.
+        /// @brief Clears the list of entities tracked by the broad phase, and all collision candidates.
         void clearEntities();
 
+        /// @brief Updates the AABB mirrored for an entity. Does nothing if the entity isn't tracked.
+        /// @param entity Entity.
+        /// @param aabb New AABB of the entity.
+        void updateBounds(Entity entity, const ColliderAABB& aabb);
+
         /// @brief Adds a collision candidate to the list of candidates for a specific collision type.
+        ///
+        /// Candidates are kept between frames, and are only added or removed when the overlap of
+        /// the entities' AABBs changes. They are stored with the entity with the lowest index
+        /// first, so that a pair is only stored once regardless of the order in which it was found.
+        ///
         /// @param type Collision type.
         /// @param candidate Collision candidate.
         void addCandidate(CollisionType type, Candidate candidate);
 
+        /// @brief Removes a collision candidate from the list of candidates for a specific collision type.
+        /// @param type Collision type.
+        /// @param candidate Collision candidate.
+        void removeCandidate(CollisionType type, Candidate candidate);
+
         /// @brief Gets the collision candidates for a specific collision type.
         /// @param type Collision type.
         /// @return Collision candidates.
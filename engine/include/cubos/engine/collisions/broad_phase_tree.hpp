@@ -0,0 +1,288 @@
+/// @file
+/// @brief Resource @ref cubos::engine::BroadPhaseTree.
+/// @ingroup collisions-plugin
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <cubos/core/ecs/entity_manager.hpp>
+
+#include <cubos/engine/collisions/aabb.hpp>
+
+namespace cubos::engine
+{
+    /// @brief Resource which stores a dynamic AABB tree - a bounding volume hierarchy - with the
+    /// AABBs of every collider.
+    ///
+    /// @details Each leaf stores an AABB enlarged by @ref Margin, so that colliders which move
+    /// little stay inside their leaf and don't need to be reinserted. Whenever an entity leaves
+    /// its leaf, it is removed and reinserted, and the tree is rebalanced with rotations on the
+    /// way back up, which keeps its height logarithmic on the number of colliders.
+    ///
+    /// The tree is always kept up to date, so that gameplay code can use it to find colliders in
+    /// a region or along a ray, even when the sweep and prune backend is used to find candidates.
+    ///
+    /// @ingroup collisions-plugin
+    class BroadPhaseTree
+    {
+    public:
+        /// @brief Distance by which the AABBs stored in the leaves are enlarged.
+        static constexpr float Margin = 0.1F;
+
+        /// @brief Inserts an entity into the tree, or updates its AABB if it's already there.
+        ///
+        /// The entity is only reinserted if the new AABB isn't contained in its enlarged AABB.
+        ///
+        /// @param entity Entity.
+        /// @param aabb New AABB of the entity.
+        /// @return Whether the entity was inserted or reinserted.
+        bool update(core::ecs::Entity entity, const ColliderAABB& aabb);
+
+        /// @brief Removes an entity from the tree. Does nothing if it isn't there.
+        /// @param entity Entity.
+        void remove(core::ecs::Entity entity);
+
+        /// @brief Removes every entity from the tree.
+        void clear();
+
+        /// @brief Checks whether an entity is in the tree.
+        /// @param entity Entity.
+        /// @return Whether the entity is in the tree.
+        bool contains(core::ecs::Entity entity) const;
+
+        /// @brief Checks whether the enlarged AABBs of two entities in the tree overlap.
+        /// @param entity First entity.
+        /// @param other Second entity.
+        /// @return Whether both entities are in the tree and their enlarged AABBs overlap.
+        bool overlaps(core::ecs::Entity entity, core::ecs::Entity other) const;
+
+        /// @brief Gets the enlarged AABB stored for an entity.
+        /// @param entity Entity, which must be in the tree.
+        /// @return Enlarged AABB.
+        const ColliderAABB& aabb(core::ecs::Entity entity) const;
+
+        /// @brief Gets the entities which were inserted or reinserted since the last call to
+        /// @ref clearMoved.
+        /// @return Moved entities.
+        const std::vector<core::ecs::Entity>& moved() const;
+
+        /// @brief Clears the list of moved entities.
+        void clearMoved();
+
+        /// @brief Gets the number of entities in the tree.
+        /// @return Number of entities.
+        std::size_t size() const;
+
+        /// @brief Gets the number of levels of the tree, which is zero for an empty tree.
+        /// @return Height of the tree.
+        int height() const;
+
+        /// @brief Calls a function for each entity whose enlarged AABB overlaps the given AABB.
+        ///
+        /// As the stored AABBs are enlarged, the callback may be called for entities whose actual
+        /// AABB doesn't overlap the given one.
+        ///
+        /// @tparam F Function type, taking the entity and returning whether to continue searching.
+        /// @param aabb AABB to search.
+        /// @param callback Function to call for each entity found.
+        template <typename F>
+        void query(const ColliderAABB& aabb, F callback) const;
+
+        /// @brief Calls a function for each entity whose enlarged AABB is hit by a ray.
+        ///
+        /// Entities are not visited in order of distance, so the callback may shorten the ray by
+        /// returning a smaller maximum distance, which prunes every subtree beyond it.
+        ///
+        /// @tparam F Function type, taking the entity and the distance at which the ray enters
+        /// its AABB, and returning the new maximum distance, or a negative value to stop.
+        /// @param origin Origin of the ray.
+        /// @param direction Direction of the ray, which doesn't need to be normalized. Distances
+        /// are measured in multiples of its length.
+        /// @param maxDistance Maximum distance along the ray.
+        /// @param callback Function to call for each entity hit.
+        template <typename F>
+        void raycast(glm::vec3 origin, glm::vec3 direction, float maxDistance, F callback) const;
+
+    private:
+        /// @brief Index used to represent the absence of a node.
+        static constexpr int Null = -1;
+
+        /// @brief Node of the tree. Leaves have no children, and store an entity.
+        struct Node
+        {
+            ColliderAABB aabb;        ///< AABB which contains every leaf below this node.
+            core::ecs::Entity entity; ///< Entity of the leaf.
+            int parent = Null;        ///< Parent node, or next free node if the node isn't used.
+            int left = Null;          ///< First child.
+            int right = Null;         ///< Second child.
+            int height = 0;           ///< Height of the subtree, zero for leaves and -1 for free nodes.
+
+            /// @brief Checks whether the node is a leaf.
+            /// @return Whether the node is a leaf.
+            bool isLeaf() const
+            {
+                return left == Null;
+            }
+        };
+
+        /// @brief Gets a node from the free list, growing the pool if it's empty.
+        /// @return Node index.
+        int allocate();
+
+        /// @brief Returns a node to the free list.
+        /// @param node Node index.
+        void release(int node);
+
+        /// @brief Inserts a leaf into the tree, next to the sibling which increases its cost the least.
+        /// @param leaf Leaf index.
+        void insertLeaf(int leaf);
+
+        /// @brief Removes a leaf from the tree, without releasing it.
+        /// @param leaf Leaf index.
+        void removeLeaf(int leaf);
+
+        /// @brief Replaces a child of a node, or the root if the node is @ref Null.
+        /// @param parent Parent node index.
+        /// @param oldChild Child to replace.
+        /// @param newChild Replacement child.
+        void replaceChild(int parent, int oldChild, int newChild);
+
+        /// @brief Recomputes the AABB and height of a node from its children.
+        /// @param node Node index.
+        void fit(int node);
+
+        /// @brief Recomputes the AABBs and heights of a node and its ancestors, rebalancing them.
+        /// @param node Node index.
+        void refit(int node);
+
+        /// @brief Rotates a node if its children's heights differ by more than one.
+        /// @param node Node index.
+        /// @return Index of the node which took its place.
+        int balance(int node);
+
+        /// @brief Gets a node.
+        /// @param index Node index.
+        /// @return Node.
+        Node& node(int index);
+
+        /// @copydoc node(int)
+        const Node& node(int index) const;
+
+        /// @brief Gets the leaf of an entity.
+        /// @param entity Entity.
+        /// @return Leaf index, or @ref Null if the entity isn't in the tree.
+        int leaf(core::ecs::Entity entity) const;
+
+        std::vector<Node> mNodes;              ///< Node pool.
+        int mRoot = Null;                      ///< Root node.
+        int mFree = Null;                      ///< First node of the free list.
+        std::vector<int> mLeaves;              ///< Leaf of each entity, indexed by the entity's index.
+        std::vector<core::ecs::Entity> mMoved; ///< Entities inserted or reinserted since the last clear.
+        std::size_t mSize = 0;                 ///< Number of entities in the tree.
+    };
+
+    // Implementation.
+
+    template <typename F>
+    void BroadPhaseTree::query(const ColliderAABB& aabb, F callback) const
+    {
+        std::vector<int> stack;
+        if (mRoot != Null)
+        {
+            stack.push_back(mRoot);
+        }
+
+        while (!stack.empty())
+        {
+            const auto& current = node(stack.back());
+            stack.pop_back();
+
+            if (!current.aabb.overlaps(aabb))
+            {
+                continue;
+            }
+
+            if (current.isLeaf())
+            {
+                if (!callback(current.entity))
+                {
+                    return;
+                }
+            }
+            else
+            {
+                stack.push_back(current.left);
+                stack.push_back(current.right);
+            }
+        }
+    }
+
+    template <typename F>
+    void BroadPhaseTree::raycast(glm::vec3 origin, glm::vec3 direction, float maxDistance, F callback) const
+    {
+        // Slab test, which returns the distance at which the ray enters the AABB, or a negative
+        // value if it misses it.
+        auto enter = [&](const ColliderAABB& aabb) {
+            float near = 0.0F;
+            float far = maxDistance;
+            for (glm::length_t axis = 0; axis < 3; ++axis)
+            {
+                if (direction[axis] == 0.0F)
+                {
+                    // Parallel to the slab, so the origin must be inside it.
+                    if (origin[axis] < aabb.min[axis] || origin[axis] > aabb.max[axis])
+                    {
+                        return -1.0F;
+                    }
+                    continue;
+                }
+
+                auto t1 = (aabb.min[axis] - origin[axis]) / direction[axis];
+                auto t2 = (aabb.max[axis] - origin[axis]) / direction[axis];
+                near = glm::max(near, glm::min(t1, t2));
+                far = glm::min(far, glm::max(t1, t2));
+                if (near > far)
+                {
+                    return -1.0F;
+                }
+            }
+            return near;
+        };
+
+        std::vector<int> stack;
+        if (mRoot != Null)
+        {
+            stack.push_back(mRoot);
+        }
+
+        while (!stack.empty())
+        {
+            const auto& current = node(stack.back());
+            stack.pop_back();
+
+            auto distance = enter(current.aabb);
+            if (distance < 0.0F)
+            {
+                continue;
+            }
+
+            if (current.isLeaf())
+            {
+                maxDistance = callback(current.entity, distance);
+                if (maxDistance < 0.0F)
+                {
+                    return;
+                }
+            }
+            else
+            {
+                stack.push_back(current.left);
+                stack.push_back(current.right);
+            }
+        }
+    }
+} // namespace cubos::engine
@@ -0,0 +1,23 @@
+/// @file
+/// @brief Event @ref cubos::engine::CollisionEvent.
+/// @ingroup collisions-plugin
+
+#pragma once
+
+#include <cubos/core/ecs/entity_manager.hpp>
+#include <cubos/core/geom/intersections.hpp>
+
+namespace cubos::engine
+{
+    /// @brief Event sent by the narrow phase when two colliders intersect.
+    /// @ingroup collisions-plugin
+    struct CollisionEvent
+    {
+        core::ecs::Entity entity; ///< First entity involved in the collision.
+        core::ecs::Entity other;  ///< Second entity involved in the collision.
+
+        /// @brief Contact manifold of the collision, with the normal pointing from @ref entity to
+        /// @ref other.
+        core::geom::ContactManifold manifold;
+    };
+} // namespace cubos::engine
@@ -0,0 +1,23 @@
+/// @file
+/// @brief Component @ref cubos::engine::ContinuousCollider.
+/// @ingroup collisions-plugin
+
+#pragma once
+
+#include <glm/mat4x4.hpp>
+
+namespace cubos::engine
+{
+    /// @brief Component which enables continuous collision detection for an entity with a
+    /// collider, so that it doesn't tunnel through thin colliders when moving fast.
+    ///
+    /// The AABB of the entity is swept from its transform on the previous frame to its current
+    /// one, and the time of impact with any collider in its path is sent in an @ref ImpactEvent.
+    ///
+    /// @ingroup collisions-plugin
+    struct [[cubos::component("cubos/continuous_collider", VecStorage)]] ContinuousCollider
+    {
+        glm::mat4 previous{1.0f}; ///< Local to world transform on the previous frame, set by the plugin.
+        bool hasPrevious = false; ///< Whether @ref previous has been set yet.
+    };
+} // namespace cubos::engine
@@ -0,0 +1,28 @@
+/// @file
+/// @brief Event @ref cubos::engine::ImpactEvent.
+/// @ingroup collisions-plugin
+
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cubos/core/ecs/entity_manager.hpp>
+
+namespace cubos::engine
+{
+    /// @brief Event sent when an entity with a @ref ContinuousCollider hits another collider
+    /// during the last frame.
+    /// @ingroup collisions-plugin
+    struct ImpactEvent
+    {
+        core::ecs::Entity entity; ///< First entity involved in the impact.
+        core::ecs::Entity other;  ///< Second entity involved in the impact.
+
+        /// @brief Time of impact, as a fraction of the motion from the previous frame to the
+        /// current one, between 0 and 1.
+        float time;
+
+        glm::vec3 normal; ///< Contact normal at the time of impact, pointing from @ref entity to @ref other.
+        glm::vec3 point;  ///< Contact point at the time of impact, in world space.
+    };
+} // namespace cubos::engine
@@ -23,20 +23,33 @@ namespace cubos::engine
     /// - @ref CapsuleCollider - holds the capsule collider data.
     /// - @ref PlaneCollider - holds the plane collider data.
     /// - @ref SimplexCollider - holds the simplex collider data.
+    /// - @ref ContinuousCollider - enables continuous collision detection for a collider.
     ///
     /// ## Events
-    /// - @ref CollisionEvent - (TODO) emitted when a collision occurs.
+    /// - @ref CollisionEvent - emitted by the narrow phase when two colliders intersect.
+    /// - @ref ImpactEvent - emitted when a continuous collider hits another collider during a frame.
     /// - @ref TriggerEvent - (TODO) emitted when a trigger is entered or exited.
     ///
+    /// ## Settings
+    /// - `collisions.broadPhase` - algorithm used to find collision candidates, either `sweep`
+    ///   for sweep and prune, `tree` for a dynamic AABB tree or `grid` for a uniform grid
+    ///   (default: `sweep`).
+    ///
     /// ## Resources
     /// - @ref BroadPhaseCollisions - stores broad phase collision data.
+    /// - @ref BroadPhaseTree - dynamic AABB tree with every collider, which can be used to query
+    ///   colliders in a region or along a ray.
     ///
     /// ## Tags
     /// - `cubos.collisions.aabb.missing` - missing aabb colliders are added.
     /// - `cubos.collisions.aabb` - collider aabbs are updated.
     /// - `cubos.collisions.broad.markers` - sweep markers are updated.
     /// - `cubos.collisions.broad.sweep` - sweep is performed.
+    /// - `cubos.collisions.broad.tree` - broad phase tree is updated.
     /// - `cubos.collisions.broad` - broad phase collision detection.
+    /// - `cubos.collisions.narrow` - narrow phase collision detection, sends @ref CollisionEvent.
+    /// - `cubos.collisions.impact` - times of impact of continuous colliders are found, sends
+    ///   @ref ImpactEvent.
     /// - `cubos.collisions` - collisions are resolved.
     ///
     /// ## Dependencies
@@ -11,6 +11,7 @@
 #include <cubos/core/ecs/event_pipe.hpp>
 #include <cubos/core/ecs/system.hpp>
 #include <cubos/core/ecs/world.hpp>
+#include <cubos/core/thread_pool.hpp>
 
 namespace cubos::engine
 {
@@ -121,6 +122,9 @@ namespace cubos::engine
 
     /// @brief Represents the engine itself, and exposes the interface with which the game
     /// developer interacts with. Ties up all the different parts of the engine together.
+    ///
+    /// Besides the resources defined in this file, a @ref core::ThreadPool resource with one
+    /// thread per hardware thread is also added, which systems can use to split their work.
     /// @ingroup engine
     class Cubos final
     {
@@ -192,6 +196,10 @@ namespace cubos::engine
         ///
         /// Initially, dispatches all of the startup systems.
         /// Then, while @ref ShouldQuit is false, dispatches all other systems.
+        ///
+        /// Between frames, profiling is enabled or disabled according to the setting
+        /// `profiling.enabled`. When it's disabled, or the engine stops, the recorded zones are
+        /// written as a Chrome trace to the file at `profiling.path` (`profile.json` by default).
         void run();
 
     private:
@@ -10,12 +10,11 @@
 #include <cubos/core/gl/vertex.hpp>
 #include <cubos/core/settings.hpp>
 
+#include <cubos/engine/renderer/light_clusters.hpp>
 #include <cubos/engine/renderer/renderer.hpp>
 
 // TODO: make these defines proper constants (we're using C++!)
-#define CUBOS_DEFERRED_RENDERER_MAX_SPOT_LIGHT_COUNT 128
 #define CUBOS_DEFERRED_RENDERER_MAX_DIRECTIONAL_LIGHT_COUNT 128
-#define CUBOS_DEFERRED_RENDERER_MAX_POINT_LIGHT_COUNT 128
 
 namespace cubos::engine
 {
@@ -26,6 +25,12 @@ namespace cubos::engine
     /// 1. Render the scene to the GBuffer textures: position, normal and material.
     /// 2. Take the GBuffer textures and calculate the color of the pixels with the lighting applied.
     ///
+    /// Draw commands which share a grid are drawn together with instanced draw calls.
+    ///
+    /// Point and spot lights are assigned to the clusters of the view frustum of each camera,
+    /// through @ref LightClusters, so that the lighting pass only evaluates, for each pixel, the
+    /// lights which may reach it. There's no limit on the number of those lights.
+    ///
     /// @ingroup renderer-plugin
     class DeferredRenderer : public BaseRenderer
     {
@@ -68,6 +73,9 @@ namespace cubos::engine
         core::gl::ShaderPipeline mGeometryPipeline;
         core::gl::ShaderBindingPoint mVpBp;
         core::gl::ConstantBuffer mVpBuffer;
+        core::gl::ShaderBindingPoint mInstancesBp;
+        core::gl::ConstantBuffer mInstancesBuffer;
+        std::vector<std::size_t> mDrawOrder;
         core::gl::RasterState mGeometryRasterState;
         core::gl::BlendState mGeometryBlendState;
         core::gl::DepthStencilState mGeometryDepthStencilState;
@@ -88,10 +96,28 @@ namespace cubos::engine
         core::gl::ShaderBindingPoint mSkyGradientTopBp;
         core::gl::ShaderBindingPoint mInvVBp;
         core::gl::ShaderBindingPoint mInvPBp;
+        core::gl::ShaderBindingPoint mVBp;
+        core::gl::ShaderBindingPoint mLightDataBp;
+        core::gl::ShaderBindingPoint mLightClustersBp;
+        core::gl::ShaderBindingPoint mLightIndicesBp;
+        core::gl::ShaderBindingPoint mClusterSizeBp;
+        core::gl::ShaderBindingPoint mClusterDepthBp;
         core::gl::Sampler mSampler;
         core::gl::Texture2D mPaletteTex;
         core::gl::ConstantBuffer mLightsBuffer;
 
+        // Clustered point and spot lights.
+
+        LightClusters mLightClusters;
+        std::vector<LightClusters::Bounds> mLightBounds;
+        std::vector<glm::vec4> mLightTexels;
+        std::vector<std::uint32_t> mLightIndices;
+        core::gl::Texture2D mLightDataTex;
+        core::gl::Texture2D mLightClustersTex;
+        core::gl::Texture2D mLightIndicesTex;
+        std::size_t mLightDataRows = 0;
+        std::size_t mLightIndicesRows = 0;
+
         // Screen quad used for the lighting pass.
 
         core::gl::VertexArray mScreenQuadVa;
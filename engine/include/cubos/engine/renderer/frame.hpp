@@ -4,8 +4,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
+#include <cubos/core/thread_pool.hpp>
+
+#include <cubos/engine/renderer/light_clusters.hpp>
 #include <cubos/engine/renderer/renderer.hpp>
 
 namespace cubos::engine
@@ -27,6 +31,8 @@ namespace cubos::engine
         {
             RendererGrid grid;  ///< Grid to be drawn.
             glm::mat4 modelMat; ///< Model transform matrix.
+            glm::vec3 center;   ///< Center of the world space bounding box of the grid.
+            glm::vec3 extent;   ///< Half size of the world space bounding box of the grid.
         };
 
         /// @brief Submits a draw command.
@@ -55,6 +61,17 @@ namespace cubos::engine
         /// @param light Point light to add.
         void light(const core::gl::PointLight& light);
 
+        /// @brief Culls the draw commands whose bounds are outside the view frustum of a camera,
+        /// and assigns the point and spot lights to the camera's @ref LightClusters.
+        ///
+        /// Until the next call, or until the frame is cleared, only the draw commands which may
+        /// be visible from the camera are reported by @ref isVisible(). The work is split between
+        /// the threads of the given pool.
+        ///
+        /// @param camera Camera, whose viewport size must already be set.
+        /// @param pool Thread pool to run the tests on.
+        void cull(const core::gl::Camera& camera, core::ThreadPool& pool);
+
         /// @brief Clears the frame, removing all draw calls and lights.
         void clear();
 
@@ -62,6 +79,28 @@ namespace cubos::engine
         /// @return Draw commands.
         const std::vector<DrawCmd>& drawCmds() const;
 
+        /// @brief Checks whether a draw command survived the last call to @ref cull().
+        /// @param drawCmd Index of the draw command.
+        /// @return Whether the draw command may be visible, always true if the frame wasn't culled.
+        bool isVisible(std::size_t drawCmd) const;
+
+        /// @brief Checks whether the frame was culled since it was last cleared.
+        /// @return Whether the frame was culled.
+        bool isCulled() const;
+
+        /// @brief Gets the light clusters assigned by the last call to @ref cull().
+        ///
+        /// Lights are identified by their index in @ref pointLights(), and spot lights follow the
+        /// point lights, offset by their count. Use @ref lightBounds() to get the lights assigned.
+        ///
+        /// @return Light clusters.
+        const LightClusters& lightClusters() const;
+
+        /// @brief Gets the bounding spheres of the point and spot lights, in the order used by
+        /// @ref lightClusters().
+        /// @param[out] bounds Bounding spheres.
+        void lightBounds(std::vector<LightClusters::Bounds>& bounds) const;
+
         /// @brief Gets the ambient light of the scene.
         /// @return Dmbient light.
         const glm::vec3& ambient() const;
@@ -87,6 +126,10 @@ namespace cubos::engine
         glm::vec3 mAmbientColor;
         glm::vec3 mSkyGradient[2];
         std::vector<DrawCmd> mDrawCmds;
+        std::vector<std::uint8_t> mVisible;
+        bool mCulled{false};
+        LightClusters mLightClusters;
+        std::vector<LightClusters::Bounds> mLightBounds;
         std::vector<core::gl::SpotLight> mSpotLights;
         std::vector<core::gl::DirectionalLight> mDirectionalLights;
         std::vector<core::gl::PointLight> mPointLights;
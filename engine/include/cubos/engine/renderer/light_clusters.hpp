@@ -0,0 +1,120 @@
+/// @file
+/// @brief Class @ref cubos::engine::LightClusters.
+/// @ingroup renderer-plugin
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <cubos/core/gl/camera.hpp>
+#include <cubos/core/thread_pool.hpp>
+
+namespace cubos::engine
+{
+    /// @brief Assigns lights to the clusters of a camera's view frustum, so that shading a pixel
+    /// only needs to consider the lights which may reach its cluster.
+    ///
+    /// The frustum is split into a grid of tiles on screen, and each tile is split into slices
+    /// along the view direction, whose depths grow exponentially from the near plane to the far
+    /// plane. Lights are given by their bounding spheres, and are assigned to every cluster whose
+    /// view space bounding box their sphere intersects.
+    ///
+    /// Clusters are indexed by `x + width * (y + height * z)`, where `x` and `y` are the tile
+    /// coordinates, starting on the bottom left of the viewport, and `z` is the slice.
+    ///
+    /// @ingroup renderer-plugin
+    class LightClusters final
+    {
+    public:
+        /// @brief Bounding sphere of a light, in world space.
+        struct Bounds
+        {
+            glm::vec3 center; ///< Center of the sphere.
+            float radius;     ///< Radius of the sphere.
+        };
+
+        /// @brief Range of @ref indices() holding the lights of a cluster.
+        struct Range
+        {
+            std::uint32_t offset; ///< Index of the first light of the cluster.
+            std::uint32_t count;  ///< Number of lights in the cluster.
+        };
+
+        /// @brief Constructs.
+        /// @param size Number of tiles along each axis of the screen, and number of depth slices.
+        LightClusters(glm::uvec3 size = {16, 9, 24});
+
+        /// @brief Gets the number of clusters along each axis.
+        /// @return Number of tiles along each axis of the screen, and number of depth slices.
+        glm::uvec3 size() const;
+
+        /// @brief Assigns lights to the clusters of a camera.
+        /// @param camera Camera, whose viewport size must already be set.
+        /// @param lights Bounding spheres of the lights, whose indices are stored in the clusters.
+        void assign(const core::gl::Camera& camera, const std::vector<Bounds>& lights);
+
+        /// @brief Assigns lights to the clusters of a camera, splitting the slices between the
+        /// threads of a pool.
+        /// @param camera Camera, whose viewport size must already be set.
+        /// @param lights Bounding spheres of the lights, whose indices are stored in the clusters.
+        /// @param pool Thread pool to run on.
+        void assign(const core::gl::Camera& camera, const std::vector<Bounds>& lights, core::ThreadPool& pool);
+
+        /// @brief Gets the index of a cluster.
+        /// @param cluster Tile coordinates and slice of the cluster.
+        /// @return Cluster index.
+        std::size_t index(glm::uvec3 cluster) const;
+
+        /// @brief Gets the cluster which contains a point in view space.
+        /// @param point Point in view space, which must be in front of the camera.
+        /// @return Tile coordinates and slice of the cluster, clamped to the grid.
+        glm::uvec3 clusterOf(glm::vec3 point) const;
+
+        /// @brief Gets the view space bounding box of a cluster.
+        /// @param cluster Tile coordinates and slice of the cluster.
+        /// @param[out] min Minimum corner of the box.
+        /// @param[out] max Maximum corner of the box.
+        void bounds(glm::uvec3 cluster, glm::vec3& min, glm::vec3& max) const;
+
+        /// @brief Gets the range of light indices of each cluster.
+        /// @return Ranges, by cluster index.
+        const std::vector<Range>& ranges() const;
+
+        /// @brief Gets the light indices of every cluster, grouped by cluster.
+        /// @return Light indices.
+        const std::vector<std::uint32_t>& indices() const;
+
+    private:
+        /// @brief Prepares the slices of a camera, and finds the clusters each light may reach.
+        void prepare(const core::gl::Camera& camera, const std::vector<Bounds>& lights);
+
+        /// @brief Assigns the lights of a range of slices.
+        void assignSlices(std::uint32_t begin, std::uint32_t end);
+
+        /// @brief Merges the indices of every slice.
+        void merge();
+
+        /// @brief Light which may reach some of the clusters.
+        struct Candidate
+        {
+            std::uint32_t light; ///< Index of the light.
+            glm::vec3 center;    ///< Center of the bounding sphere, in view space.
+            float radius;        ///< Radius of the bounding sphere.
+            glm::uvec3 min;      ///< First cluster reached by the bounding box of the sphere.
+            glm::uvec3 max;      ///< Last cluster reached by the bounding box of the sphere.
+        };
+
+        glm::uvec3 mSize;
+        float mZNear{0.1F};
+        float mZFar{1000.0F};
+        glm::vec2 mTanHalfFov{1.0F}; ///< Tangents of the horizontal and vertical half fields of view.
+        std::vector<Candidate> mCandidates;
+        std::vector<std::vector<std::uint32_t>> mSliceIndices;
+        std::vector<Range> mRanges;
+        std::vector<std::uint32_t> mIndices;
+    };
+} // namespace cubos::engine
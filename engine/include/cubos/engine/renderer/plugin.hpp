@@ -30,6 +30,10 @@ namespace cubos::engine
     /// @note Entities with the above entities will be ignored if they do not possess
     /// @ref LocalToWorld components.
     ///
+    /// Before rendering each camera, grids whose bounding boxes are outside the camera's view
+    /// frustum are culled, so that only the grids which may be visible are drawn. Point and spot
+    /// lights are also assigned to the clusters of the frustum, through @ref LightClusters.
+    ///
     /// The rendering environment, such as the ambient lighting and sky color, can be set through
     /// the resource @ref RendererEnvironment.
     ///
@@ -135,6 +135,9 @@ namespace cubos::engine
         public:
             virtual ~RendererGrid() = default;
 
+            glm::vec3 min{0.0F}; ///< Minimum corner of the bounding box of the grid's mesh, in grid space.
+            glm::vec3 max{0.0F}; ///< Maximum corner of the bounding box of the grid's mesh, in grid space.
+
         protected:
             RendererGrid() = default;
         };
@@ -0,0 +1,22 @@
+/// @file
+/// @brief Component @ref cubos::engine::Children.
+/// @ingroup transform-plugin
+
+#pragma once
+
+#include <vector>
+
+#include <cubos/core/ecs/entity_manager.hpp>
+
+namespace cubos::engine
+{
+    /// @brief Component which lists the entities attached to an entity through their @ref Parent
+    /// component.
+    /// @note This component is added and kept up to date by the @ref transform-plugin
+    /// "transform plugin", and shouldn't be modified manually.
+    /// @ingroup transform-plugin
+    struct [[cubos::component("cubos/children", VecStorage)]] Children
+    {
+        std::vector<core::ecs::Entity> entities; ///< Entities whose parent is this entity.
+    };
+} // namespace cubos::engine
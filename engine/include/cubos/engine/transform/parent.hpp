@@ -0,0 +1,21 @@
+/// @file
+/// @brief Component @ref cubos::engine::Parent.
+/// @ingroup transform-plugin
+
+#pragma once
+
+#include <cubos/core/ecs/entity_manager.hpp>
+
+namespace cubos::engine
+{
+    /// @brief Component which attaches an entity to a parent entity, making its @ref Position,
+    /// @ref Rotation and @ref Scale relative to the parent's transform.
+    /// @note The parent must also have a @ref LocalToWorld component, otherwise the entity is
+    /// treated as if it had no parent.
+    /// @sa Children Holds the entities attached to an entity.
+    /// @ingroup transform-plugin
+    struct [[cubos::component("cubos/parent", VecStorage)]] Parent
+    {
+        core::ecs::Entity entity; ///< Parent entity.
+    };
+} // namespace cubos::engine
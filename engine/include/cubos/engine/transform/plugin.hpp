@@ -8,7 +8,9 @@
 #pragma once
 
 #include <cubos/engine/cubos.hpp>
+#include <cubos/engine/transform/children.hpp>
 #include <cubos/engine/transform/local_to_world.hpp>
+#include <cubos/engine/transform/parent.hpp>
 #include <cubos/engine/transform/position.hpp>
 #include <cubos/engine/transform/rotation.hpp>
 #include <cubos/engine/transform/scale.hpp>
@@ -24,15 +26,24 @@ namespace cubos::engine
     /// entity which doesn't need rotation, but has a position and a scale, you do not need to add
     /// the @ref Rotation component, and its transform will still be updated.
     ///
+    /// Entities can be attached to others with the @ref Parent component, which makes their
+    /// transform relative to the parent's. World matrices are propagated from the roots of the
+    /// hierarchy down to the leaves, and only recomputed for entities whose @ref Position,
+    /// @ref Rotation, @ref Scale or @ref Parent changed since the last frame, or whose ancestors
+    /// did. Independent subtrees are processed in parallel.
+    ///
     /// ## Components
     /// - @ref LocalToWorld - holds the local to world transform matrix.
     /// - @ref Position - holds the position of an entity.
     /// - @ref Rotation - holds the rotation of an entity.
     /// - @ref Scale - holds the scaling of an entity.
+    /// - @ref Parent - attaches an entity to a parent entity.
+    /// - @ref Children - lists the entities attached to an entity, added automatically.
     ///
     /// ## Tags
     /// - `cubos.transform.update` - the @ref LocalToWorld components are updated with the
-    ///    information from the @ref Position, @ref Rotation and @ref Scale components.
+    ///    information from the @ref Position, @ref Rotation and @ref Scale components, and the
+    ///    @ref Children components are updated with the information from the @ref Parent components.
 
     /// @brief Plugin entry function.
     /// @param cubos @b CUBOS. main class
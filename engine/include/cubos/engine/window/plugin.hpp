@@ -24,6 +24,8 @@ namespace cubos::engine
     /// - `window.title` - the window's title (default: `CUBOS.`).
     /// - `window.width` - the window's width (default: `800`).
     /// - `window.height` - the window's height (default: `600`).
+    /// - `window.headless` - whether to open a window which renders nothing, see
+    ///   @ref core::io::openHeadlessWindow() (default: `false`). It is never closed.
     ///
     /// ## Events
     /// - @ref core::io::WindowEvent - event polled from the window.
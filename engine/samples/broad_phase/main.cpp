@@ -0,0 +1,131 @@
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <utility>
+
+#include <cubos/core/log.hpp>
+#include <cubos/core/settings.hpp>
+
+#include <cubos/engine/collisions/broad_phase_collisions.hpp>
+#include <cubos/engine/collisions/colliders/box.hpp>
+#include <cubos/engine/collisions/plugin.hpp>
+#include <cubos/engine/transform/plugin.hpp>
+
+using cubos::core::Settings;
+using cubos::core::ecs::Commands;
+using cubos::core::ecs::Query;
+using cubos::core::ecs::Read;
+using cubos::core::ecs::Write;
+
+using namespace cubos::engine;
+
+using Clock = std::chrono::steady_clock;
+
+/// Number of boxes spawned, which are spread over a cube with this many boxes per side.
+static const int BoxesPerSide = 16;
+
+/// Distance between the centers of neighbouring boxes at rest, which makes unit boxes touch.
+static const float Spacing = 1.0F;
+
+/// Number of frames measured for each backend.
+static const std::size_t Frames = 300;
+
+struct Benchmark
+{
+    Benchmark(std::string backend)
+        : backend(std::move(backend))
+    {
+    }
+
+    std::string backend;
+    std::size_t frame = 0;
+    std::size_t candidates = 0;
+    Clock::time_point start;
+    Clock::duration total{};
+};
+
+static void settings(Read<Benchmark> benchmark, Write<Settings> settings)
+{
+    settings->setString("collisions.broadPhase", benchmark->backend);
+}
+
+static void spawn(Commands commands)
+{
+    for (int x = 0; x < BoxesPerSide; ++x)
+    {
+        for (int y = 0; y < BoxesPerSide; ++y)
+        {
+            for (int z = 0; z < BoxesPerSide; ++z)
+            {
+                auto position = glm::vec3{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)};
+                commands.create(BoxCollider{}, LocalToWorld{}, Position{position * Spacing});
+            }
+        }
+    }
+}
+
+/// Moves every box around its rest position, so that pairs start and stop overlapping every frame.
+static void move(Read<Benchmark> benchmark, Query<Write<Position>> query)
+{
+    auto time = static_cast<float>(benchmark->frame) * 0.05F;
+    for (auto [entity, position] : query)
+    {
+        auto phase = static_cast<float>(entity.index);
+        auto offset = glm::vec3{std::sin(time + phase), std::cos(time * 1.3F + phase), std::sin(time * 0.7F - phase)};
+        position->vec += offset * 0.02F;
+    }
+}
+
+static void startTimer(Write<Benchmark> benchmark)
+{
+    benchmark->start = Clock::now();
+}
+
+static void stopTimer(Write<Benchmark> benchmark, Read<BroadPhaseCollisions> collisions, Write<ShouldQuit> quit)
+{
+    // The first frame inserts every box, so it isn't representative of the steady state.
+    if (benchmark->frame > 0)
+    {
+        benchmark->total += Clock::now() - benchmark->start;
+    }
+
+    benchmark->candidates = collisions->candidates(BroadPhaseCollisions::CollisionType::BoxBox).size();
+    benchmark->frame += 1;
+    quit->value = benchmark->frame == Frames;
+
+    if (quit->value)
+    {
+        auto average = std::chrono::duration<double, std::milli>(benchmark->total) / static_cast<double>(Frames - 1);
+        CUBOS_INFO("{}: {:.3f} ms per frame, {} candidates", benchmark->backend, average.count(),
+                   benchmark->candidates);
+    }
+}
+
+int main()
+{
+    for (const char* backend : {"sweep", "tree", "grid"})
+    {
+        auto cubos = Cubos();
+
+        cubos.addPlugin(collisionsPlugin);
+        cubos.addResource<Benchmark>(std::string{backend});
+
+        cubos.startupSystem(settings).tagged("cubos.settings");
+        cubos.startupSystem(spawn);
+
+        cubos.system(move).before("cubos.transform.update");
+
+        // The broad phase tree is updated with every backend, as it's also used for queries, so
+        // its upkeep is included in every measurement.
+        cubos.system(startTimer)
+            .after("cubos.collisions.aabb")
+            .before("cubos.collisions.broad.markers")
+            .before("cubos.collisions.broad.tree")
+            .before("cubos.collisions.broad");
+        cubos.system(stopTimer).after("cubos.collisions.broad").before("cubos.collisions.narrow");
+
+        cubos.run();
+    }
+
+    return 0;
+}
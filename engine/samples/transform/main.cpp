@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cubos/core/log.hpp>
+
+#include <cubos/engine/transform/plugin.hpp>
+
+using cubos::core::ecs::Commands;
+using cubos::core::ecs::Query;
+using cubos::core::ecs::Read;
+using cubos::core::ecs::Write;
+
+using namespace cubos::engine;
+
+using Clock = std::chrono::steady_clock;
+
+/// Number of entities spawned.
+static const int Entities = 100000;
+
+/// Number of frames measured.
+static const std::size_t Frames = 300;
+
+struct Benchmark
+{
+    std::size_t frame = 0;
+    Clock::time_point start;
+    Clock::duration total{};
+    Clock::duration reference{};
+    std::vector<glm::mat4> matrices;
+    float maxError = 0.0F;
+};
+
+static void spawn(Commands commands)
+{
+    for (int i = 0; i < Entities; ++i)
+    {
+        auto angle = static_cast<float>(i) * 0.01F;
+        commands.create(LocalToWorld{}, Position{{static_cast<float>(i), 0.0F, 0.0F}},
+                        Rotation{glm::angleAxis(angle, glm::vec3{0.0F, 1.0F, 0.0F})}, Scale{1.0F});
+    }
+}
+
+/// Moves every entity, so that every transform must be recomputed on every frame.
+static void move(Read<Benchmark> benchmark, Query<Write<Position>> query)
+{
+    auto offset = std::sin(static_cast<float>(benchmark->frame) * 0.05F);
+    for (auto [entity, position] : query)
+    {
+        position->vec.y = offset;
+    }
+}
+
+static void startTimer(Write<Benchmark> benchmark)
+{
+    benchmark->start = Clock::now();
+}
+
+static void stopTimer(Write<Benchmark> benchmark)
+{
+    // The first frame also allocates the hierarchy, so it isn't representative of the steady state.
+    if (benchmark->frame > 0)
+    {
+        benchmark->total += Clock::now() - benchmark->start;
+    }
+}
+
+/// Composes the same transforms with one matrix product per component, for comparison, and checks
+/// that the plugin computed the same matrices.
+static void reference(Write<Benchmark> benchmark,
+                      Query<Read<Position>, Read<Rotation>, Read<Scale>, Read<LocalToWorld>> query,
+                      Write<ShouldQuit> quit)
+{
+    auto start = Clock::now();
+    benchmark->matrices.clear();
+    for (auto [entity, position, rotation, scale, localToWorld] : query)
+    {
+        auto mat = glm::translate(glm::mat4(1.0F), position->vec);
+        mat *= glm::toMat4(rotation->quat);
+        benchmark->matrices.push_back(glm::scale(mat, glm::vec3(scale->factor)));
+    }
+
+    if (benchmark->frame > 0)
+    {
+        benchmark->reference += Clock::now() - start;
+    }
+
+    // Not timed. The query visits the entities in the same order as above.
+    std::size_t i = 0;
+    for (auto [entity, position, rotation, scale, localToWorld] : query)
+    {
+        const auto& expected = benchmark->matrices[i++];
+        for (glm::length_t column = 0; column < 4; ++column)
+        {
+            for (glm::length_t row = 0; row < 4; ++row)
+            {
+                auto error = std::abs(localToWorld->mat[column][row] - expected[column][row]);
+                benchmark->maxError = std::max(benchmark->maxError, error);
+            }
+        }
+    }
+
+    benchmark->frame += 1;
+    quit->value = benchmark->frame == Frames;
+
+    if (quit->value)
+    {
+        auto rate = [](Clock::duration duration) {
+            auto seconds = std::chrono::duration<double>(duration).count();
+            return static_cast<double>(Entities) * static_cast<double>(Frames - 1) / seconds / 1e6;
+        };
+        CUBOS_INFO("transform plugin: {:.2f} M entities/s", rate(benchmark->total));
+        CUBOS_INFO("matrix products: {:.2f} M entities/s", rate(benchmark->reference));
+
+        // Positions go up to the number of entities, so the error is relative to that.
+        if (benchmark->maxError > static_cast<float>(Entities) * 1e-6F)
+        {
+            CUBOS_ERROR("transform plugin differs from the matrix products by up to {}", benchmark->maxError);
+        }
+        else
+        {
+            CUBOS_INFO("transform plugin matches the matrix products, maximum error {}", benchmark->maxError);
+        }
+    }
+}
+
+int main()
+{
+    auto cubos = Cubos();
+
+    cubos.addPlugin(transformPlugin);
+    cubos.addResource<Benchmark>();
+
+    cubos.startupSystem(spawn);
+
+    cubos.system(move).tagged("move");
+    cubos.system(startTimer).after("move").before("cubos.transform.update");
+    cubos.system(stopTimer).tagged("stop").after("cubos.transform.update");
+    cubos.system(reference).after("stop");
+
+    cubos.run();
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include <cubos/core/data/json_deserializer.hpp>
 #include <cubos/core/data/json_serializer.hpp>
 #include <cubos/core/log.hpp>
+#include <cubos/core/profiling/profiler.hpp>
 
 #include <cubos/engine/assets/assets.hpp>
 
@@ -101,21 +102,17 @@ void Assets::loadMeta(std::string_view path)
     {
         CUBOS_DEBUG("Loading asset metadata from '{}'", path);
 
-        // Read the file contents into a string.
-        std::string contents;
-        {
-            auto stream = file->open(core::data::File::OpenMode::Read);
-            stream->readUntil(contents, nullptr);
-        }
-
-        // Deserialize the asset metadata from the JSON string.
+        // Deserialize the asset metadata directly from the file.
         auto meta = AssetMeta();
-        auto des = core::data::JSONDeserializer(contents);
-        des.read(meta);
-        if (des.failed())
         {
-            CUBOS_ERROR("Couldn't load asset metadata: JSON deserialization failed for file '{}'", path);
-            return;
+            auto stream = file->open(core::data::File::OpenMode::Read);
+            auto des = core::data::JSONDeserializer(*stream);
+            des.read(meta);
+            if (des.failed())
+            {
+                CUBOS_ERROR("Couldn't load asset metadata: JSON deserialization failed for file '{}'", path);
+                return;
+            }
         }
 
         // Check if the metadata has a path field, which is always ignored.
@@ -406,10 +403,13 @@ void* Assets::access(const AnyAsset& handle, std::type_index type, Lock& lock, b
         // the interface more readable. We need to unlock temporarily to avoid a deadlock, since the
         // bridge will call back into the asset manager.
         lock.unlock();
-        if (!bridge->load(const_cast<Assets&>(*this), handle))
         {
-            CUBOS_CRITICAL("Could not load asset {}", core::data::Debug(handle));
-            abort();
+            CUBOS_PROFILE_ZONE("Load asset");
+            if (!bridge->load(const_cast<Assets&>(*this), handle))
+            {
+                CUBOS_CRITICAL("Could not load asset {}", core::data::Debug(handle));
+                abort();
+            }
         }
         lock.lock();
     }
@@ -580,6 +580,7 @@ void Assets::loader()
         mLoaderQueue.pop_front();
         loaderLock.unlock(); // Unlock the mutex before loading the asset.
 
+        CUBOS_PROFILE_ZONE("Load asset");
         if (!task.bridge->load(*this, task.handle))
         {
             CUBOS_ERROR("Failed to load asset '{}'", core::data::Debug(task.handle));
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+
+#include "aabb_batch.hpp"
+
+using cubos::core::ThreadPool;
+using cubos::engine::BroadPhaseCollisions;
+using cubos::engine::ColliderAABB;
+
+/// Maximum number of colliders processed by a single task.
+static const std::size_t BatchSize = 512;
+
+/// Kernel which computes the bounds of the colliders in a range of lane groups.
+using Kernel = void (*)(AABBBatch& batch, std::size_t begin, std::size_t end);
+
+/// Stores the bounds computed for a lane group. Kernels compute into local arrays, which the
+/// compiler knows can't alias the inputs, so that the lane loops are vectorized.
+static void store(AABBBatch& batch, std::size_t axis, std::size_t group, const float* min, const float* max)
+{
+    std::copy(min, min + AABBBatch::Lanes, batch.min[axis].begin() + static_cast<std::ptrdiff_t>(group));
+    std::copy(max, max + AABBBatch::Lanes, batch.max[axis].begin() + static_cast<std::ptrdiff_t>(group));
+}
+
+/// Computes the bounds of a range of boxes. Each axis of a box contributes the absolute value of
+/// its transformed half size to the extents of the AABB.
+static void boxKernel(AABBBatch& batch, std::size_t begin, std::size_t end)
+{
+    const auto& t = batch.transform;
+    const auto& h = batch.points[0];
+    for (std::size_t group = begin; group < end; group += AABBBatch::Lanes)
+    {
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            float min[AABBBatch::Lanes];
+            float max[AABBBatch::Lanes];
+            for (std::size_t lane = 0; lane < AABBBatch::Lanes; ++lane)
+            {
+                auto i = group + lane;
+                auto extent = std::abs(t[axis][i]) * h[0][i] + std::abs(t[3 + axis][i]) * h[1][i] +
+                              std::abs(t[6 + axis][i]) * h[2][i] + batch.radius[i];
+                min[lane] = t[9 + axis][i] - extent;
+                max[lane] = t[9 + axis][i] + extent;
+            }
+            store(batch, axis, group, min, max);
+        }
+    }
+}
+
+/// Computes the bounds of a range of point hulls, by transforming each of their points.
+static void hullKernel(AABBBatch& batch, std::size_t begin, std::size_t end)
+{
+    const auto& t = batch.transform;
+    const auto& p = batch.points;
+    for (std::size_t group = begin; group < end; group += AABBBatch::Lanes)
+    {
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            float min[AABBBatch::Lanes];
+            float max[AABBBatch::Lanes];
+            for (std::size_t lane = 0; lane < AABBBatch::Lanes; ++lane)
+            {
+                min[lane] = INFINITY;
+                max[lane] = -INFINITY;
+            }
+
+            for (const auto& point : p)
+            {
+                for (std::size_t lane = 0; lane < AABBBatch::Lanes; ++lane)
+                {
+                    auto i = group + lane;
+                    auto world = t[axis][i] * point[0][i] + t[3 + axis][i] * point[1][i] +
+                                 t[6 + axis][i] * point[2][i] + t[9 + axis][i];
+                    min[lane] = std::min(min[lane], world);
+                    max[lane] = std::max(max[lane], world);
+                }
+            }
+
+            for (std::size_t lane = 0; lane < AABBBatch::Lanes; ++lane)
+            {
+                min[lane] -= batch.radius[group + lane];
+                max[lane] += batch.radius[group + lane];
+            }
+            store(batch, axis, group, min, max);
+        }
+    }
+}
+
+/// Runs a kernel over a range of lane groups, and writes the results back.
+static void run(Kernel kernel, AABBBatch& batch, BroadPhaseCollisions& collisions, std::size_t begin, std::size_t end)
+{
+    kernel(batch, begin, end);
+
+    // Every collider owns its own component and slot, so ranges can be written back concurrently.
+    end = std::min(end, batch.size());
+    for (auto i = begin; i < end; ++i)
+    {
+        auto& aabb = *batch.aabbs[i];
+        glm::vec3 min{batch.min[0][i], batch.min[1][i], batch.min[2][i]};
+        glm::vec3 max{batch.max[0][i], batch.max[1][i], batch.max[2][i]};
+        aabb.min = batch.merge ? glm::min(aabb.min, min) : min;
+        aabb.max = batch.merge ? glm::max(aabb.max, max) : max;
+        collisions.updateBounds(batch.entities[i], aabb);
+    }
+}
+
+/// Pads the batch to a whole number of lane groups, and runs a kernel over it on the thread pool.
+static void run(Kernel kernel, AABBBatch& batch, BroadPhaseCollisions& collisions, ThreadPool& pool)
+{
+    auto size = batch.size();
+    if (size == 0)
+    {
+        return;
+    }
+
+    // Padding lanes repeat the last collider, so that the kernels never have to handle a partial group.
+    auto padded = (size + AABBBatch::Lanes - 1) / AABBBatch::Lanes * AABBBatch::Lanes;
+    auto pad = [&](std::vector<float>& values) { values.resize(padded, values.back()); };
+    for (auto& values : batch.transform)
+    {
+        pad(values);
+    }
+    for (auto& point : batch.points)
+    {
+        for (auto& values : point)
+        {
+            pad(values);
+        }
+    }
+    pad(batch.radius);
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        batch.min[axis].resize(padded);
+        batch.max[axis].resize(padded);
+    }
+
+    if (padded <= BatchSize)
+    {
+        // Not worth waking up the pool.
+        run(kernel, batch, collisions, 0, padded);
+        return;
+    }
+
+    for (std::size_t begin = 0; begin < padded; begin += BatchSize)
+    {
+        auto end = std::min(begin + BatchSize, padded);
+        pool.addTask([kernel, &batch, &collisions, begin, end]() { run(kernel, batch, collisions, begin, end); });
+    }
+    pool.wait();
+}
+
+void AABBBatch::add(Entity entity, ColliderAABB* aabb, const glm::mat4& transform, const glm::vec3* points,
+                    std::size_t count, float radius)
+{
+    entities.push_back(entity);
+    aabbs.push_back(aabb);
+
+    for (glm::length_t column = 0; column < 4; ++column)
+    {
+        for (glm::length_t row = 0; row < 3; ++row)
+        {
+            this->transform[column * 3 + row].push_back(transform[column][row]);
+        }
+    }
+
+    // Colliders without points, such as empty simplices, are collapsed into their origin.
+    for (std::size_t point = 0; point < MaxPoints; ++point)
+    {
+        auto value = count == 0 ? glm::vec3{0.0F} : points[std::min(point, count - 1)];
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            this->points[point][axis].push_back(value[axis]);
+        }
+    }
+
+    this->radius.push_back(radius);
+}
+
+std::size_t AABBBatch::size() const
+{
+    return entities.size();
+}
+
+void computeBoxAABBs(AABBBatch& batch, BroadPhaseCollisions& collisions, ThreadPool& pool)
+{
+    run(boxKernel, batch, collisions, pool);
+}
+
+void computeHullAABBs(AABBBatch& batch, BroadPhaseCollisions& collisions, ThreadPool& pool)
+{
+    run(hullKernel, batch, collisions, pool);
+}
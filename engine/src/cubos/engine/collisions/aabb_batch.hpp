@@ -0,0 +1,73 @@
+/// @file
+/// @brief Batched computation of the AABBs of colliders.
+///
+/// @details Colliders are gathered into a structure of arrays, padded to a whole number of lane
+/// groups, so that the kernels run the same arithmetic over groups of contiguous lanes, which
+/// the compiler turns into SIMD instructions. Groups are split over the thread pool.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <cubos/core/thread_pool.hpp>
+
+#include <cubos/engine/collisions/aabb.hpp>
+#include <cubos/engine/collisions/broad_phase_collisions.hpp>
+
+/// @brief Colliders gathered for a batched AABB update.
+struct AABBBatch
+{
+    /// @brief Number of colliders processed together by the kernels.
+    static constexpr std::size_t Lanes = 8;
+
+    /// @brief Maximum number of points of a collider.
+    static constexpr std::size_t MaxPoints = 4;
+
+    std::vector<Entity> entities;                    ///< Entity of each collider.
+    std::vector<cubos::engine::ColliderAABB*> aabbs; ///< AABB component of each collider.
+    std::vector<float> transform[12];                ///< Collider to world transform, column by column.
+    std::vector<float> points[MaxPoints][3];         ///< Points of each collider, in collider space.
+    std::vector<float> radius;                       ///< Radius by which each collider is inflated.
+    std::vector<float> min[3];                       ///< Computed minimum bound of each collider.
+    std::vector<float> max[3];                       ///< Computed maximum bound of each collider.
+
+    /// @brief Whether the computed bounds are merged into the current AABBs of the colliders,
+    /// instead of replacing them. Used to sweep AABBs over the previous transforms.
+    bool merge = false;
+
+    /// @brief Adds a collider to the batch.
+    ///
+    /// @details Boxes only use their first point, which holds their half size. Other colliders are
+    /// the convex hull of their points, and missing points are filled by repeating the last one.
+    ///
+    /// @param entity Entity of the collider.
+    /// @param aabb AABB component of the collider.
+    /// @param transform Collider to world transform.
+    /// @param points Points of the collider, in collider space.
+    /// @param count Number of points, up to @ref MaxPoints.
+    /// @param radius Radius by which the collider is inflated.
+    void add(Entity entity, cubos::engine::ColliderAABB* aabb, const glm::mat4& transform, const glm::vec3* points,
+             std::size_t count, float radius);
+
+    /// @brief Gets the number of colliders in the batch, excluding padding.
+    /// @return Number of colliders.
+    std::size_t size() const;
+};
+
+/// @brief Computes the AABBs of a batch of box colliders, writing them to their components and to
+/// the mirrored bounds of the broad phase.
+/// @param batch Batch of boxes.
+/// @param collisions Broad phase collisions resource.
+/// @param pool Thread pool to run the kernels on.
+void computeBoxAABBs(AABBBatch& batch, cubos::engine::BroadPhaseCollisions& collisions, cubos::core::ThreadPool& pool);
+
+/// @brief Computes the AABBs of a batch of point hull colliders, writing them to their components
+/// and to the mirrored bounds of the broad phase.
+/// @param batch Batch of point hulls.
+/// @param collisions Broad phase collisions resource.
+/// @param pool Thread pool to run the kernels on.
+void computeHullAABBs(AABBBatch& batch, cubos::engine::BroadPhaseCollisions& collisions,
+                      cubos::core::ThreadPool& pool);
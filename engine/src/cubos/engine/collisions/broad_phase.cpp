@@ -1,101 +1,190 @@
+#include <algorithm>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "aabb_batch.hpp"
 #include "broad_phase.hpp"
+#include "overlap.hpp"
 
+using Candidate = BroadPhaseCollisions::Candidate;
 using CollisionType = BroadPhaseCollisions::CollisionType;
+using Shape = BroadPhaseCollisions::Shape;
+using SweepMarker = BroadPhaseCollisions::SweepMarker;
 
-void updateBoxAABBs(Query<Read<LocalToWorld>, Read<BoxCollider>, Write<ColliderAABB>> query)
+void updateBoxAABBs(
+    Query<Read<LocalToWorld>, Read<BoxCollider>, Write<ColliderAABB>, OptRead<ContinuousCollider>> query,
+    Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool)
 {
-    for (auto [entity, localToWorld, collider, aabb] : query)
+    AABBBatch batch;
+    AABBBatch swept;
+    swept.merge = true;
+    for (auto [entity, localToWorld, collider, aabb, continuous] : query)
     {
-        // Get the 4 points of the collider.
-        glm::vec3 corners[4];
-        collider->shape.corners4(corners);
+        batch.add(entity, &*aabb, localToWorld->mat * collider->transform, &collider->shape.halfSize, 1,
+                  collider->margin);
+        if (continuous && continuous->hasPrevious)
+        {
+            swept.add(entity, &*aabb, continuous->previous * collider->transform, &collider->shape.halfSize, 1,
+                      collider->margin);
+        }
+    }
+
+    computeBoxAABBs(batch, *collisions, *pool);
+    computeBoxAABBs(swept, *collisions, *pool);
+}
 
-        // Pack the 3 points of the collider into a matrix.
-        auto points = glm::mat4{glm::vec4{corners[0], 1.0F}, glm::vec4{corners[1], 1.0F}, glm::vec4{corners[2], 1.0F},
-                                glm::vec4{corners[3], 1.0F}};
+void updateCapsuleAABBs(
+    Query<Read<LocalToWorld>, Read<CapsuleCollider>, Write<ColliderAABB>, OptRead<ContinuousCollider>> query,
+    Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool)
+{
+    AABBBatch batch;
+    AABBBatch swept;
+    swept.merge = true;
+    for (auto [entity, localToWorld, collider, aabb, continuous] : query)
+    {
+        // Capsules are segments along their local Y axis, inflated by their radius.
+        auto halfLength = collider->shape.length / 2.0F;
+        glm::vec3 points[2] = {{0.0F, -halfLength, 0.0F}, {0.0F, halfLength, 0.0F}};
+        batch.add(entity, &*aabb, localToWorld->mat * collider->transform, points, 2, collider->shape.radius);
+        if (continuous && continuous->hasPrevious)
+        {
+            swept.add(entity, &*aabb, continuous->previous * collider->transform, points, 2, collider->shape.radius);
+        }
+    }
 
-        // Transforms collider space to world space.
-        auto transform = localToWorld->mat * collider->transform;
+    computeHullAABBs(batch, *collisions, *pool);
+    computeHullAABBs(swept, *collisions, *pool);
+}
 
-        // Only want scale and rotation, extract translation and remove it.
-        auto translation = glm::vec3{transform[3]};
-        transform[3] = glm::vec4{0.0f, 0.0f, 0.0f, 1.0f};
+void updateSimplexAABBs(
+    Query<Read<LocalToWorld>, Read<SimplexCollider>, Write<ColliderAABB>, OptRead<ContinuousCollider>> query,
+    Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool)
+{
+    AABBBatch batch;
+    AABBBatch swept;
+    swept.merge = true;
+    for (auto [entity, localToWorld, collider, aabb, continuous] : query)
+    {
+        const auto& points = collider->shape.points;
+        auto count = std::min(points.size(), AABBBatch::MaxPoints);
+        batch.add(entity, &*aabb, glm::translate(localToWorld->mat, collider->offset), points.data(), count,
+                  collider->margin);
+        if (continuous && continuous->hasPrevious)
+        {
+            swept.add(entity, &*aabb, glm::translate(continuous->previous, collider->offset), points.data(), count,
+                      collider->margin);
+        }
+    }
 
-        // Rotate and scale corners.
-        auto rotatedCorners = glm::mat4x3{transform * points};
+    computeHullAABBs(batch, *collisions, *pool);
+    computeHullAABBs(swept, *collisions, *pool);
+}
 
-        // Get the max of the rotated corners.
-        auto max = glm::max(glm::abs(rotatedCorners[0]), glm::abs(rotatedCorners[1]));
-        max = glm::max(max, glm::abs(rotatedCorners[2]));
-        max = glm::max(max, glm::abs(rotatedCorners[3]));
+/// An incremental sort is quadratic on the number of new markers, so if more than one in this many
+/// entities was added since the last sweep, the markers are sorted from scratch instead.
+static const std::size_t RebuildRatio = 8;
 
-        // Add the collider's margin.
-        max += glm::vec3{collider->margin};
+/// Sorts the markers of an axis with an insertion sort, which is close to linear when they were
+/// already sorted in the previous frame. Every time a min marker crosses a max marker, the overlap
+/// of their entities on this axis changed, and the pair is added to @p deltas.
+static void sortMarkers(std::vector<SweepMarker>& markers, std::vector<Candidate>& deltas)
+{
+    deltas.clear();
 
-        // Set the AABB.
-        aabb->max = translation + max;
-        aabb->min = translation - max;
+    for (std::size_t i = 1; i < markers.size(); i++)
+    {
+        auto marker = markers[i];
+        auto j = i;
+        for (; j > 0 && markers[j - 1].position > marker.position; j--)
+        {
+            const auto& other = markers[j - 1];
+            if (marker.isMin != other.isMin && marker.entity != other.entity)
+            {
+                deltas.push_back({marker.entity, other.entity});
+            }
+            markers[j] = other;
+        }
+        markers[j] = marker;
     }
 }
 
-void updateCapsuleAABBs(Query<Read<LocalToWorld>, Read<CapsuleCollider>, Write<ColliderAABB>> query,
-                        Write<BroadPhaseCollisions> collisions)
+/// Sorts the markers of an axis from scratch. If @p sweep is true, also sweeps through them and
+/// adds every pair overlapping on this axis to @p deltas.
+static void rebuildMarkers(std::vector<SweepMarker>& markers, std::vector<Candidate>& deltas, bool sweep)
 {
-    (void)query;
-    (void)collisions;
-}
+    deltas.clear();
 
-void updateSimplexAABBs(Query<Read<LocalToWorld>, Read<SimplexCollider>, Write<ColliderAABB>> query,
-                        Write<BroadPhaseCollisions> collisions)
-{
-    (void)query;
-    (void)collisions;
-}
+    // Min markers go first on ties, so that an entity is never closed before being opened.
+    std::sort(markers.begin(), markers.end(), [](const SweepMarker& a, const SweepMarker& b) {
+        return a.position < b.position || (a.position == b.position && a.isMin && !b.isMin);
+    });
 
-void updateMarkers(Query<Read<ColliderAABB>> query, Write<BroadPhaseCollisions> collisions)
-{
-    // TODO: This is parallelizable.
-    for (glm::length_t axis = 0; axis < 3; axis++)
+    if (!sweep)
     {
-        // TODO: Should use insert sort to leverage spatial coherence.
-        std::sort(
-            collisions->markersPerAxis[axis].begin(), collisions->markersPerAxis[axis].end(),
-            [axis, &query](const BroadPhaseCollisions::SweepMarker& a, const BroadPhaseCollisions::SweepMarker& b) {
-                auto [aAABB] = query[a.entity].value();
-                auto [bAABB] = query[b.entity].value();
-                auto aPos = a.isMin ? aAABB->min : aAABB->max;
-                auto bPos = b.isMin ? bAABB->min : bAABB->max;
-                return aPos[axis] < bPos[axis];
-            });
+        return;
+    }
+
+    std::vector<Entity> active;
+    for (const auto& marker : markers)
+    {
+        if (marker.isMin)
+        {
+            for (const auto& other : active)
+            {
+                deltas.push_back({marker.entity, other});
+            }
+            active.push_back(marker.entity);
+        }
+        else
+        {
+            auto it = std::find(active.begin(), active.end(), marker.entity);
+            if (it != active.end())
+            {
+                *it = active.back();
+                active.pop_back();
+            }
+        }
     }
 }
 
-void sweep(Write<BroadPhaseCollisions> collisions)
+void updateMarkers(Write<BroadPhaseCollisions> collisions)
 {
-    // TODO: This is parallelizable.
-    for (glm::length_t axis = 0; axis < 3; axis++)
+    const auto& bounds = collisions->bounds;
+    for (std::size_t axis = 0; axis < 3; axis++)
     {
-        CUBOS_ASSERT(collisions->activePerAxis[axis].empty(), "Last sweep entered an entity but never exited");
-
-        collisions->sweepOverlapMaps[axis].clear();
-
         for (auto& marker : collisions->markersPerAxis[axis])
         {
-            if (marker.isMin)
-            {
-                for (auto& other : collisions->activePerAxis[axis])
-                {
-                    collisions->sweepOverlapMaps[axis][marker.entity].push_back(other);
-                }
+            auto slot = bounds.slot(marker.entity);
+            marker.position = marker.isMin ? bounds.min[axis][slot] : bounds.max[axis][slot];
+        }
+    }
+}
 
-                collisions->activePerAxis[axis].insert(marker.entity);
+void sweep(Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool)
+{
+    auto entityCount = collisions->markersPerAxis[0].size() / 2;
+    auto rebuild = collisions->addedEntities * RebuildRatio > entityCount;
+    collisions->rebuilt = rebuild;
+    collisions->addedEntities = 0;
+
+    // Axes are independent from each other, so they can be sorted in parallel. When rebuilding,
+    // sweeping a single axis is enough to find every overlapping pair.
+    for (std::size_t axis = 0; axis < 3; axis++)
+    {
+        auto& markers = collisions->markersPerAxis[axis];
+        auto& deltas = collisions->deltasPerAxis[axis];
+        pool->addTask([&markers, &deltas, rebuild, axis]() {
+            if (rebuild)
+            {
+                rebuildMarkers(markers, deltas, axis == 0);
             }
             else
             {
-                collisions->activePerAxis[axis].erase(marker.entity);
+                sortMarkers(markers, deltas);
             }
-        }
+        });
     }
+    pool->wait();
 }
 
 CollisionType getCollisionType(bool box, bool capsule, bool plane, bool simplex)
@@ -121,42 +210,159 @@ CollisionType getCollisionType(bool box, bool capsule, bool plane, bool simplex)
     return CollisionType::SimplexSimplex;
 }
 
-void findPairs(Query<OptRead<BoxCollider>, OptRead<CapsuleCollider>, OptRead<PlaneCollider>, OptRead<SimplexCollider>,
-                     Read<ColliderAABB>>
-                   query,
-               Write<BroadPhaseCollisions> collisions)
+/// Gets the bit of a shape in a shape mask.
+static std::uint8_t shapeBit(Shape shape)
 {
-    collisions->clearCandidates();
+    return static_cast<std::uint8_t>(1U << static_cast<unsigned>(shape));
+}
 
-    for (glm::length_t axis = 0; axis < 3; axis++)
+CollisionType getCollisionType(std::uint8_t shapes, std::uint8_t otherShapes)
+{
+    auto both = static_cast<std::uint8_t>(shapes | otherShapes);
+    return getCollisionType((both & shapeBit(Shape::Box)) != 0, (both & shapeBit(Shape::Capsule)) != 0,
+                            (both & shapeBit(Shape::Plane)) != 0, (both & shapeBit(Shape::Simplex)) != 0);
+}
+
+void findPairs(Write<BroadPhaseCollisions> collisions)
+{
+    if (collisions->rebuilt)
     {
-        for (auto& [entity, overlaps] : collisions->sweepOverlapMaps[axis])
+        collisions->clearCandidates();
+    }
+
+    // Only the overlap along one axis is known to have changed for each delta, so the others must
+    // be checked too. The deltas of every axis are translated to slots and tested in one batch.
+    const auto& bounds = collisions->bounds;
+    std::vector<std::uint32_t> first;
+    std::vector<std::uint32_t> second;
+    for (const auto& deltas : collisions->deltasPerAxis)
+    {
+        for (const auto& [entity, other] : deltas)
         {
-            auto [box, capsule, plane, simplex, aabb] = query[entity].value();
-            for (auto& other : overlaps)
+            auto slot = bounds.slot(entity);
+            auto otherSlot = bounds.slot(other);
+            if (slot != BroadPhaseCollisions::Bounds::NoSlot && otherSlot != BroadPhaseCollisions::Bounds::NoSlot)
             {
-                auto [otherBox, otherCapsule, otherPlane, otherSimplex, otherAabb] = query[other].value();
+                first.push_back(slot);
+                second.push_back(otherSlot);
+            }
+        }
+    }
+
+    std::vector<std::uint8_t> overlapping(first.size());
+    overlapPairs(bounds, first.data(), second.data(), first.size(), overlapping.data());
+
+    for (std::size_t i = 0; i < first.size(); ++i)
+    {
+        auto type = getCollisionType(bounds.shapes[first[i]], bounds.shapes[second[i]]);
+        Candidate candidate{bounds.entities[first[i]], bounds.entities[second[i]]};
+        if (overlapping[i] != 0)
+        {
+            collisions->addCandidate(type, candidate);
+        }
+        else
+        {
+            collisions->removeCandidate(type, candidate);
+        }
+    }
+}
+
+void updateTree(Read<BroadPhaseCollisions> collisions, Write<BroadPhaseTree> tree)
+{
+    tree->clearMoved();
+
+    const auto& bounds = collisions->bounds;
+    for (std::uint32_t slot = 0; slot < static_cast<std::uint32_t>(bounds.size()); ++slot)
+    {
+        tree->update(bounds.entities[slot], bounds.aabb(slot));
+    }
+}
 
-                // TODO: Should this be inside the if statement?
-                auto type = getCollisionType(box || otherBox, capsule || otherCapsule, plane || otherPlane,
-                                             simplex || otherSimplex);
+void findTreePairs(Read<BroadPhaseTree> tree, Write<BroadPhaseCollisions> collisions)
+{
+    using Bounds = BroadPhaseCollisions::Bounds;
 
-                switch (axis)
+    auto& pairs = collisions->treePairs;
+    const auto& bounds = collisions->bounds;
+    const auto& moved = tree->moved();
+    if (!moved.empty())
+    {
+        std::vector<bool> isMoved;
+        for (const auto& entity : moved)
+        {
+            if (isMoved.size() <= entity.index)
+            {
+                isMoved.resize(entity.index + 1, false);
+            }
+            isMoved[entity.index] = true;
+        }
+        auto wasMoved = [&](Entity entity) { return entity.index < isMoved.size() && isMoved[entity.index]; };
+
+        // The enlarged AABBs only change when their entities are reinserted, so only the pairs
+        // which include a moved entity may have stopped overlapping. Their actual AABBs can't
+        // overlap either, so they're no longer candidates.
+        std::erase_if(pairs, [&](const Candidate& c) {
+            if ((!wasMoved(c.first) && !wasMoved(c.second)) || tree->overlaps(c.first, c.second))
+            {
+                return false;
+            }
+
+            auto slot = bounds.slot(c.first);
+            auto otherSlot = bounds.slot(c.second);
+            if (slot != Bounds::NoSlot && otherSlot != Bounds::NoSlot)
+            {
+                collisions->removeCandidate(getCollisionType(bounds.shapes[slot], bounds.shapes[otherSlot]), c);
+            }
+            return true;
+        });
+
+        for (const auto& entity : moved)
+        {
+            if (bounds.slot(entity) == Bounds::NoSlot)
+            {
+                continue;
+            }
+
+            tree->query(tree->aabb(entity), [&](Entity other) {
+                // Pairs of moved entities are found from both sides, so only the entity with the
+                // lowest index adds them.
+                if (other != entity && bounds.slot(other) != Bounds::NoSlot &&
+                    (!wasMoved(other) || entity.index < other.index))
                 {
-                case 0: // X
-                    if (aabb->overlapsY(*otherAabb) && aabb->overlapsZ(*otherAabb))
-                        collisions->addCandidate(type, {entity, other});
-                    break;
-                case 1: // Y
-                    if (aabb->overlapsX(*otherAabb) && aabb->overlapsZ(*otherAabb))
-                        collisions->addCandidate(type, {entity, other});
-                    break;
-                case 2: // Z
-                    if (aabb->overlapsX(*otherAabb) && aabb->overlapsY(*otherAabb))
-                        collisions->addCandidate(type, {entity, other});
-                    break;
+                    pairs.insert(entity.index < other.index ? Candidate{entity, other} : Candidate{other, entity});
                 }
-            }
+                return true;
+            });
         }
     }
-}
\ No newline at end of file
+
+    // Entities may move inside their enlarged AABBs, so the actual AABBs of every pair are tested
+    // again, which leaves the same candidates as sweep and prune would find.
+    std::vector<std::uint32_t> first;
+    std::vector<std::uint32_t> second;
+    first.reserve(pairs.size());
+    second.reserve(pairs.size());
+    for (const auto& [entity, other] : pairs)
+    {
+        first.push_back(bounds.slot(entity));
+        second.push_back(bounds.slot(other));
+    }
+
+    std::vector<std::uint8_t> overlapping(first.size());
+    overlapPairs(bounds, first.data(), second.data(), first.size(), overlapping.data());
+
+    std::size_t i = 0;
+    for (const auto& candidate : pairs)
+    {
+        auto type = getCollisionType(bounds.shapes[first[i]], bounds.shapes[second[i]]);
+        if (overlapping[i] != 0)
+        {
+            collisions->addCandidate(type, candidate);
+        }
+        else
+        {
+            collisions->removeCandidate(type, candidate);
+        }
+        i += 1;
+    }
+}
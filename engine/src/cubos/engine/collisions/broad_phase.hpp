@@ -3,16 +3,23 @@
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+
 #include <cubos/core/ecs/query.hpp>
+#include <cubos/core/thread_pool.hpp>
 
 #include <cubos/engine/collisions/aabb.hpp>
 #include <cubos/engine/collisions/broad_phase_collisions.hpp>
+#include <cubos/engine/collisions/broad_phase_tree.hpp>
 #include <cubos/engine/collisions/colliders/box.hpp>
 #include <cubos/engine/collisions/colliders/capsule.hpp>
 #include <cubos/engine/collisions/colliders/plane.hpp>
 #include <cubos/engine/collisions/colliders/simplex.hpp>
+#include <cubos/engine/collisions/continuous_collider.hpp>
 #include <cubos/engine/transform/plugin.hpp>
 
+using cubos::core::ThreadPool;
 using cubos::core::ecs::Commands;
 using cubos::core::ecs::OptRead;
 using cubos::core::ecs::Query;
@@ -21,15 +28,41 @@ using cubos::core::ecs::Write;
 
 using cubos::engine::BoxCollider;
 using cubos::engine::BroadPhaseCollisions;
+using cubos::engine::BroadPhaseTree;
 using cubos::engine::CapsuleCollider;
 using cubos::engine::ColliderAABB;
+using cubos::engine::ContinuousCollider;
 using cubos::engine::LocalToWorld;
 using cubos::engine::PlaneCollider;
 using cubos::engine::SimplexCollider;
 
-/// @brief Adds missing AABBs to all colliders.
+/// @brief Gets the shape of a collider component.
 template <typename C>
-void addMissingAABBs(Query<Read<C>, OptRead<ColliderAABB>> query, Commands commands)
+constexpr BroadPhaseCollisions::Shape colliderShape()
+{
+    if constexpr (std::is_same_v<C, BoxCollider>)
+    {
+        return BroadPhaseCollisions::Shape::Box;
+    }
+    else if constexpr (std::is_same_v<C, CapsuleCollider>)
+    {
+        return BroadPhaseCollisions::Shape::Capsule;
+    }
+    else if constexpr (std::is_same_v<C, PlaneCollider>)
+    {
+        return BroadPhaseCollisions::Shape::Plane;
+    }
+    else
+    {
+        static_assert(std::is_same_v<C, SimplexCollider>, "Unknown collider type");
+        return BroadPhaseCollisions::Shape::Simplex;
+    }
+}
+
+/// @brief Adds missing AABBs to all colliders, and registers them in the broad phase.
+template <typename C>
+void addMissingAABBs(Query<Read<C>, OptRead<ColliderAABB>> query, Commands commands,
+                     Write<BroadPhaseCollisions> collisions)
 {
     // TODO: This query should eventually be replaced by Query<With<C>, Without<ColliderAABB>>
 
@@ -38,33 +71,59 @@ void addMissingAABBs(Query<Read<C>, OptRead<ColliderAABB>> query, Commands comma
         if (!aabb)
         {
             commands.add(entity, ColliderAABB{});
+            collisions->addEntity(entity, colliderShape<C>());
         }
     }
 }
 
-/// @brief Updates the AABBs of all box colliders.
-void updateBoxAABBs(Query<Read<LocalToWorld>, Read<BoxCollider>, Write<ColliderAABB>> query);
+/// @brief Updates the AABBs of all box colliders, in batches spread over the thread pool. The AABBs
+/// of continuous colliders are swept from their previous transform.
+void updateBoxAABBs(
+    Query<Read<LocalToWorld>, Read<BoxCollider>, Write<ColliderAABB>, OptRead<ContinuousCollider>> query,
+    Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool);
+
+/// @brief Updates the AABBs of all capsule colliders, in batches spread over the thread pool. The
+/// AABBs of continuous colliders are swept from their previous transform.
+void updateCapsuleAABBs(
+    Query<Read<LocalToWorld>, Read<CapsuleCollider>, Write<ColliderAABB>, OptRead<ContinuousCollider>> query,
+    Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool);
+
+/// @brief Updates the AABBs of all simplex colliders, in batches spread over the thread pool. The
+/// AABBs of continuous colliders are swept from their previous transform.
+void updateSimplexAABBs(
+    Query<Read<LocalToWorld>, Read<SimplexCollider>, Write<ColliderAABB>, OptRead<ContinuousCollider>> query,
+    Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool);
+
+/// @brief Updates the positions cached in the sweep markers of all colliders.
+void updateMarkers(Write<BroadPhaseCollisions> collisions);
+
+/// @brief Sorts the sweep markers of each axis in parallel, finding which pairs of colliders had
+/// their overlap along that axis changed.
+void sweep(Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool);
 
-/// @brief Updates the AABBs of all capsule colliders.
-void updateCapsuleAABBs(Query<Read<LocalToWorld>, Read<CapsuleCollider>, Write<ColliderAABB>> query,
-                        Write<BroadPhaseCollisions> collisions);
+/// @brief Gets the collision type of a pair of colliders.
+/// @param box Whether either collider is a box.
+/// @param capsule Whether either collider is a capsule.
+/// @param plane Whether either collider is a plane.
+/// @param simplex Whether either collider is a simplex.
+/// @return Collision type.
+BroadPhaseCollisions::CollisionType getCollisionType(bool box, bool capsule, bool plane, bool simplex);
 
-/// @brief Updates the AABBs of all simplex colliders.
-void updateSimplexAABBs(Query<Read<LocalToWorld>, Read<SimplexCollider>, Write<ColliderAABB>> query,
-                        Write<BroadPhaseCollisions> collisions);
+/// @brief Gets the collision type of a pair of colliders from their shape masks.
+/// @param shapes Bit mask of the shapes of the first collider.
+/// @param otherShapes Bit mask of the shapes of the second collider.
+/// @return Collision type.
+BroadPhaseCollisions::CollisionType getCollisionType(std::uint8_t shapes, std::uint8_t otherShapes);
 
-/// @brief Updates the sweep markers of all colliders.
-void updateMarkers(Query<Read<ColliderAABB>> query, Write<BroadPhaseCollisions> collisions);
+/// @brief Updates the collision candidates with the pairs whose overlap changed in the last sweep,
+/// testing them in batches.
+void findPairs(Write<BroadPhaseCollisions> collisions);
 
-/// @brief Performs a sweep of all colliders.
-void sweep(Write<BroadPhaseCollisions> collisions);
+/// @brief Inserts the AABBs of all colliders in the broad phase tree, reinserting only the ones
+/// which left their enlarged AABB.
+void updateTree(Read<BroadPhaseCollisions> collisions, Write<BroadPhaseTree> tree);
 
-/// @brief Finds all pairs of colliders which may be colliding.
-///
-/// @details
-/// TODO: This query is disgusting. We need a way to find if a component is present without reading it.
-/// Maybe something like Commands but for reads?
-void findPairs(Query<OptRead<BoxCollider>, OptRead<CapsuleCollider>, OptRead<PlaneCollider>, OptRead<SimplexCollider>,
-                     Read<ColliderAABB>>
-                   query,
-               Write<BroadPhaseCollisions> collisions);
\ No newline at end of file
+/// @brief Updates the pairs whose enlarged AABBs overlap by querying the broad phase tree with the
+/// entities reinserted in the last update, and then the collision candidates with the pairs whose
+/// actual AABBs overlap.
+void findTreePairs(Read<BroadPhaseTree> tree, Write<BroadPhaseCollisions> collisions);
@@ -1,21 +1,65 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
 #include <cubos/core/log.hpp>
 
 #include <cubos/engine/collisions/broad_phase_collisions.hpp>
 
 using cubos::engine::BroadPhaseCollisions;
+using cubos::engine::ColliderAABB;
 
 using Candidate = BroadPhaseCollisions::Candidate;
 using CandidateHash = BroadPhaseCollisions::CandidateHash;
 using CollisionType = BroadPhaseCollisions::CollisionType;
 using SweepMarker = BroadPhaseCollisions::SweepMarker;
 
-void BroadPhaseCollisions::addEntity(Entity entity)
+/// Orders the entities of a candidate, so that each pair has a single representation.
+static Candidate canonical(Candidate candidate)
+{
+    // The same pair may be found in different orders on different axes.
+    if (candidate.second.index < candidate.first.index)
+    {
+        std::swap(candidate.first, candidate.second);
+    }
+
+    return candidate;
+}
+
+void BroadPhaseCollisions::addEntity(Entity entity, Shape shape)
 {
+    auto shapeBit = static_cast<std::uint8_t>(1U << static_cast<unsigned>(shape));
+    if (auto slot = bounds.slot(entity); slot != Bounds::NoSlot)
+    {
+        bounds.shapes[slot] |= shapeBit;
+        return;
+    }
+
+    // The index may still be held by a previous generation of the entity, which must have been
+    // destroyed without being removed.
+    if (entity.index < bounds.slots.size() && bounds.slots[entity.index] != Bounds::NoSlot)
+    {
+        this->removeEntity(bounds.entities[bounds.slots[entity.index]]);
+    }
+
+    if (bounds.slots.size() <= entity.index)
+    {
+        bounds.slots.resize(entity.index + 1, Bounds::NoSlot);
+    }
+    bounds.slots[entity.index] = static_cast<std::uint32_t>(bounds.entities.size());
+    bounds.entities.push_back(entity);
+    bounds.shapes.push_back(shapeBit);
+
+    // Until their AABBs are first updated, entities overlap everything.
     for (std::size_t axis = 0; axis < 3; axis++)
     {
-        markersPerAxis[axis].push_back({entity, true});
-        markersPerAxis[axis].push_back({entity, false});
+        bounds.min[axis].push_back(-INFINITY);
+        bounds.max[axis].push_back(INFINITY);
+        markersPerAxis[axis].push_back({entity, true, 0.0F});
+        markersPerAxis[axis].push_back({entity, false, 0.0F});
     }
+
+    addedEntities += 1;
 }
 
 void BroadPhaseCollisions::removeEntity(Entity entity)
@@ -27,6 +71,34 @@ void BroadPhaseCollisions::removeEntity(Entity entity)
                                      [entity](const SweepMarker& m) { return m.entity == entity; }),
                       markers.end());
     }
+
+    for (auto& candidates : candidatesPerType)
+    {
+        std::erase_if(candidates, [entity](const Candidate& c) { return c.first == entity || c.second == entity; });
+    }
+    std::erase_if(treePairs, [entity](const Candidate& c) { return c.first == entity || c.second == entity; });
+
+    // Move the last slot into the removed one, so that the arrays stay contiguous.
+    auto slot = bounds.slot(entity);
+    if (slot == Bounds::NoSlot)
+    {
+        return;
+    }
+
+    auto last = static_cast<std::uint32_t>(bounds.entities.size() - 1);
+    bounds.entities[slot] = bounds.entities[last];
+    bounds.shapes[slot] = bounds.shapes[last];
+    for (std::size_t axis = 0; axis < 3; axis++)
+    {
+        bounds.min[axis][slot] = bounds.min[axis][last];
+        bounds.max[axis][slot] = bounds.max[axis][last];
+        bounds.min[axis].pop_back();
+        bounds.max[axis].pop_back();
+    }
+    bounds.slots[bounds.entities[slot].index] = slot;
+    bounds.slots[entity.index] = Bounds::NoSlot;
+    bounds.entities.pop_back();
+    bounds.shapes.pop_back();
 }
 
 void BroadPhaseCollisions::clearEntities()
@@ -34,12 +106,42 @@ void BroadPhaseCollisions::clearEntities()
     for (std::size_t axis = 0; axis < 3; axis++)
     {
         markersPerAxis[axis].clear();
+        deltasPerAxis[axis].clear();
+        bounds.min[axis].clear();
+        bounds.max[axis].clear();
+    }
+
+    bounds.entities.clear();
+    bounds.shapes.clear();
+    bounds.slots.clear();
+    addedEntities = 0;
+    treePairs.clear();
+    this->clearCandidates();
+}
+
+void BroadPhaseCollisions::updateBounds(Entity entity, const ColliderAABB& aabb)
+{
+    auto slot = bounds.slot(entity);
+    if (slot == Bounds::NoSlot)
+    {
+        return;
+    }
+
+    for (glm::length_t axis = 0; axis < 3; axis++)
+    {
+        bounds.min[axis][slot] = aabb.min[axis];
+        bounds.max[axis][slot] = aabb.max[axis];
     }
 }
 
 void BroadPhaseCollisions::addCandidate(CollisionType type, Candidate candidate)
 {
-    candidatesPerType[static_cast<std::size_t>(type)].insert(candidate);
+    candidatesPerType[static_cast<std::size_t>(type)].insert(canonical(candidate));
+}
+
+void BroadPhaseCollisions::removeCandidate(CollisionType type, Candidate candidate)
+{
+    candidatesPerType[static_cast<std::size_t>(type)].erase(canonical(candidate));
 }
 
 const std::unordered_set<Candidate, CandidateHash>& BroadPhaseCollisions::candidates(CollisionType type) const
@@ -54,3 +156,24 @@ void BroadPhaseCollisions::clearCandidates()
         candidatesPerType[i].clear();
     }
 }
+
+std::uint32_t BroadPhaseCollisions::Bounds::slot(Entity entity) const
+{
+    if (entity.index >= slots.size())
+    {
+        return NoSlot;
+    }
+
+    auto slot = slots[entity.index];
+    return slot != NoSlot && entities[slot] == entity ? slot : NoSlot;
+}
+
+ColliderAABB BroadPhaseCollisions::Bounds::aabb(std::uint32_t slot) const
+{
+    return ColliderAABB{{min[0][slot], min[1][slot], min[2][slot]}, {max[0][slot], max[1][slot], max[2][slot]}};
+}
+
+std::size_t BroadPhaseCollisions::Bounds::size() const
+{
+    return entities.size();
+}
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cmath>
+
+#include "broad_phase_grid.hpp"
+#include "overlap.hpp"
+
+using Bounds = BroadPhaseCollisions::Bounds;
+using Entry = BroadPhaseGrid::Entry;
+using Pair = BroadPhaseGrid::Pair;
+
+/// Maximum number of colliders inserted by a single task.
+static const std::size_t InsertBatchSize = 1024;
+
+/// Maximum number of cells tested by a single task.
+static const std::size_t CellBatchSize = 256;
+
+/// Colliders which would cover more than this many cells along any axis are tested against every
+/// other collider instead of being inserted in the grid.
+static const float MaxCellsPerAxis = 4.0F;
+
+/// Smallest allowed cell size, so that a scene made only of points doesn't produce a degenerate grid.
+static const float MinCellSize = 1e-3F;
+
+/// Number of bits of each cell coordinate in a cell key. Coordinates wrap around, which can only
+/// make distant cells share a key, and colliders which share a cell are always tested for overlap.
+static const std::uint64_t CoordinateBits = 21;
+
+/// Mask of the bits of a cell coordinate.
+static const std::uint64_t CoordinateMask = (std::uint64_t{1} << CoordinateBits) - 1;
+
+/// Checks whether an AABB has a finite size.
+static bool isBounded(const ColliderAABB& aabb)
+{
+    auto size = aabb.max - aabb.min;
+    return std::isfinite(size.x) && std::isfinite(size.y) && std::isfinite(size.z);
+}
+
+/// Gets the coordinates of the cell which contains a point.
+static glm::ivec3 cellOf(glm::vec3 point, float inverseCellSize)
+{
+    return glm::ivec3{glm::floor(point * inverseCellSize)};
+}
+
+/// Packs the coordinates of a cell into a single key.
+static std::uint64_t cellKey(glm::ivec3 cell)
+{
+    auto coordinate = [](int value) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(value)) & CoordinateMask;
+    };
+    return (coordinate(cell.x) << (2 * CoordinateBits)) | (coordinate(cell.y) << CoordinateBits) | coordinate(cell.z);
+}
+
+/// Orders entries by cell, and then by collider.
+static bool entryLess(const Entry& a, const Entry& b)
+{
+    return a.cell < b.cell || (a.cell == b.cell && a.collider < b.collider);
+}
+
+/// Inserts a range of colliders into the cells their AABBs cover, sorting the resulting entries.
+static void insertColliders(const Bounds& bounds, const std::uint32_t* begin, const std::uint32_t* end,
+                            float inverseCellSize, std::vector<Entry>& entries)
+{
+    entries.clear();
+
+    for (const auto* it = begin; it != end; ++it)
+    {
+        auto aabb = bounds.aabb(*it);
+        auto min = cellOf(aabb.min, inverseCellSize);
+        auto max = cellOf(aabb.max, inverseCellSize);
+
+        for (int x = min.x; x <= max.x; ++x)
+        {
+            for (int y = min.y; y <= max.y; ++y)
+            {
+                for (int z = min.z; z <= max.z; ++z)
+                {
+                    entries.push_back({cellKey({x, y, z}), *it});
+                }
+            }
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), entryLess);
+}
+
+/// Finds the overlapping pairs of colliders in a range of cells.
+static void testCells(const Bounds& bounds, const std::vector<Entry>& entries, const std::size_t* begin,
+                      const std::size_t* end, float inverseCellSize, std::vector<Pair>& pairs)
+{
+    pairs.clear();
+
+    // Gather every pair which shares a cell, and then test them all for overlap in a single batch.
+    // Each cell is delimited by its first entry and the first entry of the next cell.
+    std::vector<std::uint32_t> first;
+    std::vector<std::uint32_t> second;
+    std::vector<std::uint64_t> keys;
+    for (const auto* cell = begin; cell != end; ++cell)
+    {
+        for (auto i = cell[0]; i < cell[1]; ++i)
+        {
+            for (auto j = i + 1; j < cell[1]; ++j)
+            {
+                first.push_back(entries[i].collider);
+                second.push_back(entries[j].collider);
+                keys.push_back(entries[i].cell);
+            }
+        }
+    }
+
+    std::vector<std::uint8_t> overlapping(first.size());
+    overlapPairs(bounds, first.data(), second.data(), first.size(), overlapping.data());
+
+    for (std::size_t i = 0; i < first.size(); ++i)
+    {
+        if (overlapping[i] == 0)
+        {
+            continue;
+        }
+
+        // A pair is found in every cell shared by both colliders, but only reported by the one
+        // which contains the minimum corner of their intersection.
+        auto corner = glm::max(bounds.aabb(first[i]).min, bounds.aabb(second[i]).min);
+        if (cellKey(cellOf(corner, inverseCellSize)) == keys[i])
+        {
+            pairs.push_back({first[i], second[i]});
+        }
+    }
+}
+
+void findGridPairs(Write<BroadPhaseGrid> grid, Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool)
+{
+    const auto& bounds = collisions->bounds;
+    auto count = static_cast<std::uint32_t>(bounds.size());
+    auto& gridded = grid->gridded;
+    auto& oversized = grid->oversized;
+    gridded.clear();
+    oversized.clear();
+
+    // Use the average size of the bounded colliders as the cell size, so that most colliders cover
+    // at most two cells along each axis.
+    float totalSize = 0.0F;
+    std::size_t boundedCount = 0;
+    for (std::uint32_t slot = 0; slot < count; ++slot)
+    {
+        auto aabb = bounds.aabb(slot);
+        if (isBounded(aabb))
+        {
+            auto size = aabb.max - aabb.min;
+            totalSize += glm::max(size.x, glm::max(size.y, size.z));
+            boundedCount += 1;
+        }
+    }
+
+    if (boundedCount > 0)
+    {
+        grid->cellSize = std::max(totalSize / static_cast<float>(boundedCount), MinCellSize);
+    }
+    auto inverseCellSize = 1.0F / grid->cellSize;
+
+    for (std::uint32_t slot = 0; slot < count; ++slot)
+    {
+        auto aabb = bounds.aabb(slot);
+        auto cells = (aabb.max - aabb.min) * inverseCellSize;
+        if (isBounded(aabb) && cells.x <= MaxCellsPerAxis && cells.y <= MaxCellsPerAxis &&
+            cells.z <= MaxCellsPerAxis)
+        {
+            gridded.push_back(slot);
+        }
+        else
+        {
+            oversized.push_back(slot);
+        }
+    }
+
+    // Insert the colliders in parallel, each task into its own sorted list of entries.
+    auto insertTasks = (gridded.size() + InsertBatchSize - 1) / InsertBatchSize;
+    if (grid->entriesPerTask.size() < insertTasks)
+    {
+        grid->entriesPerTask.resize(insertTasks);
+    }
+
+    for (std::size_t task = 0; task < insertTasks; ++task)
+    {
+        const auto* begin = gridded.data() + task * InsertBatchSize;
+        const auto* end = gridded.data() + std::min((task + 1) * InsertBatchSize, gridded.size());
+        auto& entries = grid->entriesPerTask[task];
+        pool->addTask([&bounds, begin, end, inverseCellSize, &entries]() {
+            insertColliders(bounds, begin, end, inverseCellSize, entries);
+        });
+    }
+    pool->wait();
+
+    // Merge the sorted lists, so that the entries of each cell become contiguous.
+    auto& entries = grid->entries;
+    entries.clear();
+    for (std::size_t task = 0; task < insertTasks; ++task)
+    {
+        auto middle = static_cast<std::ptrdiff_t>(entries.size());
+        entries.insert(entries.end(), grid->entriesPerTask[task].begin(), grid->entriesPerTask[task].end());
+        std::inplace_merge(entries.begin(), entries.begin() + middle, entries.end(), entryLess);
+    }
+
+    auto& cells = grid->cells;
+    cells.clear();
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        if (i == 0 || entries[i].cell != entries[i - 1].cell)
+        {
+            cells.push_back(i);
+        }
+    }
+    auto cellCount = cells.size();
+    cells.push_back(entries.size());
+
+    // Test the colliders in each cell in parallel.
+    auto cellTasks = (cellCount + CellBatchSize - 1) / CellBatchSize;
+    if (grid->pairsPerTask.size() < cellTasks)
+    {
+        grid->pairsPerTask.resize(cellTasks);
+    }
+
+    for (std::size_t task = 0; task < cellTasks; ++task)
+    {
+        const auto* begin = cells.data() + task * CellBatchSize;
+        const auto* end = cells.data() + std::min((task + 1) * CellBatchSize, cellCount);
+        auto& pairs = grid->pairsPerTask[task];
+        pool->addTask([&bounds, &entries, begin, end, inverseCellSize, &pairs]() {
+            testCells(bounds, entries, begin, end, inverseCellSize, pairs);
+        });
+    }
+    pool->wait();
+
+    // Every pair is found again on each frame, so the candidates are rebuilt from scratch.
+    collisions->clearCandidates();
+
+    auto addCandidate = [&](std::uint32_t first, std::uint32_t second) {
+        auto type = getCollisionType(bounds.shapes[first], bounds.shapes[second]);
+        collisions->addCandidate(type, {bounds.entities[first], bounds.entities[second]});
+    };
+
+    for (std::size_t task = 0; task < cellTasks; ++task)
+    {
+        for (const auto& pair : grid->pairsPerTask[task])
+        {
+            addCandidate(pair.first, pair.second);
+        }
+    }
+
+    // Oversized colliders are few, so they are simply streamed against every other collider. Pairs
+    // of oversized colliders would be found from both sides, so only the lowest slot reports them.
+    std::vector<bool> isOversized(count, false);
+    for (auto slot : oversized)
+    {
+        isOversized[slot] = true;
+    }
+
+    std::vector<std::uint32_t> overlapping(count);
+    for (auto slot : oversized)
+    {
+        auto found = overlapRange(bounds, bounds.aabb(slot), 0, count, overlapping.data());
+        for (std::size_t i = 0; i < found; ++i)
+        {
+            auto other = overlapping[i];
+            if (other != slot && (!isOversized[other] || slot < other))
+            {
+                addCandidate(slot, other);
+            }
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/// @file
+/// @brief Uniform grid broad phase collision detection.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "broad_phase.hpp"
+
+namespace cubos::engine
+{
+    /// @brief Resource which stores the buffers used by the uniform grid broad phase, which are
+    /// rebuilt every frame but kept to avoid reallocating them.
+    struct BroadPhaseGrid
+    {
+        /// @brief Occupation of a cell by a collider.
+        struct Entry
+        {
+            std::uint64_t cell;     ///< Key of the cell.
+            std::uint32_t collider; ///< Slot of the collider in the mirrored bounds.
+        };
+
+        /// @brief Pair of overlapping colliders.
+        struct Pair
+        {
+            std::uint32_t first;  ///< Slot of the first collider.
+            std::uint32_t second; ///< Slot of the second collider.
+        };
+
+        /// @brief Side of each cell, derived from the average size of the colliders.
+        float cellSize = 1.0F;
+
+        std::vector<std::uint32_t> gridded;             ///< Slots which were inserted in the grid.
+        std::vector<std::uint32_t> oversized;           ///< Slots too large to insert in the grid.
+        std::vector<std::vector<Entry>> entriesPerTask; ///< Cell entries produced by each insertion task.
+        std::vector<Entry> entries;                     ///< Cell entries of every task, sorted by cell.
+        std::vector<std::size_t> cells;                 ///< Index of the first entry of each cell.
+        std::vector<std::vector<Pair>> pairsPerTask;    ///< Overlapping pairs found by each task.
+    };
+} // namespace cubos::engine
+
+using cubos::engine::BroadPhaseGrid;
+
+/// @brief Finds the collision candidates by inserting every collider in the cells of a uniform
+/// grid which its AABB covers, and testing the colliders which share a cell.
+///
+/// @details Colliders are inserted in parallel into per task lists, which are then merged and
+/// sorted by cell. A pair which shares multiple cells is only reported by the cell which contains
+/// the minimum corner of the intersection of both AABBs, so no set is needed to deduplicate them.
+/// Unbounded colliders, such as planes, and colliders which would cover too many cells are tested
+/// against every other collider instead. The AABBs are read from the mirrored bounds of the
+/// broad phase, and the candidate pairs of each cell are tested for overlap in batches.
+void findGridPairs(Write<BroadPhaseGrid> grid, Write<BroadPhaseCollisions> collisions, Write<ThreadPool> pool);
@@ -0,0 +1,333 @@
+#include <algorithm>
+
+#include <cubos/core/log.hpp>
+
+#include <cubos/engine/collisions/broad_phase_tree.hpp>
+
+using cubos::core::ecs::Entity;
+using cubos::engine::BroadPhaseTree;
+using cubos::engine::ColliderAABB;
+
+/// Extents are clamped to this value when computing costs, so that infinite AABBs, such as the
+/// ones of planes, don't turn them into NaNs.
+static const float MaxExtent = 1e12F;
+
+/// Gets the surface area of an AABB, which is the cost of visiting it in a query.
+static float area(const ColliderAABB& aabb)
+{
+    auto size = glm::min(aabb.max - aabb.min, glm::vec3{MaxExtent});
+    return 2.0F * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+/// Gets the smallest AABB which contains both AABBs.
+static ColliderAABB merge(const ColliderAABB& a, const ColliderAABB& b)
+{
+    return ColliderAABB{glm::min(a.min, b.min), glm::max(a.max, b.max)};
+}
+
+/// Checks whether an AABB is completely inside another.
+static bool encloses(const ColliderAABB& outer, const ColliderAABB& inner)
+{
+    return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::lessThanEqual(inner.max, outer.max));
+}
+
+bool BroadPhaseTree::update(Entity entity, const ColliderAABB& aabb)
+{
+    auto leaf = this->leaf(entity);
+    if (leaf != Null)
+    {
+        if (encloses(node(leaf).aabb, aabb))
+        {
+            return false;
+        }
+
+        this->removeLeaf(leaf);
+    }
+    else
+    {
+        if (mLeaves.size() <= entity.index)
+        {
+            mLeaves.resize(entity.index + 1, Null);
+        }
+
+        // The index may still be held by a previous generation of the entity, which must have
+        // been destroyed without being removed.
+        if (auto stale = mLeaves[entity.index]; stale != Null)
+        {
+            this->removeLeaf(stale);
+            this->release(stale);
+            mSize -= 1;
+        }
+
+        leaf = this->allocate();
+        node(leaf).entity = entity;
+        mLeaves[entity.index] = leaf;
+        mSize += 1;
+    }
+
+    node(leaf).aabb = ColliderAABB{aabb.min - glm::vec3{Margin}, aabb.max + glm::vec3{Margin}};
+    this->insertLeaf(leaf);
+    mMoved.push_back(entity);
+    return true;
+}
+
+void BroadPhaseTree::remove(Entity entity)
+{
+    auto leaf = this->leaf(entity);
+    if (leaf == Null)
+    {
+        return;
+    }
+
+    this->removeLeaf(leaf);
+    this->release(leaf);
+    mLeaves[entity.index] = Null;
+    mSize -= 1;
+}
+
+void BroadPhaseTree::clear()
+{
+    mNodes.clear();
+    mRoot = Null;
+    mFree = Null;
+    mLeaves.clear();
+    mMoved.clear();
+    mSize = 0;
+}
+
+bool BroadPhaseTree::contains(Entity entity) const
+{
+    return this->leaf(entity) != Null;
+}
+
+bool BroadPhaseTree::overlaps(Entity entity, Entity other) const
+{
+    auto leaf = this->leaf(entity);
+    auto otherLeaf = this->leaf(other);
+    return leaf != Null && otherLeaf != Null && node(leaf).aabb.overlaps(node(otherLeaf).aabb);
+}
+
+const ColliderAABB& BroadPhaseTree::aabb(Entity entity) const
+{
+    auto leaf = this->leaf(entity);
+    CUBOS_ASSERT(leaf != Null, "Entity is not in the broad phase tree");
+    return node(leaf).aabb;
+}
+
+const std::vector<Entity>& BroadPhaseTree::moved() const
+{
+    return mMoved;
+}
+
+void BroadPhaseTree::clearMoved()
+{
+    mMoved.clear();
+}
+
+std::size_t BroadPhaseTree::size() const
+{
+    return mSize;
+}
+
+int BroadPhaseTree::height() const
+{
+    return mRoot == Null ? 0 : node(mRoot).height + 1;
+}
+
+int BroadPhaseTree::allocate()
+{
+    if (mFree == Null)
+    {
+        mNodes.emplace_back();
+        return static_cast<int>(mNodes.size() - 1);
+    }
+
+    auto index = mFree;
+    mFree = node(index).parent;
+    node(index) = Node{};
+    return index;
+}
+
+void BroadPhaseTree::release(int index)
+{
+    node(index) = Node{};
+    node(index).parent = mFree;
+    node(index).height = -1;
+    mFree = index;
+}
+
+void BroadPhaseTree::insertLeaf(int leaf)
+{
+    if (mRoot == Null)
+    {
+        mRoot = leaf;
+        node(leaf).parent = Null;
+        return;
+    }
+
+    // Descend from the root, stopping when pairing the leaf with the current node is cheaper than
+    // pushing it further down. The cost of a tree is the sum of the areas of its internal nodes.
+    auto leafAABB = node(leaf).aabb;
+    auto sibling = mRoot;
+    while (!node(sibling).isLeaf())
+    {
+        const auto& current = node(sibling);
+        auto combinedArea = area(merge(current.aabb, leafAABB));
+
+        // Cost of creating a new parent for the current node and the leaf.
+        auto cost = 2.0F * combinedArea;
+
+        // Minimum cost added to the ancestors if the leaf goes further down.
+        auto inheritedCost = 2.0F * (combinedArea - area(current.aabb));
+
+        auto childCost = [&](int child) {
+            auto childArea = area(merge(node(child).aabb, leafAABB));
+            if (!node(child).isLeaf())
+            {
+                childArea -= area(node(child).aabb);
+            }
+            return childArea + inheritedCost;
+        };
+
+        auto leftCost = childCost(current.left);
+        auto rightCost = childCost(current.right);
+        if (cost < leftCost && cost < rightCost)
+        {
+            break;
+        }
+
+        sibling = leftCost < rightCost ? current.left : current.right;
+    }
+
+    // The new parent must be allocated before taking any references, as the pool may grow.
+    auto parent = this->allocate();
+    auto oldParent = node(sibling).parent;
+    this->replaceChild(oldParent, sibling, parent);
+    node(parent).parent = oldParent;
+    node(parent).left = sibling;
+    node(parent).right = leaf;
+    node(sibling).parent = parent;
+    node(leaf).parent = parent;
+
+    this->refit(parent);
+}
+
+void BroadPhaseTree::removeLeaf(int leaf)
+{
+    if (leaf == mRoot)
+    {
+        mRoot = Null;
+        return;
+    }
+
+    // The sibling takes the place of the parent, which is no longer needed.
+    auto parent = node(leaf).parent;
+    auto grandParent = node(parent).parent;
+    auto sibling = node(parent).left == leaf ? node(parent).right : node(parent).left;
+
+    this->replaceChild(grandParent, parent, sibling);
+    node(sibling).parent = grandParent;
+    node(leaf).parent = Null;
+    this->release(parent);
+    this->refit(grandParent);
+}
+
+void BroadPhaseTree::replaceChild(int parent, int oldChild, int newChild)
+{
+    if (parent == Null)
+    {
+        mRoot = newChild;
+    }
+    else if (node(parent).left == oldChild)
+    {
+        node(parent).left = newChild;
+    }
+    else
+    {
+        node(parent).right = newChild;
+    }
+}
+
+void BroadPhaseTree::fit(int index)
+{
+    auto& current = node(index);
+    current.aabb = merge(node(current.left).aabb, node(current.right).aabb);
+    current.height = 1 + std::max(node(current.left).height, node(current.right).height);
+}
+
+void BroadPhaseTree::refit(int index)
+{
+    while (index != Null)
+    {
+        index = this->balance(index);
+        this->fit(index);
+        index = node(index).parent;
+    }
+}
+
+int BroadPhaseTree::balance(int index)
+{
+    if (node(index).isLeaf())
+    {
+        return index;
+    }
+
+    auto left = node(index).left;
+    auto right = node(index).right;
+    auto difference = node(right).height - node(left).height;
+    if (difference >= -1 && difference <= 1)
+    {
+        return index;
+    }
+
+    // The taller child takes the place of the node, which becomes its child and adopts its
+    // shorter grandchild in place of the taller child. The taller grandchild stays with the
+    // promoted node.
+    auto promoted = difference > 1 ? right : left;
+    auto first = node(promoted).left;
+    auto second = node(promoted).right;
+    auto taller = node(first).height > node(second).height ? first : second;
+    auto shorter = taller == first ? second : first;
+
+    auto parent = node(index).parent;
+    this->replaceChild(parent, index, promoted);
+    node(promoted).parent = parent;
+    node(promoted).left = index;
+    node(promoted).right = taller;
+    node(index).parent = promoted;
+
+    if (promoted == right)
+    {
+        node(index).right = shorter;
+    }
+    else
+    {
+        node(index).left = shorter;
+    }
+    node(shorter).parent = index;
+
+    this->fit(index);
+    this->fit(promoted);
+    return promoted;
+}
+
+BroadPhaseTree::Node& BroadPhaseTree::node(int index)
+{
+    return mNodes[static_cast<std::size_t>(index)];
+}
+
+const BroadPhaseTree::Node& BroadPhaseTree::node(int index) const
+{
+    return mNodes[static_cast<std::size_t>(index)];
+}
+
+int BroadPhaseTree::leaf(Entity entity) const
+{
+    if (entity.index >= mLeaves.size())
+    {
+        return Null;
+    }
+
+    auto leaf = mLeaves[entity.index];
+    return leaf != Null && node(leaf).entity == entity ? leaf : Null;
+}
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cubos/core/geom/intersections.hpp>
+
+#include "continuous.hpp"
+
+using cubos::core::ecs::Entity;
+using cubos::core::geom::Convex;
+using cubos::core::geom::Plane;
+
+using CollisionType = BroadPhaseCollisions::CollisionType;
+
+/// Maximum number of pairs solved by a single task.
+static const std::size_t BatchSize = 64;
+
+/// Maximum number of conservative advancement steps taken for each pair.
+static const std::size_t MaxIterations = 64;
+
+/// Distance under which two shapes are considered to be touching.
+static const float Tolerance = 1e-3F;
+
+/// Approach speed under which two shapes are considered to not be approaching each other.
+static const float MinSpeed = 1e-6F;
+
+namespace
+{
+    /// @brief Motion of a collider during the last frame.
+    struct Motion
+    {
+        bool isPlane{false};    ///< Whether the collider is a plane, in which case it doesn't move.
+        Convex start;           ///< Convex shape of the collider on the previous frame.
+        Convex end;             ///< Convex shape of the collider on the current frame.
+        Plane plane;            ///< Plane of the collider, with its normal in world space.
+        glm::vec3 origin{0.0F}; ///< Point on the plane, in world space.
+        float radius{0.0F};     ///< Margin of the plane.
+    };
+
+    /// @brief Candidate pair whose time of impact is being found.
+    struct Pair
+    {
+        Entity entity;          ///< First entity.
+        Entity other;           ///< Second entity.
+        Motion motions[2];      ///< Motions of both entities.
+        bool hit{false};        ///< Whether the shapes start touching during the frame.
+        float time{0.0F};       ///< Time of impact, valid only if @ref hit is true.
+        glm::vec3 normal{0.0F}; ///< Normal at the time of impact, from the first entity to the second.
+        glm::vec3 point{0.0F};  ///< Contact point at the time of impact.
+    };
+} // namespace
+
+/// Gets the shape of a motion at a given time. Every point of the shape moves along a straight line.
+static Convex interpolate(const Motion& motion, float time)
+{
+    auto convex = motion.end;
+    convex.center = glm::mix(motion.start.center, motion.end.center, time);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        convex.axes[i] = glm::mix(motion.start.axes[i], motion.end.axes[i], time);
+    }
+    for (std::size_t i = 0; i < convex.pointCount; ++i)
+    {
+        convex.points[i] = glm::mix(motion.start.points[i], motion.end.points[i], time);
+    }
+    return convex;
+}
+
+/// Gets the vertices of the core of a shape. Shapes created from the same collider always list
+/// their vertices in the same order.
+static std::size_t vertices(const Convex& convex, glm::vec3 out[8])
+{
+    if (convex.isBox)
+    {
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            out[i] = convex.center;
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+                out[i] += ((i >> axis) & 1U) != 0 ? convex.axes[axis] : -convex.axes[axis];
+            }
+        }
+        return 8;
+    }
+
+    std::copy(convex.points, convex.points + convex.pointCount, out);
+    return convex.pointCount;
+}
+
+/// Gets the highest speed along a direction of the vertices of a motion. As every point of the
+/// core is a fixed combination of its vertices, no point of the core moves faster.
+static float maxSpeed(const Motion& motion, glm::vec3 direction)
+{
+    glm::vec3 start[8];
+    glm::vec3 end[8];
+    auto count = vertices(motion.start, start);
+    vertices(motion.end, end);
+
+    auto speed = 0.0F;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        speed = std::max(speed, glm::dot(end[i] - start[i], direction));
+    }
+    return speed;
+}
+
+/// Finds the time of impact between two convex shapes.
+static bool solveConvex(const Motion& a, const Motion& b, Pair& pair)
+{
+    auto time = 0.0F;
+    for (std::size_t i = 0; i < MaxIterations; ++i)
+    {
+        auto shapeA = interpolate(a, time);
+        auto shapeB = interpolate(b, time);
+        glm::vec3 pointA;
+        glm::vec3 pointB;
+        auto core = coreDistance(shapeA, shapeB, pointA, pointB);
+        auto distance = core - shapeA.radius - shapeB.radius;
+        if (distance <= Tolerance)
+        {
+            // Shapes which were already touching on the previous frame are left to the narrow phase.
+            if (time == 0.0F)
+            {
+                return false;
+            }
+
+            pair.time = time;
+            pair.point = pointA + pair.normal * shapeA.radius;
+            return true;
+        }
+
+        pair.normal = (pointB - pointA) / core;
+        auto speed = maxSpeed(a, pair.normal) + maxSpeed(b, -pair.normal);
+        if (speed <= MinSpeed)
+        {
+            return false;
+        }
+
+        time += distance / speed;
+        if (time > 1.0F)
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+/// Finds the time of impact between a convex shape and a plane, which is taken as static.
+static bool solvePlane(const Motion& a, const Motion& plane, Pair& pair)
+{
+    auto length = glm::length(plane.plane.normal);
+    if (length <= 0.0F)
+    {
+        return false;
+    }
+
+    auto normal = plane.plane.normal / length;
+    pair.normal = -normal;
+
+    auto time = 0.0F;
+    for (std::size_t i = 0; i < MaxIterations; ++i)
+    {
+        auto shape = interpolate(a, time);
+        auto support = shape.support(-normal);
+        auto distance = glm::dot(support - plane.origin, normal) - shape.radius - plane.radius;
+        if (distance <= Tolerance)
+        {
+            // Shapes which were already touching on the previous frame are left to the narrow phase.
+            if (time == 0.0F)
+            {
+                return false;
+            }
+
+            pair.time = time;
+            pair.point = support - normal * shape.radius;
+            return true;
+        }
+
+        auto speed = maxSpeed(a, -normal);
+        if (speed <= MinSpeed)
+        {
+            return false;
+        }
+
+        time += distance / speed;
+        if (time > 1.0F)
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+/// Finds the times of impact of a range of pairs.
+static void solveBatch(Pair* begin, Pair* end)
+{
+    for (auto* pair = begin; pair != end; ++pair)
+    {
+        const auto& a = pair->motions[0];
+        const auto& b = pair->motions[1];
+        if (b.isPlane)
+        {
+            pair->hit = solvePlane(a, b, *pair);
+        }
+        else if (a.isPlane)
+        {
+            pair->hit = solvePlane(b, a, *pair);
+            pair->normal = -pair->normal;
+        }
+        else
+        {
+            pair->hit = solveConvex(a, b, *pair);
+        }
+    }
+}
+
+void findImpacts(Query<OptRead<BoxCollider>, OptRead<CapsuleCollider>, OptRead<PlaneCollider>, OptRead<SimplexCollider>,
+                       Read<LocalToWorld>, OptRead<ContinuousCollider>>
+                     query,
+                 Read<BroadPhaseCollisions> collisions, Write<ThreadPool> pool, EventWriter<ImpactEvent> events)
+{
+    // Fetches the motion of an entity during the last frame. Done on this thread, as the query
+    // can't be shared with the tasks.
+    auto fetchMotion = [&](Entity entity, Motion& motion, bool& continuous) {
+        auto match = query[entity];
+        if (!match)
+        {
+            return false;
+        }
+
+        auto [box, capsule, plane, simplex, localToWorld, ccd] = *match;
+        continuous = ccd && ccd->hasPrevious;
+        const auto& previous = continuous ? ccd->previous : localToWorld->mat;
+        if (box)
+        {
+            motion.start = Convex::box(box->shape, previous * box->transform, box->margin);
+            motion.end = Convex::box(box->shape, localToWorld->mat * box->transform, box->margin);
+        }
+        else if (capsule)
+        {
+            motion.start = Convex::capsule(capsule->shape, previous * capsule->transform);
+            motion.end = Convex::capsule(capsule->shape, localToWorld->mat * capsule->transform);
+        }
+        else if (simplex)
+        {
+            motion.start = Convex::simplex(simplex->shape, glm::translate(previous, simplex->offset), simplex->margin);
+            motion.end =
+                Convex::simplex(simplex->shape, glm::translate(localToWorld->mat, simplex->offset), simplex->margin);
+        }
+        else if (plane)
+        {
+            motion.isPlane = true;
+            motion.plane.normal = glm::mat3(localToWorld->mat) * plane->shape.normal;
+            motion.origin = glm::vec3(localToWorld->mat * glm::vec4(plane->offset, 1.0F));
+            motion.radius = plane->margin;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+
+        return !motion.end.empty();
+    };
+
+    // Gather the candidates which include at least one continuous collider.
+    std::vector<Pair> pairs;
+    for (std::size_t type = 0; type < static_cast<std::size_t>(CollisionType::Count); ++type)
+    {
+        if (static_cast<CollisionType>(type) == CollisionType::PlanePlane)
+        {
+            continue;
+        }
+
+        for (const auto& [entity, other] : collisions->candidates(static_cast<CollisionType>(type)))
+        {
+            Pair pair{entity, other, {}, false, 0.0F, {}, {}};
+            bool continuous[2];
+            if (fetchMotion(entity, pair.motions[0], continuous[0]) &&
+                fetchMotion(other, pair.motions[1], continuous[1]) && (continuous[0] || continuous[1]))
+            {
+                pairs.push_back(pair);
+            }
+        }
+    }
+
+    if (pairs.size() <= BatchSize)
+    {
+        // Not worth waking up the pool.
+        solveBatch(pairs.data(), pairs.data() + pairs.size());
+    }
+    else
+    {
+        for (std::size_t begin = 0; begin < pairs.size(); begin += BatchSize)
+        {
+            auto* first = pairs.data() + begin;
+            auto* last = pairs.data() + std::min(begin + BatchSize, pairs.size());
+            pool->addTask([first, last]() { solveBatch(first, last); });
+        }
+        pool->wait();
+    }
+
+    for (const auto& pair : pairs)
+    {
+        if (pair.hit)
+        {
+            events.push({pair.entity, pair.other, pair.time, pair.normal, pair.point});
+        }
+    }
+}
+
+void storePreviousTransforms(Query<Read<LocalToWorld>, Write<ContinuousCollider>> query)
+{
+    for (auto [entity, localToWorld, continuous] : query)
+    {
+        continuous->previous = localToWorld->mat;
+        continuous->hasPrevious = true;
+    }
+}
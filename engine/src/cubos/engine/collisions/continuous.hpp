@@ -0,0 +1,51 @@
+/// @file
+/// @brief Continuous collision detection systems.
+
+#pragma once
+
+#include <cubos/core/ecs/event_writer.hpp>
+#include <cubos/core/ecs/query.hpp>
+#include <cubos/core/thread_pool.hpp>
+
+#include <cubos/engine/collisions/broad_phase_collisions.hpp>
+#include <cubos/engine/collisions/colliders/box.hpp>
+#include <cubos/engine/collisions/colliders/capsule.hpp>
+#include <cubos/engine/collisions/colliders/plane.hpp>
+#include <cubos/engine/collisions/colliders/simplex.hpp>
+#include <cubos/engine/collisions/continuous_collider.hpp>
+#include <cubos/engine/collisions/impact_event.hpp>
+#include <cubos/engine/transform/plugin.hpp>
+
+using cubos::core::ThreadPool;
+using cubos::core::ecs::EventWriter;
+using cubos::core::ecs::OptRead;
+using cubos::core::ecs::Query;
+using cubos::core::ecs::Read;
+using cubos::core::ecs::Write;
+
+using cubos::engine::BoxCollider;
+using cubos::engine::BroadPhaseCollisions;
+using cubos::engine::CapsuleCollider;
+using cubos::engine::ContinuousCollider;
+using cubos::engine::ImpactEvent;
+using cubos::engine::LocalToWorld;
+using cubos::engine::PlaneCollider;
+using cubos::engine::SimplexCollider;
+
+/// @brief Finds the time of impact of the candidate pairs which include a continuous collider,
+/// sending an @ref ImpactEvent for each pair which starts touching during the frame.
+///
+/// @details Each point of a continuous collider moves along a straight line from its position on
+/// the previous frame to its current one, while other colliders are taken at their current
+/// transform. The time of impact is found by conservative advancement: the distance between the
+/// shapes divided by a bound on their approach speed is a step which can't skip past a contact.
+/// Transforms are interpolated linearly, which is accurate for the small rotations of a single
+/// frame, and planes are always taken as static. Pairs are split into batches, which are solved in
+/// parallel on the thread pool.
+void findImpacts(Query<OptRead<BoxCollider>, OptRead<CapsuleCollider>, OptRead<PlaneCollider>, OptRead<SimplexCollider>,
+                       Read<LocalToWorld>, OptRead<ContinuousCollider>>
+                     query,
+                 Read<BroadPhaseCollisions> collisions, Write<ThreadPool> pool, EventWriter<ImpactEvent> events);
+
+/// @brief Stores the current transform of every continuous collider, to sweep it on the next frame.
+void storePreviousTransforms(Query<Read<LocalToWorld>, Write<ContinuousCollider>> query);
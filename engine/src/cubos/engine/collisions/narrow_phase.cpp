@@ -0,0 +1,168 @@
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cubos/core/geom/intersections.hpp>
+
+#include "narrow_phase.hpp"
+
+using cubos::core::ecs::Entity;
+using cubos::core::geom::ContactManifold;
+using cubos::core::geom::Convex;
+using cubos::core::geom::Plane;
+
+using CollisionType = BroadPhaseCollisions::CollisionType;
+
+/// Maximum number of candidate pairs tested by a single task.
+static const std::size_t BatchSize = 64;
+
+namespace
+{
+    /// @brief World space shape of a collider, as tested by the narrow phase.
+    struct Shape
+    {
+        bool isPlane{false};    ///< Whether the collider is a plane, in which case @ref convex is unused.
+        Convex convex;          ///< Convex shape of the collider.
+        Plane plane;            ///< Plane of the collider, with its normal in world space.
+        glm::vec3 origin{0.0F}; ///< Point on the plane, in world space.
+        float radius{0.0F};     ///< Margin of the plane.
+    };
+
+    /// @brief Candidate pair being tested by the narrow phase.
+    struct Pair
+    {
+        Entity entity;            ///< First entity.
+        Entity other;             ///< Second entity.
+        Shape shapes[2];          ///< Shapes of both entities.
+        bool colliding{false};    ///< Whether the shapes intersect.
+        ContactManifold manifold; ///< Contact manifold, valid only if @ref colliding is true.
+    };
+} // namespace
+
+/// Tests whether two shapes intersect.
+static bool test(const Shape& a, const Shape& b, ContactManifold& manifold)
+{
+    if (a.isPlane && b.isPlane)
+    {
+        return false; // Planes are infinite, so their intersections are meaningless.
+    }
+
+    if (b.isPlane)
+    {
+        return intersects(a.convex, b.plane, b.origin, b.radius, manifold);
+    }
+
+    if (a.isPlane)
+    {
+        if (!intersects(b.convex, a.plane, a.origin, a.radius, manifold))
+        {
+            return false;
+        }
+
+        manifold.normal = -manifold.normal;
+        return true;
+    }
+
+    return intersects(a.convex, b.convex, manifold);
+}
+
+/// Tests a range of candidate pairs.
+static void testBatch(Pair* begin, Pair* end)
+{
+    for (auto* pair = begin; pair != end; ++pair)
+    {
+        pair->colliding = test(pair->shapes[0], pair->shapes[1], pair->manifold);
+    }
+}
+
+void narrowPhase(Query<OptRead<BoxCollider>, OptRead<CapsuleCollider>, OptRead<PlaneCollider>, OptRead<SimplexCollider>,
+                       Read<LocalToWorld>>
+                     query,
+                 Read<BroadPhaseCollisions> collisions, Write<ThreadPool> pool, EventWriter<CollisionEvent> events)
+{
+    // Fetches the world space shape of an entity. Done on this thread, as the query can't be
+    // shared with the tasks.
+    auto fetchShape = [&](Entity entity, Shape& shape) {
+        auto match = query[entity];
+        if (!match)
+        {
+            return false;
+        }
+
+        auto [box, capsule, plane, simplex, localToWorld] = *match;
+        if (box)
+        {
+            shape.convex = Convex::box(box->shape, localToWorld->mat * box->transform, box->margin);
+        }
+        else if (capsule)
+        {
+            shape.convex = Convex::capsule(capsule->shape, localToWorld->mat * capsule->transform);
+        }
+        else if (simplex)
+        {
+            shape.convex =
+                Convex::simplex(simplex->shape, glm::translate(localToWorld->mat, simplex->offset), simplex->margin);
+        }
+        else if (plane)
+        {
+            shape.isPlane = true;
+            shape.plane.normal = glm::mat3(localToWorld->mat) * plane->shape.normal;
+            shape.origin = glm::vec3(localToWorld->mat * glm::vec4(plane->offset, 1.0F));
+            shape.radius = plane->margin;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    };
+
+    // Gather the candidates, keeping the pairs of each collision type contiguous so that every
+    // batch only holds a single type.
+    std::vector<Pair> pairs;
+    std::vector<std::size_t> typeEnds;
+    for (std::size_t type = 0; type < static_cast<std::size_t>(CollisionType::Count); ++type)
+    {
+        if (static_cast<CollisionType>(type) != CollisionType::PlanePlane)
+        {
+            for (const auto& [entity, other] : collisions->candidates(static_cast<CollisionType>(type)))
+            {
+                Pair pair{entity, other, {}, false, {}};
+                if (fetchShape(entity, pair.shapes[0]) && fetchShape(other, pair.shapes[1]))
+                {
+                    pairs.push_back(pair);
+                }
+            }
+        }
+
+        typeEnds.push_back(pairs.size());
+    }
+
+    if (pairs.size() <= BatchSize)
+    {
+        // Not worth waking up the pool.
+        testBatch(pairs.data(), pairs.data() + pairs.size());
+    }
+    else
+    {
+        std::size_t begin = 0;
+        for (auto end : typeEnds)
+        {
+            for (; begin < end; begin += BatchSize)
+            {
+                auto* first = pairs.data() + begin;
+                auto* last = pairs.data() + std::min(begin + BatchSize, end);
+                pool->addTask([first, last]() { testBatch(first, last); });
+            }
+            begin = end;
+        }
+        pool->wait();
+    }
+
+    for (const auto& pair : pairs)
+    {
+        if (pair.colliding)
+        {
+            events.push({pair.entity, pair.other, pair.manifold});
+        }
+    }
+}
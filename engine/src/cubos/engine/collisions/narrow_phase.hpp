@@ -0,0 +1,42 @@
+/// @file
+/// @brief Narrow phase collision detection system.
+
+#pragma once
+
+#include <cubos/core/ecs/event_writer.hpp>
+#include <cubos/core/ecs/query.hpp>
+#include <cubos/core/thread_pool.hpp>
+
+#include <cubos/engine/collisions/broad_phase_collisions.hpp>
+#include <cubos/engine/collisions/collision_event.hpp>
+#include <cubos/engine/collisions/colliders/box.hpp>
+#include <cubos/engine/collisions/colliders/capsule.hpp>
+#include <cubos/engine/collisions/colliders/plane.hpp>
+#include <cubos/engine/collisions/colliders/simplex.hpp>
+#include <cubos/engine/transform/plugin.hpp>
+
+using cubos::core::ThreadPool;
+using cubos::core::ecs::EventWriter;
+using cubos::core::ecs::OptRead;
+using cubos::core::ecs::Query;
+using cubos::core::ecs::Read;
+using cubos::core::ecs::Write;
+
+using cubos::engine::BoxCollider;
+using cubos::engine::BroadPhaseCollisions;
+using cubos::engine::CapsuleCollider;
+using cubos::engine::CollisionEvent;
+using cubos::engine::LocalToWorld;
+using cubos::engine::PlaneCollider;
+using cubos::engine::SimplexCollider;
+
+/// @brief Tests the candidate pairs found by the broad phase, sending a @ref CollisionEvent for
+/// each pair which is actually colliding.
+///
+/// @details The candidates of each collision type are split into batches, which are tested in
+/// parallel on the thread pool. Events are only sent after every batch finishes, from the calling
+/// thread.
+void narrowPhase(Query<OptRead<BoxCollider>, OptRead<CapsuleCollider>, OptRead<PlaneCollider>, OptRead<SimplexCollider>,
+                       Read<LocalToWorld>>
+                     query,
+                 Read<BroadPhaseCollisions> collisions, Write<ThreadPool> pool, EventWriter<CollisionEvent> events);
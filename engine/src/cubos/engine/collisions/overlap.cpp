@@ -0,0 +1,194 @@
+#include <bit>
+
+#if defined(__AVX2__)
+#define CUBOS_OVERLAP_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CUBOS_OVERLAP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define CUBOS_OVERLAP_NEON
+#include <arm_neon.h>
+#endif
+
+#include "overlap.hpp"
+
+using cubos::engine::BroadPhaseCollisions;
+using cubos::engine::ColliderAABB;
+
+using Bounds = BroadPhaseCollisions::Bounds;
+
+#ifdef CUBOS_OVERLAP_AVX2
+/// Number of AABBs tested at once.
+static const std::size_t Lanes = 8;
+#else
+/// Number of AABBs tested at once.
+static const std::size_t Lanes = 4;
+#endif
+
+/// Tests lane by lane whether the AABBs of two groups overlap. Each group is given by pointers to
+/// @ref Lanes contiguous bounds per axis.
+/// @return Mask with the bit of each overlapping lane set.
+static unsigned overlapLanes(const float* const aMin[3], const float* const aMax[3], const float* const bMin[3],
+                             const float* const bMax[3])
+{
+#if defined(CUBOS_OVERLAP_AVX2)
+    auto mask = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        auto below = _mm256_cmp_ps(_mm256_loadu_ps(aMin[axis]), _mm256_loadu_ps(bMax[axis]), _CMP_LE_OQ);
+        auto above = _mm256_cmp_ps(_mm256_loadu_ps(aMax[axis]), _mm256_loadu_ps(bMin[axis]), _CMP_GE_OQ);
+        mask = _mm256_and_ps(mask, _mm256_and_ps(below, above));
+    }
+    return static_cast<unsigned>(_mm256_movemask_ps(mask));
+#elif defined(CUBOS_OVERLAP_SSE2)
+    auto mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        auto below = _mm_cmple_ps(_mm_loadu_ps(aMin[axis]), _mm_loadu_ps(bMax[axis]));
+        auto above = _mm_cmpge_ps(_mm_loadu_ps(aMax[axis]), _mm_loadu_ps(bMin[axis]));
+        mask = _mm_and_ps(mask, _mm_and_ps(below, above));
+    }
+    return static_cast<unsigned>(_mm_movemask_ps(mask));
+#elif defined(CUBOS_OVERLAP_NEON)
+    auto mask = vdupq_n_u32(0xFFFFFFFFU);
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        auto below = vcleq_f32(vld1q_f32(aMin[axis]), vld1q_f32(bMax[axis]));
+        auto above = vcgeq_f32(vld1q_f32(aMax[axis]), vld1q_f32(bMin[axis]));
+        mask = vandq_u32(mask, vandq_u32(below, above));
+    }
+
+    // NEON has no movemask, so each lane is shifted into its bit and the lanes are summed.
+    const uint32_t weights[4] = {1, 2, 4, 8};
+    return static_cast<unsigned>(vaddvq_u32(vandq_u32(mask, vld1q_u32(weights))));
+#else
+    unsigned mask = 0;
+    for (std::size_t lane = 0; lane < Lanes; ++lane)
+    {
+        bool overlaps = true;
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            overlaps = overlaps && aMin[axis][lane] <= bMax[axis][lane] && aMax[axis][lane] >= bMin[axis][lane];
+        }
+        mask |= static_cast<unsigned>(overlaps) << lane;
+    }
+    return mask;
+#endif
+}
+
+/// Tests whether two slots overlap, one at a time.
+static bool overlapSlots(const Bounds& bounds, std::uint32_t a, std::uint32_t b)
+{
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        if (bounds.min[axis][a] > bounds.max[axis][b] || bounds.max[axis][a] < bounds.min[axis][b])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void overlapPairs(const Bounds& bounds, const std::uint32_t* first, const std::uint32_t* second, std::size_t count,
+                  std::uint8_t* overlapping)
+{
+    // Pairs come from the sweep deltas or the tree, and reference scattered slots, so their bounds
+    // can't be streamed from the arrays and must be gathered.
+    std::size_t i = 0;
+#if defined(CUBOS_OVERLAP_AVX2)
+    // AVX2 gathers the bounds of a whole block of pairs with one instruction per array.
+    for (; i + Lanes <= count; i += Lanes)
+    {
+        auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+        auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + i));
+        auto mask = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            auto aMin = _mm256_i32gather_ps(bounds.min[axis].data(), a, 4);
+            auto aMax = _mm256_i32gather_ps(bounds.max[axis].data(), a, 4);
+            auto bMin = _mm256_i32gather_ps(bounds.min[axis].data(), b, 4);
+            auto bMax = _mm256_i32gather_ps(bounds.max[axis].data(), b, 4);
+            auto below = _mm256_cmp_ps(aMin, bMax, _CMP_LE_OQ);
+            auto above = _mm256_cmp_ps(aMax, bMin, _CMP_GE_OQ);
+            mask = _mm256_and_ps(mask, _mm256_and_ps(below, above));
+        }
+
+        auto bits = static_cast<unsigned>(_mm256_movemask_ps(mask));
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+            overlapping[i + lane] = static_cast<std::uint8_t>((bits >> lane) & 1U);
+        }
+    }
+#else
+    float gathered[4][3][Lanes];
+    const float* const aMin[3] = {gathered[0][0], gathered[0][1], gathered[0][2]};
+    const float* const aMax[3] = {gathered[1][0], gathered[1][1], gathered[1][2]};
+    const float* const bMin[3] = {gathered[2][0], gathered[2][1], gathered[2][2]};
+    const float* const bMax[3] = {gathered[3][0], gathered[3][1], gathered[3][2]};
+
+    for (; i + Lanes <= count; i += Lanes)
+    {
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            for (std::size_t lane = 0; lane < Lanes; ++lane)
+            {
+                gathered[0][axis][lane] = bounds.min[axis][first[i + lane]];
+                gathered[1][axis][lane] = bounds.max[axis][first[i + lane]];
+                gathered[2][axis][lane] = bounds.min[axis][second[i + lane]];
+                gathered[3][axis][lane] = bounds.max[axis][second[i + lane]];
+            }
+        }
+
+        auto mask = overlapLanes(aMin, aMax, bMin, bMax);
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+            overlapping[i + lane] = static_cast<std::uint8_t>((mask >> lane) & 1U);
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        overlapping[i] = static_cast<std::uint8_t>(overlapSlots(bounds, first[i], second[i]));
+    }
+}
+
+std::size_t overlapRange(const Bounds& bounds, const ColliderAABB& aabb, std::uint32_t begin, std::uint32_t end,
+                         std::uint32_t* slots)
+{
+    // The tested AABB is broadcast to every lane, while the range is streamed straight from the arrays.
+    float broadcast[2][3][Lanes];
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+            broadcast[0][axis][lane] = aabb.min[axis];
+            broadcast[1][axis][lane] = aabb.max[axis];
+        }
+    }
+    const float* const aMin[3] = {broadcast[0][0], broadcast[0][1], broadcast[0][2]};
+    const float* const aMax[3] = {broadcast[1][0], broadcast[1][1], broadcast[1][2]};
+
+    std::size_t count = 0;
+    auto slot = begin;
+    for (; slot + Lanes <= end; slot += static_cast<std::uint32_t>(Lanes))
+    {
+        const float* const bMin[3] = {&bounds.min[0][slot], &bounds.min[1][slot], &bounds.min[2][slot]};
+        const float* const bMax[3] = {&bounds.max[0][slot], &bounds.max[1][slot], &bounds.max[2][slot]};
+        for (auto mask = overlapLanes(aMin, aMax, bMin, bMax); mask != 0; mask &= mask - 1)
+        {
+            slots[count++] = slot + static_cast<std::uint32_t>(std::countr_zero(mask));
+        }
+    }
+
+    for (; slot < end; ++slot)
+    {
+        if (aabb.overlaps(bounds.aabb(slot)))
+        {
+            slots[count++] = slot;
+        }
+    }
+
+    return count;
+}
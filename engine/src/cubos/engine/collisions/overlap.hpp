@@ -0,0 +1,34 @@
+/// @file
+/// @brief Batched AABB overlap tests over @ref cubos::engine::BroadPhaseCollisions::Bounds.
+///
+/// @details The tests process several AABBs at once with SIMD instructions - AVX2 when the engine
+/// is compiled with it, SSE2 on other x86 targets and NEON on ARM - and fall back to scalar code
+/// on any other target.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <cubos/engine/collisions/aabb.hpp>
+#include <cubos/engine/collisions/broad_phase_collisions.hpp>
+
+/// @brief Tests pairs of slots for overlap.
+/// @param bounds Mirrored AABBs.
+/// @param first First slot of each pair.
+/// @param second Second slot of each pair.
+/// @param count Number of pairs.
+/// @param[out] overlapping Set to 1 for each pair which overlaps, and to 0 otherwise.
+void overlapPairs(const cubos::engine::BroadPhaseCollisions::Bounds& bounds, const std::uint32_t* first,
+                  const std::uint32_t* second, std::size_t count, std::uint8_t* overlapping);
+
+/// @brief Finds the slots in a range whose AABBs overlap an AABB.
+/// @param bounds Mirrored AABBs.
+/// @param aabb AABB to test.
+/// @param begin First slot of the range.
+/// @param end Slot after the last slot of the range.
+/// @param[out] slots Overlapping slots, which must have room for the whole range.
+/// @return Number of overlapping slots.
+std::size_t overlapRange(const cubos::engine::BroadPhaseCollisions::Bounds& bounds,
+                         const cubos::engine::ColliderAABB& aabb, std::uint32_t begin, std::uint32_t end,
+                         std::uint32_t* slots);
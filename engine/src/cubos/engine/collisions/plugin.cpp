@@ -1,20 +1,78 @@
+#include <string>
+
+#include <cubos/core/log.hpp>
+#include <cubos/core/settings.hpp>
+
 #include <cubos/engine/collisions/aabb.hpp>
 #include <cubos/engine/collisions/broad_phase_collisions.hpp>
+#include <cubos/engine/collisions/broad_phase_tree.hpp>
+#include <cubos/engine/collisions/collision_event.hpp>
+#include <cubos/engine/collisions/continuous_collider.hpp>
+#include <cubos/engine/collisions/impact_event.hpp>
 #include <cubos/engine/collisions/plugin.hpp>
 
 #include "broad_phase.hpp"
+#include "broad_phase_grid.hpp"
+#include "continuous.hpp"
+#include "narrow_phase.hpp"
+
+using cubos::core::Settings;
+
+using Backend = BroadPhaseCollisions::Backend;
+
+static void selectBroadPhase(Read<Settings> settings, Write<BroadPhaseCollisions> collisions)
+{
+    auto backend = settings->getString("collisions.broadPhase", "sweep");
+    if (backend == "tree")
+    {
+        collisions->backend = Backend::AABBTree;
+    }
+    else if (backend == "grid")
+    {
+        collisions->backend = Backend::HashGrid;
+    }
+    else
+    {
+        if (backend != "sweep")
+        {
+            CUBOS_WARN("Unknown broad phase backend '{}', using sweep and prune instead", backend);
+        }
+        collisions->backend = Backend::SweepAndPrune;
+    }
+}
+
+static bool usesSweepAndPrune(Read<BroadPhaseCollisions> collisions)
+{
+    return collisions->backend == Backend::SweepAndPrune;
+}
+
+static bool usesAABBTree(Read<BroadPhaseCollisions> collisions)
+{
+    return collisions->backend == Backend::AABBTree;
+}
+
+static bool usesHashGrid(Read<BroadPhaseCollisions> collisions)
+{
+    return collisions->backend == Backend::HashGrid;
+}
 
 void cubos::engine::collisionsPlugin(Cubos& cubos)
 {
     cubos.addPlugin(transformPlugin);
 
     cubos.addResource<BroadPhaseCollisions>();
+    cubos.addResource<BroadPhaseTree>();
+    cubos.addResource<BroadPhaseGrid>();
+
+    cubos.addEvent<CollisionEvent>();
+    cubos.addEvent<ImpactEvent>();
 
     cubos.addComponent<ColliderAABB>();
     cubos.addComponent<BoxCollider>();
     cubos.addComponent<SimplexCollider>();
     cubos.addComponent<CapsuleCollider>();
     cubos.addComponent<PlaneCollider>();
+    cubos.addComponent<ContinuousCollider>();
 
     cubos.system(addMissingAABBs<BoxCollider>).tagged("cubos.collisions.aabb.missing");
     cubos.system(addMissingAABBs<SimplexCollider>).tagged("cubos.collisions.aabb.missing");
@@ -27,9 +85,31 @@ void cubos::engine::collisionsPlugin(Cubos& cubos)
     cubos.system(updateSimplexAABBs).tagged("cubos.collisions.aabb");
     cubos.tag("cubos.collisions.aabb").after("cubos.transform.update");
 
+    cubos.startupSystem(selectBroadPhase).after("cubos.settings");
+
     cubos.system(updateMarkers).tagged("cubos.collisions.broad.markers").after("cubos.collisions.aabb");
     cubos.system(sweep).tagged("cubos.collisions.broad.sweep").after("cubos.collisions.broad.markers");
-    cubos.system(findPairs).tagged("cubos.collisions.broad").after("cubos.collisions.broad.sweep");
+    cubos.system(findPairs)
+        .tagged("cubos.collisions.broad")
+        .after("cubos.collisions.broad.sweep")
+        .runIf(usesSweepAndPrune);
+    cubos.tag("cubos.collisions.broad.markers").runIf(usesSweepAndPrune);
+    cubos.tag("cubos.collisions.broad.sweep").runIf(usesSweepAndPrune);
+
+    cubos.system(updateTree).tagged("cubos.collisions.broad.tree").after("cubos.collisions.aabb");
+    cubos.system(findTreePairs)
+        .tagged("cubos.collisions.broad")
+        .after("cubos.collisions.broad.tree")
+        .runIf(usesAABBTree);
+
+    cubos.system(findGridPairs).tagged("cubos.collisions.broad").after("cubos.collisions.aabb").runIf(usesHashGrid);
 
     cubos.tag("cubos.collisions.broad").before("cubos.collisions");
+
+    cubos.system(narrowPhase).tagged("cubos.collisions.narrow").after("cubos.collisions.broad");
+    cubos.tag("cubos.collisions.narrow").before("cubos.collisions");
+
+    cubos.system(findImpacts).tagged("cubos.collisions.impact").after("cubos.collisions.broad");
+    cubos.system(storePreviousTransforms).after("cubos.collisions.impact").before("cubos.collisions");
+    cubos.tag("cubos.collisions.impact").before("cubos.collisions");
 }
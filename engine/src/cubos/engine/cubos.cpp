@@ -1,13 +1,49 @@
+#include <algorithm>
 #include <utility>
 
 #include <cubos/core/ecs/commands.hpp>
 #include <cubos/core/log.hpp>
+#include <cubos/core/memory/standard_stream.hpp>
+#include <cubos/core/profiling/profiler.hpp>
 #include <cubos/core/settings.hpp>
 
 #include <cubos/engine/cubos.hpp>
 
 using namespace cubos::engine;
 
+/// Enables or disables profiling according to the settings. When profiling is disabled, writes
+/// the recorded zones to the file set in the settings.
+static void updateProfiling(const cubos::core::Settings& settings, bool exiting)
+{
+    namespace profiling = cubos::core::profiling;
+
+    bool enabled = !exiting && settings.getBool("profiling.enabled", false);
+    if (enabled == profiling::isEnabled())
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        profiling::clear();
+        profiling::setEnabled(true);
+        return;
+    }
+
+    profiling::setEnabled(false);
+    auto path = settings.getString("profiling.path", "profile.json");
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+    {
+        CUBOS_ERROR("Could not open profiling output file '{}'", path);
+        return;
+    }
+
+    cubos::core::memory::StandardStream stream(file, true);
+    profiling::exportChromeTrace(stream);
+    CUBOS_INFO("Wrote profiling trace to '{}'", path);
+}
+
 DeltaTime::DeltaTime(float value)
     : value(value)
 {
@@ -114,11 +150,17 @@ TagBuilder Cubos::startupTag(const std::string& tag)
 
 Cubos::Cubos()
 {
-    core::initializeLogger();
+    // Systems may log every frame, so logging must not block on the sinks, and repeated
+    // warnings must not flood them.
+    core::LoggerOptions logger{};
+    logger.async = true;
+    logger.rateLimit = 10;
+    core::initializeLogger(logger);
 
     this->addResource<DeltaTime>(0.0F);
     this->addResource<ShouldQuit>(true);
     this->addResource<cubos::core::Settings>();
+    this->addResource<cubos::core::ThreadPool>(std::max(1U, std::thread::hardware_concurrency()));
 }
 
 Cubos::Cubos(int argc, char** argv)
@@ -140,15 +182,25 @@ void Cubos::run()
 
     cubos::core::ecs::CommandBuffer cmds(mWorld);
 
-    mStartupDispatcher.callSystems(mWorld, cmds);
+    updateProfiling(mWorld.read<core::Settings>().get(), false);
+    {
+        CUBOS_PROFILE_ZONE("Startup");
+        mStartupDispatcher.callSystems(mWorld, cmds);
+    }
 
     auto currentTime = std::chrono::steady_clock::now();
     auto previousTime = std::chrono::steady_clock::now();
     do
     {
+        // Settings may be changed by systems, so profiling is toggled between frames.
+        updateProfiling(mWorld.read<core::Settings>().get(), false);
+
+        CUBOS_PROFILE_ZONE("Frame");
         mMainDispatcher.callSystems(mWorld, cmds);
         currentTime = std::chrono::steady_clock::now();
         mWorld.write<DeltaTime>().get().value = std::chrono::duration<float>(currentTime - previousTime).count();
         previousTime = currentTime;
     } while (!mWorld.read<ShouldQuit>().get().value);
+
+    updateProfiling(mWorld.read<core::Settings>().get(), true);
 }
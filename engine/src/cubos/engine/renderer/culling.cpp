@@ -0,0 +1,136 @@
+#include <cmath>
+
+#if defined(__AVX2__)
+#define CUBOS_CULLING_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CUBOS_CULLING_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define CUBOS_CULLING_NEON
+#include <arm_neon.h>
+#endif
+
+#include "culling.hpp"
+
+using DrawCmd = cubos::engine::RendererFrame::DrawCmd;
+
+#ifdef CUBOS_CULLING_AVX2
+/// Number of bounds tested at once.
+static const std::size_t Lanes = 8;
+#else
+/// Number of bounds tested at once.
+static const std::size_t Lanes = 4;
+#endif
+
+/// Tests lane by lane whether boxes intersect a frustum. A box is outside if it's entirely behind
+/// any of the planes, which happens when its center is further behind the plane than the box's
+/// projected radius along the plane's normal.
+/// @return Mask with the bit of each visible lane set.
+static unsigned cullLanes(const float center[3][Lanes], const float extent[3][Lanes], const glm::vec4 planes[6])
+{
+#if defined(CUBOS_CULLING_AVX2)
+    auto mask = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        auto distance = _mm256_set1_ps(planes[i].w);
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            auto normal = _mm256_set1_ps(planes[i][axis]);
+            auto absNormal = _mm256_set1_ps(std::abs(planes[i][axis]));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(normal, _mm256_loadu_ps(center[axis])));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(absNormal, _mm256_loadu_ps(extent[axis])));
+        }
+        mask = _mm256_and_ps(mask, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+    }
+    return static_cast<unsigned>(_mm256_movemask_ps(mask));
+#elif defined(CUBOS_CULLING_SSE2)
+    auto mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        auto distance = _mm_set1_ps(planes[i].w);
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            auto normal = _mm_set1_ps(planes[i][axis]);
+            auto absNormal = _mm_set1_ps(std::abs(planes[i][axis]));
+            distance = _mm_add_ps(distance, _mm_mul_ps(normal, _mm_loadu_ps(center[axis])));
+            distance = _mm_add_ps(distance, _mm_mul_ps(absNormal, _mm_loadu_ps(extent[axis])));
+        }
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+    }
+    return static_cast<unsigned>(_mm_movemask_ps(mask));
+#elif defined(CUBOS_CULLING_NEON)
+    auto mask = vdupq_n_u32(0xFFFFFFFFU);
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        auto distance = vdupq_n_f32(planes[i].w);
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            distance = vmlaq_n_f32(distance, vld1q_f32(center[axis]), planes[i][axis]);
+            distance = vmlaq_n_f32(distance, vld1q_f32(extent[axis]), std::abs(planes[i][axis]));
+        }
+        mask = vandq_u32(mask, vcgeq_f32(distance, vdupq_n_f32(0.0F)));
+    }
+
+    // NEON has no movemask, so each lane is shifted into its bit and the lanes are summed.
+    const uint32_t weights[4] = {1, 2, 4, 8};
+    return static_cast<unsigned>(vaddvq_u32(vandq_u32(mask, vld1q_u32(weights))));
+#else
+    unsigned mask = 0;
+    for (std::size_t lane = 0; lane < Lanes; ++lane)
+    {
+        bool visible = true;
+        for (std::size_t i = 0; i < 6; ++i)
+        {
+            auto distance = planes[i].w;
+            for (glm::length_t axis = 0; axis < 3; ++axis)
+            {
+                distance += planes[i][axis] * center[axis][lane] + std::abs(planes[i][axis]) * extent[axis][lane];
+            }
+            visible = visible && distance >= 0.0F;
+        }
+        mask |= static_cast<unsigned>(visible) << lane;
+    }
+    return mask;
+#endif
+}
+
+void frustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6])
+{
+    // Each plane is the sum or difference of the last row with one of the others.
+    auto row = [&](glm::length_t i) {
+        return glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+    };
+
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        planes[2 * axis] = row(3) + row(axis);
+        planes[2 * axis + 1] = row(3) - row(axis);
+    }
+}
+
+void cullDrawCmds(const glm::vec4 planes[6], const DrawCmd* drawCmds, std::size_t count, std::uint8_t* visible)
+{
+    // Draw commands store their bounds interleaved, so they're gathered into contiguous lanes first.
+    // The last group is padded with empty bounds at the origin, whose results are discarded.
+    float center[3][Lanes];
+    float extent[3][Lanes];
+    for (std::size_t i = 0; i < count; i += Lanes)
+    {
+        auto lanes = count - i < Lanes ? count - i : Lanes;
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+            for (glm::length_t axis = 0; axis < 3; ++axis)
+            {
+                center[axis][lane] = lane < lanes ? drawCmds[i + lane].center[axis] : 0.0F;
+                extent[axis][lane] = lane < lanes ? drawCmds[i + lane].extent[axis] : 0.0F;
+            }
+        }
+
+        auto mask = cullLanes(center, extent, planes);
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+        {
+            visible[i + lane] = static_cast<std::uint8_t>((mask >> lane) & 1U);
+        }
+    }
+}
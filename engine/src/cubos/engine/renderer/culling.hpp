@@ -0,0 +1,30 @@
+/// @file
+/// @brief Batched frustum culling of @ref cubos::engine::RendererFrame::DrawCmd bounds.
+///
+/// @details The tests process several draw commands at once with SIMD instructions - AVX2 when the
+/// engine is compiled with it, SSE2 on other x86 targets and NEON on ARM - and fall back to scalar
+/// code on any other target.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <cubos/engine/renderer/frame.hpp>
+
+/// @brief Extracts the planes of the frustum of a view projection matrix.
+/// @param viewProjection View projection matrix.
+/// @param[out] planes Planes, with their normals pointing inwards, as (a, b, c, d) such that the
+/// points inside satisfy a * x + b * y + c * z + d >= 0.
+void frustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+
+/// @brief Tests the bounds of a range of draw commands against a frustum.
+/// @param planes Frustum planes, as returned by @ref frustumPlanes.
+/// @param drawCmds Draw commands.
+/// @param count Number of draw commands.
+/// @param[out] visible Set to 1 for each draw command whose bounds intersect the frustum, and to
+/// 0 otherwise.
+void cullDrawCmds(const glm::vec4 planes[6], const cubos::engine::RendererFrame::DrawCmd* drawCmds, std::size_t count,
+                  std::uint8_t* visible);
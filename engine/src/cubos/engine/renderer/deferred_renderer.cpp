@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <random>
 
 #include <glm/gtc/matrix_transform.hpp>
@@ -23,26 +24,18 @@ struct DeferredGrid : public cubos::engine::impl::RendererGrid
     std::size_t indexCount;
 };
 
-/// Holds the model view matrix sent to the GPU.
-struct MVP
+/// Maximum number of instances drawn with a single draw call. Must match the size of the array in
+/// the Instances block of the geometry pass vertex shader, and fit in the 16 KiB every OpenGL
+/// implementation supports for uniform blocks.
+static const std::size_t MaxInstances = 256;
+
+/// Holds the view and projection matrices sent to the GPU.
+struct VP
 {
-    glm::mat4 m;
     glm::mat4 v;
     glm::mat4 p;
 };
 
-// Holds the data of a spot light, ready to be sent to the lighting pass pipeline.
-struct SpotLightData
-{
-    glm::vec4 position;
-    glm::mat4 rotation;
-    glm::vec4 color;
-    float intensity;
-    float range;
-    float spotCutoff;
-    float innerSpotCutoff;
-};
-
 // Holds the data of a directional light, ready to be sent to the lighting pass pipeline.
 struct DirectionalLightData
 {
@@ -52,28 +45,51 @@ struct DirectionalLightData
     float padding[3]; // Necessary to align the struct to a 16 byte boundary.
 };
 
-// Holds the data of a point light, ready to be sent to the lighting pass pipeline.
-struct PointLightData
-{
-    glm::vec4 position;
-    glm::vec4 color;
-    float intensity;
-    float range;
-    float padding[2]; // Necessary to align the struct to a 16 byte boundary.
-};
-
-/// Holds all of the light data sent to the lighting pass pipeline.
+/// Holds the ambient and directional light data sent to the lighting pass pipeline. Point and
+/// spot lights are sent through textures, as there can be any number of them.
 struct LightsData
 {
     glm::vec4 ambientLight;
-    SpotLightData spotLights[CUBOS_DEFERRED_RENDERER_MAX_SPOT_LIGHT_COUNT];
     DirectionalLightData directionalLights[CUBOS_DEFERRED_RENDERER_MAX_DIRECTIONAL_LIGHT_COUNT];
-    PointLightData pointLights[CUBOS_DEFERRED_RENDERER_MAX_POINT_LIGHT_COUNT];
-    uint32_t numSpotLights;
     uint32_t numDirectionalLights;
-    uint32_t numPointLights;
 };
 
+/// Width of the textures which hold the point and spot light data and the cluster light indices.
+/// Must match the value used in the lighting pass pixel shader.
+static const std::size_t LightTextureWidth = 1024;
+
+/// Number of texels holding the data of each point and spot light.
+static const std::size_t TexelsPerLight = 4;
+
+/// Uploads data to a texture with @ref LightTextureWidth texels per row, growing it if needed.
+/// @param device Render device used to create the texture.
+/// @param texture Texture to upload to.
+/// @param rows Number of rows of the texture, updated when it grows.
+/// @param format Format of the texture.
+/// @param data Texels to upload, padded to whole rows.
+template <typename T>
+static void uploadRows(RenderDevice& device, Texture2D& texture, std::size_t& rows, TextureFormat format,
+                       std::vector<T>& data)
+{
+    auto needed = std::max<std::size_t>(1, (data.size() + LightTextureWidth - 1) / LightTextureWidth);
+    data.resize(needed * LightTextureWidth);
+
+    // Grow geometrically, so that the texture isn't recreated every time a light is added.
+    if (rows < needed)
+    {
+        rows = std::max(needed, rows * 2);
+
+        Texture2DDesc desc;
+        desc.width = LightTextureWidth;
+        desc.height = rows;
+        desc.format = format;
+        desc.usage = Usage::Dynamic;
+        texture = device.createTexture2D(desc);
+    }
+
+    texture->update(0, 0, LightTextureWidth, needed, data.data());
+}
+
 /// The vertex shader of the geometry pass pipeline.
 static const char* geometryPassVs = R"glsl(
 #version 330 core
@@ -86,15 +102,20 @@ out vec3 fragPosition;
 out vec3 fragNormal;
 flat out uint fragMaterial;
 
-uniform MVP
+uniform VP
 {
-    mat4 M;
     mat4 V;
     mat4 P;
 };
 
+uniform Instances
+{
+    mat4 models[256];
+};
+
 void main()
 {
+    mat4 M = models[gl_InstanceID];
     vec4 worldPosition = M * vec4(position, 1.0);
     vec4 viewPosition = V * worldPosition;
     fragPosition = vec3(worldPosition);
@@ -167,17 +188,6 @@ uniform vec2 uvOffset;
 uniform mat4 invV;
 uniform mat4 invP;
 
-struct SpotLight
-{
-    vec4 position;
-    mat4 rotation;
-    vec4 color;
-    float intensity;
-    float range;
-    float spotCutoff;
-    float innerSpotCutoff;
-};
-
 struct DirectionalLight
 {
     mat4 rotation;
@@ -185,61 +195,75 @@ struct DirectionalLight
     float intensity;
 };
 
-struct PointLight
-{
-    vec4 position;
-    vec4 color;
-    float intensity;
-    float range;
-};
-
 layout(std140) uniform Lights
 {
     vec4 ambientLight;
-    SpotLight spotLights[128];
     DirectionalLight directionalLights[128];
-    PointLight pointLights[128];
-    uint numSpotLights;
     uint numDirectionalLights;
-    uint numPointLights;
 };
 
+// Point and spot lights, assigned to clusters of the view frustum.
+const uint lightTextureWidth = 1024u;
+uniform sampler2D lightData;
+uniform usampler2D lightClusters;
+uniform usampler2D lightIndices;
+uniform uvec3 clusterSize;
+uniform vec2 clusterDepth;
+uniform mat4 V;
+
 layout(location = 0) out vec4 color;
 
 float remap(float value, float min1, float max1, float min2, float max2) {
     return max2 + (value - min1) * (max2 - min2) / (max1 - min1);
 }
 
-vec3 spotLightCalc(vec3 fragPos, vec3 fragNormal, SpotLight light) {
-    vec3 toLight = vec3(light.position) - fragPos;
-    float r = length(toLight) / light.range;
-    if (r < 1) {
-        vec3 toLightNormalized = normalize(toLight);
-        float a = dot(toLightNormalized, -vec3(light.rotation * vec4(0,0,1,1)));
-        if (a > light.spotCutoff) {
-            float angleValue = clamp(remap(a, light.innerSpotCutoff, light.spotCutoff, 1, 0), 0, 1);
-            float attenuation = clamp(1.0 / (1.0 + 25.0 * r * r) * clamp((1 - r) * 5.0, 0, 1), 0 , 1);
-            float diffuse = max(dot(fragNormal, toLightNormalized), 0);
-            return angleValue * attenuation * diffuse * light.intensity * vec3(light.color);
+ivec2 texelAt(uint index)
+{
+    return ivec2(index % lightTextureWidth, index / lightTextureWidth);
+}
+
+// Each light takes four texels:
+// - position and range;
+// - color and intensity;
+// - direction and cosine of the spot angle;
+// - cosine of the inner spot angle, and whether the light is a spot light.
+vec3 clusteredLightCalc(vec3 fragPos, vec3 fragNormal, uint light) {
+    vec4 positionRange = texelFetch(lightData, texelAt(light * 4u), 0);
+    vec3 toLight = positionRange.xyz - fragPos;
+    float r = length(toLight) / positionRange.w;
+    if (r >= 1) {
+        return vec3(0);
+    }
+
+    vec4 colorIntensity = texelFetch(lightData, texelAt(light * 4u + 1u), 0);
+    vec4 spot = texelFetch(lightData, texelAt(light * 4u + 3u), 0);
+    vec3 toLightNormalized = normalize(toLight);
+    float angleValue = 1.0;
+    if (spot.y > 0.5) {
+        vec4 directionCutoff = texelFetch(lightData, texelAt(light * 4u + 2u), 0);
+        float a = dot(toLightNormalized, directionCutoff.xyz);
+        if (a <= directionCutoff.w) {
+            return vec3(0);
         }
+        angleValue = clamp(remap(a, spot.x, directionCutoff.w, 1, 0), 0, 1);
     }
-    return vec3(0);
+
+    float attenuation = clamp(1.0 / (1.0 + 25.0 * r * r) * clamp((1 - r) * 5.0, 0, 1), 0, 1);
+    float diffuse = max(dot(fragNormal, toLightNormalized), 0);
+    return angleValue * attenuation * diffuse * colorIntensity.w * colorIntensity.rgb;
 }
 
-vec3 directionalLightCalc(vec3 fragNormal, DirectionalLight light)
+uvec3 clusterOf(vec2 viewportUv, vec3 fragPos)
 {
-    return max(dot(fragNormal, -vec3(light.rotation * vec4(0,0,1,1))), 0) * light.intensity * vec3(light.color);
+    float depth = -(V * vec4(fragPos, 1.0)).z;
+    float slice = log(depth / clusterDepth.x) / log(clusterDepth.y / clusterDepth.x) * float(clusterSize.z);
+    uvec3 cluster = uvec3(clamp(viewportUv, 0.0, 1.0) * vec2(clusterSize.xy), uint(max(slice, 0.0)));
+    return min(cluster, clusterSize - 1u);
 }
 
-vec3 pointLightCalc(vec3 fragPos, vec3 fragNormal, PointLight light) {
-    vec3 toLight = vec3(light.position) - fragPos;
-    float r = length(toLight) / light.range;
-    if (r < 1) {
-        float attenuation = clamp(1.0 / (1.0 + 25.0 * r * r) * clamp((1 - r) * 5.0, 0, 1), 0, 1);
-        float diffuse = max(dot(fragNormal, vec3(normalize(toLight))), 0);
-        return attenuation * diffuse * light.intensity * vec3(light.color);
-    }
-    return vec3(0);
+vec3 directionalLightCalc(vec3 fragNormal, DirectionalLight light)
+{
+    return max(dot(fragNormal, -vec3(light.rotation * vec4(0,0,1,1))), 0) * light.intensity * vec3(light.color);
 }
 
 vec4 fetchAlbedo(uint material)
@@ -269,14 +293,13 @@ void main()
         vec3 lighting = ambientLight.rgb;
         vec3 fragPos = texture(position, fragUv).xyz;
         vec3 fragNormal = texture(normal, fragUv).xyz;
-        for (uint i = 0u; i < numSpotLights; i++) {
-            lighting += spotLightCalc(fragPos, fragNormal, spotLights[i]);
-        }
         for (uint i = 0u; i < numDirectionalLights; i++) {
             lighting += directionalLightCalc(fragNormal, directionalLights[i]);
         }
-        for (uint i = 0u; i < numPointLights; i++) {
-            lighting += pointLightCalc(fragPos, fragNormal, pointLights[i]);
+        uvec3 cluster = clusterOf((fragUv - uvOffset) / uvScale, fragPos);
+        uvec2 range = texelFetch(lightClusters, ivec2(cluster.x + cluster.y * clusterSize.x, cluster.z), 0).rg;
+        for (uint i = range.x; i < range.x + range.y; i++) {
+            lighting += clusteredLightCalc(fragPos, fragNormal, texelFetch(lightIndices, texelAt(i), 0).r);
         }
         color = vec4(albedo * lighting, 1.0);
         color.r = min(color.r, 1.0);
@@ -416,10 +439,12 @@ DeferredRenderer::DeferredRenderer(RenderDevice& renderDevice, glm::uvec2 size,
     auto geometryVS = mRenderDevice.createShaderStage(Stage::Vertex, geometryPassVs);
     auto geometryPS = mRenderDevice.createShaderStage(Stage::Pixel, geometryPassPs);
     mGeometryPipeline = mRenderDevice.createShaderPipeline(geometryVS, geometryPS);
-    mVpBp = mGeometryPipeline->getBindingPoint("MVP");
+    mVpBp = mGeometryPipeline->getBindingPoint("VP");
+    mInstancesBp = mGeometryPipeline->getBindingPoint("Instances");
 
-    // Create the MVP constant buffer.
-    mVpBuffer = renderDevice.createConstantBuffer(sizeof(MVP), nullptr, Usage::Dynamic);
+    // Create the VP and instances constant buffers.
+    mVpBuffer = renderDevice.createConstantBuffer(sizeof(VP), nullptr, Usage::Dynamic);
+    mInstancesBuffer = renderDevice.createConstantBuffer(MaxInstances * sizeof(glm::mat4), nullptr, Usage::Dynamic);
 
     // Create the lighting pipeline.
     auto lightingVS = mRenderDevice.createShaderStage(Stage::Vertex, lightingPassVs);
@@ -438,6 +463,12 @@ DeferredRenderer::DeferredRenderer(RenderDevice& renderDevice, glm::uvec2 size,
     mSkyGradientTopBp = mLightingPipeline->getBindingPoint("skyGradient[1]");
     mInvVBp = mLightingPipeline->getBindingPoint("invV");
     mInvPBp = mLightingPipeline->getBindingPoint("invP");
+    mVBp = mLightingPipeline->getBindingPoint("V");
+    mLightDataBp = mLightingPipeline->getBindingPoint("lightData");
+    mLightClustersBp = mLightingPipeline->getBindingPoint("lightClusters");
+    mLightIndicesBp = mLightingPipeline->getBindingPoint("lightIndices");
+    mClusterSizeBp = mLightingPipeline->getBindingPoint("clusterSize");
+    mClusterDepthBp = mLightingPipeline->getBindingPoint("clusterDepth");
 
     // Create the SSAO pipeline.
     auto ssaoVS = mRenderDevice.createShaderStage(Stage::Vertex, ssaoPassVs);
@@ -478,6 +509,14 @@ DeferredRenderer::DeferredRenderer(RenderDevice& renderDevice, glm::uvec2 size,
     // Create the lights constant buffer.
     mLightsBuffer = mRenderDevice.createConstantBuffer(sizeof(LightsData), nullptr, Usage::Dynamic);
 
+    // Create the light clusters texture, which holds the offset and count of the light indices of
+    // each cluster, with a row per slice.
+    texDesc.width = mLightClusters.size().x * mLightClusters.size().y;
+    texDesc.height = mLightClusters.size().z;
+    texDesc.format = TextureFormat::RG32UInt;
+    texDesc.usage = Usage::Dynamic;
+    mLightClustersTex = mRenderDevice.createTexture2D(texDesc);
+
     // Generate a screen quad for the lighting pass.
     generateScreenQuad(mRenderDevice, mLightingPipeline, mScreenQuadVa);
 
@@ -514,6 +553,18 @@ cubos::engine::RendererGrid DeferredRenderer::upload(const Grid& grid)
     std::vector<uint32_t> indices;
     triangulate(grid, vertices, indices);
 
+    // Store the bounds of the mesh, so that draws which can't be seen can be culled.
+    if (!vertices.empty())
+    {
+        deferredGrid->min = glm::vec3(vertices[0].position);
+        deferredGrid->max = glm::vec3(vertices[0].position);
+        for (const auto& vertex : vertices)
+        {
+            deferredGrid->min = glm::min(deferredGrid->min, glm::vec3(vertex.position));
+            deferredGrid->max = glm::max(deferredGrid->max, glm::vec3(vertex.position));
+        }
+    }
+
     // Create the vertex array, vertex buffer and index buffer.
     VertexArrayDesc vaDesc;
     vaDesc.elementCount = 3;
@@ -608,56 +659,34 @@ void DeferredRenderer::onResize(glm::uvec2 size)
 void DeferredRenderer::onRender(const Camera& camera, const RendererFrame& frame, Framebuffer target)
 {
     // Steps:
-    // 1. Prepare the MVP matrix.
-    // 2. Fill the light buffer with the light data.
+    // 1. Prepare the VP matrices.
+    // 2. Fill the light buffer and the light textures with the light data.
     // 3. Set the renderer state.
     // 4. Geometry pass:
     //   1. Set the geometry pass state.
     //   2. Clear the GBuffer.
-    //   3. For each draw command:
-    //     1. Update the MVP constant buffer with the model matrix.
-    //     2. Draw the geometry.
+    //   3. Group the visible draw commands by grid.
+    //   4. For each group of up to MaxInstances draw commands:
+    //     1. Update the instances constant buffer with the model matrices.
+    //     2. Draw the geometry once per instance.
     // 5. Lighting pass:
     //   1. Set the lighting pass state.
     //   2. Draw the screen quad.
 
-    // 1. Prepare the MVP matrix.
-    MVP mvp;
-    mvp.v = camera.view;
-    mvp.p = glm::perspective(glm::radians(camera.fovY), float(camera.viewportSize.x) / float(camera.viewportSize.y),
+    // 1. Prepare the VP matrices.
+    VP vp;
+    vp.v = camera.view;
+    vp.p = glm::perspective(glm::radians(camera.fovY), float(camera.viewportSize.x) / float(camera.viewportSize.y),
                              camera.zNear, camera.zFar);
 
     // 2. Fill the light buffer with the light data.
     // First map the buffer.
     LightsData& lightData = *static_cast<LightsData*>(mLightsBuffer->map());
-    lightData.numSpotLights = 0;
     lightData.numDirectionalLights = 0;
-    lightData.numPointLights = 0;
 
     // Set the ambient light.
     lightData.ambientLight = glm::vec4(frame.ambient(), 1.0F);
 
-    // Spotlights.
-    for (const auto& light : frame.spotLights())
-    {
-        if (lightData.numSpotLights >= CUBOS_DEFERRED_RENDERER_MAX_SPOT_LIGHT_COUNT)
-        {
-            CUBOS_WARN("Number of spot lights to be drawn "
-                       "this frame exceeds the maximum allowed ({}).",
-                       CUBOS_DEFERRED_RENDERER_MAX_SPOT_LIGHT_COUNT);
-            break;
-        }
-
-        lightData.spotLights[lightData.numSpotLights].position = glm::vec4(light.position, 1.0F);
-        lightData.spotLights[lightData.numSpotLights].rotation = glm::toMat4(light.rotation);
-        lightData.spotLights[lightData.numSpotLights].color = glm::vec4(light.color, 1.0F);
-        lightData.spotLights[lightData.numSpotLights].intensity = light.intensity;
-        lightData.spotLights[lightData.numSpotLights].range = light.range;
-        lightData.spotLights[lightData.numSpotLights].spotCutoff = glm::cos(light.spotAngle);
-        lightData.spotLights[lightData.numSpotLights].spotCutoff = glm::cos(light.innerSpotAngle);
-        lightData.numSpotLights += 1;
-    }
-
     // Directional lights.
     for (const auto& light : frame.directionalLights())
     {
@@ -675,25 +704,43 @@ void DeferredRenderer::onRender(const Camera& camera, const RendererFrame& frame
         lightData.numDirectionalLights += 1;
     }
 
-    // Point lights.
+    // Unmap the buffer.
+    mLightsBuffer->unmap();
+
+    // Point and spot lights, in the same order as their bounds, which are point lights first.
+    mLightTexels.clear();
+    mLightTexels.reserve(TexelsPerLight * (frame.pointLights().size() + frame.spotLights().size()));
     for (const auto& light : frame.pointLights())
     {
-        if (lightData.numPointLights >= CUBOS_DEFERRED_RENDERER_MAX_POINT_LIGHT_COUNT)
-        {
-            CUBOS_WARN("Number of point lights to be drawn "
-                       "this frame exceeds the maximum allowed ({}).",
-                       CUBOS_DEFERRED_RENDERER_MAX_POINT_LIGHT_COUNT);
-            break;
-        }
-        lightData.pointLights[lightData.numPointLights].position = glm::vec4(light.position, 1.0F);
-        lightData.pointLights[lightData.numPointLights].color = glm::vec4(light.color, 1.0F);
-        lightData.pointLights[lightData.numPointLights].intensity = light.intensity;
-        lightData.pointLights[lightData.numPointLights].range = light.range;
-        lightData.numPointLights += 1;
+        mLightTexels.emplace_back(light.position, light.range);
+        mLightTexels.emplace_back(light.color, light.intensity);
+        mLightTexels.emplace_back(0.0F);
+        mLightTexels.emplace_back(0.0F);
+    }
+    for (const auto& light : frame.spotLights())
+    {
+        mLightTexels.emplace_back(light.position, light.range);
+        mLightTexels.emplace_back(light.color, light.intensity);
+        mLightTexels.emplace_back(-(light.rotation * glm::vec3(0.0F, 0.0F, 1.0F)), glm::cos(light.spotAngle));
+        mLightTexels.emplace_back(glm::cos(light.innerSpotAngle), 1.0F, 0.0F, 0.0F);
     }
 
-    // Unmap the buffer.
-    mLightsBuffer->unmap();
+    // The frame only holds clusters if it was culled against this camera, otherwise they're
+    // assigned here.
+    const LightClusters* clusters = &frame.lightClusters();
+    if (!frame.isCulled())
+    {
+        frame.lightBounds(mLightBounds);
+        mLightClusters.assign(camera, mLightBounds);
+        clusters = &mLightClusters;
+    }
+
+    // Upload the light data and the light indices of each cluster.
+    uploadRows(mRenderDevice, mLightDataTex, mLightDataRows, TextureFormat::RGBA32Float, mLightTexels);
+    mLightIndices.assign(clusters->indices().begin(), clusters->indices().end());
+    uploadRows(mRenderDevice, mLightIndicesTex, mLightIndicesRows, TextureFormat::R32UInt, mLightIndices);
+    mLightClustersTex->update(0, 0, clusters->size().x * clusters->size().y, clusters->size().z,
+                              clusters->ranges().data());
 
     // 3. Set the renderer state.
     mRenderDevice.setViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x,
@@ -706,7 +753,10 @@ void DeferredRenderer::onRender(const Camera& camera, const RendererFrame& frame
     mRenderDevice.setBlendState(mGeometryBlendState);
     mRenderDevice.setDepthStencilState(mGeometryDepthStencilState);
     mRenderDevice.setShaderPipeline(mGeometryPipeline);
+    memcpy(mVpBuffer->map(), &vp, sizeof(VP));
+    mVpBuffer->unmap();
     mVpBp->bind(mVpBuffer);
+    mInstancesBp->bind(mInstancesBuffer);
 
     // 4.2. Clear the GBuffer.
     mRenderDevice.clearTargetColor(0, 0.0F, 0.0F, 0.0F, 1.0F);
@@ -714,19 +764,47 @@ void DeferredRenderer::onRender(const Camera& camera, const RendererFrame& frame
     mRenderDevice.clearTargetColor(2, 0.0F, 0.0F, 0.0F, 0.0F);
     mRenderDevice.clearDepth(1.0F);
 
-    // 4.3. For each draw command:
-    for (const auto& drawCmd : frame.drawCmds())
+    // 4.3. Group the visible draw commands by grid.
+    const auto& drawCmds = frame.drawCmds();
+    mDrawOrder.clear();
+    for (std::size_t i = 0; i < drawCmds.size(); ++i)
     {
-        // 4.3.1. Update the MVP constant buffer with the model matrix.
-        mvp.m = drawCmd.modelMat;
-        memcpy(mVpBuffer->map(), &mvp, sizeof(MVP));
-        mVpBuffer->unmap();
-
-        // 4.3.2. Draw the geometry.
-        auto grid = std::static_pointer_cast<DeferredGrid>(drawCmd.grid);
-        mRenderDevice.setVertexArray(grid->va);
-        mRenderDevice.setIndexBuffer(grid->ib);
-        mRenderDevice.drawTrianglesIndexed(0, grid->indexCount);
+        if (frame.isVisible(i))
+        {
+            mDrawOrder.push_back(i);
+        }
+    }
+
+    std::sort(mDrawOrder.begin(), mDrawOrder.end(), [&](std::size_t a, std::size_t b) {
+        return drawCmds[a].grid.get() < drawCmds[b].grid.get() ||
+               (drawCmds[a].grid.get() == drawCmds[b].grid.get() && a < b);
+    });
+
+    // 4.4. For each group of up to MaxInstances draw commands:
+    for (std::size_t begin = 0; begin < mDrawOrder.size();)
+    {
+        const auto& grid = drawCmds[mDrawOrder[begin]].grid;
+        auto end = begin + 1;
+        while (end < mDrawOrder.size() && end - begin < MaxInstances && drawCmds[mDrawOrder[end]].grid == grid)
+        {
+            ++end;
+        }
+
+        // 4.4.1. Update the instances constant buffer with the model matrices.
+        auto* models = static_cast<glm::mat4*>(mInstancesBuffer->map());
+        for (auto i = begin; i < end; ++i)
+        {
+            models[i - begin] = drawCmds[mDrawOrder[i]].modelMat;
+        }
+        mInstancesBuffer->unmap();
+
+        // 4.4.2. Draw the geometry once per instance.
+        auto deferredGrid = std::static_pointer_cast<DeferredGrid>(grid);
+        mRenderDevice.setVertexArray(deferredGrid->va);
+        mRenderDevice.setIndexBuffer(deferredGrid->ib);
+        mRenderDevice.drawTrianglesIndexedInstanced(0, deferredGrid->indexCount, end - begin);
+
+        begin = end;
     }
 
     // 5. SSAO pass.
@@ -744,8 +822,8 @@ void DeferredRenderer::onRender(const Camera& camera, const RendererFrame& frame
         mSsaoNormalBp->bind(mSampler);
         mSsaoNoiseBp->bind(mSsaoNoiseTex);
         mSsaoNoiseBp->bind(mSsaoNoiseSampler);
-        mSsaoViewBp->setConstant(mvp.v);
-        mSsaoProjectionBp->setConstant(mvp.p);
+        mSsaoViewBp->setConstant(vp.v);
+        mSsaoProjectionBp->setConstant(vp.p);
         mSsaoScreenSizeBp->setConstant(glm::vec2(mSize));
 
         // Samples
@@ -792,15 +870,24 @@ void DeferredRenderer::onRender(const Camera& camera, const RendererFrame& frame
                                        (float)camera.viewportPosition.y / (float)mSize.y));
     mSkyGradientBottomBp->setConstant(frame.skyGradient(0));
     mSkyGradientTopBp->setConstant(frame.skyGradient(1));
-    mInvVBp->setConstant(glm::inverse(mvp.v));
-    mInvPBp->setConstant(glm::inverse(mvp.p));
+    mInvVBp->setConstant(glm::inverse(vp.v));
+    mInvPBp->setConstant(glm::inverse(vp.p));
+    mVBp->setConstant(vp.v);
+    mLightDataBp->bind(mLightDataTex);
+    mLightDataBp->bind(mSampler);
+    mLightClustersBp->bind(mLightClustersTex);
+    mLightClustersBp->bind(mSampler);
+    mLightIndicesBp->bind(mLightIndicesTex);
+    mLightIndicesBp->bind(mSampler);
+    mClusterSizeBp->setConstant(clusters->size());
+    mClusterDepthBp->setConstant(glm::vec2(camera.zNear, camera.zFar));
 
     // 6.3. Draw the screen quad.
     mRenderDevice.setVertexArray(mScreenQuadVa);
     mRenderDevice.drawTriangles(0, 6);
 
     /// FIXME: This should not be on production code.
-    core::gl::Debug::flush(mvp.p * mvp.v, 1 / 60.0F);
+    core::gl::Debug::flush(vp.p * vp.v, 1 / 60.0F);
 
     // Provide custom inputs to the PPS manager.
     this->pps().provideInput(PostProcessingInput::Position, mPositionTex);
@@ -1,16 +1,39 @@
+#include <algorithm>
+#include <cmath>
 #include <utility>
 
+#include <glm/gtc/matrix_transform.hpp>
+
 #include <cubos/engine/renderer/frame.hpp>
 
+#include "culling.hpp"
+
+using cubos::core::ThreadPool;
+using cubos::core::gl::Camera;
 using cubos::core::gl::DirectionalLight;
 using cubos::core::gl::PointLight;
 using cubos::core::gl::SpotLight;
+using cubos::engine::LightClusters;
 using cubos::engine::RendererFrame;
 using cubos::engine::RendererGrid;
 
+/// Maximum number of draw commands culled by a single task.
+static const std::size_t CullBatchSize = 1024;
+
 void RendererFrame::draw(RendererGrid grid, glm::mat4 modelMat)
 {
-    mDrawCmds.push_back(DrawCmd{std::move(grid), modelMat});
+    // Transform the grid's bounding box into an axis aligned box in world space.
+    auto center = (grid->min + grid->max) * 0.5F;
+    auto extent = (grid->max - grid->min) * 0.5F;
+    glm::vec3 worldExtent{0.0F};
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        worldExtent[axis] = std::abs(modelMat[0][axis]) * extent.x + std::abs(modelMat[1][axis]) * extent.y +
+                            std::abs(modelMat[2][axis]) * extent.z;
+    }
+
+    auto worldCenter = glm::vec3(modelMat * glm::vec4(center, 1.0F));
+    mDrawCmds.push_back(DrawCmd{std::move(grid), modelMat, worldCenter, worldExtent});
 }
 
 void RendererFrame::ambient(const glm::vec3& color)
@@ -39,9 +62,41 @@ void RendererFrame::light(const PointLight& light)
     mPointLights.push_back(light);
 }
 
+void RendererFrame::cull(const Camera& camera, ThreadPool& pool)
+{
+    // Same projection as the one used by the renderer.
+    auto aspect = static_cast<float>(camera.viewportSize.x) / static_cast<float>(camera.viewportSize.y);
+    auto projection = glm::perspective(glm::radians(camera.fovY), aspect, camera.zNear, camera.zFar);
+    glm::vec4 planes[6];
+    frustumPlanes(projection * camera.view, planes);
+
+    this->lightBounds(mLightBounds);
+    mLightClusters.assign(camera, mLightBounds, pool);
+    mCulled = true;
+
+    mVisible.resize(mDrawCmds.size());
+    if (mDrawCmds.size() <= CullBatchSize)
+    {
+        // Not worth waking up the pool.
+        cullDrawCmds(planes, mDrawCmds.data(), mDrawCmds.size(), mVisible.data());
+        return;
+    }
+
+    for (std::size_t begin = 0; begin < mDrawCmds.size(); begin += CullBatchSize)
+    {
+        auto count = std::min(CullBatchSize, mDrawCmds.size() - begin);
+        const auto* drawCmds = mDrawCmds.data() + begin;
+        auto* visible = mVisible.data() + begin;
+        pool.addTask([planes, drawCmds, count, visible]() { cullDrawCmds(planes, drawCmds, count, visible); });
+    }
+    pool.wait();
+}
+
 void RendererFrame::clear()
 {
     mDrawCmds.clear();
+    mVisible.clear();
+    mCulled = false;
     mSpotLights.clear();
     mDirectionalLights.clear();
     mPointLights.clear();
@@ -52,6 +107,37 @@ const std::vector<RendererFrame::DrawCmd>& RendererFrame::drawCmds() const
     return mDrawCmds;
 }
 
+bool RendererFrame::isVisible(std::size_t drawCmd) const
+{
+    return !mCulled || drawCmd >= mVisible.size() || mVisible[drawCmd] != 0;
+}
+
+bool RendererFrame::isCulled() const
+{
+    return mCulled;
+}
+
+const LightClusters& RendererFrame::lightClusters() const
+{
+    return mLightClusters;
+}
+
+void RendererFrame::lightBounds(std::vector<LightClusters::Bounds>& bounds) const
+{
+    bounds.clear();
+    for (const auto& light : mPointLights)
+    {
+        bounds.push_back({light.position, light.range});
+    }
+
+    // Spot lights are bounded by the sphere around their whole range, which is good enough for
+    // the narrow cones they're usually given.
+    for (const auto& light : mSpotLights)
+    {
+        bounds.push_back({light.position, light.range});
+    }
+}
+
 const glm::vec3& RendererFrame::ambient() const
 {
     return mAmbientColor;
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <cubos/engine/renderer/light_clusters.hpp>
+
+using cubos::core::ThreadPool;
+using cubos::core::gl::Camera;
+using cubos::engine::LightClusters;
+
+/// Number of slices assigned by a single task.
+static const std::uint32_t SlicesPerTask = 4;
+
+/// Number of lights under which the clusters are assigned on a single thread.
+static const std::size_t MinParallelLights = 32;
+
+/// Gets the tile which contains a coordinate in normalized device space, clamped to the grid.
+static std::uint32_t tileOf(float ndc, std::uint32_t tiles)
+{
+    auto tile = std::floor((ndc + 1.0F) * 0.5F * static_cast<float>(tiles));
+    return static_cast<std::uint32_t>(std::clamp(tile, 0.0F, static_cast<float>(tiles - 1)));
+}
+
+/// Checks whether a sphere intersects an axis aligned box.
+static bool intersects(glm::vec3 center, float radius, glm::vec3 min, glm::vec3 max)
+{
+    auto closest = glm::clamp(center, min, max);
+    auto offset = center - closest;
+    return glm::dot(offset, offset) <= radius * radius;
+}
+
+LightClusters::LightClusters(glm::uvec3 size)
+    : mSize(size)
+    , mRanges(static_cast<std::size_t>(size.x) * size.y * size.z, Range{0, 0})
+{
+}
+
+glm::uvec3 LightClusters::size() const
+{
+    return mSize;
+}
+
+void LightClusters::assign(const Camera& camera, const std::vector<Bounds>& lights)
+{
+    this->prepare(camera, lights);
+    this->assignSlices(0, mSize.z);
+    this->merge();
+}
+
+void LightClusters::assign(const Camera& camera, const std::vector<Bounds>& lights, ThreadPool& pool)
+{
+    this->prepare(camera, lights);
+
+    if (mCandidates.size() <= MinParallelLights)
+    {
+        // Not worth waking up the pool.
+        this->assignSlices(0, mSize.z);
+    }
+    else
+    {
+        for (std::uint32_t begin = 0; begin < mSize.z; begin += SlicesPerTask)
+        {
+            auto end = std::min(begin + SlicesPerTask, mSize.z);
+            pool.addTask([this, begin, end]() { this->assignSlices(begin, end); });
+        }
+        pool.wait();
+    }
+
+    this->merge();
+}
+
+std::size_t LightClusters::index(glm::uvec3 cluster) const
+{
+    return cluster.x + static_cast<std::size_t>(mSize.x) * (cluster.y + static_cast<std::size_t>(mSize.y) * cluster.z);
+}
+
+glm::uvec3 LightClusters::clusterOf(glm::vec3 point) const
+{
+    auto depth = -point.z;
+    auto slice = std::floor(std::log(depth / mZNear) / std::log(mZFar / mZNear) * static_cast<float>(mSize.z));
+    return {tileOf(point.x / (depth * mTanHalfFov.x), mSize.x), tileOf(point.y / (depth * mTanHalfFov.y), mSize.y),
+            static_cast<std::uint32_t>(std::clamp(slice, 0.0F, static_cast<float>(mSize.z - 1)))};
+}
+
+void LightClusters::bounds(glm::uvec3 cluster, glm::vec3& min, glm::vec3& max) const
+{
+    // Slice depths grow exponentially, so that clusters keep roughly the same proportions.
+    auto ratio = mZFar / mZNear;
+    auto nearDepth = mZNear * std::pow(ratio, static_cast<float>(cluster.z) / static_cast<float>(mSize.z));
+    auto farDepth = mZNear * std::pow(ratio, static_cast<float>(cluster.z + 1) / static_cast<float>(mSize.z));
+
+    // Each side of a tile is a plane through the camera, so the box is bounded by the tile's
+    // corners on the near and far sides of the slice.
+    for (glm::length_t axis = 0; axis < 2; ++axis)
+    {
+        auto tiles = static_cast<float>(mSize[axis]);
+        auto low = (-1.0F + 2.0F * static_cast<float>(cluster[axis]) / tiles) * mTanHalfFov[axis];
+        auto high = (-1.0F + 2.0F * static_cast<float>(cluster[axis] + 1) / tiles) * mTanHalfFov[axis];
+        min[axis] = std::min(low * nearDepth, low * farDepth);
+        max[axis] = std::max(high * nearDepth, high * farDepth);
+    }
+
+    min.z = -farDepth;
+    max.z = -nearDepth;
+}
+
+const std::vector<LightClusters::Range>& LightClusters::ranges() const
+{
+    return mRanges;
+}
+
+const std::vector<std::uint32_t>& LightClusters::indices() const
+{
+    return mIndices;
+}
+
+void LightClusters::prepare(const Camera& camera, const std::vector<Bounds>& lights)
+{
+    auto aspect = static_cast<float>(camera.viewportSize.x) / static_cast<float>(camera.viewportSize.y);
+    auto tanHalfFovY = std::tan(glm::radians(camera.fovY) * 0.5F);
+    mTanHalfFov = {tanHalfFovY * aspect, tanHalfFovY};
+    mZNear = camera.zNear;
+    mZFar = camera.zFar;
+
+    mCandidates.clear();
+    for (std::size_t i = 0; i < lights.size(); ++i)
+    {
+        auto center = glm::vec3(camera.view * glm::vec4(lights[i].center, 1.0F));
+        auto radius = lights[i].radius;
+        auto nearDepth = std::max(-center.z - radius, mZNear);
+        auto farDepth = std::min(-center.z + radius, mZFar);
+        if (nearDepth > farDepth)
+        {
+            // The light is entirely in front of the near plane or behind the far plane.
+            continue;
+        }
+
+        Candidate candidate{static_cast<std::uint32_t>(i), center, radius, {}, {}};
+        candidate.min.z = this->clusterOf({0.0F, 0.0F, -nearDepth}).z;
+        candidate.max.z = this->clusterOf({0.0F, 0.0F, -farDepth}).z;
+
+        // The projection of a point is x / depth, which is extreme on the corners of the sphere's
+        // bounding box, as depths are positive.
+        bool visible = true;
+        for (glm::length_t axis = 0; axis < 2; ++axis)
+        {
+            auto lowest = std::numeric_limits<float>::infinity();
+            auto highest = -std::numeric_limits<float>::infinity();
+            for (auto depth : {nearDepth, farDepth})
+            {
+                for (auto coordinate : {center[axis] - radius, center[axis] + radius})
+                {
+                    auto ndc = coordinate / (depth * mTanHalfFov[axis]);
+                    lowest = std::min(lowest, ndc);
+                    highest = std::max(highest, ndc);
+                }
+            }
+
+            visible = visible && lowest <= 1.0F && highest >= -1.0F;
+            candidate.min[axis] = tileOf(lowest, mSize[axis]);
+            candidate.max[axis] = tileOf(highest, mSize[axis]);
+        }
+
+        if (visible)
+        {
+            mCandidates.push_back(candidate);
+        }
+    }
+
+    mSliceIndices.resize(mSize.z);
+}
+
+void LightClusters::assignSlices(std::uint32_t begin, std::uint32_t end)
+{
+    std::vector<const Candidate*> candidates;
+    for (auto z = begin; z < end; ++z)
+    {
+        candidates.clear();
+        for (const auto& candidate : mCandidates)
+        {
+            if (candidate.min.z <= z && z <= candidate.max.z)
+            {
+                candidates.push_back(&candidate);
+            }
+        }
+
+        // Offsets are relative to the slice until the slices are merged.
+        auto& indices = mSliceIndices[z];
+        indices.clear();
+        for (std::uint32_t y = 0; y < mSize.y; ++y)
+        {
+            for (std::uint32_t x = 0; x < mSize.x; ++x)
+            {
+                glm::vec3 min;
+                glm::vec3 max;
+                this->bounds({x, y, z}, min, max);
+
+                auto offset = static_cast<std::uint32_t>(indices.size());
+                for (const auto* candidate : candidates)
+                {
+                    if (candidate->min.x <= x && x <= candidate->max.x && candidate->min.y <= y &&
+                        y <= candidate->max.y && intersects(candidate->center, candidate->radius, min, max))
+                    {
+                        indices.push_back(candidate->light);
+                    }
+                }
+
+                mRanges[this->index({x, y, z})] = {offset, static_cast<std::uint32_t>(indices.size()) - offset};
+            }
+        }
+    }
+}
+
+void LightClusters::merge()
+{
+    mIndices.clear();
+    auto clustersPerSlice = static_cast<std::size_t>(mSize.x) * mSize.y;
+    for (std::uint32_t z = 0; z < mSize.z; ++z)
+    {
+        auto base = static_cast<std::uint32_t>(mIndices.size());
+        for (std::size_t i = 0; i < clustersPerSlice; ++i)
+        {
+            mRanges[z * clustersPerSlice + i].offset += base;
+        }
+        mIndices.insert(mIndices.end(), mSliceIndices[z].begin(), mSliceIndices[z].end());
+    }
+}
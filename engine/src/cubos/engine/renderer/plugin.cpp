@@ -14,6 +14,7 @@
 #include <cubos/engine/window/plugin.hpp>
 
 using cubos::core::Settings;
+using cubos::core::ThreadPool;
 using cubos::core::ecs::EventReader;
 using cubos::core::ecs::Query;
 using cubos::core::ecs::Read;
@@ -141,7 +142,7 @@ static void splitViewport(glm::ivec2 position, glm::ivec2 size, int count, cubos
 }
 
 static void draw(Write<Renderer> renderer, Read<ActiveCameras> activeCameras, Write<RendererFrame> frame,
-                 Query<Read<LocalToWorld>, Read<Camera>> query)
+                 Write<ThreadPool> pool, Query<Read<LocalToWorld>, Read<Camera>> query)
 {
     cubos::core::gl::Camera cameras[4]{};
     int cameraCount = 0;
@@ -173,6 +174,7 @@ static void draw(Write<Renderer> renderer, Read<ActiveCameras> activeCameras, Wr
 
     for (int i = 0; i < cameraCount; ++i)
     {
+        frame->cull(cameras[i], *pool);
         (*renderer)->render(cameras[i], *frame);
     }
 
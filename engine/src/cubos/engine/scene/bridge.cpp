@@ -22,18 +22,8 @@ bool SceneBridge::load(Assets& assets, const AnyAsset& handle)
         return false;
     }
 
-    // Dump the file contents into a string.
-    std::string contents;
-    stream->readUntil(contents, nullptr);
-    stream.reset(); // Close the file.
-
-    // Deserialize the scene file.
-    auto deserializer = data::JSONDeserializer(contents);
-    if (deserializer.failed())
-    {
-        CUBOS_ERROR("Could not parse scene file '{}' as JSON", path);
-        return false;
-    }
+    // Deserialize the scene file, parsing it as it is read.
+    auto deserializer = data::JSONDeserializer(*stream);
 
     auto scene = Scene();
 
@@ -123,6 +113,11 @@ bool SceneBridge::load(Assets& assets, const AnyAsset& handle)
     deserializer.endDictionary();
 
     deserializer.endObject();
+    if (deserializer.failed())
+    {
+        CUBOS_ERROR("Could not parse scene file '{}' as JSON", path);
+        return false;
+    }
 
     // Finally, write the scene to the asset.
     assets.store(handle, std::move(scene));
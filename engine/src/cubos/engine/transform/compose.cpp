@@ -0,0 +1,233 @@
+#if defined(__AVX2__)
+#define CUBOS_COMPOSE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CUBOS_COMPOSE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define CUBOS_COMPOSE_NEON
+#include <arm_neon.h>
+#endif
+
+#include "compose.hpp"
+
+#if defined(CUBOS_COMPOSE_AVX2)
+/// Number of matrices composed at once.
+static const std::size_t Lanes = 8;
+
+using Lane = __m256;
+
+static Lane load(const float* values)
+{
+    return _mm256_loadu_ps(values);
+}
+
+static Lane broadcast(float value)
+{
+    return _mm256_set1_ps(value);
+}
+
+static void store(float* values, Lane lane)
+{
+    _mm256_storeu_ps(values, lane);
+}
+
+static Lane add(Lane a, Lane b)
+{
+    return _mm256_add_ps(a, b);
+}
+
+static Lane sub(Lane a, Lane b)
+{
+    return _mm256_sub_ps(a, b);
+}
+
+static Lane mul(Lane a, Lane b)
+{
+    return _mm256_mul_ps(a, b);
+}
+#elif defined(CUBOS_COMPOSE_SSE2)
+/// Number of matrices composed at once.
+static const std::size_t Lanes = 4;
+
+using Lane = __m128;
+
+static Lane load(const float* values)
+{
+    return _mm_loadu_ps(values);
+}
+
+static Lane broadcast(float value)
+{
+    return _mm_set1_ps(value);
+}
+
+static void store(float* values, Lane lane)
+{
+    _mm_storeu_ps(values, lane);
+}
+
+static Lane add(Lane a, Lane b)
+{
+    return _mm_add_ps(a, b);
+}
+
+static Lane sub(Lane a, Lane b)
+{
+    return _mm_sub_ps(a, b);
+}
+
+static Lane mul(Lane a, Lane b)
+{
+    return _mm_mul_ps(a, b);
+}
+#elif defined(CUBOS_COMPOSE_NEON)
+/// Number of matrices composed at once.
+static const std::size_t Lanes = 4;
+
+using Lane = float32x4_t;
+
+static Lane load(const float* values)
+{
+    return vld1q_f32(values);
+}
+
+static Lane broadcast(float value)
+{
+    return vdupq_n_f32(value);
+}
+
+static void store(float* values, Lane lane)
+{
+    vst1q_f32(values, lane);
+}
+
+static Lane add(Lane a, Lane b)
+{
+    return vaddq_f32(a, b);
+}
+
+static Lane sub(Lane a, Lane b)
+{
+    return vsubq_f32(a, b);
+}
+
+static Lane mul(Lane a, Lane b)
+{
+    return vmulq_f32(a, b);
+}
+#else
+/// Number of matrices composed at once.
+static const std::size_t Lanes = 1;
+
+using Lane = float;
+
+static Lane load(const float* values)
+{
+    return *values;
+}
+
+static Lane broadcast(float value)
+{
+    return value;
+}
+
+static void store(float* values, Lane lane)
+{
+    *values = lane;
+}
+
+static Lane add(Lane a, Lane b)
+{
+    return a + b;
+}
+
+static Lane sub(Lane a, Lane b)
+{
+    return a - b;
+}
+
+static Lane mul(Lane a, Lane b)
+{
+    return a * b;
+}
+#endif
+
+/// Composes the scaled rotation parts of @ref Lanes matrices, written to @p basis as the three
+/// rows of each of the three columns, lane by lane.
+static void composeLanes(const float* x, const float* y, const float* z, const float* w, const float* s,
+                         float basis[9][Lanes])
+{
+    auto qx = load(x);
+    auto qy = load(y);
+    auto qz = load(z);
+    auto qw = load(w);
+    auto scale = load(s);
+    auto one = broadcast(1.0F);
+
+    // Same expansion of the quaternion as glm::toMat4.
+    auto x2 = add(qx, qx);
+    auto y2 = add(qy, qy);
+    auto z2 = add(qz, qz);
+    auto xx = mul(qx, x2);
+    auto yy = mul(qy, y2);
+    auto zz = mul(qz, z2);
+    auto xy = mul(qx, y2);
+    auto xz = mul(qx, z2);
+    auto yz = mul(qy, z2);
+    auto wx = mul(qw, x2);
+    auto wy = mul(qw, y2);
+    auto wz = mul(qw, z2);
+
+    store(basis[0], mul(sub(one, add(yy, zz)), scale));
+    store(basis[1], mul(add(xy, wz), scale));
+    store(basis[2], mul(sub(xz, wy), scale));
+    store(basis[3], mul(sub(xy, wz), scale));
+    store(basis[4], mul(sub(one, add(xx, zz)), scale));
+    store(basis[5], mul(add(yz, wx), scale));
+    store(basis[6], mul(add(xz, wy), scale));
+    store(basis[7], mul(sub(yz, wx), scale));
+    store(basis[8], mul(sub(one, add(xx, yy)), scale));
+}
+
+void composeTransforms(const float* const position[3], const float* const rotation[4], const float* scale,
+                       std::size_t count, glm::mat4* out)
+{
+    float basis[9][Lanes];
+    for (std::size_t i = 0; i < count; i += Lanes)
+    {
+        // The last group may be incomplete, in which case it's copied into a padded group first.
+        auto lanes = count - i < Lanes ? count - i : Lanes;
+        if (lanes == Lanes)
+        {
+            composeLanes(rotation[0] + i, rotation[1] + i, rotation[2] + i, rotation[3] + i, scale + i, basis);
+        }
+        else
+        {
+            float padded[5][Lanes] = {};
+            for (std::size_t lane = 0; lane < lanes; ++lane)
+            {
+                for (std::size_t j = 0; j < 4; ++j)
+                {
+                    padded[j][lane] = rotation[j][i + lane];
+                }
+                padded[4][lane] = scale[i + lane];
+            }
+            composeLanes(padded[0], padded[1], padded[2], padded[3], padded[4], basis);
+        }
+
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+        {
+            auto& mat = out[i + lane];
+            for (glm::length_t column = 0; column < 3; ++column)
+            {
+                for (glm::length_t row = 0; row < 3; ++row)
+                {
+                    mat[column][row] = basis[3 * column + row][lane];
+                }
+                mat[column][3] = 0.0F;
+            }
+            mat[3] = {position[0][i + lane], position[1][i + lane], position[2][i + lane], 1.0F};
+        }
+    }
+}
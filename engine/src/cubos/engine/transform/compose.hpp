@@ -0,0 +1,23 @@
+/// @file
+/// @brief Batched composition of transform matrices from their translation, rotation and scale.
+///
+/// @details The matrices are built directly from the components, without intermediate matrix
+/// products, processing several entities at once with SIMD instructions - AVX2 when the engine is
+/// compiled with it, SSE2 on other x86 targets and NEON on ARM - and falling back to scalar code
+/// on any other target.
+
+#pragma once
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+/// @brief Composes the transform matrices of a batch of entities, equivalent to translating,
+/// rotating and then scaling an identity matrix.
+/// @param position Pointers to the X, Y and Z coordinates of the positions.
+/// @param rotation Pointers to the X, Y, Z and W components of the rotation quaternions.
+/// @param scale Uniform scale factors.
+/// @param count Number of entities.
+/// @param[out] out Composed matrices.
+void composeTransforms(const float* const position[3], const float* const rotation[4], const float* scale,
+                       std::size_t count, glm::mat4* out);
@@ -0,0 +1,222 @@
+#include <cubos/core/log.hpp>
+
+#include "compose.hpp"
+#include "hierarchy.hpp"
+
+using cubos::core::ThreadPool;
+using cubos::core::ecs::Entity;
+using cubos::engine::TransformHierarchy;
+
+/// Minimum number of nodes propagated by a single task. Subtrees are never split between tasks.
+static const std::size_t BatchSize = 256;
+
+/// Number of local transforms composed together.
+static const std::size_t ChunkSize = 64;
+
+/// Recomputes the world matrices of the changed nodes in a range of the depth sorted order, which
+/// must hold whole subtrees, so that every parent is processed before its children.
+static void propagateRange(TransformHierarchy& hierarchy, std::size_t begin, std::size_t end)
+{
+    // The local transforms of the changed nodes are gathered into chunks and composed together.
+    // Parents always come before their children, so they're done by the time their chunk is
+    // flushed, even if the children are in the same chunk.
+    std::uint32_t chunk[ChunkSize];
+    float position[3][ChunkSize];
+    float rotation[4][ChunkSize];
+    float scale[ChunkSize];
+    glm::mat4 locals[ChunkSize];
+    const float* const positionPtrs[3] = {position[0], position[1], position[2]};
+    const float* const rotationPtrs[4] = {rotation[0], rotation[1], rotation[2], rotation[3]};
+    std::size_t count = 0;
+
+    auto flush = [&]() {
+        composeTransforms(positionPtrs, rotationPtrs, scale, count, locals);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& node = hierarchy.nodes[chunk[i]];
+            if (node.parent == TransformHierarchy::NoNode)
+            {
+                node.localToWorld->mat = locals[i];
+            }
+            else
+            {
+                node.localToWorld->mat = hierarchy.nodes[node.parent].localToWorld->mat * locals[i];
+            }
+        }
+        count = 0;
+    };
+
+    for (auto i = begin; i < end; ++i)
+    {
+        auto index = hierarchy.order[i];
+        const auto& node = hierarchy.nodes[index];
+        auto parentChanged = node.parent != TransformHierarchy::NoNode && hierarchy.changed[node.parent] != 0;
+        if (!node.dirty && !parentChanged)
+        {
+            continue;
+        }
+
+        hierarchy.changed[index] = 1;
+        chunk[count] = index;
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            position[axis][count] = node.position[axis];
+        }
+        rotation[0][count] = node.rotation.x;
+        rotation[1][count] = node.rotation.y;
+        rotation[2][count] = node.rotation.z;
+        rotation[3][count] = node.rotation.w;
+        scale[count] = node.scale;
+
+        if (++count == ChunkSize)
+        {
+            flush();
+        }
+    }
+
+    flush();
+}
+
+void TransformHierarchy::clear()
+{
+    for (const auto& node : nodes)
+    {
+        nodeOf[node.entity.index] = NoNode;
+    }
+    nodes.clear();
+}
+
+void TransformHierarchy::add(const Node& node)
+{
+    if (nodeOf.size() <= node.entity.index)
+    {
+        nodeOf.resize(node.entity.index + 1, NoNode);
+        cache.resize(node.entity.index + 1);
+    }
+
+    nodeOf[node.entity.index] = static_cast<std::uint32_t>(nodes.size());
+    nodes.push_back(node);
+}
+
+void TransformHierarchy::build()
+{
+    auto count = static_cast<std::uint32_t>(nodes.size());
+
+    // Link each node to its parent, and compare its local transform to the previous frame's. A
+    // node whose parent can't be found is treated as a root.
+    for (auto& node : nodes)
+    {
+        node.parent = NoNode;
+        if (!node.parentEntity.isNull() && node.parentEntity.index < nodeOf.size())
+        {
+            auto parent = nodeOf[node.parentEntity.index];
+            if (parent != NoNode && nodes[parent].entity == node.parentEntity)
+            {
+                node.parent = parent;
+            }
+        }
+
+        auto parent = node.parent == NoNode ? Entity{} : node.parentEntity;
+        auto& cached = cache[node.entity.index];
+        node.dirty = cached.entity != node.entity || cached.parent != parent || cached.position != node.position ||
+                     cached.rotation != node.rotation || cached.scale != node.scale;
+        cached = {node.entity, parent, node.position, node.rotation, node.scale};
+    }
+
+    // Group the children of each node, by counting them and then placing them after the
+    // children of the nodes before it.
+    childOffsets.assign(count + 1, 0);
+    for (const auto& node : nodes)
+    {
+        if (node.parent != NoNode)
+        {
+            childOffsets[node.parent + 1] += 1;
+        }
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        childOffsets[i + 1] += childOffsets[i];
+    }
+
+    childNodes.resize(childOffsets[count]);
+    std::vector<std::uint32_t> next(childOffsets.begin(), childOffsets.end() - 1);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        if (nodes[i].parent != NoNode)
+        {
+            childNodes[next[nodes[i].parent]++] = i;
+        }
+    }
+
+    // Sort the nodes breadth-first from each root, so that each subtree is contiguous and sorted
+    // by depth.
+    order.clear();
+    subtrees.clear();
+    std::vector<bool> visited(count, false);
+    auto visit = [&](std::uint32_t root) {
+        subtrees.push_back(order.size());
+        visited[root] = true;
+        order.push_back(root);
+        for (auto i = subtrees.back(); i < order.size(); ++i)
+        {
+            auto index = order[i];
+            for (auto child = childOffsets[index]; child < childOffsets[index + 1]; ++child)
+            {
+                if (!visited[childNodes[child]])
+                {
+                    visited[childNodes[child]] = true;
+                    order.push_back(childNodes[child]);
+                }
+            }
+        }
+    };
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        if (nodes[i].parent == NoNode)
+        {
+            visit(i);
+        }
+    }
+
+    // Nodes which weren't reached from any root are part of a cycle, which is broken by ignoring
+    // the parent of one of its nodes.
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        if (!visited[i])
+        {
+            CUBOS_WARN("Entity {} is part of a parent cycle, its parent will be ignored", nodes[i].entity.index);
+            nodes[i].parent = NoNode;
+            nodes[i].dirty = true;
+            visit(i);
+        }
+    }
+
+    subtrees.push_back(order.size());
+}
+
+void TransformHierarchy::propagate(ThreadPool& pool)
+{
+    changed.assign(nodes.size(), 0);
+
+    if (nodes.size() <= BatchSize)
+    {
+        // Not worth waking up the pool.
+        propagateRange(*this, 0, order.size());
+        return;
+    }
+
+    // Split the subtrees into tasks with at least BatchSize nodes each.
+    std::size_t begin = 0;
+    for (std::size_t i = 1; i < subtrees.size(); ++i)
+    {
+        auto end = subtrees[i];
+        if (end - begin >= BatchSize || i + 1 == subtrees.size())
+        {
+            pool.addTask([this, begin, end]() { propagateRange(*this, begin, end); });
+            begin = end;
+        }
+    }
+    pool.wait();
+}
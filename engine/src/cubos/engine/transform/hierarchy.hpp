@@ -0,0 +1,76 @@
+/// @file
+/// @brief Resource @ref cubos::engine::TransformHierarchy.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <cubos/core/ecs/entity_manager.hpp>
+#include <cubos/core/thread_pool.hpp>
+
+#include <cubos/engine/transform/local_to_world.hpp>
+
+namespace cubos::engine
+{
+    /// @brief Resource which stores the transform hierarchy, rebuilt every frame from the
+    /// @ref Parent components, and the local transforms of the previous frame, used to only
+    /// recompute the world matrices which changed.
+    struct TransformHierarchy
+    {
+        /// @brief Node of entities which aren't in the hierarchy, and parent of root nodes.
+        static constexpr std::uint32_t NoNode = UINT32_MAX;
+
+        /// @brief Transform of an entity gathered for the current frame.
+        struct Node
+        {
+            core::ecs::Entity entity;                   ///< Entity of the node.
+            core::ecs::Entity parentEntity;             ///< Parent entity, or null if the entity has no parent.
+            LocalToWorld* localToWorld{nullptr};        ///< Local to world component of the entity.
+            glm::vec3 position{0.0F};                   ///< Position of the entity, relative to its parent.
+            glm::quat rotation{1.0F, 0.0F, 0.0F, 0.0F}; ///< Rotation of the entity, relative to its parent.
+            float scale{1.0F};                          ///< Scale of the entity, relative to its parent.
+            std::uint32_t parent{NoNode};               ///< Node of the parent.
+            bool dirty{true};                           ///< Whether the local transform or the parent changed.
+        };
+
+        /// @brief Local transform of an entity on the previous frame.
+        struct Cached
+        {
+            core::ecs::Entity entity;                   ///< Entity the transform belongs to.
+            core::ecs::Entity parent;                   ///< Parent the transform was relative to.
+            glm::vec3 position{0.0F};                   ///< Position on the previous frame.
+            glm::quat rotation{1.0F, 0.0F, 0.0F, 0.0F}; ///< Rotation on the previous frame.
+            float scale{1.0F};                          ///< Scale on the previous frame.
+        };
+
+        std::vector<Node> nodes;                 ///< Nodes gathered for the current frame.
+        std::vector<std::uint32_t> nodeOf;       ///< Node of each entity, indexed by the entity's index.
+        std::vector<Cached> cache;               ///< Local transforms of the previous frame, by entity index.
+        std::vector<std::uint32_t> childOffsets; ///< Index in @ref childNodes of the first child of each node.
+        std::vector<std::uint32_t> childNodes;   ///< Children of every node, grouped by parent.
+        std::vector<std::uint32_t> order;        ///< Nodes grouped by subtree, and sorted by depth within each.
+        std::vector<std::size_t> subtrees;       ///< Index in @ref order where each subtree starts.
+        std::vector<std::uint8_t> changed;       ///< Whether the world matrix of each node changed this frame.
+
+        /// @brief Removes the nodes gathered on the previous frame.
+        void clear();
+
+        /// @brief Adds a node for an entity, to be called for every entity before @ref build().
+        /// @param node Node.
+        void add(const Node& node);
+
+        /// @brief Links the gathered nodes to their parents, sorts them into subtrees and finds
+        /// which ones changed since the previous frame.
+        void build();
+
+        /// @brief Recomputes the world matrices of the changed nodes, top-down, processing
+        /// independent subtrees in parallel.
+        /// @param pool Thread pool to run on.
+        void propagate(core::ThreadPool& pool);
+    };
+} // namespace cubos::engine
@@ -1,32 +1,103 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <cubos/core/settings.hpp>
 
 #include <cubos/engine/transform/plugin.hpp>
 
+#include "hierarchy.hpp"
+
+using cubos::core::ThreadPool;
+using cubos::core::ecs::Commands;
+using cubos::core::ecs::Entity;
 using cubos::core::ecs::OptRead;
+using cubos::core::ecs::OptWrite;
 using cubos::core::ecs::Query;
+using cubos::core::ecs::Read;
 using cubos::core::ecs::Write;
 using namespace cubos::engine;
 
-static void applyTransform(Query<Write<LocalToWorld>, OptRead<Position>, OptRead<Rotation>, OptRead<Scale>> query)
+static void updateChildren(Query<Read<Parent>> children, Query<Read<LocalToWorld>, OptWrite<Children>> parents,
+                           Commands commands)
 {
-    for (auto [entity, localToWorld, position, rotation, scale] : query)
+    for (auto [entity, localToWorld, list] : parents)
+    {
+        if (list)
+        {
+            list->entities.clear();
+        }
+    }
+
+    // Parents which don't have a Children component yet get one through the commands, so their
+    // lists are gathered separately.
+    std::vector<std::pair<Entity, Children>> added;
+    for (auto [entity, parent] : children)
     {
-        localToWorld->mat = glm::mat4(1.0F);
+        auto match = parents[parent->entity];
+        if (!match)
+        {
+            continue;
+        }
+
+        auto [localToWorld, list] = *match;
+        if (list)
+        {
+            list->entities.push_back(entity);
+            continue;
+        }
+
+        auto it = std::find_if(added.begin(), added.end(),
+                               [&](const auto& pair) { return pair.first == parent->entity; });
+        if (it == added.end())
+        {
+            added.emplace_back(parent->entity, Children{});
+            it = added.end() - 1;
+        }
+        it->second.entities.push_back(entity);
+    }
+
+    for (auto& [entity, list] : added)
+    {
+        commands.add(entity, std::move(list));
+    }
+}
+
+static void applyTransform(
+    Query<Write<LocalToWorld>, OptRead<Position>, OptRead<Rotation>, OptRead<Scale>, OptRead<Parent>> query,
+    Write<TransformHierarchy> hierarchy, Write<ThreadPool> pool)
+{
+    hierarchy->clear();
+    for (auto [entity, localToWorld, position, rotation, scale, parent] : query)
+    {
+        TransformHierarchy::Node node{};
+        node.entity = entity;
+        node.localToWorld = &*localToWorld;
         if (position)
         {
-            localToWorld->mat = glm::translate(localToWorld->mat, position->vec);
+            node.position = position->vec;
         }
 
         if (rotation)
         {
-            localToWorld->mat *= glm::toMat4(rotation->quat);
+            node.rotation = rotation->quat;
         }
 
         if (scale)
         {
-            localToWorld->mat = glm::scale(localToWorld->mat, glm::vec3(scale->factor));
+            node.scale = scale->factor;
+        }
+
+        if (parent)
+        {
+            node.parentEntity = parent->entity;
         }
+
+        hierarchy->add(node);
     }
+
+    hierarchy->build();
+    hierarchy->propagate(*pool);
 }
 
 void cubos::engine::transformPlugin(Cubos& cubos)
@@ -35,6 +106,11 @@ void cubos::engine::transformPlugin(Cubos& cubos)
     cubos.addComponent<Rotation>();
     cubos.addComponent<Scale>();
     cubos.addComponent<LocalToWorld>();
+    cubos.addComponent<Parent>();
+    cubos.addComponent<Children>();
+
+    cubos.addResource<TransformHierarchy>();
 
+    cubos.system(updateChildren).tagged("cubos.transform.update");
     cubos.system(applyTransform).tagged("cubos.transform.update");
 }
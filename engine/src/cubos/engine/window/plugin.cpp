@@ -6,6 +6,7 @@ using cubos::core::Settings;
 using cubos::core::ecs::EventWriter;
 using cubos::core::ecs::Read;
 using cubos::core::ecs::Write;
+using cubos::core::io::openHeadlessWindow;
 using cubos::core::io::openWindow;
 using cubos::core::io::Window;
 using cubos::core::io::WindowEvent;
@@ -14,8 +15,15 @@ using namespace cubos::engine;
 static void init(Write<Window> window, Write<ShouldQuit> quit, Read<Settings> settings)
 {
     quit->value = false;
-    *window = openWindow(settings->getString("window.title", "CUBOS."),
-                         {settings->getInteger("window.width", 800), settings->getInteger("window.height", 600)});
+    glm::ivec2 size{settings->getInteger("window.width", 800), settings->getInteger("window.height", 600)};
+    if (settings->getBool("window.headless", false))
+    {
+        *window = openHeadlessWindow(size);
+    }
+    else
+    {
+        *window = openWindow(settings->getString("window.title", "CUBOS."), size);
+    }
 }
 
 static void poll(Read<Window> window, Write<ShouldQuit> quit, EventWriter<WindowEvent> events)
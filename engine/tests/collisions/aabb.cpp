@@ -7,6 +7,7 @@
 #include <cubos/engine/collisions/colliders/plane.hpp>
 #include <cubos/engine/collisions/colliders/simplex.hpp>
 #include <cubos/engine/collisions/plugin.hpp>
+#include <cubos/engine/transform/plugin.hpp>
 
 using cubos::core::ecs::Commands;
 using cubos::core::ecs::OptRead;
@@ -27,6 +28,47 @@ static void setup(Commands commands)
     commands.create(PlaneCollider{glm::vec3{0.0f}, Plane{glm::vec3{1.0f}}});
 }
 
+static void setupTransformed(Commands commands)
+{
+    commands.create(BoxCollider{glm::mat4{1.0f}, Box{glm::vec3{1.0f}}}, LocalToWorld{}, Position{{1.0f, 0.0f, 0.0f}});
+    commands.create(CapsuleCollider{glm::mat4{1.0f}, Capsule{1.0f, 1.0f}}, LocalToWorld{});
+    commands.create(SimplexCollider{glm::vec3{0.0f}, Simplex{{glm::vec3{1.0f}, glm::vec3{2.0f}, glm::vec3{3.0f}}}},
+                    LocalToWorld{});
+}
+
+static void checkAABB(const ColliderAABB& aabb, glm::vec3 min, glm::vec3 max)
+{
+    for (glm::length_t i = 0; i < 3; ++i)
+    {
+        CHECK(aabb.min[i] == doctest::Approx(min[i]));
+        CHECK(aabb.max[i] == doctest::Approx(max[i]));
+    }
+}
+
+static void checkBoxAABBs(Query<Read<BoxCollider>, Read<ColliderAABB>> query)
+{
+    for (auto [entity, collider, aabb] : query)
+    {
+        checkAABB(*aabb, glm::vec3{-0.04f, -1.04f, -1.04f}, glm::vec3{2.04f, 1.04f, 1.04f});
+    }
+}
+
+static void checkCapsuleAABBs(Query<Read<CapsuleCollider>, Read<ColliderAABB>> query)
+{
+    for (auto [entity, collider, aabb] : query)
+    {
+        checkAABB(*aabb, glm::vec3{-1.0f, -1.5f, -1.0f}, glm::vec3{1.0f, 1.5f, 1.0f});
+    }
+}
+
+static void checkSimplexAABBs(Query<Read<SimplexCollider>, Read<ColliderAABB>> query)
+{
+    for (auto [entity, collider, aabb] : query)
+    {
+        checkAABB(*aabb, glm::vec3{0.96f}, glm::vec3{3.04f});
+    }
+}
+
 template <typename C>
 void testAddMissingAABBs(Query<Read<C>, OptRead<ColliderAABB>> query)
 {
@@ -41,14 +83,39 @@ TEST_CASE("collisions.aabb")
     auto cubos = Cubos{};
 
     cubos.addPlugin(collisionsPlugin);
-    cubos.system(setup).beforeTag("cubos.collisions.aabb.missing");
+    cubos.system(setup).before("cubos.collisions.aabb.missing");
 
     SUBCASE("collisions.aabb.missing: missing aabbs were added")
     {
-        cubos.system(testAddMissingAABBs<BoxCollider>).afterTag("cubos.collisions.aabb.missing");
-        cubos.system(testAddMissingAABBs<CapsuleCollider>).afterTag("cubos.collisions.aabb.missing");
-        cubos.system(testAddMissingAABBs<SimplexCollider>).afterTag("cubos.collisions.aabb.missing");
-        cubos.system(testAddMissingAABBs<PlaneCollider>).afterTag("cubos.collisions.aabb.missing");
+        cubos.system(testAddMissingAABBs<BoxCollider>).after("cubos.collisions.aabb.missing");
+        cubos.system(testAddMissingAABBs<CapsuleCollider>).after("cubos.collisions.aabb.missing");
+        cubos.system(testAddMissingAABBs<SimplexCollider>).after("cubos.collisions.aabb.missing");
+        cubos.system(testAddMissingAABBs<PlaneCollider>).after("cubos.collisions.aabb.missing");
+    }
+
+    cubos.run();
+}
+
+TEST_CASE("collisions.aabb.update")
+{
+    auto cubos = Cubos{};
+
+    cubos.addPlugin(collisionsPlugin);
+    cubos.system(setupTransformed).before("cubos.transform.update").before("cubos.collisions.aabb.missing");
+
+    SUBCASE("box aabbs include the margin")
+    {
+        cubos.system(checkBoxAABBs).after("cubos.collisions.aabb");
+    }
+
+    SUBCASE("capsule aabbs enclose both caps")
+    {
+        cubos.system(checkCapsuleAABBs).after("cubos.collisions.aabb");
+    }
+
+    SUBCASE("simplex aabbs enclose every point")
+    {
+        cubos.system(checkSimplexAABBs).after("cubos.collisions.aabb");
     }
 
     cubos.run();
@@ -0,0 +1,103 @@
+#include <doctest/doctest.h>
+#include <glm/glm.hpp>
+
+#include <cubos/core/settings.hpp>
+
+#include <cubos/engine/collisions/broad_phase_collisions.hpp>
+#include <cubos/engine/collisions/colliders/box.hpp>
+#include <cubos/engine/collisions/plugin.hpp>
+#include <cubos/engine/transform/plugin.hpp>
+
+using cubos::core::Settings;
+using cubos::core::ecs::Commands;
+using cubos::core::ecs::Entity;
+using cubos::core::ecs::Query;
+using cubos::core::ecs::Read;
+using cubos::core::ecs::Write;
+using namespace cubos::engine;
+
+using CollisionType = BroadPhaseCollisions::CollisionType;
+
+/// Position of the moving box on each frame, and whether it overlaps the static box. At 1.15, the
+/// boxes don't overlap, but their AABBs enlarged by the tree's margin do.
+static const std::pair<float, bool> Frames[] = {
+    {5.0F, false}, {0.5F, true}, {0.6F, true}, {1.15F, false}, {5.0F, false}, {-0.5F, true},
+};
+
+struct State
+{
+    Entity moving;
+    std::size_t frame = 0;
+};
+
+static void useTree(Write<Settings> settings)
+{
+    settings->setString("collisions.broadPhase", "tree");
+}
+
+static void useGrid(Write<Settings> settings)
+{
+    settings->setString("collisions.broadPhase", "grid");
+}
+
+static void setup(Commands commands, Write<State> state)
+{
+    commands.create(BoxCollider{}, LocalToWorld{}, Position{{0.0F, 0.0F, 0.0F}});
+    commands.create(BoxCollider{}, LocalToWorld{}, Position{{0.0F, 10.0F, 0.0F}});
+    state->moving = commands.create(BoxCollider{}, LocalToWorld{}, Position{{Frames[0].first, 0.0F, 0.0F}}).entity();
+}
+
+static void move(Read<State> state, Query<Write<Position>> query)
+{
+    auto [position] = query[state->moving].value();
+    position->vec.x = Frames[state->frame].first;
+}
+
+static void check(Write<State> state, Read<BroadPhaseCollisions> collisions, Write<ShouldQuit> quit)
+{
+    CHECK(collisions->candidates(CollisionType::BoxBox).size() == (Frames[state->frame].second ? 1 : 0));
+
+    state->frame += 1;
+    quit->value = state->frame == std::size(Frames);
+}
+
+TEST_CASE("collisions.broad")
+{
+    auto cubos = Cubos{};
+
+    cubos.addPlugin(collisionsPlugin);
+    cubos.addResource<State>();
+    cubos.startupSystem(setup);
+    cubos.system(move).before("cubos.transform.update");
+    cubos.system(check).after("cubos.collisions.broad");
+
+    cubos.run();
+}
+
+TEST_CASE("collisions.broad.tree")
+{
+    auto cubos = Cubos{};
+
+    cubos.addPlugin(collisionsPlugin);
+    cubos.addResource<State>();
+    cubos.startupSystem(useTree).tagged("cubos.settings");
+    cubos.startupSystem(setup);
+    cubos.system(move).before("cubos.transform.update");
+    cubos.system(check).after("cubos.collisions.broad");
+
+    cubos.run();
+}
+
+TEST_CASE("collisions.broad.grid")
+{
+    auto cubos = Cubos{};
+
+    cubos.addPlugin(collisionsPlugin);
+    cubos.addResource<State>();
+    cubos.startupSystem(useGrid).tagged("cubos.settings");
+    cubos.startupSystem(setup);
+    cubos.system(move).before("cubos.transform.update");
+    cubos.system(check).after("cubos.collisions.broad");
+
+    cubos.run();
+}
@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+#include <glm/glm.hpp>
+
+#include <cubos/engine/collisions/broad_phase_collisions.hpp>
+
+using cubos::core::ecs::Entity;
+using cubos::engine::BroadPhaseCollisions;
+using cubos::engine::ColliderAABB;
+
+using Bounds = BroadPhaseCollisions::Bounds;
+using Shape = BroadPhaseCollisions::Shape;
+
+TEST_CASE("collisions.BroadPhaseCollisions.bounds")
+{
+    BroadPhaseCollisions collisions;
+    const auto& bounds = collisions.bounds;
+
+    Entity a{0, 0};
+    Entity b{1, 0};
+    Entity c{2, 0};
+    collisions.addEntity(a, Shape::Box);
+    collisions.addEntity(b, Shape::Plane);
+    collisions.addEntity(c, Shape::Capsule);
+    REQUIRE(bounds.size() == 3);
+
+    SUBCASE("shapes of the same entity are merged")
+    {
+        collisions.addEntity(a, Shape::Simplex);
+        CHECK(bounds.size() == 3);
+        CHECK(bounds.shapes[bounds.slot(a)] == ((1U << 0) | (1U << 3)));
+    }
+
+    SUBCASE("updated bounds are mirrored")
+    {
+        collisions.updateBounds(c, ColliderAABB{glm::vec3{-1.0F}, glm::vec3{2.0F}});
+        auto aabb = bounds.aabb(bounds.slot(c));
+        CHECK(aabb.min == glm::vec3{-1.0F});
+        CHECK(aabb.max == glm::vec3{2.0F});
+    }
+
+    SUBCASE("removed entities are swapped with the last slot")
+    {
+        collisions.updateBounds(c, ColliderAABB{glm::vec3{3.0F}, glm::vec3{4.0F}});
+        collisions.removeEntity(a);
+        CHECK(bounds.size() == 2);
+        CHECK(bounds.slot(a) == Bounds::NoSlot);
+        CHECK(bounds.slot(c) == 0);
+        CHECK(bounds.entities[0] == c);
+        CHECK(bounds.aabb(0).min == glm::vec3{3.0F});
+        CHECK(bounds.slot(b) == 1);
+    }
+
+    SUBCASE("a newer generation replaces the old one")
+    {
+        Entity newA{0, 1};
+        collisions.addEntity(newA, Shape::Box);
+        CHECK(bounds.size() == 3);
+        CHECK(bounds.slot(a) == Bounds::NoSlot);
+        CHECK(bounds.slot(newA) != Bounds::NoSlot);
+    }
+
+    SUBCASE("clearing removes every slot")
+    {
+        collisions.clearEntities();
+        CHECK(bounds.size() == 0);
+        CHECK(bounds.slot(b) == Bounds::NoSlot);
+    }
+}
+
+TEST_CASE("collisions.BroadPhaseCollisions.CandidateHash")
+{
+    BroadPhaseCollisions::CandidateHash hash;
+    Entity a{1, 0};
+    Entity b{2, 0};
+    Entity c{3, 0};
+
+    CHECK(hash({a, b}) != hash({b, a}));
+    CHECK(hash({a, b}) != hash({a, c}));
+    CHECK(hash({a, c}) != hash({b, c}));
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <glm/glm.hpp>
+
+#include <cubos/engine/collisions/broad_phase_tree.hpp>
+
+using cubos::core::ecs::Entity;
+using cubos::engine::BroadPhaseTree;
+using cubos::engine::ColliderAABB;
+
+static ColliderAABB cube(glm::vec3 center, float halfSize = 0.5F)
+{
+    return ColliderAABB{center - glm::vec3{halfSize}, center + glm::vec3{halfSize}};
+}
+
+static std::vector<Entity> query(const BroadPhaseTree& tree, const ColliderAABB& aabb)
+{
+    std::vector<Entity> found;
+    tree.query(aabb, [&](Entity entity) {
+        found.push_back(entity);
+        return true;
+    });
+    return found;
+}
+
+TEST_CASE("collisions.BroadPhaseTree")
+{
+    BroadPhaseTree tree;
+
+    SUBCASE("empty tree")
+    {
+        CHECK(tree.size() == 0);
+        CHECK(tree.height() == 0);
+        CHECK(query(tree, cube(glm::vec3{0.0F})).empty());
+    }
+
+    SUBCASE("entities are only reinserted when they leave their enlarged AABB")
+    {
+        Entity entity{0, 0};
+        CHECK(tree.update(entity, cube(glm::vec3{0.0F})));
+        CHECK(tree.contains(entity));
+        CHECK_FALSE(tree.update(entity, cube(glm::vec3{BroadPhaseTree::Margin / 2.0F, 0.0F, 0.0F})));
+        CHECK(tree.update(entity, cube(glm::vec3{1.0F, 0.0F, 0.0F})));
+        CHECK(tree.moved().size() == 2);
+
+        tree.clearMoved();
+        CHECK(tree.moved().empty());
+
+        tree.remove(entity);
+        CHECK_FALSE(tree.contains(entity));
+        CHECK(tree.size() == 0);
+    }
+
+    SUBCASE("entities with reused indices replace the old generation")
+    {
+        tree.update(Entity{3, 0}, cube(glm::vec3{0.0F}));
+        tree.update(Entity{3, 1}, cube(glm::vec3{10.0F}));
+        CHECK_FALSE(tree.contains(Entity{3, 0}));
+        CHECK(tree.contains(Entity{3, 1}));
+        CHECK(tree.size() == 1);
+    }
+
+    SUBCASE("queries and balance on a line of cubes")
+    {
+        // Inserting sorted entities would degenerate into a list without rotations.
+        const uint32_t count = 256;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            tree.update(Entity{i, 0}, cube(glm::vec3{static_cast<float>(i) * 2.0F, 0.0F, 0.0F}));
+        }
+        CHECK(tree.size() == count);
+        CHECK(tree.height() <= 2 * 9);
+
+        auto found = query(tree, cube(glm::vec3{19.0F, 0.0F, 0.0F}));
+        std::sort(found.begin(), found.end(), [](Entity a, Entity b) { return a.index < b.index; });
+        REQUIRE(found.size() == 2);
+        CHECK(found[0] == Entity{9, 0});
+        CHECK(found[1] == Entity{10, 0});
+
+        CHECK(tree.overlaps(Entity{9, 0}, Entity{10, 0}) == false);
+        tree.update(Entity{10, 0}, cube(glm::vec3{19.0F, 0.0F, 0.0F}));
+        CHECK(tree.overlaps(Entity{9, 0}, Entity{10, 0}));
+
+        // Removing every other entity must keep the remaining ones reachable.
+        for (uint32_t i = 0; i < count; i += 2)
+        {
+            tree.remove(Entity{i, 0});
+        }
+        CHECK(tree.size() == count / 2);
+        CHECK(query(tree, cube(glm::vec3{0.0F}, 1000.0F)).size() == count / 2);
+    }
+
+    SUBCASE("raycasts")
+    {
+        tree.update(Entity{0, 0}, cube(glm::vec3{5.0F, 0.0F, 0.0F}));
+        tree.update(Entity{1, 0}, cube(glm::vec3{10.0F, 0.0F, 0.0F}));
+        tree.update(Entity{2, 0}, cube(glm::vec3{5.0F, 5.0F, 0.0F}));
+
+        // Find the closest hit by shortening the ray on each hit.
+        Entity closest;
+        tree.raycast(glm::vec3{0.0F}, glm::vec3{1.0F, 0.0F, 0.0F}, 100.0F, [&](Entity entity, float distance) {
+            closest = entity;
+            return distance;
+        });
+        CHECK(closest == Entity{0, 0});
+
+        std::size_t hits = 0;
+        tree.raycast(glm::vec3{0.0F}, glm::vec3{1.0F, 0.0F, 0.0F}, 7.0F, [&](Entity, float) {
+            hits += 1;
+            return 7.0F;
+        });
+        CHECK(hits == 1);
+
+        hits = 0;
+        tree.raycast(glm::vec3{0.0F, 5.0F, 0.0F}, glm::vec3{1.0F, 0.0F, 0.0F}, 100.0F, [&](Entity entity, float) {
+            hits += 1;
+            CHECK(entity == Entity{2, 0});
+            return 100.0F;
+        });
+        CHECK(hits == 1);
+    }
+
+    SUBCASE("infinite AABBs overlap everything")
+    {
+        tree.update(Entity{0, 0}, ColliderAABB{});
+        tree.update(Entity{1, 0}, cube(glm::vec3{3.0F}));
+        tree.update(Entity{2, 0}, cube(glm::vec3{-3.0F}));
+        CHECK(tree.overlaps(Entity{0, 0}, Entity{1, 0}));
+        CHECK(tree.overlaps(Entity{0, 0}, Entity{2, 0}));
+        CHECK_FALSE(tree.overlaps(Entity{1, 0}, Entity{2, 0}));
+        CHECK(query(tree, cube(glm::vec3{100.0F})).size() == 1);
+    }
+}
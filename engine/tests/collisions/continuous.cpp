@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+#include <glm/glm.hpp>
+
+#include <cubos/core/ecs/event_reader.hpp>
+
+#include <cubos/engine/collisions/colliders/box.hpp>
+#include <cubos/engine/collisions/colliders/capsule.hpp>
+#include <cubos/engine/collisions/continuous_collider.hpp>
+#include <cubos/engine/collisions/impact_event.hpp>
+#include <cubos/engine/collisions/plugin.hpp>
+#include <cubos/engine/transform/plugin.hpp>
+
+using cubos::core::ecs::Commands;
+using cubos::core::ecs::Entity;
+using cubos::core::ecs::EventReader;
+using cubos::core::ecs::Query;
+using cubos::core::ecs::Read;
+using cubos::core::ecs::Write;
+using cubos::core::geom::Box;
+using cubos::core::geom::Capsule;
+using namespace cubos::engine;
+
+/// Position of the bullet on each frame, which crosses the wall between the first two frames.
+static const float Frames[] = {-10.0F, 10.0F, 12.0F};
+
+struct State
+{
+    Entity bullet;
+    std::size_t frame = 0;
+    std::size_t impacts = 0;
+};
+
+static void setup(Commands commands, Write<State> state)
+{
+    // A thin wall, and a small bullet which moves too fast to ever overlap it on a frame.
+    commands.create(BoxCollider{glm::mat4{1.0F}, Box{{0.05F, 5.0F, 5.0F}}}, LocalToWorld{}, Position{});
+    state->bullet = commands
+                        .create(CapsuleCollider{glm::mat4{1.0F}, Capsule::sphere(0.1F)}, ContinuousCollider{},
+                                LocalToWorld{}, Position{{Frames[0], 0.0F, 0.0F}})
+                        .entity();
+}
+
+static void move(Read<State> state, Query<Write<Position>> query)
+{
+    auto [position] = query[state->bullet].value();
+    position->vec.x = Frames[state->frame];
+}
+
+static void check(Write<State> state, EventReader<ImpactEvent> reader, Write<ShouldQuit> quit)
+{
+    for (const auto& event : reader)
+    {
+        auto normal = state->bullet == event.entity ? event.normal : -event.normal;
+        CHECK(state->frame == 1);
+        CHECK(event.time == doctest::Approx((10.0F - 0.15F - BoxCollider{}.margin) / 20.0F).epsilon(0.01));
+        CHECK(normal.x == doctest::Approx(1.0F));
+        CHECK(event.point.x == doctest::Approx(-0.05F - BoxCollider{}.margin).epsilon(0.05));
+        state->impacts += 1;
+    }
+
+    state->frame += 1;
+    quit->value = state->frame == std::size(Frames);
+    if (quit->value)
+    {
+        CHECK(state->impacts == 1);
+    }
+}
+
+TEST_CASE("collisions.continuous")
+{
+    auto cubos = Cubos{};
+
+    cubos.addPlugin(collisionsPlugin);
+    cubos.addResource<State>();
+    cubos.startupSystem(setup);
+    cubos.system(move).before("cubos.transform.update");
+    cubos.system(check).after("cubos.collisions.impact");
+
+    cubos.run();
+}
@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+#include <glm/glm.hpp>
+
+#include <cubos/core/ecs/event_reader.hpp>
+
+#include <cubos/engine/collisions/collision_event.hpp>
+#include <cubos/engine/collisions/colliders/box.hpp>
+#include <cubos/engine/collisions/colliders/capsule.hpp>
+#include <cubos/engine/collisions/colliders/plane.hpp>
+#include <cubos/engine/collisions/plugin.hpp>
+#include <cubos/engine/transform/plugin.hpp>
+
+using cubos::core::ecs::Commands;
+using cubos::core::ecs::EventReader;
+using cubos::core::geom::Box;
+using cubos::core::geom::Capsule;
+using namespace cubos::engine;
+
+static void setup(Commands commands)
+{
+    // Two overlapping boxes, a sphere resting on the floor, and a box far away from everything.
+    commands.create(BoxCollider{}, LocalToWorld{}, Position{{0.0F, 5.0F, 0.0F}});
+    commands.create(BoxCollider{}, LocalToWorld{}, Position{{0.9F, 5.0F, 0.0F}});
+    commands.create(CapsuleCollider{glm::mat4{1.0F}, Capsule::sphere(0.5F)}, LocalToWorld{},
+                    Position{{10.0F, 0.4F, 0.0F}});
+    commands.create(PlaneCollider{}, LocalToWorld{}, Position{{0.0F, 0.0F, 0.0F}});
+    commands.create(BoxCollider{}, LocalToWorld{}, Position{{-20.0F, 20.0F, 0.0F}});
+}
+
+static void checkCollisions(EventReader<CollisionEvent> reader)
+{
+    std::size_t boxes = 0;
+    std::size_t floor = 0;
+
+    for (const auto& event : reader)
+    {
+        CHECK(event.manifold.depth > 0.0F);
+        CHECK(event.manifold.pointCount > 0);
+
+        if (std::abs(event.manifold.normal.x) > 0.5F)
+        {
+            CHECK(event.manifold.depth == doctest::Approx(0.1F + 2 * BoxCollider{}.margin));
+            boxes += 1;
+        }
+        else
+        {
+            CHECK(std::abs(event.manifold.normal.y) == doctest::Approx(1.0F));
+            floor += 1;
+        }
+    }
+
+    CHECK(boxes == 1);
+    CHECK(floor == 1);
+}
+
+TEST_CASE("collisions.narrow")
+{
+    auto cubos = Cubos{};
+
+    cubos.addPlugin(collisionsPlugin);
+    cubos.startupSystem(setup);
+    cubos.system(checkCollisions).after("cubos.collisions.narrow");
+
+    cubos.run();
+}
@@ -0,0 +1,162 @@
+#include <random>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cubos/engine/renderer/culling.hpp>
+#include <cubos/engine/renderer/frame.hpp>
+
+using cubos::core::ThreadPool;
+using cubos::core::gl::Camera;
+using cubos::engine::RendererFrame;
+using cubos::engine::RendererGrid;
+
+/// Grid with no GPU resources, only used for its bounds.
+struct BoundsGrid : cubos::engine::impl::RendererGrid
+{
+};
+
+/// Checks whether a box may be visible, by checking whether any plane has all of its corners
+/// outside, one corner at a time.
+static bool mayBeVisible(const glm::vec4 planes[6], glm::vec3 center, glm::vec3 extent)
+{
+    for (int plane = 0; plane < 6; ++plane)
+    {
+        bool outside = true;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            glm::vec3 point = center;
+            point.x += (corner & 1) != 0 ? extent.x : -extent.x;
+            point.y += (corner & 2) != 0 ? extent.y : -extent.y;
+            point.z += (corner & 4) != 0 ? extent.z : -extent.z;
+            if (glm::dot(glm::vec3(planes[plane]), point) + planes[plane].w >= 0.0F)
+            {
+                outside = false;
+            }
+        }
+
+        if (outside)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Creates a draw command with the given world space bounds.
+static RendererFrame::DrawCmd drawCmd(glm::vec3 center, glm::vec3 extent)
+{
+    return {nullptr, glm::mat4{1.0F}, center, extent};
+}
+
+TEST_CASE("renderer.culling")
+{
+    Camera camera{};
+    camera.fovY = 60.0F;
+    camera.zNear = 0.1F;
+    camera.zFar = 100.0F;
+    camera.view = glm::inverse(glm::translate(glm::mat4{1.0F}, glm::vec3{0.0F, 2.0F, 10.0F}));
+    camera.viewportSize = {1280, 720};
+
+    auto aspect = static_cast<float>(camera.viewportSize.x) / static_cast<float>(camera.viewportSize.y);
+    auto projection = glm::perspective(glm::radians(camera.fovY), aspect, camera.zNear, camera.zFar);
+    glm::vec4 planes[6];
+    frustumPlanes(projection * camera.view, planes);
+
+    SUBCASE("boxes inside, outside and straddling the frustum")
+    {
+        // At 10 units from the camera, the frustum spans about 10.3 units to each side. There are
+        // fewer boxes than lanes, so that only the scalar tail runs, and then more, so that the
+        // tail runs after a full batch.
+        std::vector<RendererFrame::DrawCmd> drawCmds{
+            drawCmd({0.0F, 2.0F, 0.0F}, {1.0F, 1.0F, 1.0F}),    // Inside.
+            drawCmd({0.0F, 2.0F, 20.0F}, {1.0F, 1.0F, 1.0F}),   // Behind the camera.
+            drawCmd({0.0F, 2.0F, -200.0F}, {1.0F, 1.0F, 1.0F}), // Past the far plane.
+            drawCmd({-11.0F, 2.0F, 0.0F}, {2.0F, 1.0F, 1.0F}),  // Straddling the left plane.
+            drawCmd({-14.0F, 2.0F, 0.0F}, {1.0F, 1.0F, 1.0F}),  // Left of the frustum.
+            drawCmd({0.0F, 2.0F, 10.0F}, {0.5F, 0.5F, 0.5F}),   // Straddling the near plane.
+            drawCmd({0.0F, 2.0F, -95.0F}, {1.0F, 1.0F, 10.0F}), // Straddling the far plane.
+        };
+        std::vector<std::uint8_t> expected{1, 0, 0, 1, 0, 1, 1};
+
+        for (std::size_t count : {std::size_t{3}, drawCmds.size()})
+        {
+            std::vector<std::uint8_t> visible(count, 2);
+            cullDrawCmds(planes, drawCmds.data(), count, visible.data());
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                CHECK(visible[i] == expected[i]);
+            }
+        }
+    }
+
+    SUBCASE("random boxes")
+    {
+        std::mt19937 rng{3};
+        std::uniform_real_distribution<float> coordinate{-150.0F, 150.0F};
+        std::uniform_real_distribution<float> size{0.0F, 5.0F};
+
+        // Not a multiple of the number of lanes, so that the tail also runs.
+        std::vector<RendererFrame::DrawCmd> drawCmds;
+        for (int i = 0; i < 1003; ++i)
+        {
+            drawCmds.push_back(drawCmd({coordinate(rng), coordinate(rng) * 0.3F, coordinate(rng)},
+                                       {size(rng), size(rng), size(rng)}));
+        }
+
+        std::vector<std::uint8_t> visible(drawCmds.size());
+        cullDrawCmds(planes, drawCmds.data(), drawCmds.size(), visible.data());
+
+        std::size_t visibleCount = 0;
+        for (std::size_t i = 0; i < drawCmds.size(); ++i)
+        {
+            CHECK((visible[i] != 0) == mayBeVisible(planes, drawCmds[i].center, drawCmds[i].extent));
+            visibleCount += visible[i];
+        }
+
+        // Make sure both outcomes are tested.
+        CHECK(visibleCount > 0);
+        CHECK(visibleCount < drawCmds.size());
+    }
+
+    SUBCASE("frames culled on the pool agree with a single batch")
+    {
+        auto grid = std::make_shared<BoundsGrid>();
+        grid->min = {-1.0F, -1.0F, -1.0F};
+        grid->max = {1.0F, 1.0F, 1.0F};
+
+        std::mt19937 rng{5};
+        std::uniform_real_distribution<float> coordinate{-150.0F, 150.0F};
+
+        // Enough draw commands to be split into several tasks, the last of them partial.
+        RendererFrame frame{};
+        for (int i = 0; i < 5000; ++i)
+        {
+            auto modelMat =
+                glm::translate(glm::mat4{1.0F}, glm::vec3{coordinate(rng), coordinate(rng) * 0.3F, coordinate(rng)});
+            frame.draw(grid, glm::rotate(modelMat, coordinate(rng), glm::vec3{0.0F, 1.0F, 0.0F}));
+        }
+
+        CHECK_FALSE(frame.isCulled());
+        ThreadPool pool{4};
+        frame.cull(camera, pool);
+        REQUIRE(frame.isCulled());
+
+        const auto& drawCmds = frame.drawCmds();
+        std::vector<std::uint8_t> visible(drawCmds.size());
+        cullDrawCmds(planes, drawCmds.data(), drawCmds.size(), visible.data());
+
+        std::size_t visibleCount = 0;
+        for (std::size_t i = 0; i < drawCmds.size(); ++i)
+        {
+            CHECK(frame.isVisible(i) == (visible[i] != 0));
+            visibleCount += visible[i];
+        }
+        CHECK(visibleCount > 0);
+        CHECK(visibleCount < drawCmds.size());
+
+        frame.clear();
+        CHECK_FALSE(frame.isCulled());
+    }
+}
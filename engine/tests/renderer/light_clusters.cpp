@@ -0,0 +1,131 @@
+#include <cmath>
+#include <random>
+
+#include <doctest/doctest.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cubos/engine/renderer/light_clusters.hpp>
+
+using cubos::core::ThreadPool;
+using cubos::core::gl::Camera;
+using cubos::engine::LightClusters;
+
+/// Checks whether a cluster holds a light.
+static bool contains(const LightClusters& clusters, std::size_t cluster, std::uint32_t light)
+{
+    auto range = clusters.ranges()[cluster];
+    for (auto i = range.offset; i < range.offset + range.count; ++i)
+    {
+        if (clusters.indices()[i] == light)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Checks whether a sphere intersects an axis aligned box.
+static bool intersects(glm::vec3 center, float radius, glm::vec3 min, glm::vec3 max)
+{
+    auto offset = center - glm::clamp(center, min, max);
+    return glm::dot(offset, offset) <= radius * radius;
+}
+
+TEST_CASE("renderer.light_clusters")
+{
+    Camera camera{};
+    camera.fovY = 60.0F;
+    camera.zNear = 0.1F;
+    camera.zFar = 100.0F;
+    camera.view = glm::inverse(glm::translate(glm::mat4{1.0F}, glm::vec3{0.0F, 2.0F, 10.0F}));
+    camera.viewportSize = {1280, 720};
+
+    LightClusters clusters{};
+    auto size = clusters.size();
+
+    SUBCASE("small light in front of the camera")
+    {
+        clusters.assign(camera, {{{0.0F, 2.0F, 0.0F}, 0.5F}});
+
+        // The light is only in the clusters around its center.
+        auto center = clusters.clusterOf({0.0F, 0.0F, -10.0F});
+        CHECK(contains(clusters, clusters.index(center), 0));
+        CHECK_FALSE(contains(clusters, clusters.index({0, 0, center.z}), 0));
+        CHECK_FALSE(contains(clusters, clusters.index({center.x, center.y, 0}), 0));
+        CHECK(clusters.indices().size() < 16);
+    }
+
+    SUBCASE("lights out of the frustum")
+    {
+        clusters.assign(camera,
+                        {{{0.0F, 2.0F, 20.0F}, 1.0F}, {{0.0F, 2.0F, -200.0F}, 1.0F}, {{100.0F, 2.0F, 0.0F}, 1.0F}});
+        CHECK(clusters.indices().empty());
+    }
+
+    SUBCASE("many lights reach every cluster they touch")
+    {
+        std::mt19937 rng{1};
+        std::uniform_real_distribution<float> coordinate{-40.0F, 40.0F};
+        std::uniform_real_distribution<float> radius{0.1F, 8.0F};
+        std::uniform_real_distribution<float> unit{-1.0F, 1.0F};
+        std::vector<LightClusters::Bounds> lights(500);
+        for (auto& light : lights)
+        {
+            light = {{coordinate(rng), coordinate(rng), coordinate(rng)}, radius(rng)};
+        }
+
+        ThreadPool pool{4};
+        clusters.assign(camera, lights, pool);
+
+        // Lights are never assigned to clusters their spheres don't intersect.
+        std::size_t misplaced = 0;
+        for (std::uint32_t z = 0; z < size.z; ++z)
+        {
+            for (std::uint32_t y = 0; y < size.y; ++y)
+            {
+                for (std::uint32_t x = 0; x < size.x; ++x)
+                {
+                    glm::vec3 min;
+                    glm::vec3 max;
+                    clusters.bounds({x, y, z}, min, max);
+                    auto range = clusters.ranges()[clusters.index({x, y, z})];
+                    for (auto i = range.offset; i < range.offset + range.count; ++i)
+                    {
+                        const auto& light = lights[clusters.indices()[i]];
+                        auto center = glm::vec3(camera.view * glm::vec4(light.center, 1.0F));
+                        misplaced += intersects(center, light.radius, min, max) ? 0 : 1;
+                    }
+                }
+            }
+        }
+        CHECK(misplaced == 0);
+
+        // Every visible point of a light's sphere is in a cluster which holds the light.
+        auto tanHalfFovY = std::tan(glm::radians(camera.fovY) * 0.5F);
+        glm::vec2 tanHalfFov{tanHalfFovY * 1280.0F / 720.0F, tanHalfFovY};
+        std::size_t missing = 0;
+        for (std::uint32_t i = 0; i < lights.size(); ++i)
+        {
+            for (int sample = 0; sample < 100; ++sample)
+            {
+                glm::vec3 offset{unit(rng), unit(rng), unit(rng)};
+                if (glm::dot(offset, offset) > 1.0F)
+                {
+                    continue;
+                }
+
+                auto world = lights[i].center + offset * lights[i].radius;
+                auto point = glm::vec3(camera.view * glm::vec4(world, 1.0F));
+                auto depth = -point.z;
+                if (depth < camera.zNear || depth > camera.zFar || std::abs(point.x) > depth * tanHalfFov.x ||
+                    std::abs(point.y) > depth * tanHalfFov.y)
+                {
+                    continue;
+                }
+
+                missing += contains(clusters, clusters.index(clusters.clusterOf(point)), i) ? 0 : 1;
+            }
+        }
+        CHECK(missing == 0);
+    }
+}
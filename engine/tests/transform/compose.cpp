@@ -0,0 +1,60 @@
+#include <random>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <cubos/engine/transform/compose.hpp>
+
+/// Number of entities composed, which isn't a multiple of the number of lanes of any target.
+static const std::size_t Count = 37;
+
+TEST_CASE("transform.compose")
+{
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<float> coordinate{-10.0F, 10.0F};
+    std::uniform_real_distribution<float> component{-1.0F, 1.0F};
+    std::uniform_real_distribution<float> factor{0.1F, 4.0F};
+
+    std::vector<float> position[3];
+    std::vector<float> rotation[4];
+    std::vector<float> scale;
+    std::vector<glm::mat4> expected;
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        glm::vec3 translation{coordinate(rng), coordinate(rng), coordinate(rng)};
+        auto quat = glm::normalize(glm::quat{component(rng), component(rng), component(rng), component(rng)});
+        auto uniform = factor(rng);
+
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            position[axis].push_back(translation[axis]);
+        }
+        rotation[0].push_back(quat.x);
+        rotation[1].push_back(quat.y);
+        rotation[2].push_back(quat.z);
+        rotation[3].push_back(quat.w);
+        scale.push_back(uniform);
+
+        auto mat = glm::translate(glm::mat4(1.0F), translation) * glm::toMat4(quat);
+        expected.push_back(glm::scale(mat, glm::vec3(uniform)));
+    }
+
+    const float* const positionPtrs[3] = {position[0].data(), position[1].data(), position[2].data()};
+    const float* const rotationPtrs[4] = {rotation[0].data(), rotation[1].data(), rotation[2].data(),
+                                          rotation[3].data()};
+    std::vector<glm::mat4> composed(Count);
+    composeTransforms(positionPtrs, rotationPtrs, scale.data(), Count, composed.data());
+
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        for (glm::length_t column = 0; column < 4; ++column)
+        {
+            for (glm::length_t row = 0; row < 4; ++row)
+            {
+                CHECK(composed[i][column][row] == doctest::Approx(expected[i][column][row]).epsilon(1e-4));
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#include <doctest/doctest.h>
+#include <glm/glm.hpp>
+
+#include <cubos/engine/transform/plugin.hpp>
+
+using cubos::core::ecs::Commands;
+using cubos::core::ecs::Entity;
+using cubos::core::ecs::Query;
+using cubos::core::ecs::Read;
+using cubos::core::ecs::Write;
+using namespace cubos::engine;
+
+/// Number of frames run by the test.
+static const std::size_t Frames = 3;
+
+struct State
+{
+    Entity root;
+    Entity child;
+    Entity grandchild;
+    Entity other;
+    std::size_t frame = 0;
+};
+
+static void setup(Commands commands, Write<State> state)
+{
+    state->root = commands.create(LocalToWorld{}, Position{{1.0F, 0.0F, 0.0F}}, Scale{2.0F}).entity();
+    state->child = commands.create(LocalToWorld{}, Position{{0.0F, 1.0F, 0.0F}}, Parent{state->root}).entity();
+    state->grandchild = commands.create(LocalToWorld{}, Position{{0.0F, 0.0F, 1.0F}}, Parent{state->child}).entity();
+    state->other = commands.create(LocalToWorld{}, Position{{0.0F, 0.0F, 3.0F}}).entity();
+}
+
+static void move(Read<State> state, Query<Write<Position>> positions, Query<Write<LocalToWorld>> localToWorlds)
+{
+    if (state->frame == 1)
+    {
+        auto [position] = positions[state->root].value();
+        position->vec.x = 5.0F;
+
+        // Entities which didn't move aren't recomputed, so this change must survive the frame.
+        auto [localToWorld] = localToWorlds[state->other].value();
+        localToWorld->mat[3][0] = 7.0F;
+    }
+}
+
+static glm::vec3 translation(Query<Read<LocalToWorld>>& query, Entity entity)
+{
+    auto [localToWorld] = query[entity].value();
+    return glm::vec3(localToWorld->mat[3]);
+}
+
+static void check(Write<State> state, Query<Read<LocalToWorld>> query, Query<Read<Children>> children,
+                  Write<ShouldQuit> quit)
+{
+    auto x = state->frame == 0 ? 1.0F : 5.0F;
+    CHECK(translation(query, state->root) == glm::vec3{x, 0.0F, 0.0F});
+    CHECK(translation(query, state->child) == glm::vec3{x, 2.0F, 0.0F});
+    CHECK(translation(query, state->grandchild) == glm::vec3{x, 2.0F, 2.0F});
+    CHECK(translation(query, state->other) == glm::vec3{state->frame == 0 ? 0.0F : 7.0F, 0.0F, 3.0F});
+
+    // The children lists are added through commands, so they're only visible from the second frame on.
+    if (state->frame > 0)
+    {
+        auto [rootChildren] = children[state->root].value();
+        REQUIRE(rootChildren->entities.size() == 1);
+        CHECK(rootChildren->entities[0] == state->child);
+        CHECK_FALSE(children[state->grandchild].has_value());
+    }
+
+    state->frame += 1;
+    quit->value = state->frame == Frames;
+}
+
+TEST_CASE("transform.hierarchy")
+{
+    auto cubos = Cubos{};
+
+    cubos.addPlugin(transformPlugin);
+    cubos.addResource<State>();
+    cubos.startupSystem(setup);
+    cubos.system(move).before("cubos.transform.update");
+    cubos.system(check).after("cubos.transform.update");
+
+    cubos.run();
+}
@@ -793,6 +793,10 @@ static bool generate(const GenerateOptions& options)
     file << "/// This file was generated by quadrados generate." << std::endl;
     file << "/// Do not edit this file." << std::endl;
     file << std::endl;
+    file << "#include <cubos/core/data/binary_serializer.hpp>" << std::endl;
+    file << "#include <cubos/core/data/fields.hpp>" << std::endl;
+    file << "#include <cubos/core/data/tagged_deserializer.hpp>" << std::endl;
+    file << "#include <cubos/core/data/tagged_serializer.hpp>" << std::endl;
     file << "#include <cubos/core/ecs/registry.hpp>" << std::endl;
     file << "#include <cubos/core/ecs/vec_storage.hpp>" << std::endl;
     file << "#include <cubos/core/ecs/map_storage.hpp>" << std::endl;
@@ -822,57 +826,34 @@ static bool generate(const GenerateOptions& options)
 
         std::string storageId = "::cubos::core::ecs::" + component.storage + "<" + id + ">";
 
+        // Describe the fields at compile time, so that serializers with a specialized path can write
+        // them without virtual calls, and so that tagged data can be matched by field identifier.
+        file << std::endl;
+        file << "template <>" << std::endl;
+        file << "struct cubos::core::data::Fields<" << id << ">" << std::endl;
+        file << "{" << std::endl;
+        file << "    static constexpr auto value = std::make_tuple(";
+        for (std::size_t i = 0; i < component.fields.size(); ++i)
+        {
+            file << (i == 0 ? "" : ",") << std::endl;
+            file << "        makeField(\"" << component.fields[i] << "\", &" << id << "::" << component.fields[i]
+                 << ")";
+        }
+        file << ");" << std::endl;
+        file << "};" << std::endl;
         file << std::endl;
         file << "template <>" << std::endl;
         file << "void cubos::core::data::serialize<" << id << ">(Serializer& ser, const " << id << "& obj,"
              << std::endl;
         file << "                                         const char* name)" << std::endl;
         file << "{" << std::endl;
-        if (component.fields.size() == 1)
-        {
-            file << "    ser.write(obj." << component.fields[0] << ", name);" << std::endl;
-        }
-        else
-        {
-            file << "    ser.beginObject(name);" << std::endl;
-            if (component.fields.size() == 0)
-            {
-                file << "    (void)obj;" << std::endl;
-            }
-            else
-            {
-                for (auto& field : component.fields)
-                {
-                    file << "    ser.write(obj." << field << ", \"" << field << "\");" << std::endl;
-                }
-            }
-            file << "    ser.endObject();" << std::endl;
-        }
+        file << "    serializeFields<BinarySerializer, TaggedSerializer>(ser, obj, name);" << std::endl;
         file << "}" << std::endl;
         file << std::endl;
         file << "template <>" << std::endl;
         file << "void cubos::core::data::deserialize<" << id << ">(Deserializer& des, " << id << "& obj)" << std::endl;
         file << "{" << std::endl;
-        if (component.fields.size() == 1)
-        {
-            file << "    des.read(obj." << component.fields[0] << ");" << std::endl;
-        }
-        else
-        {
-            file << "    des.beginObject();" << std::endl;
-            if (component.fields.size() == 0)
-            {
-                file << "    (void)obj;" << std::endl;
-            }
-            else
-            {
-                for (auto& field : component.fields)
-                {
-                    file << "    des.read(obj." << field << ");" << std::endl;
-                }
-            }
-            file << "    des.endObject();" << std::endl;
-        }
+        file << "    deserializeFields<TaggedDeserializer>(des, obj);" << std::endl;
         file << "}" << std::endl;
         file << std::endl;
         if (!component.namespaceStr.empty())